@@ -123,7 +123,7 @@ void AStar::remove_point(int p_id) {
 	}
 
 	memdelete(p);
-	points.remove(p_id);
+	points.erase(p_id);
 	last_free_id = p_id;
 }
 
@@ -212,7 +212,7 @@ bool AStar::has_point(int p_id) const {
 Array AStar::get_point_ids() {
 	Array point_list;
 
-	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+	for (SwissHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
 		point_list.push_back(*(it.key));
 	}
 
@@ -243,7 +243,7 @@ bool AStar::are_points_connected(int p_id, int p_with_id, bool bidirectional) co
 
 void AStar::clear() {
 	last_free_id = 0;
-	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+	for (SwissHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
 		memdelete(*(it.value));
 	}
 	segments.clear();
@@ -251,7 +251,7 @@ void AStar::clear() {
 }
 
 int AStar::get_point_count() const {
-	return points.get_num_elements();
+	return points.size();
 }
 
 int AStar::get_point_capacity() const {
@@ -268,7 +268,7 @@ int AStar::get_closest_point(const Vector3 &p_point, bool p_include_disabled) co
 	int closest_id = -1;
 	real_t closest_dist = 1e20;
 
-	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+	for (SwissHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
 		if (!p_include_disabled && !(*it.value)->enabled) {
 			continue; // Disabled points should not be considered.
 		}
@@ -35,6 +35,7 @@
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
 #include "core/templates/oa_hash_map.h"
+#include "core/templates/swiss_hash_map.h"
 
 /**
 	A* pathfinding algorithm.
@@ -111,7 +112,7 @@ class AStar : public RefCounted {
 	int last_free_id = 0;
 	uint64_t pass = 1;
 
-	OAHashMap<int, Point *> points;
+	SwissHashMap<int, Point *> points;
 	Set<Segment> segments;
 
 	bool _solve(Point *begin_point, Point *end_point);
@@ -53,6 +53,7 @@
 
 #include "bvh_tree.h"
 #include "core/os/mutex.h"
+#include "core/os/worker_thread_pool.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
 #define BVH_LOCKED_FUNCTION BVHLockedFunction(&_mutex, BVH_THREAD_SAFE &&_thread_safe);
@@ -88,6 +89,18 @@ public:
 		tree.params_set_pairing_expansion(p_value);
 	}
 
+	// Cull the changed items on the WorkerThreadPool when checking for collisions.
+	// Only enable this when the user pair and cull test functions are thread safe.
+	void params_set_parallel_pairing(bool p_enable) {
+		BVH_LOCKED_FUNCTION
+		_parallel_pairing = p_enable;
+	}
+
+	// Total number of candidate pairs found by the pairing culls so far.
+	uint64_t get_pair_test_count() const {
+		return _pair_test_count;
+	}
+
 	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
 		BVH_LOCKED_FUNCTION
 		pair_callback = p_callback;
@@ -427,6 +440,28 @@ private:
 			return;
 		}
 
+		WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+		if (_parallel_pairing && thread_pool && changed_items.size() >= PARALLEL_PAIRING_THRESHOLD) {
+			// The culls only read the tree, so they run on the pool with one hit buffer
+			// per changed item. Pair callbacks are then sent serially in the same order.
+			if (_changed_item_hits.size() < changed_items.size()) {
+				_changed_item_hits.resize(changed_items.size());
+			}
+			thread_pool->do_work(changed_items.size(), this, &BVH_Manager::_cull_changed_item, nullptr);
+
+			for (unsigned int n = 0; n < changed_items.size(); n++) {
+				const BVHHandle &h = changed_items[n];
+
+				BVHABB_CLASS abb;
+				abb.from(tree._pairs[h.id()].expanded_aabb);
+
+				_find_leavers(h, abb, p_full_check);
+				_collide_hits(h, _changed_item_hits[n]);
+			}
+			_reset();
+			return;
+		}
+
 		BOUNDS bb;
 
 		typename BVHTREE_CLASS::CullParams params;
@@ -450,37 +485,52 @@ private:
 			// paired, and send callbacks
 			_find_leavers(h, abb, p_full_check);
 
-			uint32_t changed_item_ref_id = h.id();
-
 			params.abb = abb;
 
 			params.result_count_overall = 0; // might not be needed
 			tree.cull_aabb(params, false);
 
-			for (unsigned int i = 0; i < tree._cull_hits.size(); i++) {
-				uint32_t ref_id = tree._cull_hits[i];
+			_collide_hits(h, tree._cull_hits);
+		}
+		_reset();
+	}
+
+	void _cull_changed_item(uint32_t p_index, void *p_userdata) {
+		const BVHHandle &h = changed_items[p_index];
 
-				// don't collide against ourself
-				if (ref_id == changed_item_ref_id) {
-					continue;
-				}
+		typename BVHTREE_CLASS::CullParams params;
+		params.result_count_overall = 0;
+		params.result_max = INT_MAX;
+		params.result_array = nullptr;
+		params.subindex_array = nullptr;
+		params.hits = &_changed_item_hits[p_index];
 
-#ifdef BVH_CHECKS
-				// if neither are pairable, they should ignore each other
-				// THIS SHOULD NEVER HAPPEN .. now we only test the pairable tree
-				// if the changed item is not pairable
-				CRASH_COND(params.test_pairable_only && !tree._extra[ref_id].pairable);
-#endif
+		tree.item_fill_cullparams(h, params);
+		params.abb.from(tree._pairs[h.id()].expanded_aabb);
+
+		tree.cull_aabb(params, false);
+	}
+
+	// find NEW enterers among the cull hits of a changed item
+	void _collide_hits(BVHHandle p_handle, const LocalVector<uint32_t, uint32_t, true> &p_hits) {
+		uint32_t changed_item_ref_id = p_handle.id();
+		_pair_test_count += p_hits.size();
 
-				// checkmasks is already done in the cull routine.
-				BVHHandle h_collidee;
-				h_collidee.set_id(ref_id);
+		for (unsigned int i = 0; i < p_hits.size(); i++) {
+			uint32_t ref_id = p_hits[i];
 
-				// find NEW enterers, and send callbacks for them only
-				_collide(h, h_collidee);
+			// don't collide against ourself
+			if (ref_id == changed_item_ref_id) {
+				continue;
 			}
+
+			// checkmasks is already done in the cull routine.
+			BVHHandle h_collidee;
+			h_collidee.set_id(ref_id);
+
+			// find NEW enterers, and send callbacks for them only
+			_collide(p_handle, h_collidee);
 		}
-		_reset();
 	}
 
 public:
@@ -775,6 +825,12 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick;
 
+	// Below this many changed items, culling serially is cheaper than dispatching.
+	static const uint32_t PARALLEL_PAIRING_THRESHOLD = 64;
+	bool _parallel_pairing = false;
+	LocalVector<LocalVector<uint32_t, uint32_t, true>> _changed_item_hits;
+	uint64_t _pair_test_count = 0;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
@@ -97,10 +97,10 @@ public:
 
 		ObjectNativeExtension *native_extension = nullptr;
 
-		HashMap<StringName, MethodBind *> method_map;
-		HashMap<StringName, int> constant_map;
+		SwissHashMap<StringName, MethodBind *> method_map;
+		SwissHashMap<StringName, int> constant_map;
 		HashMap<StringName, List<StringName>> enum_map;
-		HashMap<StringName, MethodInfo> signal_map;
+		SwissHashMap<StringName, MethodInfo> signal_map;
 		List<PropertyInfo> property_list;
 		HashMap<StringName, PropertyInfo> property_map;
 #ifdef DEBUG_METHODS_ENABLED
@@ -112,7 +112,7 @@ public:
 		StringName category;
 		Map<StringName, Vector<Error>> method_error_values;
 #endif
-		HashMap<StringName, PropertySetGet> property_setget;
+		SwissHashMap<StringName, PropertySetGet> property_setget;
 
 		StringName inherits;
 		StringName name;
@@ -34,23 +34,153 @@
 #include "core/core_string_names.h"
 #include "core/object/class_db.h"
 #include "core/object/script_language.h"
+#include "core/os/thread.h"
 
 MessageQueue *MessageQueue::singleton = nullptr;
+uint64_t MessageQueue::last_queue_id = 0;
+thread_local MessageQueue::ThreadBufferHandle MessageQueue::thread_buffer;
+
+MessageQueue::ThreadBufferHandle::~ThreadBufferHandle() {
+	// The thread is exiting, hand its buffer back so flush() can drain and recycle it.
+	if (buffer && singleton && singleton->queue_id == queue_id) {
+		buffer->state.store(THREAD_BUFFER_ORPHANED, std::memory_order_release);
+	}
+}
 
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+MessageQueue::Page *MessageQueue::_alloc_page(uint32_t p_min_size) {
+	Page *page = nullptr;
+	if (p_min_size <= PAGE_SIZE_BYTES) {
+		if (page_pool_mutex.try_lock() != OK) {
+			contention_count.increment();
+			page_pool_mutex.lock();
+		}
+		page = free_pages;
+		if (page) {
+			free_pages = page->next_free;
+		}
+		page_pool_mutex.unlock();
+	}
+
+	if (!page) {
+		uint32_t size = MAX(uint32_t(PAGE_SIZE_BYTES), p_min_size);
+		page = (Page *)memalloc(sizeof(Page) + size);
+		memnew_placement(page, Page);
+		page->size = size;
+	}
+
+	page->next.store(nullptr, std::memory_order_relaxed);
+	page->committed.store(0, std::memory_order_relaxed);
+	page->next_free = nullptr;
+	return page;
+}
+
+void MessageQueue::_free_page(Page *p_page) {
+	if (p_page->size != PAGE_SIZE_BYTES) {
+		// Oversized page for a single huge message, not worth keeping around.
+		p_page->~Page();
+		memfree(p_page);
+		return;
+	}
+
+	page_pool_mutex.lock();
+	p_page->next_free = free_pages;
+	free_pages = p_page;
+	page_pool_mutex.unlock();
+}
+
+MessageQueue::ThreadBuffer *MessageQueue::_get_thread_buffer() {
+	if (likely(thread_buffer.buffer && thread_buffer.queue_id == queue_id)) {
+		return thread_buffer.buffer;
+	}
+
+	// First push from this thread, take over a drained buffer from an exited thread or make a new one.
+	if (thread_buffers_mutex.try_lock() != OK) {
+		contention_count.increment();
+		thread_buffers_mutex.lock();
+	}
+
+	ThreadBuffer *buffer = nullptr;
+	for (ThreadBuffer *E = thread_buffers.load(std::memory_order_acquire); E; E = E->next) {
+		uint32_t expected = THREAD_BUFFER_RECYCLABLE;
+		if (E->state.compare_exchange_strong(expected, THREAD_BUFFER_ACTIVE, std::memory_order_acq_rel)) {
+			buffer = E;
+			break;
+		}
+	}
+
+	if (!buffer) {
+		buffer = memnew(ThreadBuffer);
+		buffer->state.store(THREAD_BUFFER_ACTIVE, std::memory_order_relaxed);
+		buffer->write_page = _alloc_page(PAGE_SIZE_BYTES);
+		buffer->read_page = buffer->write_page;
+		buffer->next = thread_buffers.load(std::memory_order_relaxed);
+		thread_buffers.store(buffer, std::memory_order_release);
+	}
+
+	thread_buffers_mutex.unlock();
+
+	thread_buffer.buffer = buffer;
+	thread_buffer.queue_id = queue_id;
+	return buffer;
+}
+
+uint8_t *MessageQueue::_begin_message(uint32_t p_room_needed) {
+	if (buffer_used.add(p_room_needed) > buffer_size) {
+		buffer_used.sub(p_room_needed);
+		overflow_count.increment();
+		return nullptr;
+	}
+
+	ThreadBuffer *buffer = _get_thread_buffer();
+	if (buffer->write_pos + p_room_needed > buffer->write_page->size) {
+		Page *page = _alloc_page(p_room_needed);
+		// Everything in the old page is already committed, the consumer moves on once it sees this.
+		buffer->write_page->next.store(page, std::memory_order_release);
+		buffer->write_page = page;
+		buffer->write_pos = 0;
+	}
+
+	uint8_t *ptr = buffer->write_page->data() + buffer->write_pos;
+	buffer->write_pos += p_room_needed;
+	return ptr;
+}
+
+void MessageQueue::_commit_message() {
+	ThreadBuffer *buffer = thread_buffer.buffer;
+	buffer->write_page->committed.store(buffer->write_pos, std::memory_order_release);
+}
+
+uint32_t MessageQueue::_get_message_size(const Message *p_message) const {
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		size += sizeof(Variant) * p_message->args;
+	}
+	return size;
+}
+
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+	p_message->~Message();
+}
+
 Error MessageQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	uint8_t *ptr = _begin_message(room_needed);
+	if (!ptr) {
 		String type;
 		if (ObjectDB::get_instance(p_id)) {
 			type = ObjectDB::get_instance(p_id)->get_class();
@@ -60,41 +190,39 @@ Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Vari
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(ptr, Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement(ptr + sizeof(Message), Variant);
 	*v = p_value;
 
+	_commit_message();
+
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	uint32_t room_needed = sizeof(Message);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	uint8_t *ptr = _begin_message(room_needed);
+	if (!ptr) {
 		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
 		statistics();
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(ptr, Message);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
+	_commit_message();
 
 	return OK;
 }
@@ -112,17 +240,16 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
-
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	uint8_t *ptr = _begin_message(room_needed);
+	if (!ptr) {
 		print_line("Failed method: " + p_callable);
 		statistics();
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(ptr, Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
@@ -130,72 +257,85 @@ Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(ptr + sizeof(Message));
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	_commit_message();
+
 	return OK;
 }
 
 void MessageQueue::statistics() {
+	print_line("TOTAL BYTES: " + itos(buffer_used.get()));
+	print_line("OVERFLOW count: " + itos(overflow_count.get()));
+	print_line("THREAD BUFFERS: " + itos(get_thread_buffer_count()));
+
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		// Pending messages can only be inspected safely from the thread that flushes them.
+		return;
+	}
+
 	Map<StringName, int> set_count;
 	Map<int, int> notify_count;
 	Map<Callable, int> call_count;
 	int null_count = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	for (ThreadBuffer *buffer = thread_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+		Page *page = buffer->read_page;
+		uint32_t read_pos = buffer->read_pos;
+		while (page) {
+			uint32_t committed = page->committed.load(std::memory_order_acquire);
+			while (read_pos < committed) {
+				Message *message = (Message *)(page->data() + read_pos);
 
-		Object *target = message->callable.get_object();
+				Object *target = message->callable.get_object();
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
+				if (target != nullptr) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
+							if (!call_count.has(message->callable)) {
+								call_count[message->callable] = 0;
+							}
 
-					call_count[message->callable]++;
+							call_count[message->callable]++;
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+						} break;
+						case TYPE_NOTIFICATION: {
+							if (!notify_count.has(message->notification)) {
+								notify_count[message->notification] = 0;
+							}
 
-					notify_count[message->notification]++;
+							notify_count[message->notification]++;
 
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+						} break;
+						case TYPE_SET: {
+							StringName t = message->callable.get_method();
+							if (!set_count.has(t)) {
+								set_count[t] = 0;
+							}
 
-					set_count[t]++;
+							set_count[t]++;
 
-				} break;
-			}
+						} break;
+					}
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+				} else {
+					//object was deleted
+					print_line("Object was deleted while awaiting a callback");
 
-			null_count++;
-		}
+					null_count++;
+				}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+				read_pos += _get_message_size(message);
+			}
+			page = page->next.load(std::memory_order_acquire);
+			read_pos = 0;
 		}
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
 	print_line("NULL count: " + itos(null_count));
 
 	for (const KeyValue<StringName, int> &E : set_count) {
@@ -215,6 +355,26 @@ int MessageQueue::get_max_buffer_usage() const {
 	return buffer_max_used;
 }
 
+int MessageQueue::get_buffer_usage() const {
+	return last_flush_used;
+}
+
+uint64_t MessageQueue::get_overflow_count() const {
+	return overflow_count.get();
+}
+
+uint64_t MessageQueue::get_contention_count() const {
+	return contention_count.get();
+}
+
+int MessageQueue::get_thread_buffer_count() const {
+	int count = 0;
+	for (ThreadBuffer *E = thread_buffers.load(std::memory_order_acquire); E; E = E->next) {
+		count++;
+	}
+	return count;
+}
+
 void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
 	if (p_argcount) {
@@ -233,113 +393,131 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 }
 
 void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-	}
-
-	uint32_t read_pos = 0;
+	ERR_FAIL_COND(flushing.is_set()); //already flushing, you did something odd
+	flushing.set();
 
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
-		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+	last_flush_used = buffer_used.get();
+	if (last_flush_used > buffer_max_used) {
+		buffer_max_used = last_flush_used;
 	}
-	flushing = true;
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
+	// Keep draining until no producer has anything left, calls may re-add themselves to the queue.
+	bool processed = true;
+	while (processed) {
+		processed = false;
 
-		Message *message = (Message *)&buffer[read_pos];
+		for (ThreadBuffer *buffer = thread_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+			while (true) {
+				Page *page = buffer->read_page;
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
-		}
+				if (buffer->read_pos < page->committed.load(std::memory_order_acquire)) {
+					Message *message = (Message *)(page->data() + buffer->read_pos);
+					uint32_t advance = _get_message_size(message);
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+					//pre-advance so this function is reentrant
+					buffer->read_pos += advance;
 
-		_THREAD_SAFE_UNLOCK_
+					Object *target = message->callable.get_object();
 
-		Object *target = message->callable.get_object();
+					if (target != nullptr) {
+						switch (message->type & FLAG_MASK) {
+							case TYPE_CALL: {
+								Variant *args = (Variant *)(message + 1);
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					Variant *args = (Variant *)(message + 1);
+								// messages don't expect a return value
 
-					// messages don't expect a return value
+								_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
 
-					_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
+							} break;
+							case TYPE_NOTIFICATION: {
+								// messages don't expect a return value
+								target->notification(message->notification);
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					// messages don't expect a return value
-					target->notification(message->notification);
+							} break;
+							case TYPE_SET: {
+								Variant *arg = (Variant *)(message + 1);
+								// messages don't expect a return value
+								target->set(message->callable.get_method(), *arg);
 
-				} break;
-				case TYPE_SET: {
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->callable.get_method(), *arg);
+							} break;
+						}
+					}
 
-				} break;
+					_destroy_message(message);
+					buffer_used.sub(advance);
+					processed = true;
+					continue;
+				}
+
+				Page *next = page->next.load(std::memory_order_acquire);
+				if (!next) {
+					break;
+				}
+				if (buffer->read_pos < page->committed.load(std::memory_order_acquire)) {
+					// The producer committed more right before moving to the next page.
+					continue;
+				}
+
+				buffer->read_page = next;
+				buffer->read_pos = 0;
+				_free_page(page);
 			}
-		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
+			uint32_t expected = THREAD_BUFFER_ORPHANED;
+			if (buffer->state.load(std::memory_order_acquire) == expected && buffer->read_page->next.load(std::memory_order_acquire) == nullptr && buffer->read_pos == buffer->read_page->committed.load(std::memory_order_acquire)) {
+				buffer->state.compare_exchange_strong(expected, THREAD_BUFFER_RECYCLABLE, std::memory_order_acq_rel);
 			}
 		}
-
-		message->~Message();
-
-		_THREAD_SAFE_LOCK_
 	}
 
-	buffer_end = 0; // reset buffer
-	flushing = false;
-	_THREAD_SAFE_UNLOCK_
+	flushing.clear();
 }
 
 bool MessageQueue::is_flushing() const {
-	return flushing;
+	return flushing.is_set();
 }
 
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
+	queue_id = ++last_queue_id;
+	thread_buffers.store(nullptr);
 
 	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
 	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
+	ThreadBuffer *buffer = thread_buffers.load(std::memory_order_acquire);
+	while (buffer) {
+		Page *page = buffer->read_page;
+		uint32_t read_pos = buffer->read_pos;
+		while (page) {
+			uint32_t committed = page->committed.load(std::memory_order_acquire);
+			while (read_pos < committed) {
+				Message *message = (Message *)(page->data() + read_pos);
+				read_pos += _get_message_size(message);
+				_destroy_message(message);
 			}
+			Page *next = page->next.load(std::memory_order_acquire);
+			page->~Page();
+			memfree(page);
+			page = next;
+			read_pos = 0;
 		}
-		message->~Message();
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+		ThreadBuffer *next = buffer->next;
+		memdelete(buffer);
+		buffer = next;
+	}
+
+	while (free_pages) {
+		Page *next = free_pages->next_free;
+		free_pages->~Page();
+		memfree(free_pages);
+		free_pages = next;
 	}
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
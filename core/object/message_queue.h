@@ -32,16 +32,23 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/object_id.h"
-#include "core/os/thread_safe.h"
+#include "core/os/mutex.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
+#include <atomic>
+
 class Object;
 
-class MessageQueue {
-	_THREAD_SAFE_CLASS_
+// Messages are written by each producer thread into its own staging buffer,
+// a chain of pages that only that thread appends to. Publishing a message is a
+// single atomic store, and flush() walks every staging buffer without locking,
+// so deferred calls keep their order per producer thread.
 
+class MessageQueue {
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		PAGE_SIZE_BYTES = 16384,
 	};
 
 	enum {
@@ -62,16 +69,71 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end = 0;
+	struct alignas(16) Page {
+		std::atomic<Page *> next;
+		std::atomic<uint32_t> committed; // Bytes the consumer is allowed to read.
+		uint32_t size = 0;
+		Page *next_free = nullptr;
+
+		_FORCE_INLINE_ uint8_t *data() { return reinterpret_cast<uint8_t *>(this + 1); }
+	};
+
+	enum ThreadBufferState {
+		THREAD_BUFFER_ACTIVE,
+		THREAD_BUFFER_ORPHANED, // Producer thread exited, may still hold messages.
+		THREAD_BUFFER_RECYCLABLE, // Orphaned and fully drained, can be given to a new thread.
+	};
+
+	struct ThreadBuffer {
+		// Producer side, only touched by the owning thread.
+		Page *write_page = nullptr;
+		uint32_t write_pos = 0;
+
+		// Consumer side, only touched by the flushing thread.
+		Page *read_page = nullptr;
+		uint32_t read_pos = 0;
+
+		std::atomic<uint32_t> state;
+		ThreadBuffer *next = nullptr; // Immutable once published.
+	};
+
+	struct ThreadBufferHandle {
+		ThreadBuffer *buffer = nullptr;
+		uint64_t queue_id = 0;
+		~ThreadBufferHandle();
+	};
+
+	static thread_local ThreadBufferHandle thread_buffer;
+
+	std::atomic<ThreadBuffer *> thread_buffers;
+	BinaryMutex thread_buffers_mutex; // Only for registering new producer threads.
+
+	BinaryMutex page_pool_mutex;
+	Page *free_pages = nullptr;
+
+	uint64_t queue_id = 0;
+	uint32_t buffer_size = 0;
+	SafeNumeric<uint32_t> buffer_used;
 	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size;
+	uint32_t last_flush_used = 0;
+	SafeNumeric<uint64_t> overflow_count;
+	SafeNumeric<uint64_t> contention_count;
+
+	static uint64_t last_queue_id;
+
+	ThreadBuffer *_get_thread_buffer();
+	Page *_alloc_page(uint32_t p_min_size);
+	void _free_page(Page *p_page);
+	uint8_t *_begin_message(uint32_t p_room_needed);
+	void _commit_message();
+	uint32_t _get_message_size(const Message *p_message) const;
+	void _destroy_message(Message *p_message);
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
 
-	bool flushing = false;
+	SafeFlag flushing;
 
 public:
 	static MessageQueue *get_singleton();
@@ -121,6 +183,10 @@ public:
 	bool is_flushing() const;
 
 	int get_max_buffer_usage() const;
+	int get_buffer_usage() const;
+	uint64_t get_overflow_count() const;
+	uint64_t get_contention_count() const;
+	int get_thread_buffer_count() const;
 
 	MessageQueue();
 	~MessageQueue();
@@ -41,6 +41,7 @@
 #include "core/templates/map.h"
 #include "core/templates/safe_refcount.h"
 #include "core/templates/set.h"
+#include "core/templates/swiss_hash_map.h"
 #include "core/templates/vmap.h"
 #include "core/variant/callable_bind.h"
 #include "core/variant/variant.h"
@@ -511,7 +512,7 @@ private:
 		VMap<Callable, Slot> slot_map;
 	};
 
-	HashMap<StringName, SignalData> signal_map;
+	SwissHashMap<StringName, SignalData> signal_map;
 	List<Connection> connections;
 #ifdef DEBUG_ENABLED
 	SafeRefCount _lock_index;
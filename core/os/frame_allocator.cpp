@@ -0,0 +1,267 @@
+/*************************************************************************/
+/*  frame_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "frame_allocator.h"
+
+#include <string.h>
+
+// Precedes every allocation, keeps the payload aligned.
+struct FrameAllocationHeader {
+	uint64_t size; // Payload size, rounded up to the alignment for arena allocations.
+	void *generation; // Owning arena, null when it fell back to Memory::alloc_static().
+};
+
+static_assert(sizeof(FrameAllocationHeader) == 16, "Frame allocation header must keep 16 byte alignment.");
+
+#define BLOCK_HEADER_SIZE ((sizeof(Block) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+#define ALIGN_SIZE(m_size) (((m_size) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+
+thread_local FrameAllocator::Arena FrameAllocator::arena;
+
+SafeNumeric<uint64_t> FrameAllocator::frame;
+SafeNumeric<uint64_t> FrameAllocator::frame_usage;
+
+uint64_t FrameAllocator::usage_history[USAGE_HISTORY_SIZE] = {};
+uint32_t FrameAllocator::usage_history_pos = 0;
+uint64_t FrameAllocator::peak_usage = 0;
+
+FrameAllocator::Arena::~Arena() {
+	_flush_usage(*this);
+	for (int i = 0; i < 2; i++) {
+		if (generations[i].live.get()) {
+			// Still referenced, leak it rather than pull the memory from under its user.
+			continue;
+		}
+		Block *b = generations[i].blocks;
+		while (b) {
+			Block *next = b->next;
+			memfree(b);
+			b = next;
+		}
+		generations[i].blocks = nullptr;
+		generations[i].capacity = 0;
+	}
+}
+
+void FrameAllocator::_flush_usage(Arena &p_arena) {
+	if (p_arena.unreported_usage) {
+		frame_usage.add(p_arena.unreported_usage);
+		p_arena.unreported_usage = 0;
+	}
+}
+
+bool FrameAllocator::_reset_generation(Generation &p_generation) {
+	if (p_generation.live.get()) {
+		return false;
+	}
+
+	Block *b = p_generation.blocks;
+	if (!b) {
+		return true;
+	}
+
+	size_t new_size;
+	if (b->next) {
+		// Spilled into several blocks, replace them with one that fits the whole frame.
+		new_size = MIN(p_generation.capacity, MAX_ARENA_SIZE);
+	} else if (b->size > MIN_BLOCK_SIZE && b->used < b->size / 4) {
+		// Give back memory slowly after a spike.
+		new_size = MAX(MIN_BLOCK_SIZE, b->size / 2);
+	} else {
+		b->used = 0;
+		return true;
+	}
+
+	while (b) {
+		Block *next = b->next;
+		memfree(b);
+		b = next;
+	}
+
+	b = memnew_placement(memalloc(BLOCK_HEADER_SIZE + new_size), Block);
+	b->size = new_size;
+	p_generation.blocks = b;
+	p_generation.capacity = new_size;
+	return true;
+}
+
+void FrameAllocator::_advance_arena(Arena &p_arena, uint64_t p_frame) {
+	_flush_usage(p_arena);
+	p_arena.frame = p_frame;
+
+	// Prefer switching, so what the previous frame allocated stays untouched for a while.
+	const uint32_t other = p_arena.current ^ 1;
+	if (_reset_generation(p_arena.generations[other])) {
+		p_arena.current = other;
+	} else {
+		// Both may be in use, in which case the current one keeps growing.
+		_reset_generation(p_arena.generations[p_arena.current]);
+	}
+}
+
+void *FrameAllocator::_alloc_slow(Generation &p_generation, size_t p_bytes) {
+	const size_t total = sizeof(FrameAllocationHeader) + ALIGN_SIZE(p_bytes);
+	const size_t block_size = MAX(MAX(MIN_BLOCK_SIZE, p_generation.capacity), total);
+
+	if (p_generation.capacity + block_size > MAX_ARENA_SIZE) {
+		FrameAllocationHeader *header = static_cast<FrameAllocationHeader *>(Memory::alloc_static(sizeof(FrameAllocationHeader) + p_bytes));
+		header->size = p_bytes;
+		header->generation = nullptr;
+		return header + 1;
+	}
+
+	Block *b = memnew_placement(memalloc(BLOCK_HEADER_SIZE + block_size), Block);
+	b->size = block_size;
+	b->next = p_generation.blocks;
+	p_generation.blocks = b;
+	p_generation.capacity += block_size;
+
+	FrameAllocationHeader *header = reinterpret_cast<FrameAllocationHeader *>(reinterpret_cast<uint8_t *>(b) + BLOCK_HEADER_SIZE);
+	b->used = total;
+	header->size = ALIGN_SIZE(p_bytes);
+	header->generation = &p_generation;
+	p_generation.live.increment();
+	return header + 1;
+}
+
+void *FrameAllocator::alloc(size_t p_bytes) {
+	Arena &a = arena;
+	const uint64_t current_frame = frame.get();
+	if (unlikely(a.frame != current_frame)) {
+		_advance_arena(a, current_frame);
+	}
+
+	Generation &g = a.generations[a.current];
+	const size_t total = sizeof(FrameAllocationHeader) + ALIGN_SIZE(p_bytes);
+
+	a.unreported_usage += total;
+	if (unlikely(a.unreported_usage >= USAGE_FLUSH_BYTES)) {
+		_flush_usage(a);
+	}
+
+	Block *b = g.blocks;
+	if (unlikely(!b || b->size - b->used < total)) {
+		return _alloc_slow(g, p_bytes);
+	}
+
+	FrameAllocationHeader *header = reinterpret_cast<FrameAllocationHeader *>(reinterpret_cast<uint8_t *>(b) + BLOCK_HEADER_SIZE + b->used);
+	b->used += total;
+	header->size = ALIGN_SIZE(p_bytes);
+	header->generation = &g;
+	g.live.increment();
+	return header + 1;
+}
+
+void *FrameAllocator::realloc(void *p_memory, size_t p_bytes) {
+	if (!p_memory) {
+		return alloc(p_bytes);
+	}
+
+	FrameAllocationHeader *header = static_cast<FrameAllocationHeader *>(p_memory) - 1;
+	if (!header->generation) {
+		header = static_cast<FrameAllocationHeader *>(Memory::realloc_static(header, sizeof(FrameAllocationHeader) + p_bytes));
+		header->size = p_bytes;
+		return header + 1;
+	}
+
+	const size_t new_size = ALIGN_SIZE(p_bytes);
+	if (new_size <= header->size) {
+		return p_memory;
+	}
+
+	// Grow in place if this is the most recent allocation of this thread and the block has room.
+	Arena &a = arena;
+	if (header->generation == &a.generations[a.current]) {
+		Block *b = a.generations[a.current].blocks;
+		uint8_t *top = reinterpret_cast<uint8_t *>(b) + BLOCK_HEADER_SIZE + b->used;
+		const size_t growth = new_size - header->size;
+		if (static_cast<uint8_t *>(p_memory) + header->size == top && b->size - b->used >= growth) {
+			b->used += growth;
+			header->size = new_size;
+			a.unreported_usage += growth;
+			return p_memory;
+		}
+	}
+
+	void *new_memory = alloc(p_bytes);
+	memcpy(new_memory, p_memory, header->size);
+	free(p_memory);
+	return new_memory;
+}
+
+void FrameAllocator::free(void *p_ptr) {
+	if (!p_ptr) {
+		return;
+	}
+
+	FrameAllocationHeader *header = static_cast<FrameAllocationHeader *>(p_ptr) - 1;
+	Generation *g = static_cast<Generation *>(header->generation);
+	if (!g) {
+		Memory::free_static(header);
+		return;
+	}
+
+	// Only the top of this thread's current block can be rewound, the rest waits for the reset.
+	Arena &a = arena;
+	if (g == &a.generations[a.current]) {
+		Block *b = g->blocks;
+		if (static_cast<uint8_t *>(p_ptr) + header->size == reinterpret_cast<uint8_t *>(b) + BLOCK_HEADER_SIZE + b->used) {
+			b->used -= sizeof(FrameAllocationHeader) + header->size;
+		}
+	}
+	g->live.decrement();
+}
+
+void FrameAllocator::next_frame() {
+	_flush_usage(arena);
+
+	// Threads report in chunks, so this is approximate.
+	const uint64_t used = frame_usage.get();
+	frame_usage.sub(used);
+
+	usage_history[usage_history_pos] = used;
+	usage_history_pos = (usage_history_pos + 1) % USAGE_HISTORY_SIZE;
+	peak_usage = MAX(peak_usage, used);
+
+	frame.increment();
+}
+
+uint64_t FrameAllocator::get_average_usage() {
+	const uint64_t frames = MIN(frame.get(), (uint64_t)USAGE_HISTORY_SIZE);
+	if (!frames) {
+		return 0;
+	}
+
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < USAGE_HISTORY_SIZE; i++) {
+		total += usage_history[i];
+	}
+	return total / frames;
+}
@@ -0,0 +1,121 @@
+/*************************************************************************/
+/*  frame_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FRAME_ALLOCATOR_H
+#define FRAME_ALLOCATOR_H
+
+#include "core/os/memory.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+// Linear allocator for transient allocations made during a frame.
+//
+// Every thread bumps through its own arena, so allocating takes no lock and
+// normally no call into the system allocator. Freeing the most recent
+// allocation of a thread gives its memory back right away; anything else is
+// kept until the arena resets. Arenas are reset by their thread on its first
+// allocation after Main::iteration() advanced the frame, but only once every
+// allocation in them has been freed: each thread alternates between two arenas
+// so one that is still in use (for example by work straddling the frame
+// boundary) just keeps growing until it's released.
+//
+// Everything must be freed, from any thread, before the allocating thread
+// exits. Allocations beyond the per thread budget fall back to
+// Memory::alloc_static().
+
+class FrameAllocator {
+	static const size_t ALIGNMENT = 16;
+	static const size_t MIN_BLOCK_SIZE = 64 * 1024;
+	static const size_t MAX_ARENA_SIZE = 64 * 1024 * 1024;
+	static const size_t USAGE_FLUSH_BYTES = 16 * 1024;
+	static const uint32_t USAGE_HISTORY_SIZE = 64;
+
+	struct Block {
+		Block *next = nullptr;
+		size_t size = 0;
+		size_t used = 0;
+	};
+
+	struct Generation {
+		Block *blocks = nullptr; // Current block first.
+		size_t capacity = 0;
+		SafeNumeric<uint32_t> live; // Allocations not freed yet, may be freed by other threads.
+	};
+
+	struct Arena {
+		uint64_t frame = 0;
+		uint32_t current = 0;
+		Generation generations[2];
+		uint64_t unreported_usage = 0;
+
+		~Arena();
+	};
+
+	static thread_local Arena arena;
+
+	static SafeNumeric<uint64_t> frame;
+	static SafeNumeric<uint64_t> frame_usage;
+
+	// Only touched by the main thread in next_frame().
+	static uint64_t usage_history[USAGE_HISTORY_SIZE];
+	static uint32_t usage_history_pos;
+	static uint64_t peak_usage;
+
+	static bool _reset_generation(Generation &p_generation);
+	static void _advance_arena(Arena &p_arena, uint64_t p_frame);
+	static void *_alloc_slow(Generation &p_generation, size_t p_bytes);
+	static void _flush_usage(Arena &p_arena);
+
+public:
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_ptr);
+
+	// Called once per Main::iteration().
+	static void next_frame();
+
+	static uint64_t get_frame() { return frame.get(); }
+	static uint64_t get_peak_usage() { return peak_usage; }
+	static uint64_t get_average_usage();
+};
+
+// Allocator policy for containers taking one (see DefaultAllocator).
+class FrameArenaAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return FrameAllocator::alloc(p_memory); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return FrameAllocator::realloc(p_ptr, p_memory); }
+	_FORCE_INLINE_ static void free(void *p_ptr) { FrameAllocator::free(p_ptr); }
+};
+
+// LocalVector drawing from the calling thread's frame arena.
+template <class T, class U = uint32_t, bool force_trivial = false>
+using FrameLocalVector = LocalVector<T, U, force_trivial, FrameArenaAllocator>;
+
+#endif // FRAME_ALLOCATOR_H
@@ -0,0 +1,366 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "core/os/os.h"
+
+thread_local WorkerThreadPool::ThreadData *WorkerThreadPool::current_thread = nullptr;
+WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
+
+void WorkerThreadPool::TaskDeque::push_back(Group *p_group) {
+	lock.lock();
+	if (count == capacity) {
+		uint32_t new_capacity = MAX(16u, capacity * 2);
+		Group **new_ring = (Group **)memalloc(sizeof(Group *) * new_capacity);
+		for (uint32_t i = 0; i < count; i++) {
+			new_ring[i] = ring[(head + i) & (capacity - 1)];
+		}
+		if (ring) {
+			memfree(ring);
+		}
+		ring = new_ring;
+		capacity = new_capacity;
+		head = 0;
+	}
+	ring[(head + count) & (capacity - 1)] = p_group;
+	count++;
+	lock.unlock();
+}
+
+WorkerThreadPool::Group *WorkerThreadPool::TaskDeque::pop_back() {
+	lock.lock();
+	Group *group = nullptr;
+	if (count > 0) {
+		count--;
+		group = ring[(head + count) & (capacity - 1)];
+	}
+	lock.unlock();
+	return group;
+}
+
+WorkerThreadPool::Group *WorkerThreadPool::TaskDeque::pop_front() {
+	lock.lock();
+	Group *group = nullptr;
+	if (count > 0) {
+		group = ring[head];
+		head = (head + 1) & (capacity - 1);
+		count--;
+	}
+	lock.unlock();
+	return group;
+}
+
+WorkerThreadPool::TaskDeque::~TaskDeque() {
+	if (ring) {
+		memfree(ring);
+	}
+}
+
+void WorkerThreadPool::_thread_function(void *p_user) {
+	ThreadData *thread_data = static_cast<ThreadData *>(p_user);
+	WorkerThreadPool *pool = thread_data->pool;
+	current_thread = thread_data;
+
+	Thread::set_name("WorkerThread " + itos(thread_data->index));
+
+	while (true) {
+		Group *task = pool->_pop_task();
+		if (task) {
+			pool->_process_task(task);
+			continue;
+		}
+#if !defined(NO_THREADS)
+		std::unique_lock<std::mutex> lock(pool->sleep_mutex);
+		pool->sleep_cond.wait(lock, [pool] {
+			return pool->exit_threads.load(std::memory_order_acquire) || pool->queued_tasks.load(std::memory_order_acquire) > 0;
+		});
+#endif
+		if (pool->exit_threads.load(std::memory_order_acquire)) {
+			break;
+		}
+	}
+
+	current_thread = nullptr;
+}
+
+void WorkerThreadPool::_notify_all() {
+#if !defined(NO_THREADS)
+	std::lock_guard<std::mutex> lock(sleep_mutex);
+	sleep_cond.notify_all();
+#endif
+}
+
+WorkerThreadPool::Group *WorkerThreadPool::_pop_task() {
+	if (queued_tasks.load(std::memory_order_acquire) == 0) {
+		return nullptr;
+	}
+
+	ThreadData *own = (current_thread && current_thread->pool == this) ? current_thread : nullptr;
+
+	Group *group = nullptr;
+	if (own) {
+		// Newest work first, this is most likely what we just pushed ourselves.
+		group = own->deque.pop_back();
+	}
+
+	if (!group && thread_count > 0) {
+		// Steal the oldest work from someone else.
+		uint32_t start = own ? own->index + 1 : submit_rotation.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < thread_count && !group; i++) {
+			ThreadData *victim = &threads[(start + i) % thread_count];
+			if (victim != own) {
+				group = victim->deque.pop_front();
+			}
+		}
+	}
+
+	if (group) {
+		queued_tasks.fetch_sub(1, std::memory_order_acq_rel);
+	}
+	return group;
+}
+
+void WorkerThreadPool::_process_task(Group *p_group) {
+	// Read before signaling, the group may be freed as soon as this task is accounted for.
+	uint32_t tasks_used = p_group->tasks_used;
+
+	while (true) {
+		uint32_t work_index = p_group->index.fetch_add(1, std::memory_order_relaxed);
+		if (work_index >= p_group->max) {
+			break;
+		}
+		if (p_group->native_func) {
+			p_group->native_func(p_group->native_func_userdata, work_index);
+		} else {
+			p_group->template_userdata->callback_indexed(work_index);
+		}
+		p_group->completed_index.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (p_group->finished.fetch_add(1, std::memory_order_acq_rel) + 1 == tasks_used) {
+		_group_task_done(p_group);
+	}
+}
+
+void WorkerThreadPool::_push_group_tasks(Group *p_group) {
+	if (thread_count == 0) {
+		// No workers (single-threaded build), just run everything right away.
+		for (uint32_t i = 0; i < p_group->tasks_used; i++) {
+			_process_task(p_group);
+		}
+		return;
+	}
+
+	queued_tasks.fetch_add(p_group->tasks_used, std::memory_order_acq_rel);
+
+	if (current_thread && current_thread->pool == this) {
+		// Nested work stays local, idle workers will steal it if they can.
+		for (uint32_t i = 0; i < p_group->tasks_used; i++) {
+			current_thread->deque.push_back(p_group);
+		}
+	} else {
+		uint32_t start = submit_rotation.fetch_add(p_group->tasks_used, std::memory_order_relaxed);
+		for (uint32_t i = 0; i < p_group->tasks_used; i++) {
+			threads[(start + i) % thread_count].deque.push_back(p_group);
+		}
+	}
+
+	_notify_all();
+}
+
+void WorkerThreadPool::_group_task_done(Group *p_group) {
+	LocalVector<Group *> ready;
+
+	groups_mutex.lock();
+	for (uint32_t i = 0; i < p_group->dependents.size(); i++) {
+		Group *dependent = p_group->dependents[i];
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			ready.push_back(dependent);
+		}
+	}
+	p_group->dependents.clear();
+	// Once this is set, the waiting thread may free the group at any time.
+	p_group->completed.store(true, std::memory_order_release);
+	groups_mutex.unlock();
+
+	for (uint32_t i = 0; i < ready.size(); i++) {
+		_push_group_tasks(ready[i]);
+	}
+
+	_notify_all();
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(Group *p_group, const GroupID *p_dependencies, uint32_t p_dependency_count) {
+	// One task per thread plus one for the thread that will wait on the group.
+	p_group->tasks_used = MAX(1u, MIN(p_group->max, thread_count + 1));
+
+	groups_mutex.lock();
+	GroupID id = ++last_group_id;
+	groups.set(id, p_group);
+	for (uint32_t i = 0; i < p_dependency_count; i++) {
+		Group **dependency = groups.getptr(p_dependencies[i]);
+		// Groups that were already waited for no longer exist, they count as completed.
+		if (dependency && !(*dependency)->completed.load(std::memory_order_acquire)) {
+			(*dependency)->dependents.push_back(p_group);
+			p_group->pending_dependencies++;
+		}
+	}
+	bool ready = p_group->pending_dependencies == 0;
+	groups_mutex.unlock();
+
+	if (ready) {
+		_push_group_tasks(p_group);
+	}
+
+	return id;
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, uint32_t p_elements, const GroupID *p_dependencies, uint32_t p_dependency_count) {
+	ERR_FAIL_NULL_V(p_func, INVALID_GROUP_ID);
+
+	Group *group = group_allocator.alloc();
+	group->native_func = p_func;
+	group->native_func_userdata = p_userdata;
+	group->max = p_elements;
+	return _add_group_task(group, p_dependencies, p_dependency_count);
+}
+
+bool WorkerThreadPool::is_group_task_completed(GroupID p_group) const {
+	MutexLock lock(groups_mutex);
+	Group *const *group = groups.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!group, true, "Invalid group task ID.");
+	return (*group)->completed.load(std::memory_order_acquire);
+}
+
+uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
+	MutexLock lock(groups_mutex);
+	Group *const *group = groups.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!group, 0, "Invalid group task ID.");
+	return (*group)->completed_index.load(std::memory_order_relaxed);
+}
+
+void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
+	Group *group = nullptr;
+	groups_mutex.lock();
+	Group **group_ptr = groups.getptr(p_group);
+	if (group_ptr) {
+		group = *group_ptr;
+	}
+	groups_mutex.unlock();
+	ERR_FAIL_COND_MSG(!group, "Invalid group task ID, or group was already waited for.");
+
+	while (!group->completed.load(std::memory_order_acquire)) {
+		// Help out instead of blocking, this is what makes nested work possible.
+		Group *task = _pop_task();
+		if (task) {
+			_process_task(task);
+			continue;
+		}
+#if !defined(NO_THREADS)
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		sleep_cond.wait(lock, [this, group] {
+			return group->completed.load(std::memory_order_acquire) || queued_tasks.load(std::memory_order_acquire) > 0;
+		});
+#endif
+	}
+
+	groups_mutex.lock();
+	groups.erase(p_group);
+	groups_mutex.unlock();
+
+	if (group->template_userdata) {
+		memdelete(group->template_userdata);
+	}
+	group_allocator.free(group);
+}
+
+int WorkerThreadPool::get_thread_index() {
+	return current_thread ? int(current_thread->index) : -1;
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+	ERR_FAIL_COND(threads != nullptr);
+#if defined(NO_THREADS)
+	p_thread_count = 0;
+#else
+	if (p_thread_count < 0) {
+		p_thread_count = OS::get_singleton()->get_default_thread_pool_size();
+	}
+#endif
+
+	thread_count = p_thread_count;
+	if (thread_count == 0) {
+		return;
+	}
+
+	exit_threads.store(false);
+	threads = memnew_arr(ThreadData, thread_count);
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].index = i;
+		threads[i].pool = this;
+		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
+	}
+}
+
+void WorkerThreadPool::finish() {
+	if (threads == nullptr) {
+		return;
+	}
+
+	if (groups.size()) {
+		ERR_PRINT("Worker thread pool finished with group tasks that were never waited for.");
+	}
+
+	exit_threads.store(true, std::memory_order_release);
+	_notify_all();
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].thread.wait_to_finish();
+	}
+
+	memdelete_arr(threads);
+	threads = nullptr;
+	thread_count = 0;
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+	singleton = this;
+	exit_threads.store(false);
+	queued_tasks.store(0);
+	submit_rotation.store(0);
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+	finish();
+	singleton = nullptr;
+}
@@ -0,0 +1,207 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+#include "core/os/spin_lock.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/paged_allocator.h"
+
+#include <atomic>
+
+#if !defined(NO_THREADS)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+// Engine-wide task scheduler. Every worker owns a deque of tasks: it pushes and pops
+// its own work from the back (LIFO, cache friendly for nested parallel-for) while idle
+// workers steal from the front of other deques. Work is submitted as groups of
+// elements, which may depend on other groups. Waiting on a group never blocks while
+// there is queued work: the waiting thread runs pending tasks until the group is done.
+
+class WorkerThreadPool {
+public:
+	typedef int64_t GroupID;
+	enum {
+		INVALID_GROUP_ID = -1
+	};
+
+private:
+	struct BaseTemplateUserdata {
+		virtual void callback_indexed(uint32_t p_index) {}
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	template <class C, class M, class U>
+	struct GroupUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback_indexed(uint32_t p_index) override {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+	struct Group {
+		BaseTemplateUserdata *template_userdata = nullptr;
+		void (*native_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+
+		uint32_t max = 0;
+		std::atomic<uint32_t> index;
+		std::atomic<uint32_t> completed_index;
+		std::atomic<uint32_t> finished;
+		std::atomic<bool> completed;
+		uint32_t tasks_used = 0;
+
+		// Guarded by groups_mutex.
+		uint32_t pending_dependencies = 0;
+		LocalVector<Group *> dependents;
+
+		Group() {
+			index.store(0, std::memory_order_relaxed);
+			completed_index.store(0, std::memory_order_relaxed);
+			finished.store(0, std::memory_order_relaxed);
+			completed.store(false, std::memory_order_relaxed);
+		}
+	};
+
+	// Each entry is one "slice" of a group: the thread running it keeps claiming
+	// element indices from the group until none are left.
+	struct TaskDeque {
+		SpinLock lock;
+		Group **ring = nullptr;
+		uint32_t capacity = 0;
+		uint32_t head = 0;
+		uint32_t count = 0;
+
+		void push_back(Group *p_group);
+		Group *pop_back();
+		Group *pop_front();
+		~TaskDeque();
+	};
+
+	struct ThreadData {
+		uint32_t index = 0;
+		Thread thread;
+		TaskDeque deque;
+		WorkerThreadPool *pool = nullptr;
+	};
+
+	ThreadData *threads = nullptr;
+	uint32_t thread_count = 0;
+	std::atomic<bool> exit_threads;
+
+	std::atomic<uint32_t> queued_tasks;
+	std::atomic<uint32_t> submit_rotation;
+
+	BinaryMutex groups_mutex;
+	PagedAllocator<Group, true> group_allocator;
+	HashMap<GroupID, Group *> groups;
+	GroupID last_group_id = 0;
+
+#if !defined(NO_THREADS)
+	std::mutex sleep_mutex;
+	std::condition_variable sleep_cond;
+#endif
+
+	static thread_local ThreadData *current_thread;
+	static WorkerThreadPool *singleton;
+
+	static void _thread_function(void *p_user);
+
+	GroupID _add_group_task(Group *p_group, const GroupID *p_dependencies, uint32_t p_dependency_count);
+	void _push_group_tasks(Group *p_group);
+	void _group_task_done(Group *p_group);
+	Group *_pop_task();
+	void _process_task(Group *p_group);
+	void _notify_all();
+
+public:
+	template <class C, class M, class U>
+	GroupID add_template_group_task(C *p_instance, M p_method, U p_userdata, uint32_t p_elements, const GroupID *p_dependencies = nullptr, uint32_t p_dependency_count = 0) {
+		GroupUserData<C, M, U> *ud = memnew((GroupUserData<C, M, U>));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Group *group = group_allocator.alloc();
+		group->template_userdata = ud;
+		group->max = p_elements;
+		return _add_group_task(group, p_dependencies, p_dependency_count);
+	}
+
+	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, uint32_t p_elements, const GroupID *p_dependencies = nullptr, uint32_t p_dependency_count = 0);
+
+	bool is_group_task_completed(GroupID p_group) const;
+	uint32_t get_group_processed_element_count(GroupID p_group) const;
+	// Runs queued tasks on the calling thread until the group is completed, then frees it.
+	// Every group must be waited for exactly once.
+	void wait_for_group_task_completion(GroupID p_group);
+
+	// Parallel-for: runs p_method(index, p_userdata) for every index in [0, p_elements)
+	// and returns once all of them are done. Can be nested from inside another task.
+	template <class C, class M, class U>
+	void do_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
+		switch (p_elements) {
+			case 0:
+				// Nothing to do, so do nothing.
+				break;
+			case 1:
+				// No value in pushing the work to another thread if it's a single job
+				// and we're going to wait for it to finish. Just run it right here.
+				(p_instance->*p_method)(0, p_userdata);
+				break;
+			default:
+				wait_for_group_task_completion(add_template_group_task(p_instance, p_method, p_userdata, p_elements));
+		}
+	}
+
+	// Never zero, so it can be used to split work in per-thread slices. Without threads
+	// support, all work runs on the calling thread.
+	_FORCE_INLINE_ int get_thread_count() const { return MAX(1u, thread_count); }
+	// Index of the calling worker thread, or -1 if called from outside the pool.
+	static int get_thread_index();
+
+	static WorkerThreadPool *get_singleton() { return singleton; }
+
+	void init(int p_thread_count = -1);
+	void finish();
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+#endif // WORKER_THREAD_POOL_H
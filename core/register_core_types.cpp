@@ -74,6 +74,7 @@
 #include "core/object/undo_redo.h"
 #include "core/os/main_loop.h"
 #include "core/os/time.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/string/optimized_translation.h"
 #include "core/string/translation.h"
 
@@ -108,6 +109,8 @@ extern void unregister_global_constants();
 
 static ResourceUID *resource_uid = nullptr;
 
+static WorkerThreadPool *worker_thread_pool = nullptr;
+
 static bool _is_core_extensions_registered = false;
 
 void register_core_types() {
@@ -116,6 +119,9 @@ void register_core_types() {
 
 	ObjectDB::setup();
 
+	worker_thread_pool = memnew(WorkerThreadPool);
+	worker_thread_pool->init();
+
 	StringName::setup();
 	ResourceLoader::initialize();
 
@@ -382,4 +388,7 @@ void unregister_core_types() {
 	ResourceCache::clear();
 	CoreStringNames::free();
 	StringName::cleanup();
+
+	worker_thread_pool->finish();
+	memdelete(worker_thread_pool);
 }
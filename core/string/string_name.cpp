@@ -33,18 +33,37 @@
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 
+#include <string.h>
+
+#if !defined(NO_THREADS)
+#include <atomic>
+#include <thread>
+#endif
+
 StaticCString StaticCString::create(const char *p_ptr) {
+	return create(p_ptr, String::hash(p_ptr));
+}
+
+StaticCString StaticCString::create(const char *p_ptr, uint32_t p_hash) {
 	StaticCString scs;
 	scs.ptr = p_ptr;
+	scs.hash = p_hash;
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+SafeNumeric<StringName::_Table *> StringName::table;
+uint32_t StringName::table_count = 0;
+StringName::_Data *StringName::retired[RETIRED_MAX];
+uint32_t StringName::retired_count = 0;
 
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
 }
 
+StringName _scs_create(const char *p_chr, uint32_t p_hash, bool p_static) {
+	return (p_chr[0] ? StringName(StaticCString::create(p_chr, p_hash), p_static) : StringName());
+}
+
 bool StringName::configured = false;
 Mutex StringName::mutex;
 
@@ -52,25 +71,81 @@ Mutex StringName::mutex;
 bool StringName::debug_stringname = false;
 #endif
 
+/* Lookups that don't take the mutex announce themselves in one of these counters while walking the table. */
+
+#define READER_SLOTS 64
+
+struct alignas(64) _StringNameReaderSlot {
+	SafeNumeric<uint32_t> count;
+};
+
+static _StringNameReaderSlot reader_slots[READER_SLOTS];
+static SafeNumeric<uint32_t> reader_slot_counter;
+
+static _FORCE_INLINE_ void _full_fence() {
+#if !defined(NO_THREADS)
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+}
+
+class StringNameReadGuard {
+	SafeNumeric<uint32_t> *count;
+
+public:
+	_FORCE_INLINE_ StringNameReadGuard() {
+		static thread_local uint32_t slot = reader_slot_counter.postincrement() % READER_SLOTS;
+		count = &reader_slots[slot].count;
+		count->increment();
+		// Pairs with the fence in _wait_for_readers(), the table must not be read before the counter is visible.
+		_full_fence();
+	}
+
+	_FORCE_INLINE_ ~StringNameReadGuard() {
+		count->decrement();
+	}
+};
+
+void StringName::_wait_for_readers() {
+	// Everything unlinked before this point can only be seen by lookups that are registered now.
+	_full_fence();
+	for (int i = 0; i < READER_SLOTS; i++) {
+		while (reader_slots[i].count.get() != 0) {
+#if !defined(NO_THREADS)
+			std::this_thread::yield();
+#endif
+		}
+	}
+}
+
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+
+	_Table *t = memnew(_Table);
+	t->mask = (1 << STRING_TABLE_MIN_BITS) - 1;
+	t->buckets = memnew_arr(SafeNumeric<_Data *>, t->mask + 1);
+	for (uint32_t i = 0; i <= t->mask; i++) {
+		t->buckets[i].set(nullptr);
 	}
+	table.set(t);
+	table_count = 0;
+	retired_count = 0;
+
 	configured = true;
 }
 
 void StringName::cleanup() {
 	MutexLock lock(mutex);
 
+	_Table *t = table.get();
+
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
-		for (int i = 0; i < STRING_TABLE_LEN; i++) {
-			_Data *d = _table[i];
+		for (uint32_t i = 0; i <= t->mask; i++) {
+			_Data *d = t->buckets[i].get();
 			while (d) {
 				data.push_back(d);
-				d = d->next;
+				d = d->next.get();
 			}
 		}
 
@@ -80,10 +155,10 @@ void StringName::cleanup() {
 		int unreferenced_stringnames = 0;
 		int rarely_referenced_stringnames = 0;
 		for (int i = 0; i < data.size(); i++) {
-			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references));
-			if (data[i]->debug_references == 0) {
+			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references.get()));
+			if (data[i]->debug_references.get() == 0) {
 				unreferenced_stringnames += 1;
-			} else if (data[i]->debug_references < 5) {
+			} else if (data[i]->debug_references.get() < 5) {
 				rarely_referenced_stringnames += 1;
 			}
 		}
@@ -93,9 +168,9 @@ void StringName::cleanup() {
 	}
 #endif
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
+	for (uint32_t i = 0; i <= t->mask; i++) {
+		while (t->buckets[i].get()) {
+			_Data *d = t->buckets[i].get();
 			if (d->static_count.get() != d->refcount.get()) {
 				lost_strings++;
 
@@ -108,16 +183,142 @@ void StringName::cleanup() {
 				}
 			}
 
-			_table[i] = _table[i]->next;
+			t->buckets[i].set(d->next.get());
 			memdelete(d);
 		}
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
+
+	_wait_for_readers();
+	for (uint32_t i = 0; i < retired_count; i++) {
+		memdelete(retired[i]);
+	}
+	retired_count = 0;
+
+	memdelete_arr(t->buckets);
+	memdelete(t);
+	table.set(nullptr);
+	table_count = 0;
+
 	configured = false;
 }
 
+StringName::_Data *StringName::_lookup(uint32_t p_hash, const char *p_name) {
+	const _Table *t = table.get();
+	_Data *d = t->buckets[p_hash & t->mask].get();
+	while (d) {
+		// compare hash first
+		if (d->hash == p_hash && (d->cname ? strcmp(d->cname, p_name) == 0 : d->name == p_name)) {
+			return d;
+		}
+		d = d->next.get();
+	}
+	return nullptr;
+}
+
+StringName::_Data *StringName::_lookup(uint32_t p_hash, const String &p_name) {
+	const _Table *t = table.get();
+	_Data *d = t->buckets[p_hash & t->mask].get();
+	while (d) {
+		// compare hash first
+		if (d->hash == p_hash && (d->cname ? p_name == d->cname : d->name == p_name)) {
+			return d;
+		}
+		d = d->next.get();
+	}
+	return nullptr;
+}
+
+bool StringName::_try_ref(_Data *p_data, bool p_static) {
+	// A failed ref means the entry is being removed, a new one has to be created.
+	if (!p_data || !p_data->refcount.ref()) {
+		return false;
+	}
+	if (p_static) {
+		p_data->static_count.increment();
+	}
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		p_data->debug_references.increment();
+	}
+#endif
+	return true;
+}
+
+StringName::_Data *StringName::_insert(uint32_t p_hash, const char *p_cname, const String &p_name, bool p_static) {
+	// Must be called with the mutex held.
+	if (table_count > table.get()->mask) {
+		_grow_table();
+	}
+
+	_Data *data = memnew(_Data);
+	data->name = p_name;
+	data->refcount.init();
+	data->static_count.set(p_static ? 1 : 0);
+	data->hash = p_hash;
+	data->cname = p_cname;
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		// Keep in memory, force static.
+		data->refcount.ref();
+		data->static_count.increment();
+	}
+#endif
+
+	// Fully construct before publishing, lookups may see it as soon as the bucket is set.
+	SafeNumeric<_Data *> &bucket = table.get()->buckets[p_hash & table.get()->mask];
+	data->next.set(bucket.get());
+	bucket.set(data);
+	table_count++;
+
+	return data;
+}
+
+void StringName::_grow_table() {
+	_Table *old_table = table.get();
+
+	_Table *t = memnew(_Table);
+	t->mask = (old_table->mask << 1) | 1;
+	t->buckets = memnew_arr(SafeNumeric<_Data *>, t->mask + 1);
+	for (uint32_t i = 0; i <= t->mask; i++) {
+		t->buckets[i].set(nullptr);
+	}
+
+	// Lookups still walking the old buckets may end up in a different chain and miss,
+	// but never loop or read freed memory. A miss always falls back to a locked lookup.
+	for (uint32_t i = 0; i <= old_table->mask; i++) {
+		_Data *d = old_table->buckets[i].get();
+		while (d) {
+			_Data *next = d->next.get();
+			SafeNumeric<_Data *> &bucket = t->buckets[d->hash & t->mask];
+			d->next.set(bucket.get());
+			bucket.set(d);
+			d = next;
+		}
+	}
+
+	table.set(t);
+	_wait_for_readers();
+
+	memdelete_arr(old_table->buckets);
+	memdelete(old_table);
+}
+
+void StringName::_retire(_Data *p_data) {
+	retired[retired_count++] = p_data;
+	if (retired_count < RETIRED_MAX) {
+		return;
+	}
+
+	_wait_for_readers();
+	for (uint32_t i = 0; i < retired_count; i++) {
+		memdelete(retired[i]);
+	}
+	retired_count = 0;
+}
+
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
@@ -131,19 +332,21 @@ void StringName::unref() {
 				ERR_PRINT("BUG: Unreferenced static string to 0: " + String(_data->name));
 			}
 		}
-		if (_data->prev) {
-			_data->prev->next = _data->next;
-		} else {
-			if (_table[_data->idx] != _data) {
-				ERR_PRINT("BUG!");
-			}
-			_table[_data->idx] = _data->next;
+
+		_Table *t = table.get();
+		SafeNumeric<_Data *> *link = &t->buckets[_data->hash & t->mask];
+		while (link->get() && link->get() != _data) {
+			link = &link->get()->next;
 		}
 
-		if (_data->next) {
-			_data->next->prev = _data->prev;
+		if (link->get()) {
+			// Lookups already standing on it can still move on to the next one.
+			link->set(_data->next.get());
+			table_count--;
+			_retire(_data);
+		} else {
+			ERR_PRINT("BUG!");
 		}
-		memdelete(_data);
 	}
 
 	_data = nullptr;
@@ -206,58 +409,26 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
+	const uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
+	{
+		StringNameReadGuard guard;
+		_Data *data = _lookup(hash, p_name);
+		if (_try_ref(data, p_static)) {
+			_data = data;
+			return;
 		}
-		_data = _data->next;
 	}
 
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-		}
+	MutexLock lock(mutex);
 
+	_Data *data = _lookup(hash, p_name);
+	if (_try_ref(data, p_static)) {
+		_data = data;
 		return;
 	}
 
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _insert(hash, nullptr, p_name, p_static);
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -267,57 +438,24 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
+	{
+		StringNameReadGuard guard;
+		_Data *data = _lookup(p_static_string.hash, p_static_string.ptr);
+		if (_try_ref(data, p_static)) {
+			_data = data;
 			return;
 		}
 	}
 
-	_data = memnew(_Data);
+	MutexLock lock(mutex);
 
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	_Data *data = _lookup(p_static_string.hash, p_static_string.ptr);
+	if (_try_ref(data, p_static)) {
+		_data = data;
+		return;
 	}
-	_table[idx] = _data;
+
+	_data = _insert(p_static_string.hash, p_static_string.ptr, String(), p_static);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -329,56 +467,26 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
+	const uint32_t hash = p_name.hash();
 
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
+	{
+		StringNameReadGuard guard;
+		_Data *data = _lookup(hash, p_name);
+		if (_try_ref(data, p_static)) {
+			_data = data;
 			return;
 		}
 	}
 
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
+	MutexLock lock(mutex);
 
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	_Data *data = _lookup(hash, p_name);
+	if (_try_ref(data, p_static)) {
+		_data = data;
+		return;
 	}
-	_table[idx] = _data;
+
+	_data = _insert(hash, nullptr, p_name, p_static);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -389,29 +497,22 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	const uint32_t hash = String::hash(p_name);
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
+	{
+		StringNameReadGuard guard;
+		_Data *data = _lookup(hash, p_name);
+		if (_try_ref(data, false)) {
+			return StringName(data);
 		}
-		_data = _data->next;
 	}
 
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
+	// The unlocked lookup can miss while the table grows, so only a locked miss is final.
+	MutexLock lock(mutex);
 
-		return StringName(_data);
+	_Data *data = _lookup(hash, p_name);
+	if (_try_ref(data, false)) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -425,55 +526,30 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
-	}
-
-	return StringName(); //does not exist
+	return search(String(p_name));
 }
 
 StringName StringName::search(const String &p_name) {
-	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
-
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
+	ERR_FAIL_COND_V(!configured, StringName());
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	_Data *_data = _table[idx];
+	const uint32_t hash = p_name.hash();
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
+	{
+		StringNameReadGuard guard;
+		_Data *data = _lookup(hash, p_name);
+		if (_try_ref(data, false)) {
+			return StringName(data);
 		}
-		_data = _data->next;
 	}
 
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return StringName(_data);
+	// The unlocked lookup can miss while the table grows, so only a locked miss is final.
+	MutexLock lock(mutex);
+
+	_Data *data = _lookup(hash, p_name);
+	if (_try_ref(data, false)) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -39,14 +39,24 @@ class Main;
 
 struct StaticCString {
 	const char *ptr;
+	uint32_t hash;
 	static StaticCString create(const char *p_ptr);
+	static StaticCString create(const char *p_ptr, uint32_t p_hash);
+
+	// Same as String::hash(const char *), usable in constant expressions.
+	static constexpr uint32_t hash_static(const char *p_ptr) {
+		uint32_t hashv = 5381;
+		for (; *p_ptr; p_ptr++) {
+			hashv = ((hashv << 5) + hashv) + uint32_t(*p_ptr); /* hash * 33 + c */
+		}
+		return hashv;
+	}
 };
 
 class StringName {
 	enum {
-		STRING_TABLE_BITS = 16,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MIN_BITS = 12,
+		RETIRED_MAX = 64,
 	};
 
 	struct _Data {
@@ -55,17 +65,26 @@ class StringName {
 		const char *cname = nullptr;
 		String name;
 #ifdef DEBUG_ENABLED
-		uint32_t debug_references = 0;
+		SafeNumeric<uint32_t> debug_references;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx = 0;
 		uint32_t hash = 0;
-		_Data *prev = nullptr;
-		_Data *next = nullptr;
-		_Data() {}
+		// Only written with the mutex held, but read by lookups that don't take it.
+		SafeNumeric<_Data *> next;
+		_Data() { next.set(nullptr); }
+	};
+
+	// Buckets are read without locking. Nodes and bucket arrays that get
+	// unlinked are only freed once no lookup can still be walking them.
+	struct _Table {
+		uint32_t mask = 0;
+		SafeNumeric<_Data *> *buckets = nullptr;
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	static SafeNumeric<_Table *> table;
+	static uint32_t table_count;
+	static _Data *retired[RETIRED_MAX];
+	static uint32_t retired_count;
 
 	_Data *_data = nullptr;
 
@@ -75,6 +94,13 @@ class StringName {
 	};
 
 	void unref();
+	static _Data *_lookup(uint32_t p_hash, const char *p_name);
+	static _Data *_lookup(uint32_t p_hash, const String &p_name);
+	static bool _try_ref(_Data *p_data, bool p_static);
+	static _Data *_insert(uint32_t p_hash, const char *p_cname, const String &p_name, bool p_static);
+	static void _retire(_Data *p_data);
+	static void _grow_table();
+	static void _wait_for_readers();
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
@@ -85,7 +111,7 @@ class StringName {
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
 		bool operator()(const _Data *p_left, const _Data *p_right) const {
-			return p_left->debug_references > p_right->debug_references;
+			return p_left->debug_references.get() > p_right->debug_references.get();
 		}
 	};
 
@@ -180,6 +206,7 @@ bool operator==(const char *p_name, const StringName &p_string_name);
 bool operator!=(const char *p_name, const StringName &p_string_name);
 
 StringName _scs_create(const char *p_chr, bool p_static = false);
+StringName _scs_create(const char *p_chr, uint32_t p_hash, bool p_static);
 
 /*
  * The SNAME macro is used to speed up StringName creation, as it allows caching it after the first usage in a very efficient way.
@@ -193,6 +220,6 @@ StringName _scs_create(const char *p_chr, bool p_static = false);
  * Use in places that can be called hundreds of times per frame (or more) is recommended, but this situation is very rare. If in doubt, do not use.
  */
 
-#define SNAME(m_arg) ([]() -> const StringName & { static StringName sname = _scs_create(m_arg, true); return sname; })()
+#define SNAME(m_arg) ([]() -> const StringName & { static StringName sname = _scs_create(m_arg, StaticCString::hash_static(m_arg), true); return sname; })()
 
 #endif // STRING_NAME_H
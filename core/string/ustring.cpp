@@ -42,8 +42,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <cstdint>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USTRING_SSE2
+#endif
+
 #ifdef _MSC_VER
 #define _CRT_SECURE_NO_WARNINGS // to disable build-time warning which suggested to use strcpy_s instead strcpy
 #endif
@@ -58,6 +64,172 @@ static _FORCE_INLINE_ char32_t lower_case(char32_t c) {
 	return (is_ascii_upper_case(c) ? (c + ('a' - 'A')) : c);
 }
 
+/* ASCII fast paths, most text going through files, JSON and the network is plain ASCII. */
+
+// Number of leading bytes below 0x80.
+static int _utf8_ascii_prefix(const uint8_t *p_str, int p_len) {
+	int i = 0;
+#ifdef USTRING_SSE2
+	for (; i + 16 <= p_len; i += 16) {
+		if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_str + i)))) {
+			break;
+		}
+	}
+#else
+	for (; i + 8 <= p_len; i += 8) {
+		uint64_t word;
+		memcpy(&word, p_str + i, sizeof(word));
+		if (word & 0x8080808080808080ULL) {
+			break;
+		}
+	}
+#endif
+	while (i < p_len && p_str[i] < 0x80) {
+		i++;
+	}
+	return i;
+}
+
+// Number of leading characters below 0x80.
+static int _utf32_ascii_prefix(const char32_t *p_str, int p_len) {
+	int i = 0;
+#ifdef USTRING_SSE2
+	const __m128i high_bits = _mm_set1_epi32(~0x7f);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 4 <= p_len; i += 4) {
+		const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_str + i));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(chars, high_bits), zero)) != 0xffff) {
+			break;
+		}
+	}
+#endif
+	while (i < p_len && p_str[i] < 0x80) {
+		i++;
+	}
+	return i;
+}
+
+static void _widen_ascii(char32_t *r_dst, const uint8_t *p_src, int p_len) {
+	int i = 0;
+#ifdef USTRING_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_src + i));
+		const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+		const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(r_dst + i), _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(r_dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(r_dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(r_dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+	}
+#endif
+	for (; i < p_len; i++) {
+		r_dst[i] = p_src[i];
+	}
+}
+
+// Only valid when every character is below 0x80.
+static void _narrow_ascii(uint8_t *r_dst, const char32_t *p_src, int p_len) {
+	int i = 0;
+#ifdef USTRING_SSE2
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i *src = reinterpret_cast<const __m128i *>(p_src + i);
+		const __m128i lo = _mm_packs_epi32(_mm_loadu_si128(src), _mm_loadu_si128(src + 1));
+		const __m128i hi = _mm_packs_epi32(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(r_dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < p_len; i++) {
+		r_dst[i] = uint8_t(p_src[i]);
+	}
+}
+
+// Index of p_char in [p_from, p_to), or -1.
+static _FORCE_INLINE_ int _find_char32(const char32_t *p_str, int p_from, int p_to, char32_t p_char) {
+	int i = p_from;
+#ifdef USTRING_SSE2
+	const __m128i needle = _mm_set1_epi32(int(p_char));
+	for (; i + 4 <= p_to; i += 4) {
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_str + i)), needle))) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_to; i++) {
+		if (p_str[i] == p_char) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+template <bool p_to_lower>
+static _FORCE_INLINE_ char32_t _convert_case(char32_t p_char) {
+	if (p_char < 0x80) {
+		if (p_to_lower) {
+			return is_ascii_upper_case(p_char) ? p_char + ('a' - 'A') : p_char;
+		} else {
+			return is_ascii_lower_case(p_char) ? p_char - ('a' - 'A') : p_char;
+		}
+	}
+	return p_to_lower ? _find_lower(p_char) : _find_upper(p_char);
+}
+
+// Converts p_str in place from p_from on, returns the index of the first character changed, or p_len if none.
+// With p_write false nothing is written, which finds out whether a copy is needed at all.
+template <bool p_to_lower, bool p_write>
+static int _convert_case_range(char32_t *p_str, int p_from, int p_len) {
+	const char32_t range_begin = p_to_lower ? 'A' : 'a';
+	const char32_t range_end = p_to_lower ? 'Z' : 'z';
+	int first_changed = p_len;
+	int i = p_from;
+#ifdef USTRING_SSE2
+	const __m128i high_bits = _mm_set1_epi32(~0x7f);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i below = _mm_set1_epi32(int(range_begin) - 1);
+	const __m128i above = _mm_set1_epi32(int(range_end) + 1);
+	const __m128i delta = _mm_set1_epi32(p_to_lower ? ('a' - 'A') : ('A' - 'a'));
+	for (; i + 4 <= p_len; i += 4) {
+		__m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_str + i));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(chars, high_bits), zero)) != 0xffff) {
+			// Not all ASCII, do these four one by one.
+			for (int j = i; j < i + 4; j++) {
+				const char32_t c = _convert_case<p_to_lower>(p_str[j]);
+				if (c != p_str[j]) {
+					if (!p_write) {
+						return j;
+					}
+					first_changed = MIN(first_changed, j);
+					p_str[j] = c;
+				}
+			}
+			continue;
+		}
+		const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi32(chars, below), _mm_cmplt_epi32(chars, above));
+		if (!_mm_movemask_epi8(in_range)) {
+			continue;
+		}
+		if (!p_write) {
+			break;
+		}
+		first_changed = MIN(first_changed, i);
+		chars = _mm_add_epi32(chars, _mm_and_si128(in_range, delta));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(p_str + i), chars);
+	}
+#endif
+	for (; i < p_len; i++) {
+		const char32_t c = _convert_case<p_to_lower>(p_str[i]);
+		if (c != p_str[i]) {
+			if (!p_write) {
+				return i;
+			}
+			first_changed = MIN(first_changed, i);
+			p_str[i] = c;
+		}
+	}
+	return first_changed;
+}
+
 const char CharString::_null = 0;
 const char16_t Char16String::_null = 0;
 const char32_t String::_null = 0;
@@ -1320,30 +1492,28 @@ char32_t String::char_lowercase(char32_t p_char) {
 }
 
 String String::to_upper() const {
-	String upper = *this;
-
-	for (int i = 0; i < upper.size(); i++) {
-		const char32_t s = upper[i];
-		const char32_t t = _find_upper(s);
-		if (s != t) { // avoid copy on write
-			upper[i] = t;
-		}
+	const int len = length();
+	// Only copy if something changes.
+	const int first = _convert_case_range<false, false>(const_cast<char32_t *>(get_data()), 0, len);
+	if (first == len) {
+		return *this;
 	}
 
+	String upper = *this;
+	_convert_case_range<false, true>(upper.ptrw(), first, len);
 	return upper;
 }
 
 String String::to_lower() const {
-	String lower = *this;
-
-	for (int i = 0; i < lower.size(); i++) {
-		const char32_t s = lower[i];
-		const char32_t t = _find_lower(s);
-		if (s != t) { // avoid copy on write
-			lower[i] = t;
-		}
+	const int len = length();
+	// Only copy if something changes.
+	const int first = _convert_case_range<true, false>(const_cast<char32_t *>(get_data()), 0, len);
+	if (first == len) {
+		return *this;
 	}
 
+	String lower = *this;
+	_convert_case_range<true, true>(lower.ptrw(), first, len);
 	return lower;
 }
 
@@ -1634,9 +1804,34 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 		}
 	}
 
+	// Parsing stops at the first zero byte, like the scan below always did.
+	int byte_len;
+	if (p_len < 0) {
+		byte_len = strlen(p_utf8);
+	} else {
+		const char *terminator = (const char *)memchr(p_utf8, 0, p_len);
+		byte_len = terminator ? terminator - p_utf8 : p_len;
+	}
+
+	const int ascii_len = _utf8_ascii_prefix((const uint8_t *)p_utf8, byte_len);
+	if (ascii_len == byte_len) {
+		if (byte_len == 0) {
+			clear();
+			return false;
+		}
+		resize(byte_len + 1);
+		char32_t *dst = ptrw();
+		_widen_ascii(dst, (const uint8_t *)p_utf8, byte_len);
+		dst[byte_len] = 0;
+		return false;
+	}
+
+	cstr_size = ascii_len;
+	str_size = ascii_len;
+
 	{
-		const char *ptrtmp = p_utf8;
-		const char *ptrtmp_limit = &p_utf8[p_len];
+		const char *ptrtmp = p_utf8 + ascii_len;
+		const char *ptrtmp_limit = &p_utf8[byte_len];
 		int skip = 0;
 		while (ptrtmp != ptrtmp_limit && *ptrtmp) {
 			if (skip == 0) {
@@ -1686,6 +1881,11 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 	char32_t *dst = ptrw();
 	dst[str_size] = 0;
 
+	_widen_ascii(dst, (const uint8_t *)p_utf8, ascii_len);
+	dst += ascii_len;
+	p_utf8 += ascii_len;
+	cstr_size -= ascii_len;
+
 	while (cstr_size) {
 		int len = 0;
 
@@ -1755,8 +1955,18 @@ CharString String::utf8() const {
 	}
 
 	const char32_t *d = &operator[](0);
-	int fl = 0;
-	for (int i = 0; i < l; i++) {
+	const int ascii_len = _utf32_ascii_prefix(d, l);
+	if (ascii_len == l) {
+		CharString utf8s;
+		utf8s.resize(l + 1);
+		uint8_t *cdst = (uint8_t *)utf8s.ptrw();
+		_narrow_ascii(cdst, d, l);
+		cdst[l] = 0;
+		return utf8s;
+	}
+
+	int fl = ascii_len;
+	for (int i = ascii_len; i < l; i++) {
 		uint32_t c = d[i];
 		if (c <= 0x7f) { // 7 bits.
 			fl += 1;
@@ -1784,9 +1994,12 @@ CharString String::utf8() const {
 	utf8s.resize(fl + 1);
 	uint8_t *cdst = (uint8_t *)utf8s.get_data();
 
+	_narrow_ascii(cdst, d, ascii_len);
+	cdst += ascii_len;
+
 #define APPEND_CHAR(m_c) *(cdst++) = m_c
 
-	for (int i = 0; i < l; i++) {
+	for (int i = ascii_len; i < l; i++) {
 		uint32_t c = d[i];
 
 		if (c <= 0x7f) { // 7 bits.
@@ -2713,26 +2926,19 @@ int String::find(const String &p_str, int p_from) const {
 
 	const char32_t *src = get_data();
 	const char32_t *str = p_str.get_data();
+	const int last = len - src_len;
 
-	for (int i = p_from; i <= (len - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= len) {
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			}
-
-			if (src[read_pos] != str[j]) {
-				found = false;
-				break;
-			}
+	// Jump between occurrences of the first character, then compare the rest.
+	int i = p_from;
+	while (i <= last) {
+		i = _find_char32(src, i, last + 1, str[0]);
+		if (i < 0) {
+			return -1;
 		}
-
-		if (found) {
+		if (memcmp(src + i + 1, str + 1, (src_len - 1) * sizeof(char32_t)) == 0) {
 			return i;
 		}
+		i++;
 	}
 
 	return -1;
@@ -2756,36 +2962,30 @@ int String::find(const char *p_str, int p_from) const {
 		src_len++;
 	}
 
-	if (src_len == 1) {
-		const char32_t needle = p_str[0];
-
-		for (int i = p_from; i < len; i++) {
-			if (src[i] == needle) {
-				return i;
-			}
-		}
-
-	} else {
-		for (int i = p_from; i <= (len - src_len); i++) {
-			bool found = true;
-			for (int j = 0; j < src_len; j++) {
-				int read_pos = i + j;
-
-				if (read_pos >= len) {
-					ERR_PRINT("read_pos>=len");
-					return -1;
-				}
+	if (src_len == 0) {
+		return p_from <= len ? p_from : -1;
+	}
 
-				if (src[read_pos] != (char32_t)p_str[j]) {
-					found = false;
-					break;
-				}
-			}
+	const char32_t first = (char32_t)p_str[0];
+	const int last = len - src_len;
 
-			if (found) {
-				return i;
+	int i = p_from;
+	while (i <= last) {
+		i = _find_char32(src, i, last + 1, first);
+		if (i < 0) {
+			return -1;
+		}
+		bool found = true;
+		for (int j = 1; j < src_len; j++) {
+			if (src[i + j] != (char32_t)p_str[j]) {
+				found = false;
+				break;
 			}
 		}
+		if (found) {
+			return i;
+		}
+		i++;
 	}
 
 	return -1;
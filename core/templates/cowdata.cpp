@@ -1,5 +1,5 @@
 /*************************************************************************/
-/*  renderer_thread_pool.cpp                                             */
+/*  cowdata.cpp                                                          */
 /*************************************************************************/
 /*                       This file is part of:                           */
 /*                           GODOT ENGINE                                */
@@ -28,15 +28,8 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 
-#include "renderer_thread_pool.h"
+#include "cowdata.h"
 
-RendererThreadPool *RendererThreadPool::singleton = nullptr;
-
-RendererThreadPool::RendererThreadPool() {
-	singleton = this;
-	thread_work_pool.init();
-}
-
-RendererThreadPool::~RendererThreadPool() {
-	thread_work_pool.finish();
-}
+#ifdef DEBUG_ENABLED
+SafeNumeric<uint64_t> CowDataStats::copies;
+#endif
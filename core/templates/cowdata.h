@@ -55,6 +55,19 @@ SAFE_NUMERIC_TYPE_PUN_GUARANTEES(uint32_t)
 #pragma GCC diagnostic ignored "-Wplacement-new"
 #endif
 
+#ifdef DEBUG_ENABLED
+// Counts buffers duplicated by copy-on-write, so tests can catch accidental copies of shared data.
+class CowDataStats {
+	template <class T>
+	friend class CowData;
+
+	static SafeNumeric<uint64_t> copies;
+
+public:
+	static uint64_t get_copy_count() { return copies.get(); }
+};
+#endif
+
 template <class T>
 class CowData {
 	template <class TV>
@@ -257,6 +270,9 @@ uint32_t CowData<T>::_copy_on_write() {
 		_ptr = _data;
 
 		rc = 1;
+#ifdef DEBUG_ENABLED
+		CowDataStats::copies.increment();
+#endif
 	}
 	return rc;
 }
@@ -1,5 +1,5 @@
 /*************************************************************************/
-/*  renderer_thread_pool.h                                               */
+/*  span.h                                                               */
 /*************************************************************************/
 /*                       This file is part of:                           */
 /*                           GODOT ENGINE                                */
@@ -28,18 +28,37 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 
-#ifndef RENDERERTHREADPOOL_H
-#define RENDERERTHREADPOOL_H
+#ifndef SPAN_H
+#define SPAN_H
 
-#include "core/templates/thread_work_pool.h"
+#include "core/error/error_macros.h"
+#include "core/typedefs.h"
+
+// Read-only view over contiguous memory owned by someone else, typically a Vector.
+// It neither owns nor reference counts the data, so it must not outlive its source.
+// Binding a method argument as Span<T> lets packed arrays reach native code without
+// touching the shared reference count.
+template <class T>
+class Span {
+	const T *_ptr = nullptr;
+	int _len = 0;
 
-class RendererThreadPool {
 public:
-	ThreadWorkPool thread_work_pool;
+	_FORCE_INLINE_ const T *ptr() const { return _ptr; }
+	_FORCE_INLINE_ int size() const { return _len; }
+	_FORCE_INLINE_ bool is_empty() const { return _len == 0; }
+
+	_FORCE_INLINE_ const T &operator[](int p_index) const {
+		CRASH_BAD_INDEX(p_index, _len);
+		return _ptr[p_index];
+	}
+
+	_FORCE_INLINE_ const T *begin() const { return _ptr; }
+	_FORCE_INLINE_ const T *end() const { return _ptr + _len; }
 
-	static RendererThreadPool *singleton;
-	RendererThreadPool();
-	~RendererThreadPool();
+	_FORCE_INLINE_ Span() {}
+	_FORCE_INLINE_ Span(const T *p_ptr, int p_len) :
+			_ptr(p_ptr), _len(p_len) {}
 };
 
-#endif // RENDERERTHREADPOOL_H
+#endif // SPAN_H
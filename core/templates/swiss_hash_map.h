@@ -0,0 +1,584 @@
+/*************************************************************************/
+/*  swiss_hash_map.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SWISS_HASH_MAP_H
+#define SWISS_HASH_MAP_H
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/list.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWISS_HASH_MAP_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SWISS_HASH_MAP_NEON
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/**
+ * @class SwissHashMap
+ *
+ * Open addressing hash map in the style of Swiss tables. Every slot has a one
+ * byte control entry (empty, deleted, or the low 7 bits of the hash), and lookups
+ * compare 16 control bytes at a time with SSE2 or NEON (a scalar fallback is used
+ * elsewhere), so only slots whose control byte matches are ever dereferenced.
+ *
+ * Keys and values are stored inline next to the control bytes, so a hit costs
+ * one control group load plus the slot itself, and a miss usually touches only
+ * the control bytes.
+ *
+ * The API mirrors HashMap, so it can be used as a drop-in replacement, with one
+ * difference: elements move when the table grows. Pointers returned by getptr(),
+ * operator[] and set() are invalidated by any insertion, like with OAHashMap.
+ * Only use it where such pointers are not held across insertions.
+ *
+ * The OAHashMap style lookup() and iter()/next_iter() are provided as well, the
+ * latter being the fastest way to walk the map.
+ */
+
+template <class TKey, class TData, class Hasher = HashMapHasherDefault, class Comparator = HashMapComparatorDefault<TKey>>
+class SwissHashMap {
+public:
+	struct Pair {
+		TKey key;
+		TData data;
+
+		Pair() {}
+		Pair(const TKey &p_key, const TData &p_data) :
+				key(p_key),
+				data(p_data) {
+		}
+	};
+
+	struct Element {
+	private:
+		friend class SwissHashMap;
+
+		Pair pair;
+
+	public:
+		const TKey &key() const {
+			return pair.key;
+		}
+
+		TData &value() {
+			return pair.data;
+		}
+
+		const TData &value() const {
+			return pair.data;
+		}
+
+		Element(const TKey &p_key, const TData &p_data) :
+				pair(p_key, p_data) {
+		}
+	};
+
+	struct Iterator {
+		bool valid = false;
+
+		const TKey *key = nullptr;
+		TData *value = nullptr;
+
+	private:
+		uint32_t pos = 0;
+		friend class SwissHashMap;
+	};
+
+private:
+	static const int8_t CTRL_EMPTY = -128;
+	static const int8_t CTRL_DELETED = -2;
+	static const uint32_t GROUP_WIDTH = 16;
+	static const uint32_t NOT_FOUND = 0xFFFFFFFF;
+
+	int8_t *ctrl = nullptr;
+	Element *slots = nullptr; // Only constructed where the control byte is full.
+	uint32_t capacity = 0; // Zero, or a power of two no smaller than GROUP_WIDTH.
+	uint32_t num_elements = 0;
+	uint32_t growth_left = 0; // Empty slots that can be claimed before rehashing.
+
+	/* Group probing, one bit (or nibble on NEON) per control byte. */
+
+#if defined(SWISS_HASH_MAP_SSE2)
+	static const uint32_t LANE_SHIFT = 0;
+
+	static _FORCE_INLINE_ uint64_t _group_match(const int8_t *p_group, int8_t p_h2) {
+		const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_group));
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(p_h2)));
+	}
+
+	static _FORCE_INLINE_ uint64_t _group_match_free(const int8_t *p_group) {
+		// Empty and deleted are the only control bytes with the sign bit set.
+		return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_group)));
+	}
+#elif defined(SWISS_HASH_MAP_NEON)
+	static const uint32_t LANE_SHIFT = 2;
+
+	static _FORCE_INLINE_ uint64_t _neon_mask(uint8x16_t p_cmp) {
+		// Narrow every byte to a nibble, then keep one bit per nibble so masks can be iterated bit by bit.
+		const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(p_cmp), 4);
+		return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL;
+	}
+
+	static _FORCE_INLINE_ uint64_t _group_match(const int8_t *p_group, int8_t p_h2) {
+		return _neon_mask(vceqq_s8(vld1q_s8(p_group), vdupq_n_s8(p_h2)));
+	}
+
+	static _FORCE_INLINE_ uint64_t _group_match_free(const int8_t *p_group) {
+		return _neon_mask(vcltq_s8(vld1q_s8(p_group), vdupq_n_s8(0)));
+	}
+#else
+	// Portable SWAR fallback, two 8 byte words per group.
+	static const uint32_t LANE_SHIFT = 0;
+	static const uint64_t LSB_BYTES = 0x0101010101010101ULL;
+	static const uint64_t MSB_BYTES = 0x8080808080808080ULL;
+
+	static _FORCE_INLINE_ uint64_t _swar_to_mask(uint64_t p_lo, uint64_t p_hi) {
+		// Gather the top bit of each byte into consecutive bits.
+		const uint64_t lo = ((p_lo >> 7) * 0x0102040810204080ULL) >> 56;
+		const uint64_t hi = ((p_hi >> 7) * 0x0102040810204080ULL) >> 56;
+		return lo | (hi << 8);
+	}
+
+	static _FORCE_INLINE_ uint64_t _group_match(const int8_t *p_group, int8_t p_h2) {
+		uint64_t words[2];
+		memcpy(words, p_group, sizeof(words));
+		const uint64_t pattern = LSB_BYTES * uint8_t(p_h2);
+		const uint64_t lo = words[0] ^ pattern;
+		const uint64_t hi = words[1] ^ pattern;
+		// May report false positives next to a real match. Those are full slots (h2 ^ 1), and keys are always compared.
+		return _swar_to_mask((lo - LSB_BYTES) & ~lo & MSB_BYTES, (hi - LSB_BYTES) & ~hi & MSB_BYTES);
+	}
+
+	static _FORCE_INLINE_ uint64_t _group_match_free(const int8_t *p_group) {
+		uint64_t words[2];
+		memcpy(words, p_group, sizeof(words));
+		return _swar_to_mask(words[0] & MSB_BYTES, words[1] & MSB_BYTES);
+	}
+
+	static _FORCE_INLINE_ uint64_t _group_match_empty(const int8_t *p_group) {
+		// Empty is the only control byte with the sign bit set and bit 1 clear, this must be exact.
+		uint64_t words[2];
+		memcpy(words, p_group, sizeof(words));
+		return _swar_to_mask(words[0] & ~(words[0] << 6) & MSB_BYTES, words[1] & ~(words[1] << 6) & MSB_BYTES);
+	}
+#endif
+
+#if defined(SWISS_HASH_MAP_SSE2) || defined(SWISS_HASH_MAP_NEON)
+	static _FORCE_INLINE_ uint64_t _group_match_empty(const int8_t *p_group) {
+		return _group_match(p_group, CTRL_EMPTY);
+	}
+#endif
+
+	static _FORCE_INLINE_ uint32_t _lowest_lane(uint64_t p_mask) {
+#if defined(__GNUC__) || defined(__clang__)
+		return uint32_t(__builtin_ctzll(p_mask)) >> LANE_SHIFT;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index;
+		_BitScanForward64(&index, p_mask);
+		return uint32_t(index) >> LANE_SHIFT;
+#else
+		uint32_t index = 0;
+		while (!(p_mask & 1)) {
+			p_mask >>= 1;
+			index++;
+		}
+		return index >> LANE_SHIFT;
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t _mix_hash(uint32_t p_hash) {
+		// Integer hashers are the identity, so mix before splitting into group index and control byte.
+		p_hash ^= p_hash >> 16;
+		p_hash *= 0x85ebca6b;
+		p_hash ^= p_hash >> 13;
+		p_hash *= 0xc2b2ae35;
+		p_hash ^= p_hash >> 16;
+		return p_hash;
+	}
+
+	static _FORCE_INLINE_ uint32_t _max_load(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8;
+	}
+
+	template <class K>
+	_FORCE_INLINE_ uint32_t _find_slot(const K &p_key, uint32_t p_hash) const {
+		if (unlikely(!capacity)) {
+			return NOT_FOUND;
+		}
+
+		const uint32_t group_mask = capacity / GROUP_WIDTH - 1;
+		const int8_t h2 = int8_t(p_hash & 0x7F);
+		uint32_t group = (p_hash >> 7) & group_mask;
+
+		for (uint32_t step = 1;; step++) {
+			const int8_t *group_ctrl = ctrl + group * GROUP_WIDTH;
+			uint64_t mask = _group_match(group_ctrl, h2);
+			while (mask) {
+				const uint32_t slot = group * GROUP_WIDTH + _lowest_lane(mask);
+				if (Comparator::compare(slots[slot].pair.key, p_key)) {
+					return slot;
+				}
+				mask &= mask - 1;
+			}
+			if (likely(_group_match_empty(group_ctrl))) {
+				return NOT_FOUND;
+			}
+			// Triangular probing visits every group when the group count is a power of two.
+			group = (group + step) & group_mask;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t _find_free_slot(uint32_t p_hash) const {
+		const uint32_t group_mask = capacity / GROUP_WIDTH - 1;
+		uint32_t group = (p_hash >> 7) & group_mask;
+
+		for (uint32_t step = 1;; step++) {
+			const uint64_t mask = _group_match_free(ctrl + group * GROUP_WIDTH);
+			if (mask) {
+				return group * GROUP_WIDTH + _lowest_lane(mask);
+			}
+			group = (group + step) & group_mask;
+		}
+	}
+
+	void _rehash(uint32_t p_new_capacity) {
+		int8_t *old_ctrl = ctrl;
+		Element *old_slots = slots;
+		const uint32_t old_capacity = capacity;
+
+		capacity = p_new_capacity;
+		ctrl = static_cast<int8_t *>(memalloc(sizeof(int8_t) * capacity));
+		slots = static_cast<Element *>(memalloc(sizeof(Element) * capacity));
+		memset(ctrl, CTRL_EMPTY, sizeof(int8_t) * capacity);
+		growth_left = _max_load(capacity) - num_elements;
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] >= 0) {
+				const uint32_t slot = _find_free_slot(_mix_hash(Hasher::hash(old_slots[i].pair.key)));
+				ctrl[slot] = old_ctrl[i];
+				memnew_placement(&slots[slot], Element(old_slots[i]));
+				old_slots[i].~Element();
+			}
+		}
+
+		if (old_ctrl) {
+			memfree(old_ctrl);
+			memfree(old_slots);
+		}
+	}
+
+	void _grow() {
+		if (!capacity) {
+			_rehash(GROUP_WIDTH);
+		} else if (num_elements < _max_load(capacity) / 2) {
+			// Mostly tombstones, clean them up without growing.
+			_rehash(capacity);
+		} else {
+			_rehash(capacity * 2);
+		}
+	}
+
+	Element *_insert(const TKey &p_key, const TData &p_data, uint32_t p_hash) {
+		if (unlikely(!capacity)) {
+			_grow();
+		}
+		uint32_t slot = _find_free_slot(p_hash);
+		if (ctrl[slot] == CTRL_EMPTY && growth_left == 0) {
+			_grow();
+			slot = _find_free_slot(p_hash);
+		}
+		if (ctrl[slot] == CTRL_EMPTY) {
+			growth_left--;
+		}
+
+		Element *e = memnew_placement(&slots[slot], Element(p_key, p_data));
+		ctrl[slot] = int8_t(p_hash & 0x7F);
+		num_elements++;
+		return e;
+	}
+
+	Iterator _iter_from(uint32_t p_pos) const {
+		Iterator it;
+		for (uint32_t i = p_pos; i < capacity; i++) {
+			if (ctrl[i] >= 0) {
+				it.valid = true;
+				it.key = &slots[i].pair.key;
+				it.value = const_cast<TData *>(&slots[i].pair.data);
+				it.pos = i;
+				break;
+			}
+		}
+		return it;
+	}
+
+	void copy_from(const SwissHashMap &p_other) {
+		if (&p_other == this) {
+			return;
+		}
+
+		clear();
+		if (!p_other.num_elements) {
+			return;
+		}
+
+		reserve(p_other.num_elements);
+		for (uint32_t i = 0; i < p_other.capacity; i++) {
+			if (p_other.ctrl[i] >= 0) {
+				const Element &e = p_other.slots[i];
+				_insert(e.pair.key, e.pair.data, _mix_hash(Hasher::hash(e.pair.key)));
+			}
+		}
+	}
+
+public:
+	Element *set(const TKey &p_key, const TData &p_data) {
+		return set(Pair(p_key, p_data));
+	}
+
+	Element *set(const Pair &p_pair) {
+		const uint32_t hash = _mix_hash(Hasher::hash(p_pair.key));
+		const uint32_t slot = _find_slot(p_pair.key, hash);
+		if (slot != NOT_FOUND) {
+			slots[slot].pair.data = p_pair.data;
+			return &slots[slot];
+		}
+		return _insert(p_pair.key, p_pair.data, hash);
+	}
+
+	bool has(const TKey &p_key) const {
+		return getptr(p_key) != nullptr;
+	}
+
+	/**
+	 * Get a key from data, return a const reference.
+	 * WARNING: this doesn't check errors, use either getptr and check nullptr, or check
+	 * first with has(key)
+	 */
+
+	const TData &get(const TKey &p_key) const {
+		const TData *res = getptr(p_key);
+		CRASH_COND_MSG(!res, "Map key not found.");
+		return *res;
+	}
+
+	TData &get(const TKey &p_key) {
+		TData *res = getptr(p_key);
+		CRASH_COND_MSG(!res, "Map key not found.");
+		return *res;
+	}
+
+	/**
+	 * Same as get, except it can return nullptr when item was not found.
+	 * This is mainly used for speed purposes.
+	 */
+
+	_FORCE_INLINE_ TData *getptr(const TKey &p_key) {
+		const uint32_t slot = _find_slot(p_key, _mix_hash(Hasher::hash(p_key)));
+		return slot != NOT_FOUND ? &slots[slot].pair.data : nullptr;
+	}
+
+	_FORCE_INLINE_ const TData *getptr(const TKey &p_key) const {
+		const uint32_t slot = _find_slot(p_key, _mix_hash(Hasher::hash(p_key)));
+		return slot != NOT_FOUND ? &slots[slot].pair.data : nullptr;
+	}
+
+	/**
+	 * Same as get, except it can return nullptr when item was not found.
+	 * This version is custom, will take a hash and a custom key (that should support operator==()
+	 */
+
+	template <class C>
+	_FORCE_INLINE_ TData *custom_getptr(C p_custom_key, uint32_t p_custom_hash) {
+		const uint32_t slot = _find_slot(p_custom_key, _mix_hash(p_custom_hash));
+		return slot != NOT_FOUND ? &slots[slot].pair.data : nullptr;
+	}
+
+	template <class C>
+	_FORCE_INLINE_ const TData *custom_getptr(C p_custom_key, uint32_t p_custom_hash) const {
+		const uint32_t slot = _find_slot(p_custom_key, _mix_hash(p_custom_hash));
+		return slot != NOT_FOUND ? &slots[slot].pair.data : nullptr;
+	}
+
+	/**
+	 * OAHashMap style lookup, copies the value into r_data when found.
+	 */
+
+	bool lookup(const TKey &p_key, TData &r_data) const {
+		const TData *res = getptr(p_key);
+		if (res) {
+			r_data = *res;
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Erase an item, return true if erasing was successful
+	 */
+
+	bool erase(const TKey &p_key) {
+		const uint32_t slot = _find_slot(p_key, _mix_hash(Hasher::hash(p_key)));
+		if (slot == NOT_FOUND) {
+			return false;
+		}
+
+		// If the group still has an empty slot no probe sequence continues past it,
+		// so the slot can become empty again instead of a tombstone.
+		if (_group_match_empty(ctrl + (slot & ~(GROUP_WIDTH - 1)))) {
+			ctrl[slot] = CTRL_EMPTY;
+			growth_left++;
+		} else {
+			ctrl[slot] = CTRL_DELETED;
+		}
+
+		slots[slot].~Element();
+		num_elements--;
+		if (num_elements == 0) {
+			clear();
+		}
+		return true;
+	}
+
+	inline const TData &operator[](const TKey &p_key) const { //constref
+		return get(p_key);
+	}
+
+	inline TData &operator[](const TKey &p_key) { //assignment
+		const uint32_t hash = _mix_hash(Hasher::hash(p_key));
+		const uint32_t slot = _find_slot(p_key, hash);
+		if (slot != NOT_FOUND) {
+			return slots[slot].pair.data;
+		}
+		return _insert(p_key, TData(), hash)->pair.data;
+	}
+
+	/**
+	 * Get the next key to p_key, and the first key if p_key is null.
+	 * Returns a pointer to the next key if found, nullptr otherwise.
+	 * Adding/Removing elements while iterating will, of course, have unexpected results, don't do it.
+	 * Each step looks p_key up again, iter()/next_iter() avoid that.
+	 */
+	const TKey *next(const TKey *p_key) const {
+		uint32_t from = 0;
+		if (p_key) {
+			const uint32_t slot = _find_slot(*p_key, _mix_hash(Hasher::hash(*p_key)));
+			ERR_FAIL_COND_V_MSG(slot == NOT_FOUND, nullptr, "Invalid key supplied.");
+			from = slot + 1;
+		}
+
+		Iterator it = _iter_from(from);
+		return it.valid ? it.key : nullptr;
+	}
+
+	Iterator iter() const {
+		return _iter_from(0);
+	}
+
+	Iterator next_iter(const Iterator &p_iter) const {
+		if (!p_iter.valid) {
+			return p_iter;
+		}
+		return _iter_from(p_iter.pos + 1);
+	}
+
+	inline unsigned int size() const {
+		return num_elements;
+	}
+
+	inline bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	_FORCE_INLINE_ uint32_t get_capacity() const {
+		return capacity;
+	}
+
+	/**
+	 * Make room for at least p_elements without rehashing.
+	 */
+	void reserve(uint32_t p_elements) {
+		uint32_t new_capacity = MAX(capacity, GROUP_WIDTH);
+		while (_max_load(new_capacity) < p_elements) {
+			new_capacity *= 2;
+		}
+		if (new_capacity != capacity) {
+			_rehash(new_capacity);
+		}
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (ctrl[i] >= 0) {
+				slots[i].~Element();
+			}
+		}
+		if (ctrl) {
+			memfree(ctrl);
+			memfree(slots);
+		}
+
+		ctrl = nullptr;
+		slots = nullptr;
+		capacity = 0;
+		num_elements = 0;
+		growth_left = 0;
+	}
+
+	void operator=(const SwissHashMap &p_other) {
+		copy_from(p_other);
+	}
+
+	void get_key_list(List<TKey> *r_keys) const {
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (ctrl[i] >= 0) {
+				r_keys->push_back(slots[i].pair.key);
+			}
+		}
+	}
+
+	SwissHashMap() {}
+
+	SwissHashMap(const SwissHashMap &p_other) {
+		copy_from(p_other);
+	}
+
+	~SwissHashMap() {
+		clear();
+	}
+};
+
+#endif // SWISS_HASH_MAP_H
@@ -41,6 +41,7 @@
 #include "core/templates/cowdata.h"
 #include "core/templates/search_array.h"
 #include "core/templates/sort_array.h"
+#include "core/templates/span.h"
 
 #include <climits>
 #include <initializer_list>
@@ -81,6 +82,8 @@ public:
 
 	_FORCE_INLINE_ T *ptrw() { return _cowdata.ptrw(); }
 	_FORCE_INLINE_ const T *ptr() const { return _cowdata.ptr(); }
+	_FORCE_INLINE_ Span<T> span() const { return Span<T>(_cowdata.ptr(), _cowdata.size()); }
+	_FORCE_INLINE_ operator Span<T>() const { return span(); }
 	_FORCE_INLINE_ void clear() { resize(0); }
 	_FORCE_INLINE_ bool is_empty() const { return _cowdata.is_empty(); }
 
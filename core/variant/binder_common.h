@@ -83,6 +83,55 @@ struct VariantCaster<const T &> {
 	}
 };
 
+// Packed array arguments read the array stored in the Variant in place, only other
+// types are converted into a local copy. The proxy lives until the bound call returns.
+template <class T>
+struct VariantPackedArrayArg {
+	const Vector<T> *array = nullptr;
+	Vector<T> converted;
+
+	_FORCE_INLINE_ operator const Vector<T> &() const { return array ? *array : converted; }
+	_FORCE_INLINE_ operator Span<T>() const { return operator const Vector<T> &().span(); }
+
+	_FORCE_INLINE_ VariantPackedArrayArg(const Variant &p_variant) {
+		if (p_variant.get_type() == GetTypeInfo<Vector<T>>::VARIANT_TYPE) {
+			array = &VariantInternalAccessor<Vector<T>>::get(&p_variant);
+		} else {
+			converted = p_variant;
+		}
+	}
+};
+
+#define VARIANT_PACKED_ARRAY_CAST(m_type, m_elem)                                            \
+	template <>                                                                              \
+	struct VariantCaster<m_type> {                                                           \
+		static _FORCE_INLINE_ VariantPackedArrayArg<m_elem> cast(const Variant &p_variant) { \
+			return VariantPackedArrayArg<m_elem>(p_variant);                                 \
+		}                                                                                    \
+	};                                                                                       \
+	template <>                                                                              \
+	struct VariantCaster<const m_type &> {                                                   \
+		static _FORCE_INLINE_ VariantPackedArrayArg<m_elem> cast(const Variant &p_variant) { \
+			return VariantPackedArrayArg<m_elem>(p_variant);                                 \
+		}                                                                                    \
+	};                                                                                       \
+	template <>                                                                              \
+	struct VariantCaster<Span<m_elem>> {                                                     \
+		static _FORCE_INLINE_ VariantPackedArrayArg<m_elem> cast(const Variant &p_variant) { \
+			return VariantPackedArrayArg<m_elem>(p_variant);                                 \
+		}                                                                                    \
+	};
+
+VARIANT_PACKED_ARRAY_CAST(PackedByteArray, uint8_t)
+VARIANT_PACKED_ARRAY_CAST(PackedInt32Array, int32_t)
+VARIANT_PACKED_ARRAY_CAST(PackedInt64Array, int64_t)
+VARIANT_PACKED_ARRAY_CAST(PackedFloat32Array, float)
+VARIANT_PACKED_ARRAY_CAST(PackedFloat64Array, double)
+VARIANT_PACKED_ARRAY_CAST(PackedStringArray, String)
+VARIANT_PACKED_ARRAY_CAST(PackedVector2Array, Vector2)
+VARIANT_PACKED_ARRAY_CAST(PackedVector3Array, Vector3)
+VARIANT_PACKED_ARRAY_CAST(PackedColorArray, Color)
+
 #define VARIANT_ENUM_CAST(m_enum)                                            \
 	MAKE_ENUM_TYPE_INFO(m_enum)                                              \
 	template <>                                                              \
@@ -183,7 +232,7 @@ struct VariantObjectClassChecker<const Ref<T> &> {
 
 template <class T>
 struct VariantCasterAndValidate {
-	static _FORCE_INLINE_ T cast(const Variant **p_args, uint32_t p_arg_idx, Callable::CallError &r_error) {
+	static _FORCE_INLINE_ auto cast(const Variant **p_args, uint32_t p_arg_idx, Callable::CallError &r_error) {
 		Variant::Type argtype = GetTypeInfo<T>::VARIANT_TYPE;
 		if (!Variant::can_convert_strict(p_args[p_arg_idx]->get_type(), argtype) ||
 				!VariantObjectClassChecker<T>::check(*p_args[p_arg_idx])) {
@@ -198,7 +247,7 @@ struct VariantCasterAndValidate {
 
 template <class T>
 struct VariantCasterAndValidate<T &> {
-	static _FORCE_INLINE_ T cast(const Variant **p_args, uint32_t p_arg_idx, Callable::CallError &r_error) {
+	static _FORCE_INLINE_ auto cast(const Variant **p_args, uint32_t p_arg_idx, Callable::CallError &r_error) {
 		Variant::Type argtype = GetTypeInfo<T>::VARIANT_TYPE;
 		if (!Variant::can_convert_strict(p_args[p_arg_idx]->get_type(), argtype) ||
 				!VariantObjectClassChecker<T>::check(*p_args[p_arg_idx])) {
@@ -213,7 +262,7 @@ struct VariantCasterAndValidate<T &> {
 
 template <class T>
 struct VariantCasterAndValidate<const T &> {
-	static _FORCE_INLINE_ T cast(const Variant **p_args, uint32_t p_arg_idx, Callable::CallError &r_error) {
+	static _FORCE_INLINE_ auto cast(const Variant **p_args, uint32_t p_arg_idx, Callable::CallError &r_error) {
 		Variant::Type argtype = GetTypeInfo<T>::VARIANT_TYPE;
 		if (!Variant::can_convert_strict(p_args[p_arg_idx]->get_type(), argtype) ||
 				!VariantObjectClassChecker<T>::check(*p_args[p_arg_idx])) {
@@ -104,6 +104,36 @@ struct PtrToArg {};
 		}                                                                     \
 	}
 
+// Packed arrays are reference counted, so const reference and Span arguments read
+// straight from the caller's array instead of taking a reference of their own.
+#define MAKE_PTRARG_PACKED(m_type, m_elem)                               \
+	template <>                                                          \
+	struct PtrToArg<m_type> {                                            \
+		_FORCE_INLINE_ static m_type convert(const void *p_ptr) {        \
+			return *reinterpret_cast<const m_type *>(p_ptr);             \
+		}                                                                \
+		typedef m_type EncodeT;                                          \
+		_FORCE_INLINE_ static void encode(m_type p_val, void *p_ptr) {   \
+			*((m_type *)p_ptr) = p_val;                                  \
+		}                                                                \
+	};                                                                   \
+	template <>                                                          \
+	struct PtrToArg<const m_type &> {                                    \
+		_FORCE_INLINE_ static const m_type &convert(const void *p_ptr) { \
+			return *reinterpret_cast<const m_type *>(p_ptr);             \
+		}                                                                \
+		typedef m_type EncodeT;                                          \
+		_FORCE_INLINE_ static void encode(m_type p_val, void *p_ptr) {   \
+			*((m_type *)p_ptr) = p_val;                                  \
+		}                                                                \
+	};                                                                   \
+	template <>                                                          \
+	struct PtrToArg<Span<m_elem>> {                                      \
+		_FORCE_INLINE_ static Span<m_elem> convert(const void *p_ptr) {  \
+			return reinterpret_cast<const m_type *>(p_ptr)->span();      \
+		}                                                                \
+	}
+
 MAKE_PTRARGCONV(bool, uint8_t);
 // Integer types.
 MAKE_PTRARGCONV(uint8_t, int64_t);
@@ -140,15 +170,15 @@ MAKE_PTRARG(Callable);
 MAKE_PTRARG(Signal);
 MAKE_PTRARG(Dictionary);
 MAKE_PTRARG(Array);
-MAKE_PTRARG(PackedByteArray);
-MAKE_PTRARG(PackedInt32Array);
-MAKE_PTRARG(PackedInt64Array);
-MAKE_PTRARG(PackedFloat32Array);
-MAKE_PTRARG(PackedFloat64Array);
-MAKE_PTRARG(PackedStringArray);
-MAKE_PTRARG(PackedVector2Array);
-MAKE_PTRARG(PackedVector3Array);
-MAKE_PTRARG(PackedColorArray);
+MAKE_PTRARG_PACKED(PackedByteArray, uint8_t);
+MAKE_PTRARG_PACKED(PackedInt32Array, int32_t);
+MAKE_PTRARG_PACKED(PackedInt64Array, int64_t);
+MAKE_PTRARG_PACKED(PackedFloat32Array, float);
+MAKE_PTRARG_PACKED(PackedFloat64Array, double);
+MAKE_PTRARG_PACKED(PackedStringArray, String);
+MAKE_PTRARG_PACKED(PackedVector2Array, Vector2);
+MAKE_PTRARG_PACKED(PackedVector3Array, Vector3);
+MAKE_PTRARG_PACKED(PackedColorArray, Color);
 MAKE_PTRARG_BY_REFERENCE(Variant);
 
 // This is for Object.
@@ -223,6 +223,16 @@ MAKE_TEMPLATE_TYPE_INFO(Vector, Plane, Variant::ARRAY)
 MAKE_TEMPLATE_TYPE_INFO(Vector, Face3, Variant::PACKED_VECTOR3_ARRAY)
 MAKE_TEMPLATE_TYPE_INFO(Vector, StringName, Variant::PACKED_STRING_ARRAY)
 
+MAKE_TEMPLATE_TYPE_INFO(Span, uint8_t, Variant::PACKED_BYTE_ARRAY)
+MAKE_TEMPLATE_TYPE_INFO(Span, int32_t, Variant::PACKED_INT32_ARRAY)
+MAKE_TEMPLATE_TYPE_INFO(Span, int64_t, Variant::PACKED_INT64_ARRAY)
+MAKE_TEMPLATE_TYPE_INFO(Span, float, Variant::PACKED_FLOAT32_ARRAY)
+MAKE_TEMPLATE_TYPE_INFO(Span, double, Variant::PACKED_FLOAT64_ARRAY)
+MAKE_TEMPLATE_TYPE_INFO(Span, String, Variant::PACKED_STRING_ARRAY)
+MAKE_TEMPLATE_TYPE_INFO(Span, Vector2, Variant::PACKED_VECTOR2_ARRAY)
+MAKE_TEMPLATE_TYPE_INFO(Span, Vector3, Variant::PACKED_VECTOR3_ARRAY)
+MAKE_TEMPLATE_TYPE_INFO(Span, Color, Variant::PACKED_COLOR_ARRAY)
+
 template <typename T>
 struct GetTypeInfo<T *, typename EnableIf<TypeInherits<Object, T>::value>::type> {
 	static const Variant::Type VARIANT_TYPE = Variant::OBJECT;
@@ -31,6 +31,7 @@
 #include "performance.h"
 
 #include "core/object/message_queue.h"
+#include "core/os/frame_allocator.h"
 #include "core/os/os.h"
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
@@ -73,6 +74,11 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(MEMORY_MESSAGE_BUFFER_USAGE);
+	BIND_ENUM_CONSTANT(MESSAGE_QUEUE_OVERFLOW_COUNT);
+	BIND_ENUM_CONSTANT(MESSAGE_QUEUE_CONTENTION_COUNT);
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ARENA_PEAK);
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ARENA_AVERAGE);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -112,6 +118,11 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/driver/output_latency",
+		"memory/msg_buf_usage",
+		"message_queue/overflows",
+		"message_queue/contention",
+		"memory/frame_arena_peak",
+		"memory/frame_arena_avg",
 
 	};
 
@@ -166,6 +177,16 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case MEMORY_MESSAGE_BUFFER_USAGE:
+			return MessageQueue::get_singleton()->get_buffer_usage();
+		case MESSAGE_QUEUE_OVERFLOW_COUNT:
+			return MessageQueue::get_singleton()->get_overflow_count();
+		case MESSAGE_QUEUE_CONTENTION_COUNT:
+			return MessageQueue::get_singleton()->get_contention_count();
+		case MEMORY_FRAME_ARENA_PEAK:
+			return FrameAllocator::get_peak_usage();
+		case MEMORY_FRAME_ARENA_AVERAGE:
+			return FrameAllocator::get_average_usage();
 
 		default: {
 		}
@@ -201,6 +222,11 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
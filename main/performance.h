@@ -87,6 +87,11 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		MEMORY_MESSAGE_BUFFER_USAGE,
+		MESSAGE_QUEUE_OVERFLOW_COUNT,
+		MESSAGE_QUEUE_CONTENTION_COUNT,
+		MEMORY_FRAME_ARENA_PEAK,
+		MEMORY_FRAME_ARENA_AVERAGE,
 		MONITOR_MAX
 	};
 
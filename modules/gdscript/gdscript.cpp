@@ -631,7 +631,7 @@ bool GDScript::_update_exports(bool *r_err, bool p_recursive_call, PlaceHolderSc
 
 		GDScriptParser parser;
 		GDScriptAnalyzer analyzer(&parser);
-		Error err = parser.parse(source, path, false);
+		Error err = GDScriptCache::parse_script(&parser, path, source);
 
 		if (err == OK && analyzer.analyze() == OK) {
 			const GDScriptParser::ClassNode *c = parser.get_tree();
@@ -803,6 +803,10 @@ String GDScript::_get_debug_path() const {
 }
 
 Error GDScript::reload(bool p_keep_state) {
+	return _reload(p_keep_state, nullptr);
+}
+
+Error GDScript::_reload(bool p_keep_state, GDScriptParser *p_parser) {
 	bool has_instances;
 	{
 		MutexLock lock(GDScriptLanguage::singleton->lock);
@@ -839,7 +843,7 @@ Error GDScript::reload(bool p_keep_state) {
 			source_path = get_path();
 		}
 		if (!source_path.is_empty()) {
-			MutexLock lock(GDScriptCache::singleton->lock);
+			GDScriptCache::CacheLock lock;
 			if (!GDScriptCache::singleton->shallow_gdscript_cache.has(source_path)) {
 				GDScriptCache::singleton->shallow_gdscript_cache[source_path] = this;
 			}
@@ -847,8 +851,9 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 
 	valid = false;
-	GDScriptParser parser;
-	Error err = parser.parse(source, path, false);
+	GDScriptParser own_parser;
+	GDScriptParser &parser = p_parser ? *p_parser : own_parser;
+	Error err = p_parser ? OK : GDScriptCache::parse_script(&parser, path, source);
 	if (err) {
 		if (EngineDebugger::is_active()) {
 			GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
@@ -858,6 +863,13 @@ Error GDScript::reload(bool p_keep_state) {
 		ERR_FAIL_V(ERR_PARSE_ERROR);
 	}
 
+	// Parse the scripts this one depends on in parallel, before the analyzer asks for them one by one.
+	// Scripts loaded through the cache had their dependency graph parsed before they were passed here.
+	Vector<Ref<GDScriptParserRef>> dependency_parsers;
+	if (!path.is_empty()) {
+		dependency_parsers = GDScriptCache::_parse_dependency_graph(path, parser.get_dependencies());
+	}
+
 	GDScriptAnalyzer analyzer(&parser);
 	err = analyzer.analyze();
 
@@ -1017,6 +1029,13 @@ Error GDScript::load_byte_code(const String &p_path) {
 }
 
 Error GDScript::load_source_code(const String &p_path) {
+	if (GDScriptCache::is_exported_only(p_path)) {
+		// Only the token stream was exported, it's parsed on reload.
+		source = String();
+		path = p_path;
+		return OK;
+	}
+
 	Vector<uint8_t> sourcef;
 	Error err;
 	FileAccess *f = FileAccess::open(p_path, FileAccess::READ, &err);
@@ -2198,6 +2217,9 @@ GDScriptLanguage::GDScriptLanguage() {
 	script_frame_time = 0;
 
 	_debug_call_stack_pos = 0;
+	// Replaying cached tokens still parses, analyzes and compiles, and measures no faster than scanning the source.
+	GLOBAL_DEF("gdscript/token_cache/enabled", false);
+
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/gdscript/max_call_stack", PropertyInfo(Variant::INT, "debug/settings/gdscript/max_call_stack", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater")); //minimum is 1024
 
@@ -2282,10 +2304,11 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 		*r_error = ERR_FILE_CANT_OPEN;
 	}
 
-	Error err;
-	Ref<GDScript> script = GDScriptCache::get_full_script(p_path, err);
+	// Exported scripts are remapped to their ".gdc" token stream, but are cached under their source path.
+	String path = p_path.get_extension() == "gdc" ? p_path.get_basename() + ".gd" : p_path;
 
-	// TODO: Reintroduce binary and encrypted scripts.
+	Error err;
+	Ref<GDScript> script = GDScriptCache::get_full_script(path, err);
 
 	if (script.is_null()) {
 		// Don't fail loading because of parsing error.
@@ -2301,9 +2324,7 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 
 void ResourceFormatLoaderGDScript::get_recognized_extensions(List<String> *p_extensions) const {
 	p_extensions->push_back("gd");
-	// TODO: Reintroduce binary and encrypted scripts.
-	// p_extensions->push_back("gdc");
-	// p_extensions->push_back("gde");
+	p_extensions->push_back("gdc");
 }
 
 bool ResourceFormatLoaderGDScript::handles_type(const String &p_type) const {
@@ -2312,14 +2333,24 @@ bool ResourceFormatLoaderGDScript::handles_type(const String &p_type) const {
 
 String ResourceFormatLoaderGDScript::get_resource_type(const String &p_path) const {
 	String el = p_path.get_extension().to_lower();
-	// TODO: Reintroduce binary and encrypted scripts.
-	if (el == "gd" /*|| el == "gdc" || el == "gde"*/) {
+	if (el == "gd" || el == "gdc") {
 		return "GDScript";
 	}
 	return "";
 }
 
 void ResourceFormatLoaderGDScript::get_dependencies(const String &p_path, List<String> *p_dependencies, bool p_add_types) {
+	if (p_path.get_extension() == "gdc") {
+		GDScriptParser parser;
+		if (OK != GDScriptCache::parse_script(&parser, p_path.get_basename() + ".gd", String())) {
+			return;
+		}
+		for (const String &E : parser.get_dependencies()) {
+			p_dependencies->push_back(E);
+		}
+		return;
+	}
+
 	FileAccessRef file = FileAccess::open(p_path, FileAccess::READ);
 	ERR_FAIL_COND_MSG(!file, "Cannot open file '" + p_path + "'.");
 
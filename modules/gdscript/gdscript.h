@@ -39,6 +39,8 @@
 #include "core/object/script_language.h"
 #include "gdscript_function.h"
 
+class GDScriptParser;
+
 class GDScriptNativeClass : public RefCounted {
 	GDCLASS(GDScriptNativeClass, RefCounted);
 
@@ -72,6 +74,7 @@ class GDScript : public Script {
 	friend class GDScriptAnalyzer;
 	friend class GDScriptCompiler;
 	friend class GDScriptLanguage;
+	friend class GDScriptCache;
 	friend struct GDScriptUtilityFunctionsDefinitions;
 
 	Ref<GDScriptNativeClass> native;
@@ -136,6 +139,8 @@ class GDScript : public Script {
 
 	void _set_subclass_path(Ref<GDScript> &p_sc, const String &p_path);
 	String _get_debug_path() const;
+	// p_parser holds the script already parsed from its source, or is null.
+	Error _reload(bool p_keep_state, GDScriptParser *p_parser);
 
 #ifdef TOOLS_ENABLED
 	Set<PlaceHolderScriptInstance *> placeholders;
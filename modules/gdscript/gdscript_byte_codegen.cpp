@@ -565,6 +565,9 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
+		last_operator_pos = opcodes.size();
+		last_operator_target = p_target;
+
 		append(GDScriptFunction::OPCODE_OPERATOR_VALIDATED, 3);
 		append(p_left_operand);
 		append(p_right_operand);
@@ -790,6 +793,17 @@ void GDScriptByteCodeGenerator::write_get_member(const Address &p_target, const
 	append(p_name);
 }
 
+void GDScriptByteCodeGenerator::write_set_member_with_operator(const Address &p_member, const StringName &p_name, Variant::Operator p_operator, const Address &p_value) {
+	// The compiler only uses this when the operator can write its result over the left operand.
+	Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_member.type.builtin_type, p_value.type.builtin_type);
+
+	append(GDScriptFunction::OPCODE_SET_MEMBER_OPERATOR_VALIDATED, 2);
+	append(p_value);
+	append(p_member);
+	append(p_name);
+	append(op_func);
+}
+
 void GDScriptByteCodeGenerator::write_assign_with_conversion(const Address &p_target, const Address &p_source) {
 	switch (p_target.type.kind) {
 		case GDScriptDataType::BUILTIN: {
@@ -1299,8 +1313,10 @@ void GDScriptByteCodeGenerator::write_await(const Address &p_target, const Addre
 }
 
 void GDScriptByteCodeGenerator::write_if(const Address &p_condition) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_condition);
+	if (!fuse_operator_jump_if_not(p_condition)) {
+		append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
+		append(p_condition);
+	}
 	if_jmp_addrs.push_back(opcodes.size());
 	append(0); // Jump destination, will be patched.
 }
@@ -1482,12 +1498,15 @@ void GDScriptByteCodeGenerator::write_endfor() {
 void GDScriptByteCodeGenerator::start_while_condition() {
 	current_breaks_to_patch.push_back(List<int>());
 	continue_addrs.push_back(opcodes.size());
+	last_operator_pos = -1;
 }
 
 void GDScriptByteCodeGenerator::write_while(const Address &p_condition) {
 	// Condition check.
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_condition);
+	if (!fuse_operator_jump_if_not(p_condition)) {
+		append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
+		append(p_condition);
+	}
 	while_jmp_addrs.push_back(opcodes.size());
 	append(0); // End of loop address, will be patched.
 }
@@ -115,6 +115,10 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	List<List<int>> current_breaks_to_patch;
 	List<List<int>> match_continues_to_patch;
 
+	// Last validated operator, so a conditional jump on its result can be fused into it.
+	int last_operator_pos = -1;
+	Address last_operator_target;
+
 	void add_stack_identifier(const StringName &p_id, int p_stackpos) {
 		if (locals.size() > max_locals) {
 			max_locals = locals.size();
@@ -402,6 +406,20 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	void patch_jump(int p_address) {
 		opcodes.write[p_address] = opcodes.size();
+		last_operator_pos = -1; // Something jumps right after it now.
+	}
+
+	bool fuse_operator_jump_if_not(const Address &p_condition) {
+		if (last_operator_pos < 0 || last_operator_pos + 5 != opcodes.size()) {
+			return false;
+		}
+		// Only temporaries, their value is not read after the jump.
+		if (p_condition.mode != Address::TEMPORARY || last_operator_target.mode != Address::TEMPORARY || last_operator_target.address != p_condition.address) {
+			return false;
+		}
+		opcodes.write[last_operator_pos] = (GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT & GDScriptFunction::INSTR_MASK) | (3 << GDScriptFunction::INSTR_BITS);
+		last_operator_pos = -1;
+		return true;
 	}
 
 public:
@@ -449,6 +467,7 @@ public:
 	virtual void write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) override;
 	virtual void write_set_member(const Address &p_value, const StringName &p_name) override;
 	virtual void write_get_member(const Address &p_target, const StringName &p_name) override;
+	virtual void write_set_member_with_operator(const Address &p_member, const StringName &p_name, Variant::Operator p_operator, const Address &p_value) override;
 	virtual void write_assign(const Address &p_target, const Address &p_source) override;
 	virtual void write_assign_with_conversion(const Address &p_target, const Address &p_source) override;
 	virtual void write_assign_true(const Address &p_target) override;
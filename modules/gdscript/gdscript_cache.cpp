@@ -30,7 +30,12 @@
 
 #include "gdscript_cache.h"
 
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/vector.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
@@ -50,6 +55,7 @@ GDScriptParser *GDScriptParserRef::get_parser() const {
 
 Error GDScriptParserRef::raise_status(Status p_new_status) {
 	ERR_FAIL_COND_V(parser == nullptr, ERR_INVALID_DATA);
+	MutexLock lock(mutex);
 
 	if (result != OK) {
 		return result;
@@ -59,7 +65,7 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 		switch (status) {
 			case EMPTY:
 				status = PARSED;
-				result = parser->parse(GDScriptCache::get_source_code(path), path, false);
+				result = GDScriptCache::parse_script(parser, path, GDScriptCache::is_exported_only(path) ? String() : GDScriptCache::get_source_code(path));
 				break;
 			case PARSED: {
 				analyzer = memnew(GDScriptAnalyzer(parser));
@@ -102,32 +108,29 @@ GDScriptParserRef::~GDScriptParserRef() {
 	if (analyzer != nullptr) {
 		memdelete(analyzer);
 	}
-	MutexLock lock(GDScriptCache::singleton->lock);
+	GDScriptCache::CacheLock lock;
 	GDScriptCache::singleton->parser_map.erase(path);
 }
 
 GDScriptCache *GDScriptCache::singleton = nullptr;
+thread_local uint32_t GDScriptCache::lock_depth = 0;
 
 void GDScriptCache::remove_script(const String &p_path) {
-	MutexLock lock(singleton->lock);
+	CacheLock lock;
 	singleton->shallow_gdscript_cache.erase(p_path);
 	singleton->full_gdscript_cache.erase(p_path);
 }
 
-Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
-	MutexLock lock(singleton->lock);
+Ref<GDScriptParserRef> GDScriptCache::_get_parser_ref(const String &p_path, Error &r_error) {
 	Ref<GDScriptParserRef> ref;
-	if (!p_owner.is_empty()) {
-		singleton->dependencies[p_owner].insert(p_path);
-	}
+	r_error = OK;
 	if (singleton->parser_map.has(p_path)) {
 		ref = Ref<GDScriptParserRef>(singleton->parser_map[p_path]);
 		if (ref.is_null()) {
 			r_error = ERR_INVALID_DATA;
-			return ref;
 		}
 	} else {
-		if (!FileAccess::exists(p_path)) {
+		if (!FileAccess::exists(p_path) && !is_exported_only(p_path)) {
 			r_error = ERR_FILE_NOT_FOUND;
 			return ref;
 		}
@@ -137,11 +140,93 @@ Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptP
 		ref->path = p_path;
 		singleton->parser_map[p_path] = ref.ptr();
 	}
+	return ref;
+}
+
+Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
+	CacheLock lock;
+	if (!p_owner.is_empty()) {
+		singleton->dependencies[p_owner].insert(p_path);
+	}
+	Ref<GDScriptParserRef> ref = _get_parser_ref(p_path, r_error);
+	if (ref.is_null()) {
+		return ref;
+	}
 	r_error = ref->raise_status(p_status);
 
 	return ref;
 }
 
+void GDScriptCache::_parse_thread(uint32_t p_index, GDScriptParserRef **p_refs) {
+	p_refs[p_index]->raise_status(GDScriptParserRef::PARSED);
+}
+
+// Parsing only depends on a script's own code, so the scripts reachable from p_path are parsed on worker
+// threads, one breadth-first level of the dependency graph at a time. Analysis and compilation, which
+// link scripts together, then run serialized under the cache lock and find their dependencies parsed.
+// p_path itself was already parsed by the caller, which passes its dependencies.
+// The cache lock is only taken to look up the parsers of a level, never while waiting for the workers:
+// the waiting thread runs other pool tasks meanwhile, which can load scripts too. When the calling thread
+// already holds the lock, for example while compiling a script that depends on p_path, nothing is done
+// and the dependencies are parsed on demand.
+// The returned references keep the parsers alive until the scripts are compiled.
+Vector<Ref<GDScriptParserRef>> GDScriptCache::_parse_dependency_graph(const String &p_path, const List<String> &p_dependencies) {
+	Vector<Ref<GDScriptParserRef>> parsed;
+	if (lock_depth > 0) {
+		return parsed;
+	}
+
+	Set<String> visited;
+	Vector<String> level;
+	visited.insert(p_path);
+	for (const String &E : p_dependencies) {
+		if (E.get_extension() == "gd" && !visited.has(E)) {
+			visited.insert(E);
+			level.push_back(E);
+		}
+	}
+
+	while (!level.is_empty()) {
+		Vector<Ref<GDScriptParserRef>> level_refs;
+		LocalVector<GDScriptParserRef *> to_parse;
+		{
+			CacheLock lock;
+			for (int i = 0; i < level.size(); i++) {
+				Error err = OK;
+				Ref<GDScriptParserRef> ref = _get_parser_ref(level[i], err);
+				if (ref.is_null()) {
+					continue;
+				}
+				// Scripts that are already parsed are skipped by raise_status().
+				to_parse.push_back(ref.ptr());
+				level_refs.push_back(ref);
+			}
+		}
+
+		WorkerThreadPool::get_singleton()->do_work(to_parse.size(), singleton, &GDScriptCache::_parse_thread, to_parse.ptr());
+
+		Vector<String> next_level;
+		CacheLock lock;
+		for (int i = 0; i < level_refs.size(); i++) {
+			const Ref<GDScriptParserRef> &ref = level_refs[i];
+			parsed.push_back(ref);
+			MutexLock ref_lock(ref->mutex);
+			if (ref->result != OK) {
+				continue;
+			}
+			for (const String &E : ref->get_parser()->get_dependencies()) {
+				if (E.get_extension() == "gd" && !visited.has(E)) {
+					visited.insert(E);
+					next_level.push_back(E);
+				}
+			}
+		}
+		level = next_level;
+	}
+
+	return parsed;
+}
+
 String GDScriptCache::get_source_code(const String &p_path) {
 	Vector<uint8_t> source_file;
 	Error err;
@@ -164,8 +249,121 @@ String GDScriptCache::get_source_code(const String &p_path) {
 	return source;
 }
 
+#define GDSCRIPT_TOKEN_CACHE_MAGIC "GDTC"
+#define GDSCRIPT_EXPORTED_TOKENS_MAGIC "GDSC"
+
+String GDScriptCache::get_exported_tokens_path(const String &p_path) {
+	return p_path.get_basename() + ".gdc";
+}
+
+bool GDScriptCache::is_exported_only(const String &p_path) {
+	return p_path.get_extension() == "gd" && !FileAccess::exists(p_path) && FileAccess::exists(get_exported_tokens_path(p_path));
+}
+
+Vector<uint8_t> GDScriptCache::encode_exported_tokens(const Vector<uint8_t> &p_token_stream) {
+	Vector<uint8_t> file;
+	file.resize(4 + p_token_stream.size());
+	memcpy(file.ptrw(), GDSCRIPT_EXPORTED_TOKENS_MAGIC, 4);
+	memcpy(file.ptrw() + 4, p_token_stream.ptr(), p_token_stream.size());
+	return file;
+}
+
+String GDScriptCache::_get_token_cache_path(const String &p_path) {
+	return ProjectSettings::get_singleton()->get_project_data_path().plus_file("gdscript_cache").plus_file(p_path.md5_text() + ".gdt");
+}
+
+// Cache files hold the MD5 of the source they were scanned from, so edited scripts are rescanned.
+// Editor builds keep doc comments in the stream, so they don't share cache files with templates.
+static uint32_t _get_token_cache_flags() {
+#ifdef TOOLS_ENABLED
+	return 1;
+#else
+	return 0;
+#endif // TOOLS_ENABLED
+}
+
+Vector<uint8_t> GDScriptCache::_load_token_cache(const String &p_path, const String &p_source_hash) {
+	FileAccessRef f = FileAccess::open(_get_token_cache_path(p_path), FileAccess::READ);
+	if (!f) {
+		return Vector<uint8_t>();
+	}
+
+	uint8_t magic[4];
+	if (f->get_buffer(magic, 4) != 4 || memcmp(magic, GDSCRIPT_TOKEN_CACHE_MAGIC, 4) != 0) {
+		return Vector<uint8_t>();
+	}
+	if (f->get_32() != _get_token_cache_flags() || f->get_pascal_string() != p_source_hash) {
+		return Vector<uint8_t>();
+	}
+
+	uint64_t len = f->get_32();
+	if (len != f->get_length() - f->get_position()) {
+		return Vector<uint8_t>();
+	}
+	Vector<uint8_t> token_stream;
+	token_stream.resize(len);
+	if (f->get_buffer(token_stream.ptrw(), len) != len) {
+		return Vector<uint8_t>();
+	}
+	return token_stream;
+}
+
+void GDScriptCache::_save_token_cache(const String &p_path, const String &p_source_hash, const Vector<uint8_t> &p_token_stream) {
+	if (p_token_stream.is_empty()) {
+		return;
+	}
+
+	String cache_path = _get_token_cache_path(p_path);
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+	if (!da->dir_exists(cache_path.get_base_dir())) {
+		// Scripts are parsed in parallel, another one may have created it meanwhile.
+		Error err = da->make_dir_recursive(cache_path.get_base_dir());
+		if (err != OK && err != ERR_ALREADY_EXISTS) {
+			return;
+		}
+	}
+
+	FileAccessRef f = FileAccess::open(cache_path, FileAccess::WRITE);
+	if (!f) {
+		return;
+	}
+	f->store_buffer((const uint8_t *)GDSCRIPT_TOKEN_CACHE_MAGIC, 4);
+	f->store_32(_get_token_cache_flags());
+	f->store_pascal_string(p_source_hash);
+	f->store_32(p_token_stream.size());
+	f->store_buffer(p_token_stream.ptr(), p_token_stream.size());
+}
+
+Error GDScriptCache::parse_script(GDScriptParser *p_parser, const String &p_path, const String &p_source) {
+	if (p_source.is_empty() && is_exported_only(p_path)) {
+		Vector<uint8_t> file = FileAccess::get_file_as_array(get_exported_tokens_path(p_path));
+		ERR_FAIL_COND_V_MSG(file.size() < 4 || memcmp(file.ptr(), GDSCRIPT_EXPORTED_TOKENS_MAGIC, 4) != 0, ERR_FILE_CORRUPT, "Invalid exported GDScript file '" + get_exported_tokens_path(p_path) + "'.");
+		return p_parser->parse_binary(file.slice(4, file.size()), p_path);
+	}
+
+	// Built-in and unsaved scripts are not cached.
+	bool use_cache = p_path.begins_with("res://") && p_path.find("::") == -1 && GLOBAL_GET("gdscript/token_cache/enabled");
+	if (!use_cache) {
+		return p_parser->parse(p_source, p_path, false);
+	}
+
+	String source_hash = p_source.md5_text();
+	Vector<uint8_t> cached = _load_token_cache(p_path, source_hash);
+	if (!cached.is_empty() && p_parser->parse_binary(cached, p_path) == OK) {
+		return OK;
+	}
+
+	p_parser->set_record_tokens(true);
+	Error err = p_parser->parse(p_source, p_path, false);
+	if (err == OK) {
+		_save_token_cache(p_path, source_hash, p_parser->get_token_stream());
+	}
+	p_parser->set_record_tokens(false);
+	return err;
+}
+
 Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const String &p_owner) {
-	MutexLock lock(singleton->lock);
+	CacheLock lock;
 	if (!p_owner.is_empty()) {
 		singleton->dependencies[p_owner].insert(p_path);
 	}
@@ -187,7 +385,28 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const Stri
 }
 
 Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_error, const String &p_owner) {
-	MutexLock lock(singleton->lock);
+	// Compiling holds the lock until the end, so a script loaded from outside the cache is parsed before,
+	// along with the scripts it depends on. Scripts loaded while compiling another one are parsed on demand.
+	GDScriptParser parser;
+	String parsed_source;
+	bool parsed = false;
+	Vector<Ref<GDScriptParserRef>> dependency_parsers;
+	if (lock_depth == 0 && p_path.get_extension() == "gd") {
+		bool compiled;
+		{
+			CacheLock lock;
+			compiled = singleton->full_gdscript_cache.has(p_path);
+		}
+		if (!compiled && (FileAccess::exists(p_path) || is_exported_only(p_path))) {
+			parsed_source = is_exported_only(p_path) ? String() : get_source_code(p_path);
+			parsed = parse_script(&parser, p_path, parsed_source) == OK;
+			if (parsed) {
+				dependency_parsers = _parse_dependency_graph(p_path, parser.get_dependencies());
+			}
+		}
+	}
+
+	CacheLock lock;
 
 	if (!p_owner.is_empty()) {
 		singleton->dependencies[p_owner].insert(p_path);
@@ -207,7 +426,8 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 		return script;
 	}
 
-	r_error = script->reload();
+	// The file may have changed since it was parsed.
+	r_error = script->_reload(false, parsed && script->source == parsed_source ? &parser : nullptr);
 	if (r_error) {
 		return script;
 	}
@@ -219,6 +439,8 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 }
 
 Error GDScriptCache::finish_compiling(const String &p_owner) {
+	CacheLock lock;
+
 	// Mark this as compiled.
 	Ref<GDScript> script = get_shallow_script(p_owner);
 	singleton->full_gdscript_cache[p_owner] = script.ptr();
@@ -56,6 +56,8 @@ private:
 	Status status = EMPTY;
 	Error result = OK;
 	String path;
+	// Scripts are parsed on worker threads without the cache lock, see GDScriptCache::_parse_dependency_graph().
+	Mutex mutex;
 
 	friend class GDScriptCache;
 
@@ -82,11 +84,38 @@ class GDScriptCache {
 	static GDScriptCache *singleton;
 
 	Mutex lock;
+	static thread_local uint32_t lock_depth;
+
+	// Locks the cache and counts how many times the calling thread holds it.
+	class CacheLock {
+		MutexLock<Mutex> mutex_lock;
+
+	public:
+		CacheLock() :
+				mutex_lock(singleton->lock) { lock_depth++; }
+		~CacheLock() { lock_depth--; }
+	};
+
 	static void remove_script(const String &p_path);
 
+	static Ref<GDScriptParserRef> _get_parser_ref(const String &p_path, Error &r_error);
+	void _parse_thread(uint32_t p_index, GDScriptParserRef **p_refs);
+	static Vector<Ref<GDScriptParserRef>> _parse_dependency_graph(const String &p_path, const List<String> &p_dependencies);
+
+	static String _get_token_cache_path(const String &p_path);
+	static Vector<uint8_t> _load_token_cache(const String &p_path, const String &p_source_hash);
+	static void _save_token_cache(const String &p_path, const String &p_source_hash, const Vector<uint8_t> &p_token_stream);
+
 public:
 	static Ref<GDScriptParserRef> get_parser(const String &p_path, GDScriptParserRef::Status status, Error &r_error, const String &p_owner = String());
 	static String get_source_code(const String &p_path);
+
+	// Exported projects ship scripts as token streams in ".gdc" files instead of source code.
+	static String get_exported_tokens_path(const String &p_path);
+	static bool is_exported_only(const String &p_path);
+	static Vector<uint8_t> encode_exported_tokens(const Vector<uint8_t> &p_token_stream);
+	// Parses the script at p_path, from its exported tokens if it has no source, or through the on-disk token cache.
+	static Error parse_script(GDScriptParser *p_parser, const String &p_path, const String &p_source);
 	static Ref<GDScript> get_shallow_script(const String &p_path, const String &p_owner = String());
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String());
 	static Error finish_compiling(const String &p_owner);
@@ -79,6 +79,79 @@ void GDScriptCompiler::_set_error(const String &p_error, const GDScriptParser::N
 	}
 }
 
+// Whether `target op= value` can be done by a validated operator writing straight into the target.
+// Limited to types stored inside the Variant, so the result can safely overwrite the left operand.
+static bool _can_operate_in_place(const GDScriptDataType &p_target, Variant::Operator p_operator, const GDScriptDataType &p_value) {
+	if (!p_target.has_type || p_target.kind != GDScriptDataType::BUILTIN || !p_value.has_type || p_value.kind != GDScriptDataType::BUILTIN) {
+		return false;
+	}
+	switch (p_target.builtin_type) {
+		case Variant::BOOL:
+		case Variant::INT:
+		case Variant::FLOAT:
+		case Variant::VECTOR2:
+		case Variant::VECTOR2I:
+		case Variant::RECT2:
+		case Variant::RECT2I:
+		case Variant::VECTOR3:
+		case Variant::VECTOR3I:
+		case Variant::PLANE:
+		case Variant::QUATERNION:
+		case Variant::COLOR:
+			break;
+		default:
+			return false;
+	}
+	if (Variant::get_operator_return_type(p_operator, p_target.builtin_type, p_value.builtin_type) != p_target.builtin_type) {
+		return false;
+	}
+	return Variant::get_validated_operator_evaluator(p_operator, p_target.builtin_type, p_value.builtin_type) != nullptr;
+}
+
+static bool _is_int32_range_argument(const GDScriptParser::ExpressionNode *p_argument, bool p_is_step) {
+	if (!p_argument->is_constant) {
+		// Checked at runtime.
+		return true;
+	}
+	int64_t value = p_argument->reduced_value;
+	if (p_is_step && value == 0) {
+		// Let range() report the error.
+		return false;
+	}
+	return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+// Non-constant `range()` calls with int arguments are iterated over their bounds (int, Vector2i or Vector3i),
+// like the analyzer does for constant ones, instead of allocating an array.
+static Variant::Type _get_range_bounds_type(const GDScriptParser::ExpressionNode *p_list) {
+	if (p_list == nullptr || p_list->type != GDScriptParser::Node::CALL || p_list->is_constant) {
+		return Variant::VARIANT_MAX;
+	}
+	const GDScriptParser::CallNode *call = static_cast<const GDScriptParser::CallNode *>(p_list);
+	if (call->is_super || call->get_callee_type() != GDScriptParser::Node::IDENTIFIER || static_cast<const GDScriptParser::IdentifierNode *>(call->callee)->name != SNAME("range")) {
+		return Variant::VARIANT_MAX;
+	}
+	for (int i = 0; i < call->arguments.size(); i++) {
+		GDScriptParser::DataType arg_type = call->arguments[i]->get_datatype();
+		if (!arg_type.is_hard_type() || arg_type.kind != GDScriptParser::DataType::BUILTIN || arg_type.builtin_type != Variant::INT) {
+			return Variant::VARIANT_MAX;
+		}
+		if (call->arguments.size() > 1 && !_is_int32_range_argument(call->arguments[i], i == 2)) {
+			return Variant::VARIANT_MAX;
+		}
+	}
+	switch (call->arguments.size()) {
+		case 1:
+			return Variant::INT;
+		case 2:
+			return Variant::VECTOR2I;
+		case 3:
+			return Variant::VECTOR3I;
+		default:
+			return Variant::VARIANT_MAX;
+	}
+}
+
 GDScriptDataType GDScriptCompiler::_gdtype_from_datatype(const GDScriptParser::DataType &p_datatype, GDScript *p_owner) const {
 	if (!p_datatype.is_set() || !p_datatype.is_hard_type()) {
 		return GDScriptDataType();
@@ -1080,6 +1153,18 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 				StringName name = static_cast<GDScriptParser::IdentifierNode *>(assignment->assignee)->name;
 
 				if (has_operation) {
+					GDScriptDataType member_type = _gdtype_from_datatype(assignment->assignee->get_datatype());
+					if (_can_operate_in_place(member_type, assignment->variant_op, assigned_value.type)) {
+						// Get, operate and set in a single instruction.
+						GDScriptCodeGenerator::Address member = codegen.add_temporary(member_type);
+						gen->write_set_member_with_operator(member, name, assignment->variant_op, assigned_value);
+						gen->pop_temporary();
+						if (assigned_value.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+							gen->pop_temporary();
+						}
+						return GDScriptCodeGenerator::Address();
+					}
+
 					GDScriptCodeGenerator::Address op_result = codegen.add_temporary(_gdtype_from_datatype(assignment->get_datatype()));
 					GDScriptCodeGenerator::Address member = codegen.add_temporary(_gdtype_from_datatype(assignment->assignee->get_datatype()));
 					gen->write_get_member(member, name);
@@ -1132,6 +1217,18 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 
 				GDScriptCodeGenerator::Address to_assign;
 				bool has_operation = assignment->operation != GDScriptParser::AssignmentNode::OP_NONE;
+
+				// Typed locals and plain members can be operated on in place, without a temporary and an assignment.
+				bool has_getter = is_member && codegen.script->member_indices[var_name].getter != StringName();
+				bool direct_target = target.mode == GDScriptCodeGenerator::Address::LOCAL_VARIABLE || (target.mode == GDScriptCodeGenerator::Address::MEMBER && !has_setter && !has_getter);
+				if (has_operation && direct_target && _can_operate_in_place(target.type, assignment->variant_op, assigned_value.type)) {
+					gen->write_binary_operator(target, assignment->variant_op, target, assigned_value);
+					if (assigned_value.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+						gen->pop_temporary();
+					}
+					return GDScriptCodeGenerator::Address();
+				}
+
 				if (has_operation) {
 					// Perform operation.
 					GDScriptCodeGenerator::Address op_result = codegen.add_temporary(_gdtype_from_datatype(assignment->get_datatype()));
@@ -1741,11 +1838,84 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				codegen.start_block();
 				GDScriptCodeGenerator::Address iterator = codegen.add_local(for_n->variable->name, _gdtype_from_datatype(for_n->variable->get_datatype()));
 
-				gen->start_for(iterator.type, _gdtype_from_datatype(for_n->list->get_datatype()));
+				GDScriptDataType list_type = _gdtype_from_datatype(for_n->list->get_datatype());
+				Variant::Type range_bounds_type = _get_range_bounds_type(for_n->list);
+				if (range_bounds_type == Variant::INT) {
+					list_type = GDScriptDataType();
+					list_type.has_type = true;
+					list_type.kind = GDScriptDataType::BUILTIN;
+					list_type.builtin_type = range_bounds_type;
+				} else if (range_bounds_type != Variant::VARIANT_MAX) {
+					// Holds either the bounds or the range() array, see below.
+					list_type = GDScriptDataType();
+				}
 
-				GDScriptCodeGenerator::Address list = _parse_expression(codegen, error, for_n->list);
-				if (error) {
-					return error;
+				gen->start_for(iterator.type, list_type);
+
+				GDScriptCodeGenerator::Address list;
+				if (range_bounds_type == Variant::VARIANT_MAX) {
+					list = _parse_expression(codegen, error, for_n->list);
+					if (error) {
+						return error;
+					}
+				} else {
+					const GDScriptParser::CallNode *range_call = static_cast<const GDScriptParser::CallNode *>(for_n->list);
+					if (range_bounds_type != Variant::INT) {
+						list = codegen.add_temporary(list_type);
+					}
+
+					Vector<GDScriptCodeGenerator::Address> bounds;
+					for (int j = 0; j < range_call->arguments.size(); j++) {
+						GDScriptCodeGenerator::Address arg = _parse_expression(codegen, error, range_call->arguments[j]);
+						if (error) {
+							return error;
+						}
+						bounds.push_back(arg);
+					}
+
+					if (range_bounds_type == Variant::INT) {
+						list = bounds[0];
+					} else {
+						// Vector2i and Vector3i bounds are 32-bit, so fall back to range() when a bound doesn't fit,
+						// or when the step is zero so that range() reports the error.
+						GDScriptDataType bool_type;
+						bool_type.has_type = true;
+						bool_type.kind = GDScriptDataType::BUILTIN;
+						bool_type.builtin_type = Variant::BOOL;
+						GDScriptCodeGenerator::Address in_range = codegen.add_temporary(bool_type);
+						GDScriptCodeGenerator::Address check = codegen.add_temporary(bool_type);
+						GDScriptCodeGenerator::Address int32_min = codegen.add_constant(INT32_MIN);
+						GDScriptCodeGenerator::Address int32_max = codegen.add_constant(INT32_MAX);
+
+						gen->write_assign_true(in_range);
+						for (int j = 0; j < bounds.size(); j++) {
+							if (range_call->arguments[j]->is_constant) {
+								continue;
+							}
+							gen->write_binary_operator(check, Variant::OP_GREATER_EQUAL, bounds[j], int32_min);
+							gen->write_binary_operator(in_range, Variant::OP_AND, in_range, check);
+							gen->write_binary_operator(check, Variant::OP_LESS_EQUAL, bounds[j], int32_max);
+							gen->write_binary_operator(in_range, Variant::OP_AND, in_range, check);
+							if (j == 2) {
+								gen->write_binary_operator(check, Variant::OP_NOT_EQUAL, bounds[j], codegen.add_constant(0));
+								gen->write_binary_operator(in_range, Variant::OP_AND, in_range, check);
+							}
+						}
+
+						gen->write_if(in_range);
+						gen->write_construct(list, range_bounds_type, bounds);
+						gen->write_else();
+						gen->write_call_gdscript_utility(list, GDScriptUtilityFunctions::get_function("range"), bounds);
+						gen->write_endif();
+
+						gen->pop_temporary(); // check
+						gen->pop_temporary(); // in_range
+						for (int j = 0; j < bounds.size(); j++) {
+							if (bounds[j].mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+								gen->pop_temporary();
+							}
+						}
+					}
 				}
 
 				gen->write_for_assignment(iterator, list);
@@ -155,6 +155,8 @@ void GDScriptParser::clear() {
 	for_completion = false;
 	errors.clear();
 	multiline_stack.clear();
+	dependency_paths.clear();
+	dependency_names.clear();
 }
 
 void GDScriptParser::push_error(const String &p_message, const Node *p_origin) {
@@ -340,7 +342,57 @@ Error GDScriptParser::parse(const String &p_source_code, const String &p_script_
 
 	tokenizer.set_source_code(source);
 	tokenizer.set_cursor_position(cursor_line, cursor_column);
+	tokenizer.set_recording(record_tokens && !for_completion);
 	script_path = p_script_path;
+	return _parse();
+}
+
+Error GDScriptParser::parse_binary(const Vector<uint8_t> &p_token_stream, const String &p_script_path) {
+	clear();
+
+	Error err = tokenizer.set_token_stream(p_token_stream);
+	if (err) {
+		return err;
+	}
+	tokenizer.set_recording(false);
+	script_path = p_script_path;
+	return _parse();
+}
+
+void GDScriptParser::_add_dependency_path(const String &p_path) {
+	if (p_path.is_empty()) {
+		return;
+	}
+	String path = p_path;
+	if (path.is_relative_path()) {
+		path = script_path.get_base_dir().plus_file(path);
+	}
+	dependency_paths.insert(path.simplify_path());
+}
+
+List<String> GDScriptParser::get_dependencies() const {
+	List<String> dependencies;
+	for (const String &E : dependency_paths) {
+		dependencies.push_back(E);
+	}
+	for (const StringName &E : dependency_names) {
+		if (!ScriptServer::is_global_class(E)) {
+			continue;
+		}
+		String path = ScriptServer::get_global_class_path(E);
+		if (path != script_path && !dependency_paths.has(path)) {
+			dependencies.push_back(path);
+		}
+	}
+	return dependencies;
+}
+
+Vector<uint8_t> GDScriptParser::get_token_stream(bool p_include_comments) const {
+	ERR_FAIL_COND_V_MSG(!record_tokens, Vector<uint8_t>(), "Token recording must be enabled before parsing.");
+	return tokenizer.get_recorded_stream(p_include_comments);
+}
+
+Error GDScriptParser::_parse() {
 	current = tokenizer.scan();
 	// Avoid error or newline as the first token.
 	// The latter can mess with the parser when opening files filled exclusively with comments and newlines.
@@ -681,6 +733,7 @@ void GDScriptParser::parse_extends() {
 			push_error(vformat(R"(Only strings or identifiers can be used after "extends", found "%s" instead.)", Variant::get_type_name(previous.literal.get_type())));
 		}
 		current_class->extends_path = previous.literal;
+		_add_dependency_path(current_class->extends_path);
 
 		if (!match(GDScriptTokenizer::Token::PERIOD)) {
 			return;
@@ -693,6 +746,7 @@ void GDScriptParser::parse_extends() {
 		return;
 	}
 	current_class->extends.push_back(previous.literal);
+	dependency_names.insert(previous.literal);
 
 	while (match(GDScriptTokenizer::Token::PERIOD)) {
 		make_completion_context(COMPLETION_INHERIT_TYPE, current_class, chain_index++);
@@ -2141,6 +2195,10 @@ GDScriptParser::ExpressionNode *GDScriptParser::parse_identifier(ExpressionNode
 	IdentifierNode *identifier = alloc_node<IdentifierNode>();
 	identifier->name = previous.get_identifier();
 
+	if (current_suite == nullptr || !current_suite->has_local(identifier->name)) {
+		dependency_names.insert(identifier->name);
+	}
+
 	if (current_suite != nullptr && current_suite->has_local(identifier->name)) {
 		const SuiteNode::Local &declaration = current_suite->get_local(identifier->name);
 
@@ -2878,6 +2936,8 @@ GDScriptParser::ExpressionNode *GDScriptParser::parse_preload(ExpressionNode *p_
 
 	if (preload->path == nullptr) {
 		push_error(R"(Expected resource path after "(".)");
+	} else if (preload->path->type == Node::LITERAL && static_cast<LiteralNode *>(preload->path)->value.get_type() == Variant::STRING) {
+		_add_dependency_path(static_cast<LiteralNode *>(preload->path)->value);
 	}
 
 	pop_completion_call();
@@ -1207,6 +1207,9 @@ private:
 #endif
 
 	GDScriptTokenizer tokenizer;
+	bool record_tokens = false;
+	Set<String> dependency_paths;
+	Set<StringName> dependency_names;
 	GDScriptTokenizer::Token previous;
 	GDScriptTokenizer::Token current;
 
@@ -1389,6 +1392,8 @@ private:
 	ExpressionNode *parse_yield(ExpressionNode *p_previous_operand, bool p_can_assign);
 	ExpressionNode *parse_invalid_token(ExpressionNode *p_previous_operand, bool p_can_assign);
 	TypeNode *parse_type(bool p_allow_void = false);
+	Error _parse();
+	void _add_dependency_path(const String &p_path);
 #ifdef TOOLS_ENABLED
 	// Doc comments.
 	int class_doc_line = 0x7FFFFFFF;
@@ -1399,6 +1404,10 @@ private:
 
 public:
 	Error parse(const String &p_source_code, const String &p_script_path, bool p_for_completion);
+	Error parse_binary(const Vector<uint8_t> &p_token_stream, const String &p_script_path);
+	// Keeps the scanned tokens so the parsed code can be saved as a token stream.
+	void set_record_tokens(bool p_record) { record_tokens = p_record; }
+	Vector<uint8_t> get_token_stream(bool p_include_comments = true) const;
 	ClassNode *get_tree() const { return head; }
 	bool is_tool() const { return _is_tool; }
 	static Variant::Type get_builtin_type(const StringName &p_type);
@@ -1408,10 +1417,8 @@ public:
 	void get_annotation_list(List<MethodInfo> *r_annotations) const;
 
 	const List<ParserError> &get_errors() const { return errors; }
-	const List<String> get_dependencies() const {
-		// TODO: Keep track of deps.
-		return List<String>();
-	}
+	// Scripts and resources referenced by path or by global class name, known without analyzing the code.
+	List<String> get_dependencies() const;
 #ifdef DEBUG_ENABLED
 	const List<GDScriptWarning> &get_warnings() const { return warnings; }
 	const Set<int> &get_unsafe_lines() const { return unsafe_lines; }
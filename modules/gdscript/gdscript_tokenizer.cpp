@@ -31,6 +31,8 @@
 #include "gdscript_tokenizer.h"
 
 #include "core/error/error_macros.h"
+#include "core/io/marshalls.h"
+#include "core/templates/hash_map.h"
 
 #ifdef TOOLS_ENABLED
 #include "editor/editor_settings.h"
@@ -220,6 +222,8 @@ String GDScriptTokenizer::get_token_name(Token::Type p_token_type) {
 }
 
 void GDScriptTokenizer::set_source_code(const String &p_source_code) {
+	replay_tokens.clear();
+	replay_position = -1;
 	source = p_source_code;
 	if (source.is_empty()) {
 		_source = U"";
@@ -233,6 +237,225 @@ void GDScriptTokenizer::set_source_code(const String &p_source_code) {
 	position = 0;
 }
 
+void GDScriptTokenizer::set_recording(bool p_recording) {
+	recording = p_recording;
+	recorded_tokens.clear();
+}
+
+static void _put_u32(Vector<uint8_t> &r_stream, uint32_t p_value) {
+	int pos = r_stream.size();
+	r_stream.resize(pos + 4);
+	encode_uint32(p_value, r_stream.ptrw() + pos);
+}
+
+static void _put_bytes(Vector<uint8_t> &r_stream, const uint8_t *p_bytes, int p_length) {
+	_put_u32(r_stream, p_length);
+	int pos = r_stream.size();
+	r_stream.resize(pos + p_length);
+	memcpy(r_stream.ptrw() + pos, p_bytes, p_length);
+}
+
+// Layout: version, token type count, then tables of strings, literals, tokens and doc comments.
+// Token sources are deduplicated in the string table; identifier and annotation literals are rebuilt from them.
+Vector<uint8_t> GDScriptTokenizer::get_recorded_stream(bool p_include_comments) const {
+	HashMap<String, uint32_t> string_map;
+	Vector<String> strings;
+	Vector<Variant> literals;
+	Vector<uint32_t> token_data;
+
+	for (int i = 0; i < recorded_tokens.size(); i++) {
+		const Token &token = recorded_tokens[i];
+		ERR_FAIL_COND_V_MSG(token.type == Token::ERROR, Vector<uint8_t>(), "Can't record a token stream with errors.");
+
+		const uint32_t *string_index = string_map.getptr(token.source);
+		if (string_index == nullptr) {
+			string_map[token.source] = strings.size();
+			string_index = string_map.getptr(token.source);
+			strings.push_back(token.source);
+		}
+
+		uint32_t literal_index = UINT32_MAX;
+		if (token.type == Token::LITERAL) {
+			literal_index = literals.size();
+			literals.push_back(token.literal);
+		}
+
+		token_data.push_back(token.type);
+		token_data.push_back(*string_index);
+		token_data.push_back(literal_index);
+		token_data.push_back(token.start_line);
+		token_data.push_back(token.end_line);
+		token_data.push_back(token.start_column);
+		token_data.push_back(token.end_column);
+		token_data.push_back(token.leftmost_column);
+		token_data.push_back(token.rightmost_column);
+	}
+
+	Vector<uint8_t> stream;
+	_put_u32(stream, TOKEN_STREAM_VERSION);
+	_put_u32(stream, Token::TK_MAX);
+
+	_put_u32(stream, strings.size());
+	for (int i = 0; i < strings.size(); i++) {
+		CharString utf8 = strings[i].utf8();
+		_put_bytes(stream, (const uint8_t *)utf8.get_data(), utf8.length());
+	}
+
+	_put_u32(stream, literals.size());
+	for (int i = 0; i < literals.size(); i++) {
+		int length = 0;
+		Error err = encode_variant(literals[i], nullptr, length);
+		ERR_FAIL_COND_V(err != OK, Vector<uint8_t>());
+		Vector<uint8_t> encoded;
+		encoded.resize(length);
+		encode_variant(literals[i], encoded.ptrw(), length);
+		_put_bytes(stream, encoded.ptr(), length);
+	}
+
+	_put_u32(stream, recorded_tokens.size());
+	for (int i = 0; i < token_data.size(); i++) {
+		_put_u32(stream, token_data[i]);
+	}
+
+#ifdef TOOLS_ENABLED
+	if (p_include_comments) {
+		_put_u32(stream, comments.size());
+		for (const KeyValue<int, CommentData> &E : comments) {
+			_put_u32(stream, E.key);
+			_put_u32(stream, E.value.new_line);
+			CharString utf8 = E.value.comment.utf8();
+			_put_bytes(stream, (const uint8_t *)utf8.get_data(), utf8.length());
+		}
+	} else {
+		_put_u32(stream, 0);
+	}
+#else
+	_put_u32(stream, 0);
+#endif // TOOLS_ENABLED
+
+	return stream;
+}
+
+struct TokenStreamReader {
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t position = 0;
+	bool error = false;
+
+	uint32_t get_u32() {
+		if (error || size - position < 4) {
+			error = true;
+			return 0;
+		}
+		uint32_t value = decode_uint32(data + position);
+		position += 4;
+		return value;
+	}
+
+	const uint8_t *get_bytes(uint32_t &r_length) {
+		r_length = get_u32();
+		if (error || size - position < r_length) {
+			error = true;
+			return nullptr;
+		}
+		const uint8_t *bytes = data + position;
+		position += r_length;
+		return bytes;
+	}
+
+	String get_string() {
+		uint32_t length = 0;
+		const uint8_t *bytes = get_bytes(length);
+		String string;
+		if (bytes != nullptr && string.parse_utf8((const char *)bytes, length)) {
+			error = true;
+		}
+		return string;
+	}
+};
+
+Error GDScriptTokenizer::set_token_stream(const Vector<uint8_t> &p_stream) {
+	TokenStreamReader reader;
+	reader.data = p_stream.ptr();
+	reader.size = p_stream.size();
+
+	ERR_FAIL_COND_V_MSG(reader.get_u32() != TOKEN_STREAM_VERSION || reader.get_u32() != Token::TK_MAX, ERR_INVALID_DATA, "Unsupported GDScript token stream version.");
+
+	Vector<String> strings;
+	uint32_t string_count = reader.get_u32();
+	for (uint32_t i = 0; i < string_count && !reader.error; i++) {
+		strings.push_back(reader.get_string());
+	}
+
+	Vector<Variant> literals;
+	uint32_t literal_count = reader.get_u32();
+	for (uint32_t i = 0; i < literal_count && !reader.error; i++) {
+		uint32_t length = 0;
+		const uint8_t *bytes = reader.get_bytes(length);
+		Variant literal;
+		if (bytes == nullptr || decode_variant(literal, bytes, length) != OK) {
+			reader.error = true;
+			break;
+		}
+		literals.push_back(literal);
+	}
+
+	replay_tokens.clear();
+	uint32_t token_count = reader.get_u32();
+	for (uint32_t i = 0; i < token_count && !reader.error; i++) {
+		Token token((Token::Type)reader.get_u32());
+		uint32_t string_index = reader.get_u32();
+		uint32_t literal_index = reader.get_u32();
+		token.start_line = reader.get_u32();
+		token.end_line = reader.get_u32();
+		token.start_column = reader.get_u32();
+		token.end_column = reader.get_u32();
+		token.leftmost_column = reader.get_u32();
+		token.rightmost_column = reader.get_u32();
+
+		if (token.type >= Token::TK_MAX || token.type == Token::ERROR || string_index >= (uint32_t)strings.size() || (literal_index != UINT32_MAX && literal_index >= (uint32_t)literals.size())) {
+			reader.error = true;
+			break;
+		}
+		token.source = strings[string_index];
+		if (literal_index != UINT32_MAX) {
+			token.literal = literals[literal_index];
+		} else if (token.type == Token::IDENTIFIER || token.type == Token::ANNOTATION) {
+			token.literal = StringName(token.source);
+		}
+		replay_tokens.push_back(token);
+	}
+
+#ifdef TOOLS_ENABLED
+	comments.clear();
+#endif // TOOLS_ENABLED
+	uint32_t comment_count = reader.get_u32();
+	for (uint32_t i = 0; i < comment_count && !reader.error; i++) {
+		int comment_line = reader.get_u32();
+		bool new_line = reader.get_u32();
+		String comment = reader.get_string();
+#ifdef TOOLS_ENABLED
+		comments[comment_line] = CommentData(comment, new_line);
+#else
+		(void)comment_line;
+		(void)new_line;
+#endif // TOOLS_ENABLED
+	}
+
+	if (reader.error || replay_tokens.is_empty() || replay_tokens[replay_tokens.size() - 1].type != Token::TK_EOF) {
+		replay_tokens.clear();
+		ERR_FAIL_V_MSG(ERR_INVALID_DATA, "Corrupted GDScript token stream.");
+	}
+
+	source = String();
+	_source = U"";
+	_current = _source;
+	length = 0;
+	position = 0;
+	replay_position = 0;
+	return OK;
+}
+
 void GDScriptTokenizer::set_cursor_position(int p_line, int p_column) {
 	cursor_line = p_line;
 	cursor_column = p_column;
@@ -1237,6 +1460,21 @@ void GDScriptTokenizer::_skip_whitespace() {
 }
 
 GDScriptTokenizer::Token GDScriptTokenizer::scan() {
+	if (replay_position >= 0) {
+		// The stream ends with an EOF token, which is returned again if the parser asks for more.
+		Token token = replay_tokens[MIN(replay_position, replay_tokens.size() - 1)];
+		replay_position++;
+		return token;
+	}
+
+	Token token = _scan();
+	if (recording) {
+		recorded_tokens.push_back(token);
+	}
+	return token;
+}
+
+GDScriptTokenizer::Token GDScriptTokenizer::_scan() {
 	if (has_error()) {
 		return pop_error();
 	}
@@ -1301,7 +1539,7 @@ GDScriptTokenizer::Token GDScriptTokenizer::scan() {
 		_advance();
 		newline(false);
 		line_continuation = true;
-		return scan(); // Recurse to get next token.
+		return _scan(); // Recurse to get next token.
 	}
 
 	line_continuation = false;
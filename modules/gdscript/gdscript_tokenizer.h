@@ -39,6 +39,10 @@
 
 class GDScriptTokenizer {
 public:
+	enum {
+		TOKEN_STREAM_VERSION = 1,
+	};
+
 	enum CursorPlace {
 		CURSOR_NONE,
 		CURSOR_BEGINNING,
@@ -227,6 +231,12 @@ private:
 	Map<int, CommentData> comments;
 #endif // TOOLS_ENABLED
 
+	// Token streams recorded while parsing, and replayed instead of scanning source code.
+	bool recording = false;
+	Vector<Token> recorded_tokens;
+	Vector<Token> replay_tokens;
+	int replay_position = -1;
+
 	_FORCE_INLINE_ bool _is_at_end() { return position >= length; }
 	_FORCE_INLINE_ char32_t _peek(int p_offset = 0) { return position + p_offset >= 0 && position + p_offset < length ? _current[p_offset] : '\0'; }
 	int indent_level() const { return indent_stack.size(); }
@@ -253,12 +263,17 @@ private:
 	Token potential_identifier();
 	Token string();
 	Token annotation();
+	Token _scan();
 
 public:
 	Token scan();
 
 	void set_source_code(const String &p_source_code);
 
+	void set_recording(bool p_recording);
+	Vector<uint8_t> get_recorded_stream(bool p_include_comments = true) const;
+	Error set_token_stream(const Vector<uint8_t> &p_stream);
+
 	int get_cursor_line() const;
 	int get_cursor_column() const;
 	void set_cursor_position(int p_line, int p_column);
@@ -37,6 +37,7 @@
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
 #include "gdscript_cache.h"
+#include "gdscript_parser.h"
 #include "gdscript_tokenizer.h"
 #include "gdscript_utility_functions.h"
 
@@ -85,8 +86,16 @@ public:
 			return;
 		}
 
-		// TODO: Re-add compiled GDScript on export.
-		return;
+		String source = FileAccess::get_file_as_string(p_path);
+		GDScriptParser parser;
+		parser.set_record_tokens(true);
+		if (parser.parse(source, p_path, false) != OK) {
+			// Export the source as is, so the errors are reported when running the project.
+			return;
+		}
+
+		add_file(GDScriptCache::get_exported_tokens_path(p_path), GDScriptCache::encode_exported_tokens(parser.get_token_stream(false)), true);
+		skip();
 	}
 };
 
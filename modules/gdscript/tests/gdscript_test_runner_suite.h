@@ -32,6 +32,16 @@
 #define GDSCRIPT_TEST_RUNNER_SUITE_H
 
 #include "gdscript_test_runner.h"
+
+#include "../gdscript_analyzer.h"
+#include "../gdscript_cache.h"
+#include "../gdscript_compiler.h"
+#include "../gdscript_parser.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
 #include "tests/test_macros.h"
 
 namespace GDScriptTests {
@@ -69,6 +79,312 @@ func _init():
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
 
+TEST_CASE("[Modules][GDScript] Compile and run a script from its token stream") {
+	const String source = R"(
+extends RefCounted
+
+## Doc comments are kept in the stream.
+var values := [1, 2, 3]
+
+func _init():
+	var total := 0
+	for value in values:
+		total += value * (2 if value > 1 else 1)
+	set_meta("result", total)
+	set_meta("name", &"token")
+	var add_one := func(x): return x + 1
+	set_meta("lambda", add_one.call(41))
+)";
+
+	GDScriptParser parser;
+	parser.set_record_tokens(true);
+	REQUIRE_MESSAGE(parser.parse(source, "res://token_stream.gd", false) == OK, "The script should parse successfully.");
+	const Vector<uint8_t> token_stream = parser.get_token_stream();
+	REQUIRE_FALSE(token_stream.is_empty());
+
+	GDScriptParser binary_parser;
+	REQUIRE_MESSAGE(binary_parser.parse_binary(token_stream, "res://token_stream.gd") == OK, "The token stream should parse successfully.");
+	GDScriptAnalyzer analyzer(&binary_parser);
+	REQUIRE(analyzer.analyze() == OK);
+
+	Ref<GDScript> gdscript = memnew(GDScript);
+	GDScriptCompiler compiler;
+	REQUIRE(compiler.compile(&binary_parser, gdscript.ptr(), false) == OK);
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+	CHECK(int(ref_counted->get_meta("result")) == 11);
+	CHECK(ref_counted->get_meta("name").get_type() == Variant::STRING_NAME);
+	CHECK(int(ref_counted->get_meta("lambda")) == 42);
+
+	ERR_PRINT_OFF;
+	GDScriptParser corrupted_parser;
+	CHECK_MESSAGE(corrupted_parser.parse_binary(token_stream.slice(0, token_stream.size() / 2), "res://token_stream.gd") != OK, "Truncated token streams should be rejected.");
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Modules][GDScript] Dependencies are known after parsing") {
+	GDScriptParser parser;
+	const Error error = parser.parse(R"(
+extends "base.gd"
+
+const Other = preload("../other.gd")
+const Texture = preload("res://icon.png")
+
+func _init():
+	var path := "not_a_dependency.gd"
+	print(path)
+)",
+			"res://scripts/main.gd", false);
+	REQUIRE(error == OK);
+
+	List<String> dependencies = parser.get_dependencies();
+	CHECK(dependencies.size() == 3);
+	CHECK(dependencies.find("res://scripts/base.gd") != nullptr);
+	CHECK(dependencies.find("res://other.gd") != nullptr);
+	CHECK(dependencies.find("res://icon.png") != nullptr);
+}
+
+// Two scripts that share a base and a chain of preloaded dependencies, written to p_dir.
+static void _write_dependency_graph(const String &p_dir) {
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	REQUIRE(da->make_dir_recursive(p_dir) == OK);
+	const char *scripts[][2] = {
+		{ "base.gd", "extends RefCounted\nfunc value() -> int:\n\treturn 0\n" },
+		{ "leaf.gd", "const VALUE = 10\n" },
+		{ "middle.gd", "const Leaf = preload(\"leaf.gd\")\nconst VALUE = Leaf.VALUE * 2\n" },
+		{ "main_a.gd", "extends \"base.gd\"\nconst Middle = preload(\"middle.gd\")\nfunc value() -> int:\n\treturn Middle.VALUE + 1\n" },
+		{ "main_b.gd", "extends \"base.gd\"\nconst Leaf = preload(\"leaf.gd\")\nfunc value() -> int:\n\treturn Leaf.VALUE + 2\n" },
+	};
+	for (const auto &script : scripts) {
+		FileAccessRef f = FileAccess::open(p_dir.plus_file(script[0]), FileAccess::WRITE);
+		REQUIRE(f);
+		f->store_string(script[1]);
+	}
+}
+
+static int _get_script_value(const Ref<GDScript> &p_script) {
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(p_script);
+	return ref_counted->call("value");
+}
+
+struct DependencyGraphLoader {
+	String paths[2];
+	Ref<GDScript> scripts[2];
+	Error errors[2] = { FAILED, FAILED };
+
+	void load(uint32_t p_index, void *p_userdata) {
+		scripts[p_index] = GDScriptCache::get_full_script(paths[p_index], errors[p_index]);
+	}
+};
+
+TEST_CASE("[Modules][GDScript] Scripts are compiled after their dependency graph is parsed") {
+	init_language("modules/gdscript/tests/scripts");
+
+	SUBCASE("From the calling thread") {
+		const String dir = OS::get_singleton()->get_cache_path().plus_file("gdscript_dependency_graph_serial");
+		_write_dependency_graph(dir);
+
+		Error err = FAILED;
+		Ref<GDScript> script = GDScriptCache::get_full_script(dir.plus_file("main_a.gd"), err);
+		REQUIRE(err == OK);
+		CHECK(script->is_valid());
+		CHECK(_get_script_value(script) == 21);
+	}
+
+	SUBCASE("From worker threads sharing dependencies") {
+		// Each load parses its graph on the pool and waits for it without the cache lock,
+		// so the waiting thread can also run the other load.
+		const String dir = OS::get_singleton()->get_cache_path().plus_file("gdscript_dependency_graph_threaded");
+		_write_dependency_graph(dir);
+
+		DependencyGraphLoader loader;
+		loader.paths[0] = dir.plus_file("main_a.gd");
+		loader.paths[1] = dir.plus_file("main_b.gd");
+		WorkerThreadPool::get_singleton()->do_work(2, &loader, &DependencyGraphLoader::load, (void *)nullptr);
+
+		REQUIRE(loader.errors[0] == OK);
+		REQUIRE(loader.errors[1] == OK);
+		CHECK(_get_script_value(loader.scripts[0]) == 21);
+		CHECK(_get_script_value(loader.scripts[1]) == 12);
+	}
+
+	finish_language();
+}
+
+TEST_CASE("[Modules][GDScript][Benchmark] Typed micro-kernels" * doctest::skip()) {
+	// Run with `--test --no-skip --test-case="*Typed micro-kernels*"` to track VM throughput.
+	// The case usually runs on its own, so the language isn't set up by the script runner.
+	init_language("modules/gdscript/tests/scripts");
+
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+var member: int = 0
+
+func int_loop(n: int) -> int:
+	var total: int = 0
+	var i: int = 0
+	while i < n:
+		total += i
+		i += 1
+	return total
+
+func float_loop(n: int) -> float:
+	var total: float = 0.0
+	for i in range(n):
+		total += 0.5 * i
+	return total
+
+func vector_loop(n: int) -> Vector2:
+	var total := Vector2()
+	for i in range(0, n):
+		total += Vector2(i, 1.0)
+	return total
+
+func member_loop(n: int) -> int:
+	for _i in n:
+		member += 1
+	return member
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The benchmark script should parse successfully.");
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	const int iterations = 1000000;
+	const char *kernels[] = { "int_loop", "float_loop", "vector_loop", "member_loop" };
+	for (const char *kernel : kernels) {
+		const uint64_t start = OS::get_singleton()->get_ticks_usec();
+		ref_counted->call(kernel, iterations);
+		const uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - start, (uint64_t)1);
+		print_line(vformat("%s: %d iterations/s", kernel, (int64_t)(iterations * 1000000.0 / elapsed)));
+	}
+
+	ref_counted->set_script(Variant());
+	gdscript.unref();
+	finish_language();
+}
+
+struct StartupBenchmarkScript {
+	String path;
+	String source;
+	Vector<uint8_t> token_stream;
+};
+
+static void _collect_startup_benchmark_scripts(const String &p_dir, LocalVector<StartupBenchmarkScript> &r_scripts) {
+	DirAccessRef dir(DirAccess::open(p_dir));
+	if (!dir) {
+		return;
+	}
+	const String current_dir = dir->get_current_dir();
+	dir->list_dir_begin();
+	for (String next = dir->get_next(); !next.is_empty(); next = dir->get_next()) {
+		if (dir->current_is_dir()) {
+			if (next != "." && next != "..") {
+				_collect_startup_benchmark_scripts(current_dir.plus_file(next), r_scripts);
+			}
+			continue;
+		}
+		if (next.get_extension().to_lower() != "gd") {
+			continue;
+		}
+
+		// Only scripts that make it through the whole pipeline are timed.
+		StartupBenchmarkScript script;
+		script.path = current_dir.plus_file(next);
+		script.source = FileAccess::get_file_as_string(script.path);
+		GDScriptParser parser;
+		parser.set_record_tokens(true);
+		if (parser.parse(script.source, script.path, false) != OK) {
+			continue;
+		}
+		GDScriptAnalyzer analyzer(&parser);
+		if (analyzer.analyze() != OK) {
+			continue;
+		}
+		Ref<GDScript> gdscript;
+		gdscript.instantiate();
+		GDScriptCompiler compiler;
+		if (compiler.compile(&parser, gdscript.ptr(), false) != OK) {
+			continue;
+		}
+		script.token_stream = parser.get_token_stream();
+		r_scripts.push_back(script);
+	}
+}
+
+TEST_CASE("[Modules][GDScript][Benchmark] Script loading stages with and without the token cache" * doctest::skip()) {
+	// Run with `--test --no-skip --test-case="*Script loading stages*"` to see which stages dominate startup.
+	// The token cache only replaces scanning: a cached load still hashes the source and parses,
+	// analyzes and compiles the script, exactly like GDScriptCache::parse_script() does.
+	init_language("modules/gdscript/tests/scripts");
+
+	LocalVector<StartupBenchmarkScript> scripts;
+	ERR_PRINT_OFF;
+	_collect_startup_benchmark_scripts("modules/gdscript/tests/scripts", scripts);
+	ERR_PRINT_ON;
+	REQUIRE_FALSE(scripts.is_empty());
+
+	const int rounds = 10;
+	uint64_t source_parse_usec = 0;
+	uint64_t source_hash_usec = 0;
+	uint64_t token_parse_usec = 0;
+	uint64_t analyze_usec = 0;
+	uint64_t compile_usec = 0;
+
+	ERR_PRINT_OFF;
+	for (int round = 0; round < rounds; round++) {
+		for (uint32_t i = 0; i < scripts.size(); i++) {
+			const StartupBenchmarkScript &script = scripts[i];
+			GDScriptParser source_parser;
+			uint64_t start = OS::get_singleton()->get_ticks_usec();
+			source_parser.parse(script.source, script.path, false);
+			source_parse_usec += OS::get_singleton()->get_ticks_usec() - start;
+
+			start = OS::get_singleton()->get_ticks_usec();
+			const String source_hash = script.source.md5_text();
+			source_hash_usec += OS::get_singleton()->get_ticks_usec() - start;
+
+			GDScriptParser parser;
+			start = OS::get_singleton()->get_ticks_usec();
+			parser.parse_binary(script.token_stream, script.path);
+			token_parse_usec += OS::get_singleton()->get_ticks_usec() - start;
+
+			GDScriptAnalyzer analyzer(&parser);
+			start = OS::get_singleton()->get_ticks_usec();
+			analyzer.analyze();
+			analyze_usec += OS::get_singleton()->get_ticks_usec() - start;
+
+			Ref<GDScript> gdscript;
+			gdscript.instantiate();
+			GDScriptCompiler compiler;
+			start = OS::get_singleton()->get_ticks_usec();
+			compiler.compile(&parser, gdscript.ptr(), false);
+			compile_usec += OS::get_singleton()->get_ticks_usec() - start;
+		}
+	}
+	ERR_PRINT_ON;
+
+	const uint64_t uncached_usec = source_parse_usec + analyze_usec + compile_usec;
+	const uint64_t cached_usec = source_hash_usec + token_parse_usec + analyze_usec + compile_usec;
+	print_line(vformat("%d scripts, %d rounds", (int64_t)scripts.size(), rounds));
+	print_line(vformat("Scan and parse source: %.1f ms", source_parse_usec / 1000.0));
+	print_line(vformat("Hash source: %.1f ms", source_hash_usec / 1000.0));
+	print_line(vformat("Parse tokens: %.1f ms", token_parse_usec / 1000.0));
+	print_line(vformat("Analyze: %.1f ms", analyze_usec / 1000.0));
+	print_line(vformat("Compile: %.1f ms", compile_usec / 1000.0));
+	print_line(vformat("Load without the token cache: %.1f ms, with it: %.1f ms (%.1f%% saved)", uncached_usec / 1000.0, cached_usec / 1000.0, 100.0 * (double(uncached_usec) - double(cached_usec)) / MAX(uncached_usec, (uint64_t)1)));
+
+	scripts.clear();
+	finish_language();
+}
+
 } // namespace GDScriptTests
 
 #endif // GDSCRIPT_TEST_RUNNER_SUITE_H
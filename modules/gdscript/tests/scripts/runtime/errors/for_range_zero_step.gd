@@ -0,0 +1,5 @@
+#debug-only
+func test():
+	var step: int = 0
+	for i in range(0, 4, step):
+		print(i)
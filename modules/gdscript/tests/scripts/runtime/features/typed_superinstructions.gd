@@ -0,0 +1,53 @@
+extends Node
+
+var counter: int = 0
+var offset: Vector2 = Vector2.ZERO
+var ratio: float = 1.0
+
+func test():
+	var total: int = 0
+	var i: int = 0
+	while i < 10:
+		total += i
+		i += 1
+	print(total)
+
+	var n: int = 5
+	for j in range(n):
+		counter += j
+	print(counter)
+
+	var from: int = 2
+	var to: int = 6
+	for j in range(from, to):
+		offset += Vector2(j, -j)
+	print(offset)
+
+	for j in range(to, from, -2):
+		ratio *= 2.0
+		print(j)
+	print(ratio)
+
+	var empty: int = 0
+	for j in range(empty):
+		print("unreachable")
+
+	# Bounds past 32 bits go through range() instead of Vector2i.
+	var big: int = 1 << 40
+	var steps: int = 0
+	for j in range(big - 2, big):
+		steps += 1
+	print(steps)
+
+	process_priority += 3
+	process_priority *= 2
+	print(process_priority)
+
+	var a: float = 1.5
+	var b: float = 2.5
+	if a < b:
+		print("less")
+	if not (a > b):
+		print("not greater")
+	if a + b == 4.0:
+		print("sum")
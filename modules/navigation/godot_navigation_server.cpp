@@ -114,6 +114,19 @@ GodotNavigationServer::GodotNavigationServer() :
 }
 
 GodotNavigationServer::~GodotNavigationServer() {
+	if (path_query_group != WorkerThreadPool::INVALID_GROUP_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(path_query_group);
+	}
+	for (uint32_t i = 0; i < running_path_query_batches.size(); i++) {
+		memdelete(running_path_query_batches[i]);
+	}
+	for (uint32_t i = 0; i < pending_path_query_batches.size(); i++) {
+		memdelete(pending_path_query_batches[i]);
+	}
+	const uint32_t *ticket = nullptr;
+	while ((ticket = finished_path_query_batches.next(ticket))) {
+		memdelete(finished_path_query_batches[*ticket]);
+	}
 	flush_queries();
 }
 
@@ -207,6 +220,139 @@ Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin,
 	return map->get_path(p_origin, p_destination, p_optimize, p_layers);
 }
 
+uint32_t GodotNavigationServer::map_query_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, uint32_t p_layers, const Callable &p_callback) const {
+	ERR_FAIL_COND_V(!map_owner.owns(p_map), 0);
+	ERR_FAIL_COND_V_MSG(p_origins.size() != p_destinations.size(), 0, "There must be as many origins as destinations.");
+
+	PathQueryBatch *batch = memnew(PathQueryBatch);
+	batch->map = p_map;
+	batch->origins = p_origins;
+	batch->destinations = p_destinations;
+	batch->optimize = p_optimize;
+	batch->layers = p_layers;
+	batch->callback = p_callback;
+
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+	// Skip 0, which is never a valid ticket.
+	mut_this->last_path_query_ticket = MAX(last_path_query_ticket + 1, 1u);
+	batch->ticket = last_path_query_ticket;
+	mut_this->pending_path_query_batches.push_back(batch);
+	return batch->ticket;
+}
+
+bool GodotNavigationServer::path_query_is_done(uint32_t p_ticket) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+	return finished_path_query_batches.has(p_ticket);
+}
+
+Array GodotNavigationServer::path_query_get_paths(uint32_t p_ticket) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+	PathQueryBatch **batch = mut_this->finished_path_query_batches.getptr(p_ticket);
+	ERR_FAIL_COND_V_MSG(batch == nullptr, Array(), "The path queries are not done yet, or their paths were already collected.");
+
+	Array paths;
+	paths.resize((*batch)->paths.size());
+	for (uint32_t i = 0; i < (*batch)->paths.size(); i++) {
+		paths[i] = (*batch)->paths[i];
+	}
+
+	memdelete(*batch);
+	mut_this->finished_path_query_batches.erase(p_ticket);
+	return paths;
+}
+
+void GodotNavigationServer::_run_path_query(uint32_t p_index, PathQuery *p_queries) {
+	const PathQuery &query = p_queries[p_index];
+	const PathQueryBatch *batch = query.batch;
+	if (query.map) {
+		query.batch->paths[query.index] = query.map->get_path(batch->origins[query.index], batch->destinations[query.index], batch->optimize, batch->layers);
+	}
+}
+
+void GodotNavigationServer::_dispatch_path_queries() {
+	{
+		MutexLock lock(path_queries_mutex);
+		running_path_query_batches = pending_path_query_batches;
+		pending_path_query_batches.clear();
+	}
+
+	if (running_path_query_batches.is_empty()) {
+		return;
+	}
+
+	// The maps only change during `process`, which waits for the queries to
+	// finish first, so they can safely be read by the workers until then.
+	for (uint32_t i = 0; i < running_path_query_batches.size(); i++) {
+		PathQueryBatch *batch = running_path_query_batches[i];
+		batch->paths.resize(batch->origins.size());
+
+		PathQuery query;
+		query.batch = batch;
+		query.map = map_owner.get_or_null(batch->map);
+		for (int j = 0; j < batch->origins.size(); j++) {
+			query.index = j;
+			running_path_queries.push_back(query);
+		}
+	}
+
+	if (running_path_queries.is_empty()) {
+		return;
+	}
+
+	path_query_group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotNavigationServer::_run_path_query, running_path_queries.ptr(), running_path_queries.size());
+}
+
+void GodotNavigationServer::_finish_path_queries() {
+	if (path_query_group != WorkerThreadPool::INVALID_GROUP_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(path_query_group);
+		path_query_group = WorkerThreadPool::INVALID_GROUP_ID;
+	}
+	running_path_queries.clear();
+
+	if (running_path_query_batches.is_empty()) {
+		return;
+	}
+
+	{
+		MutexLock lock(path_queries_mutex);
+		for (uint32_t i = 0; i < running_path_query_batches.size(); i++) {
+			finished_path_query_batches[running_path_query_batches[i]->ticket] = running_path_query_batches[i];
+		}
+	}
+
+	// The paths of the batches with a callback are only kept during the callback.
+	for (uint32_t i = 0; i < running_path_query_batches.size(); i++) {
+		const Callable callback = running_path_query_batches[i]->callback;
+		if (callback.is_null()) {
+			continue;
+		}
+
+		const uint32_t ticket = running_path_query_batches[i]->ticket;
+		// The receiver may have been freed while the queries were running.
+		if (callback.is_valid()) {
+			const Variant ticket_variant = ticket;
+			const Variant *args[1] = { &ticket_variant };
+			Variant ret;
+			Callable::CallError ce;
+			callback.call(args, 1, ret, ce);
+			if (ce.error != Callable::CallError::CALL_OK) {
+				ERR_PRINT("Error calling path query callback method: " + Variant::get_callable_error_text(callback, args, 1, ce));
+			}
+		}
+
+		MutexLock lock(path_queries_mutex);
+		PathQueryBatch **batch = finished_path_query_batches.getptr(ticket);
+		if (batch) {
+			memdelete(*batch);
+			finished_path_query_batches.erase(ticket);
+		}
+	}
+	running_path_query_batches.clear();
+}
+
 Vector3 GodotNavigationServer::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
@@ -515,9 +661,13 @@ void GodotNavigationServer::flush_queries() {
 }
 
 void GodotNavigationServer::process(real_t p_delta_time) {
+	// The path queries read the maps, finish them before any change.
+	_finish_path_queries();
+
 	flush_queries();
 
 	if (!active) {
+		_dispatch_path_queries();
 		return;
 	}
 
@@ -536,6 +686,31 @@ void GodotNavigationServer::process(real_t p_delta_time) {
 			active_maps_update_id[i] = new_map_update_id;
 		}
 	}
+	_dispatch_path_queries();
+}
+
+int GodotNavigationServer::get_process_info(ProcessInfo p_info) const {
+	switch (p_info) {
+		case INFO_ACTIVE_MAPS: {
+			return active_maps.size();
+		} break;
+		case INFO_POLYGON_COUNT: {
+			int polygon_count = 0;
+			for (uint32_t i(0); i < active_maps.size(); i++) {
+				polygon_count += active_maps[i]->get_polygon_count();
+			}
+			return polygon_count;
+		} break;
+		case INFO_SYNC_TIME_USEC: {
+			uint64_t sync_usec = 0;
+			for (uint32_t i(0); i < active_maps.size(); i++) {
+				sync_usec += active_maps[i]->get_last_sync_usec();
+			}
+			return sync_usec;
+		} break;
+	}
+
+	return 0;
 }
 
 #undef COMMAND_1
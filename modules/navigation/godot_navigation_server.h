@@ -31,6 +31,8 @@
 #ifndef GODOT_NAVIGATION_SERVER_H
 #define GODOT_NAVIGATION_SERVER_H
 
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
@@ -79,6 +81,40 @@ class GodotNavigationServer : public NavigationServer3D {
 	LocalVector<NavMap *> active_maps;
 	LocalVector<uint32_t> active_maps_update_id;
 
+	/// A batch of asynchronous path queries.
+	struct PathQueryBatch {
+		uint32_t ticket = 0;
+		RID map;
+		Vector<Vector3> origins;
+		Vector<Vector3> destinations;
+		bool optimize = true;
+		uint32_t layers = 1;
+		Callable callback;
+		LocalVector<Vector<Vector3>> paths;
+	};
+
+	struct PathQuery {
+		PathQueryBatch *batch = nullptr;
+		const NavMap *map = nullptr;
+		uint32_t index = 0;
+	};
+
+	/// Protects the path query batches, which can be submitted and collected from any thread.
+	Mutex path_queries_mutex;
+	uint32_t last_path_query_ticket = 0;
+	/// Batches waiting for the next `sync`.
+	LocalVector<PathQueryBatch *> pending_path_query_batches;
+	/// Batches processed by `path_query_group` until the next `process`.
+	LocalVector<PathQueryBatch *> running_path_query_batches;
+	LocalVector<PathQuery> running_path_queries;
+	/// Processed batches, until their results are collected.
+	HashMap<uint32_t, PathQueryBatch *> finished_path_query_batches;
+	WorkerThreadPool::GroupID path_query_group = WorkerThreadPool::INVALID_GROUP_ID;
+
+	void _run_path_query(uint32_t p_index, PathQuery *p_queries);
+	void _dispatch_path_queries();
+	void _finish_path_queries();
+
 public:
 	GodotNavigationServer();
 	virtual ~GodotNavigationServer();
@@ -100,6 +136,10 @@ public:
 
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers = 1) const;
 
+	virtual uint32_t map_query_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, uint32_t p_layers = 1, const Callable &p_callback = Callable()) const;
+	virtual bool path_query_is_done(uint32_t p_ticket) const;
+	virtual Array path_query_get_paths(uint32_t p_ticket) const;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const;
@@ -136,6 +176,8 @@ public:
 
 	void flush_queries();
 	virtual void process(real_t p_delta_time);
+
+	virtual int get_process_info(ProcessInfo p_info) const;
 };
 
 #undef COMMAND_1
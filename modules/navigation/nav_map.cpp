@@ -30,7 +30,10 @@
 
 #include "nav_map.h"
 
+#include "core/os/os.h"
 #include "core/os/threaded_array_processor.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
 
@@ -38,6 +41,51 @@
 
 #define THREE_POINTS_CROSS_PRODUCT(m_a, m_b, m_c) (((m_c) - (m_a)).cross((m_b) - (m_a)))
 
+namespace {
+
+// Index of the navigation poly of each map polygon, for the path query running on this thread.
+// Entries only count for the query whose generation they hold, so a query doesn't have to
+// clear one entry per map polygon, and the array is reused by the next query.
+class NavigationPolyIds {
+	struct Entry {
+		uint32_t generation = 0;
+		int id = -1;
+	};
+
+	LocalVector<Entry> entries;
+	uint32_t generation = 0;
+
+public:
+	void reset(uint32_t p_polygon_count) {
+		if (entries.size() < p_polygon_count) {
+			entries.resize(p_polygon_count);
+		}
+		generation++;
+		if (generation == 0) {
+			// Wrapped around, old entries would be valid again.
+			for (uint32_t i = 0; i < entries.size(); i++) {
+				entries[i].generation = 0;
+			}
+			generation = 1;
+		}
+	}
+
+	_FORCE_INLINE_ int get(uint32_t p_polygon_id) const {
+		const Entry &entry = entries[p_polygon_id];
+		return entry.generation == generation ? entry.id : -1;
+	}
+
+	_FORCE_INLINE_ void set(uint32_t p_polygon_id, int p_id) {
+		Entry &entry = entries[p_polygon_id];
+		entry.generation = generation;
+		entry.id = p_id;
+	}
+};
+
+thread_local NavigationPolyIds navigation_poly_ids;
+
+} // namespace
+
 void NavMap::set_up(Vector3 p_up) {
 	up = p_up;
 	regenerate_polygons = true;
@@ -68,42 +116,11 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 
 Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
 	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
 	Vector3 begin_point;
 	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_layers & p.owner->get_layers()) == 0) {
-			continue;
-		}
-
-		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			float distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
-
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
-	}
+	Vector3 normal;
+	const gd::Polygon *begin_poly = _get_closest_polygon(p_origin, p_layers, begin_point, normal);
+	const gd::Polygon *end_poly = _get_closest_polygon(p_destination, p_layers, end_point, normal);
 
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
@@ -117,9 +134,31 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
+	if (use_clusters && !clusters.empty() && begin_poly->cluster != end_poly->cluster) {
+		// Search the cluster graph first, then the polygons of the clusters it goes through.
+		std::vector<uint8_t> corridor;
+		Vector<Vector3> path;
+		if (_get_cluster_corridor(begin_poly, end_poly, begin_point, end_point, p_layers, corridor) && _find_path(begin_poly, end_poly, begin_point, end_point, p_destination, p_optimize, p_layers, &corridor, path)) {
+			return path;
+		}
+	}
+
+	Vector<Vector3> path;
+	_find_path(begin_poly, end_poly, begin_point, end_point, p_destination, p_optimize, p_layers, nullptr, path);
+	return path;
+}
+
+bool NavMap::_find_path(const gd::Polygon *p_begin_poly, const gd::Polygon *p_end_poly, const Vector3 &p_begin_point, const Vector3 &p_end_point, const Vector3 &p_destination, bool p_optimize, uint32_t p_layers, const std::vector<uint8_t> *p_corridor, Vector<Vector3> &r_path) const {
+	const gd::Polygon *begin_poly = p_begin_poly;
+	const gd::Polygon *end_poly = p_end_poly;
+	const Vector3 begin_point = p_begin_point;
+	Vector3 end_point = p_end_point;
+
 	// List of all reachable navigation polys.
 	std::vector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	navigation_polys.reserve(MIN(polygons.size(), 1024u));
+
+	navigation_poly_ids.reset(polygons.size());
 
 	// Add the start polygon to the reachable navigation polygons.
 	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
@@ -128,10 +167,14 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
 	navigation_polys.push_back(begin_navigation_poly);
+	navigation_poly_ids.set(begin_poly->id, 0);
 
-	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
-	to_visit.push_back(0);
+	// Heap of the polygon IDs to visit, the least costly on top.
+	gd::NavPolyTravelCostGreaterThan less_than;
+	less_than.navigation_polys = &navigation_polys;
+	gd::NavPolyHeapIndexer indexer;
+	indexer.navigation_polys = &navigation_polys;
+	gd::Heap<uint32_t, gd::NavPolyTravelCostGreaterThan, gd::NavPolyHeapIndexer> to_visit(less_than, indexer);
 
 	// This is an implementation of the A* algorithm.
 	int least_cost_id = 0;
@@ -142,11 +185,10 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	bool is_reachable = true;
 
 	while (true) {
-		gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
-
-		// Takes the current least_cost_poly neighbors (iterating over its edges) and compute the traveled_distance.
-		for (size_t i = 0; i < least_cost_poly->poly->edges.size(); i++) {
-			const gd::Edge &edge = least_cost_poly->poly->edges[i];
+		// Takes the current least cost poly neighbors (iterating over its edges) and compute the traveled_distance.
+		const gd::Polygon *least_cost_polygon = navigation_polys[least_cost_id].poly;
+		for (size_t i = 0; i < least_cost_polygon->edges.size(); i++) {
+			const gd::Edge &edge = least_cost_polygon->edges[i];
 
 			// Iterate over connections in this edge, then compute the new optimized travel distance assigned to this polygon.
 			for (int connection_index = 0; connection_index < edge.connections.size(); connection_index++) {
@@ -157,24 +199,33 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					continue;
 				}
 
-				Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
-				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly->entry, pathway);
-				const float new_distance = least_cost_poly->entry.distance_to(new_entry) + least_cost_poly->traveled_distance;
+				// When searching a corridor, stay in its clusters.
+				if (p_corridor && !(*p_corridor)[connection.polygon->cluster]) {
+					continue;
+				}
 
-				const std::vector<gd::NavigationPoly>::iterator it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(connection.polygon));
+				// Pushing new navigation polys may reallocate the array, so don't keep references across iterations.
+				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
+				Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
+				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly.entry, pathway);
+				const float new_distance = least_cost_poly.entry.distance_to(new_entry) + least_cost_poly.traveled_distance;
 
-				if (it != navigation_polys.end()) {
+				const int navigation_poly_id = navigation_poly_ids.get(connection.polygon->id);
+				if (navigation_poly_id != -1) {
 					// Polygon already visited, check if we can reduce the travel cost.
-					if (new_distance < it->traveled_distance) {
-						it->back_navigation_poly_id = least_cost_id;
-						it->back_navigation_edge = connection.edge;
-						it->back_navigation_edge_pathway_start = connection.pathway_start;
-						it->back_navigation_edge_pathway_end = connection.pathway_end;
-						it->traveled_distance = new_distance;
-						it->entry = new_entry;
+					gd::NavigationPoly &navigation_poly = navigation_polys[navigation_poly_id];
+					if (new_distance < navigation_poly.traveled_distance) {
+						navigation_poly.back_navigation_poly_id = least_cost_id;
+						navigation_poly.back_navigation_edge = connection.edge;
+						navigation_poly.back_navigation_edge_pathway_start = connection.pathway_start;
+						navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
+						navigation_poly.traveled_distance = new_distance;
+						navigation_poly.entry = new_entry;
+						navigation_poly.distance_to_destination = new_entry.distance_to(end_point);
+
+						if (navigation_poly.heap_index != UINT32_MAX) {
+							to_visit.shift(navigation_poly.heap_index);
+						}
 					}
 				} else {
 					// Add the neighbour polygon to the reachable ones.
@@ -186,19 +237,23 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					new_navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
 					new_navigation_poly.traveled_distance = new_distance;
 					new_navigation_poly.entry = new_entry;
+					new_navigation_poly.distance_to_destination = new_entry.distance_to(end_point);
 					navigation_polys.push_back(new_navigation_poly);
+					navigation_poly_ids.set(connection.polygon->id, new_navigation_poly.self_id);
 
 					// Add the neighbour polygon to the polygons to visit.
-					to_visit.push_back(navigation_polys.size() - 1);
+					to_visit.push(new_navigation_poly.self_id);
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the list of polygons to visit so we can advance.
-		to_visit.erase(least_cost_id);
-
 		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
-		if (to_visit.size() == 0) {
+		if (to_visit.is_empty()) {
+			if (p_corridor) {
+				// Let the caller search the whole map.
+				return false;
+			}
+
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -209,7 +264,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Set as end point the furthest reachable point.
 			end_poly = reachable_end;
-			end_d = 1e20;
+			float end_d = 1e20;
 			for (size_t point_id = 2; point_id < end_poly->points.size(); point_id++) {
 				Face3 f(end_poly->points[0].pos, end_poly->points[point_id - 1].pos, end_poly->points[point_id].pos);
 				Vector3 spoint = f.get_closest_point_to(p_destination);
@@ -221,29 +276,21 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 
 			// Reset open and navigation_polys
+			navigation_poly_ids.reset(polygons.size());
+			navigation_poly_ids.set(begin_poly->id, 0);
 			gd::NavigationPoly np = navigation_polys[0];
+			np.distance_to_destination = np.entry.distance_to(end_point);
 			navigation_polys.clear();
 			navigation_polys.push_back(np);
-			to_visit.clear();
-			to_visit.push_back(0);
+			least_cost_id = 0;
 
 			reachable_end = nullptr;
 
 			continue;
 		}
 
-		// Find the polygon with the minimum cost from the list of polygons to visit.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-			cost += np->entry.distance_to(end_point);
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
+		// Take the polygon with the minimum cost from the polygons to visit.
+		least_cost_id = to_visit.pop();
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -254,8 +301,6 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 		}
 
-		ERR_BREAK(least_cost_id == -1);
-
 		// Check if we reached the end
 		if (navigation_polys[least_cost_id].poly == end_poly) {
 			found_route = true;
@@ -265,10 +310,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 	// If we did not find a route, return an empty path.
 	if (!found_route) {
-		return Vector<Vector3>();
+		return false;
 	}
 
-	Vector<Vector3> path;
+	Vector<Vector3> &path = r_path;
+	path.clear();
 	// Optimize the path.
 	if (p_optimize) {
 		// Set the apex poly/point to the end point
@@ -359,7 +405,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		path.reverse();
 	}
 
-	return path;
+	return true;
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
@@ -367,42 +413,45 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 	Vector3 closest_point;
 	real_t closest_point_d = 1e20;
 
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each face check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 inters;
-			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
-					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
+	for (size_t r(0); r < regions.size(); r++) {
+		const std::vector<gd::Polygon> &region_polygons = regions[r]->get_polygons();
+		for (size_t i(0); i < region_polygons.size(); i++) {
+			const gd::Polygon &p = region_polygons[i];
+
+			// For each face check the distance to the segment
+			for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
+				const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				Vector3 inters;
+				if (f.intersects_segment(p_from, p_to, &inters)) {
+					const real_t d = closest_point_d = p_from.distance_to(inters);
+					if (use_collision == false) {
+						closest_point = inters;
+						use_collision = true;
+						closest_point_d = d;
+					} else if (closest_point_d > d) {
+						closest_point = inters;
+						closest_point_d = d;
+					}
 				}
 			}
-		}
-
-		if (use_collision == false) {
-			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
-				Vector3 a, b;
 
-				Geometry3D::get_closest_points_between_segments(
-						p_from,
-						p_to,
-						p.points[point_id].pos,
-						p.points[(point_id + 1) % p.points.size()].pos,
-						a,
-						b);
-
-				const real_t d = a.distance_to(b);
-				if (d < closest_point_d) {
-					closest_point_d = d;
-					closest_point = b;
+			if (use_collision == false) {
+				for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
+					Vector3 a, b;
+
+					Geometry3D::get_closest_points_between_segments(
+							p_from,
+							p_to,
+							p.points[point_id].pos,
+							p.points[(point_id + 1) % p.points.size()].pos,
+							a,
+							b);
+
+					const real_t d = a.distance_to(b);
+					if (d < closest_point_d) {
+						closest_point_d = d;
+						closest_point = b;
+					}
 				}
 			}
 		}
@@ -428,38 +477,533 @@ RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
 
 gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_point) const {
 	gd::ClosestPointQueryResult result;
+	const gd::Polygon *polygon = _get_closest_polygon(p_point, 0, result.point, result.normal);
+	if (polygon) {
+		result.owner = polygon->owner->get_self();
+	}
+	return result;
+}
+
+static _FORCE_INLINE_ real_t _aabb_distance_squared_to(const AABB &p_aabb, const Vector3 &p_point) {
+	const Vector3 closest = p_point.clamp(p_aabb.position, p_aabb.position + p_aabb.size);
+	return closest.distance_squared_to(p_point);
+}
+
+const gd::Polygon *NavMap::_get_closest_polygon(const Vector3 &p_point, uint32_t p_layers, Vector3 &r_point, Vector3 &r_normal) const {
+	const gd::Polygon *closest_polygon = nullptr;
 	real_t closest_point_ds = 1e20;
 
+	for (size_t r(0); r < regions.size(); r++) {
+		const NavRegion *region = regions[r];
+
+		// Only consider the polygons of the regions with compatible layers.
+		if (p_layers != 0 && (p_layers & region->get_layers()) == 0) {
+			continue;
+		}
+		if (region->get_polygons().empty() || _aabb_distance_squared_to(region->get_aabb(), p_point) >= closest_point_ds) {
+			continue;
+		}
+
+		const gd::Polygon *polygon = region->get_closest_polygon(p_point, closest_point_ds, r_point, r_normal);
+		if (polygon) {
+			closest_polygon = polygon;
+		}
+	}
+
+	return closest_polygon;
+}
+
+static uint32_t _find_cluster_root(std::vector<uint32_t> &r_parents, uint32_t p_id) {
+	while (r_parents[p_id] != p_id) {
+		r_parents[p_id] = r_parents[r_parents[p_id]];
+		p_id = r_parents[p_id];
+	}
+	return p_id;
+}
+
+void NavMap::_split_region_clusters(NavRegion *p_region) {
+	std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+	const gd::Polygon *first_polygon = region_polygons.data();
+
+	// A spatial cluster can hold unconnected polygons, split it in its connected parts.
+	std::vector<uint32_t> parents(region_polygons.size());
+	for (size_t i(0); i < region_polygons.size(); i++) {
+		parents[i] = i;
+	}
+	for (size_t i(0); i < region_polygons.size(); i++) {
+		const gd::Polygon &poly = region_polygons[i];
+		for (size_t e(0); e < poly.edges.size(); e++) {
+			for (int c = 0; c < poly.edges[e].connections.size(); c++) {
+				const gd::Polygon *other = poly.edges[e].connections[c].polygon;
+				if (other->owner == p_region && other->region_cluster == poly.region_cluster) {
+					uint32_t a = _find_cluster_root(parents, i);
+					uint32_t b = _find_cluster_root(parents, other - first_polygon);
+					parents[MAX(a, b)] = MIN(a, b);
+				}
+			}
+		}
+	}
+
+	uint32_t cluster_count = 0;
+	std::vector<uint32_t> root_clusters(region_polygons.size(), UINT32_MAX);
+	for (size_t i(0); i < region_polygons.size(); i++) {
+		uint32_t root = _find_cluster_root(parents, i);
+		if (root_clusters[root] == UINT32_MAX) {
+			root_clusters[root] = cluster_count++;
+		}
+		region_polygons[i].region_cluster = root_clusters[root];
+	}
+	p_region->set_cluster_count(cluster_count);
+}
+
+void NavMap::_update_polygons() {
+	polygons.clear();
+	clusters.clear();
+
+	// Number the polygons and the clusters of the regions map wide.
+	for (size_t r(0); r < regions.size(); r++) {
+		std::vector<gd::Polygon> &region_polygons = regions[r]->get_polygons();
+		const uint32_t cluster_offset = clusters.size();
+		for (size_t i(0); i < region_polygons.size(); i++) {
+			gd::Polygon &poly = region_polygons[i];
+			poly.id = polygons.size();
+			poly.cluster = poly.region_cluster + cluster_offset;
+			polygons.push_back(&poly);
+		}
+
+		Cluster cluster;
+		cluster.owner = regions[r];
+		clusters.resize(cluster_offset + regions[r]->get_cluster_count(), cluster);
+	}
+}
+
+void NavMap::_build_clusters() {
+	cluster_portals.clear();
+
+	// One portal per pair of connected clusters, in the middle of the pathways between them.
+	HashMap<uint64_t, uint32_t> portal_ids;
+	std::vector<uint32_t> pathway_counts;
 	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each face check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t ds = inters.distance_squared_to(p_point);
-			if (ds < closest_point_ds) {
-				result.point = inters;
-				result.normal = f.get_plane().normal;
-				result.owner = p.owner->get_self();
-				closest_point_ds = ds;
+		const gd::Polygon &poly = *polygons[i];
+		for (size_t e(0); e < poly.edges.size(); e++) {
+			for (int c = 0; c < poly.edges[e].connections.size(); c++) {
+				const gd::Edge::Connection &connection = poly.edges[e].connections[c];
+				const uint32_t other_cluster = connection.polygon->cluster;
+				if (other_cluster == poly.cluster) {
+					continue;
+				}
+
+				const uint32_t a = MIN(poly.cluster, other_cluster);
+				const uint32_t b = MAX(poly.cluster, other_cluster);
+				const uint64_t key = (uint64_t(a) << 32) | b;
+				uint32_t *portal_id = portal_ids.getptr(key);
+				if (!portal_id) {
+					ClusterPortal portal;
+					portal.clusters[0] = a;
+					portal.clusters[1] = b;
+					clusters[a].portals.push_back(cluster_portals.size());
+					clusters[b].portals.push_back(cluster_portals.size());
+					portal_ids[key] = cluster_portals.size();
+					portal_id = portal_ids.getptr(key);
+					cluster_portals.push_back(portal);
+					pathway_counts.push_back(0);
+				}
+
+				cluster_portals[*portal_id].position += (connection.pathway_start + connection.pathway_end) * 0.5;
+				pathway_counts[*portal_id]++;
 			}
 		}
 	}
+	for (size_t i(0); i < cluster_portals.size(); i++) {
+		cluster_portals[i].position /= pathway_counts[i];
+	}
+}
 
-	return result;
+namespace {
+struct PortalNode {
+	float traveled_distance = 0.0;
+	float distance_to_destination = 0.0;
+	uint32_t back_portal = UINT32_MAX;
+	uint32_t heap_index = UINT32_MAX;
+	bool reached = false;
+};
+
+struct PortalTravelCostGreaterThan {
+	const std::vector<PortalNode> *nodes = nullptr;
+
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		const PortalNode &a = (*nodes)[p_a];
+		const PortalNode &b = (*nodes)[p_b];
+		return a.traveled_distance + a.distance_to_destination > b.traveled_distance + b.distance_to_destination;
+	}
+};
+
+struct PortalHeapIndexer {
+	std::vector<PortalNode> *nodes = nullptr;
+
+	void operator()(uint32_t p_node, uint32_t p_heap_index) const {
+		(*nodes)[p_node].heap_index = p_heap_index;
+	}
+};
+} // namespace
+
+bool NavMap::_get_cluster_corridor(const gd::Polygon *p_begin_poly, const gd::Polygon *p_end_poly, const Vector3 &p_begin_point, const Vector3 &p_end_point, uint32_t p_layers, std::vector<uint8_t> &r_corridor) const {
+	const uint32_t begin_cluster = p_begin_poly->cluster;
+	const uint32_t end_cluster = p_end_poly->cluster;
+
+	// One node per portal, and a last one for the end point.
+	const uint32_t end_node = cluster_portals.size();
+	std::vector<PortalNode> nodes(cluster_portals.size() + 1);
+
+	PortalTravelCostGreaterThan less_than;
+	less_than.nodes = &nodes;
+	PortalHeapIndexer indexer;
+	indexer.nodes = &nodes;
+	gd::Heap<uint32_t, PortalTravelCostGreaterThan, PortalHeapIndexer> to_visit(less_than, indexer);
+
+	// Relaxes the node with the given distance, coming from `p_back_portal`.
+	auto reach = [&](uint32_t p_node, uint32_t p_back_portal, float p_distance) {
+		PortalNode &node = nodes[p_node];
+		if (node.reached && node.traveled_distance <= p_distance) {
+			return;
+		}
+		if (node.reached && node.heap_index == UINT32_MAX) {
+			// Already visited.
+			return;
+		}
+
+		node.traveled_distance = p_distance;
+		node.back_portal = p_back_portal;
+		if (!node.reached) {
+			node.reached = true;
+			node.distance_to_destination = p_node == end_node ? 0.0 : cluster_portals[p_node].position.distance_to(p_end_point);
+			to_visit.push(p_node);
+		} else {
+			to_visit.shift(node.heap_index);
+		}
+	};
+
+	for (size_t i(0); i < clusters[begin_cluster].portals.size(); i++) {
+		const uint32_t portal = clusters[begin_cluster].portals[i];
+		reach(portal, UINT32_MAX, p_begin_point.distance_to(cluster_portals[portal].position));
+	}
+
+	bool found = false;
+	while (!to_visit.is_empty()) {
+		const uint32_t node_id = to_visit.pop();
+		if (node_id == end_node) {
+			found = true;
+			break;
+		}
+
+		// Move to the portals of the clusters on both sides of this one.
+		const ClusterPortal &portal = cluster_portals[node_id];
+		const float traveled_distance = nodes[node_id].traveled_distance;
+		for (int side = 0; side < 2; side++) {
+			const Cluster &cluster = clusters[portal.clusters[side]];
+			if ((p_layers & cluster.owner->get_layers()) == 0) {
+				continue;
+			}
+
+			if (portal.clusters[side] == end_cluster) {
+				reach(end_node, node_id, traveled_distance + portal.position.distance_to(p_end_point));
+			}
+
+			for (size_t i(0); i < cluster.portals.size(); i++) {
+				const uint32_t other = cluster.portals[i];
+				if (other != node_id) {
+					reach(other, node_id, traveled_distance + portal.position.distance_to(cluster_portals[other].position));
+				}
+			}
+		}
+	}
+
+	if (!found) {
+		return false;
+	}
+
+	// The corridor holds the clusters on both sides of the portals on the way.
+	r_corridor.assign(clusters.size(), 0);
+	r_corridor[begin_cluster] = 1;
+	r_corridor[end_cluster] = 1;
+	for (uint32_t portal = nodes[end_node].back_portal; portal != UINT32_MAX; portal = nodes[portal].back_portal) {
+		r_corridor[cluster_portals[portal].clusters[0]] = 1;
+		r_corridor[cluster_portals[portal].clusters[1]] = 1;
+	}
+	return true;
 }
 
 void NavMap::add_region(NavRegion *p_region) {
 	regions.push_back(p_region);
-	regenerate_links = true;
+	p_region->set_links_dirty(true);
+	regions_changed = true;
 }
 
 void NavMap::remove_region(NavRegion *p_region) {
 	const std::vector<NavRegion *>::iterator it = std::find(regions.begin(), regions.end(), p_region);
 	if (it != regions.end()) {
+		// The region can be freed right after, so detach it now.
+		_unlink_region(p_region);
+
+		// Its polygons go with it. The other polygons keep their ids until the next sync.
+		std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+		for (size_t i(0); i < region_polygons.size(); i++) {
+			const uint32_t id = region_polygons[i].id;
+			if (id < polygons.size() && polygons[id] == &region_polygons[i]) {
+				polygons[id] = nullptr;
+			}
+		}
+
 		regions.erase(it);
-		regenerate_links = true;
+		clusters.clear();
+		cluster_portals.clear();
+		regions_changed = true;
+	}
+}
+
+bool NavMap::_is_region_near(const NavRegion *p_region, const NavRegion *p_other) const {
+	// The edges of two regions can only be linked within the edge connection margin.
+	return p_region->get_aabb().grow(edge_connection_margin + cell_size).intersects(p_other->get_aabb());
+}
+
+static void _clear_links(NavRegion *p_region) {
+	p_region->get_connections().clear();
+	std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+	for (size_t i(0); i < region_polygons.size(); i++) {
+		for (size_t e(0); e < region_polygons[i].edges.size(); e++) {
+			region_polygons[i].edges[e].connections.clear();
+		}
+	}
+}
+
+static void _remove_links_to_dirty_regions(NavRegion *p_region) {
+	std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+	for (size_t i(0); i < region_polygons.size(); i++) {
+		gd::Polygon &poly = region_polygons[i];
+		for (size_t e(0); e < poly.edges.size(); e++) {
+			Vector<gd::Edge::Connection> &connections = poly.edges[e].connections;
+			for (int c = connections.size() - 1; c >= 0; c--) {
+				if (connections[c].polygon->owner->is_links_dirty()) {
+					connections.remove_at(c);
+				}
+			}
+		}
+	}
+
+	Vector<gd::Edge::Connection> &connections = p_region->get_connections();
+	for (int c = connections.size() - 1; c >= 0; c--) {
+		if (connections[c].polygon->owner->is_links_dirty()) {
+			connections.remove_at(c);
+		}
+	}
+}
+
+void NavMap::_unlink_region(NavRegion *p_region) {
+	std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+	for (size_t i(0); i < region_polygons.size(); i++) {
+		const gd::Polygon &poly = region_polygons[i];
+		for (size_t p(0); p < poly.points.size(); p++) {
+			const int next_point = (p + 1) % poly.points.size();
+			const gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+			Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *E = edge_connections.find(ek);
+			if (!E) {
+				continue;
+			}
+			for (int c = E->get().size() - 1; c >= 0; c--) {
+				if (E->get()[c].polygon->owner == p_region) {
+					E->get().remove_at(c);
+				}
+			}
+			if (E->get().is_empty()) {
+				edge_connections.erase(E);
+			}
+		}
+	}
+
+	// The polygons of the region are about to be freed, no other region can keep links to them.
+	p_region->set_links_dirty(true);
+	for (size_t r(0); r < regions.size(); r++) {
+		if (regions[r] != p_region && _is_region_near(p_region, regions[r])) {
+			_remove_links_to_dirty_regions(regions[r]);
+			regions[r]->set_links_dirty(true);
+		}
+	}
+}
+
+void NavMap::_add_region_edges(NavRegion *p_region) {
+	std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+	for (size_t i(0); i < region_polygons.size(); i++) {
+		gd::Polygon &poly = region_polygons[i];
+		for (size_t p(0); p < poly.points.size(); p++) {
+			const int next_point = (p + 1) % poly.points.size();
+			const gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+			Vector<gd::Edge::Connection> &connections = edge_connections[ek];
+			if (connections.size() <= 1) {
+				// Add the polygon/edge tuple to this key.
+				gd::Edge::Connection new_connection;
+				new_connection.polygon = &poly;
+				new_connection.edge = p;
+				new_connection.pathway_start = poly.points[p].pos;
+				new_connection.pathway_end = poly.points[next_point].pos;
+				connections.push_back(new_connection);
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
+			}
+		}
+	}
+}
+
+void NavMap::_mark_near_regions_links_dirty(NavRegion *p_region) {
+	// The edges of the near regions may now be shared with, or close to, the region.
+	p_region->set_links_dirty(true);
+	for (size_t r(0); r < regions.size(); r++) {
+		if (regions[r] != p_region && _is_region_near(p_region, regions[r])) {
+			regions[r]->set_links_dirty(true);
+		}
+	}
+}
+
+void NavMap::_connect_free_edges(const gd::Edge::Connection &p_edge, const gd::Edge::Connection &p_other_edge) const {
+	Vector3 edge_p1 = p_edge.polygon->points[p_edge.edge].pos;
+	Vector3 edge_p2 = p_edge.polygon->points[(p_edge.edge + 1) % p_edge.polygon->points.size()].pos;
+
+	Vector3 other_edge_p1 = p_other_edge.polygon->points[p_other_edge.edge].pos;
+	Vector3 other_edge_p2 = p_other_edge.polygon->points[(p_other_edge.edge + 1) % p_other_edge.polygon->points.size()].pos;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_to(self1) > edge_connection_margin) {
+		return;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_to(self2) > edge_connection_margin) {
+		return;
+	}
+
+	// The edges can now be connected.
+	gd::Edge::Connection new_connection = p_other_edge;
+	new_connection.pathway_start = (self1 + other1) / 2.0;
+	new_connection.pathway_end = (self2 + other2) / 2.0;
+	p_edge.polygon->edges[p_edge.edge].connections.push_back(new_connection);
+
+	// Add the connection to the region_connection map.
+	p_edge.polygon->owner->get_connections().push_back(new_connection);
+}
+
+void NavMap::_link_regions(const std::vector<NavRegion *> &p_regions) {
+	// Remove the connections of the regions, and the ones of the near regions to them.
+	for (size_t r(0); r < p_regions.size(); r++) {
+		_clear_links(p_regions[r]);
+	}
+
+	std::vector<NavRegion *> near_regions;
+	for (size_t r(0); r < regions.size(); r++) {
+		if (regions[r]->is_links_dirty()) {
+			continue;
+		}
+		for (size_t d(0); d < p_regions.size(); d++) {
+			if (_is_region_near(p_regions[d], regions[r])) {
+				_remove_links_to_dirty_regions(regions[r]);
+				near_regions.push_back(regions[r]);
+				break;
+			}
+		}
+	}
+
+	Vector<gd::Edge::Connection> free_edges;
+	for (size_t r(0); r < p_regions.size(); r++) {
+		std::vector<gd::Polygon> &region_polygons = p_regions[r]->get_polygons();
+		for (size_t i(0); i < region_polygons.size(); i++) {
+			gd::Polygon &poly = region_polygons[i];
+			for (size_t p(0); p < poly.points.size(); p++) {
+				const int next_point = (p + 1) % poly.points.size();
+				const gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+				const Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *E = edge_connections.find(ek);
+				ERR_CONTINUE(!E);
+				const Vector<gd::Edge::Connection> &connections = E->get();
+				if (connections.size() == 2) {
+					// Connect edge that are shared in different polygons.
+					// Note: The pathway_start/end are full for those connection and do not need to be modified.
+					const bool is_first = connections[0].polygon == &poly && connections[0].edge == int(p);
+					const gd::Edge::Connection &self = connections[is_first ? 0 : 1];
+					const gd::Edge::Connection &other = connections[is_first ? 1 : 0];
+					poly.edges[p].connections.push_back(other);
+					if (!other.polygon->owner->is_links_dirty()) {
+						other.polygon->edges[other.edge].connections.push_back(self);
+					}
+				} else {
+					CRASH_COND_MSG(connections.size() != 1, vformat("Number of connection != 1. Found: %d", connections.size()));
+					free_edges.push_back(connections[0]);
+				}
+			}
+		}
+	}
+
+	Vector<gd::Edge::Connection> near_free_edges;
+	for (size_t r(0); r < near_regions.size(); r++) {
+		std::vector<gd::Polygon> &region_polygons = near_regions[r]->get_polygons();
+		for (size_t i(0); i < region_polygons.size(); i++) {
+			const gd::Polygon &poly = region_polygons[i];
+			for (size_t p(0); p < poly.points.size(); p++) {
+				const int next_point = (p + 1) % poly.points.size();
+				const gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+				const Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *E = edge_connections.find(ek);
+				if (E && E->get().size() == 1) {
+					near_free_edges.push_back(E->get()[0]);
+				}
+			}
+		}
+	}
+
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	for (int i = 0; i < free_edges.size(); i++) {
+		const gd::Edge::Connection &free_edge = free_edges[i];
+		for (int j = 0; j < free_edges.size(); j++) {
+			const gd::Edge::Connection &other_edge = free_edges[j];
+			if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
+				continue;
+			}
+			_connect_free_edges(free_edge, other_edge);
+		}
+
+		// The near regions keep their other links, only link them back.
+		for (int j = 0; j < near_free_edges.size(); j++) {
+			const gd::Edge::Connection &other_edge = near_free_edges[j];
+			_connect_free_edges(free_edge, other_edge);
+			_connect_free_edges(other_edge, free_edge);
+		}
 	}
 }
 
@@ -499,148 +1043,56 @@ void NavMap::remove_agent_as_controlled(RvoAgent *agent) {
 }
 
 void NavMap::sync() {
+	const uint64_t sync_begin_usec = OS::get_singleton()->get_ticks_usec();
+
 	// Check if we need to update the links.
 	if (regenerate_polygons) {
 		for (size_t r(0); r < regions.size(); r++) {
 			regions[r]->scratch_polygons();
 		}
-		regenerate_links = true;
-	}
-
-	for (size_t r(0); r < regions.size(); r++) {
-		if (regions[r]->sync()) {
-			regenerate_links = true;
-		}
 	}
-
-	if (regenerate_links) {
-		// Remove regions connections.
+	if (regenerate_polygons || regenerate_links) {
+		// The near regions can't be found with the previous settings, drop all the links.
 		for (size_t r(0); r < regions.size(); r++) {
-			regions[r]->get_connections().clear();
+			_clear_links(regions[r]);
+			regions[r]->set_links_dirty(true);
 		}
+	}
 
-		// Resize the polygon count.
-		int count = 0;
-		for (size_t r(0); r < regions.size(); r++) {
-			count += regions[r]->get_polygons().size();
+	// Only the changed regions are rebuilt, the old polygons are detached
+	// from the map before being freed.
+	std::vector<NavRegion *> rebuilt_regions;
+	for (size_t r(0); r < regions.size(); r++) {
+		if (regions[r]->is_dirty()) {
+			_unlink_region(regions[r]);
+			regions[r]->sync();
+			_add_region_edges(regions[r]);
+			_mark_near_regions_links_dirty(regions[r]);
+			rebuilt_regions.push_back(regions[r]);
 		}
-		polygons.resize(count);
+	}
 
-		// Copy all region polygons in the map.
-		count = 0;
-		for (size_t r(0); r < regions.size(); r++) {
-			std::copy(
-					regions[r]->get_polygons().data(),
-					regions[r]->get_polygons().data() + regions[r]->get_polygons().size(),
-					polygons.begin() + count);
-			count += regions[r]->get_polygons().size();
+	// Then only the changed regions and their neighbours are linked again.
+	std::vector<NavRegion *> dirty_regions;
+	for (size_t r(0); r < regions.size(); r++) {
+		if (regions[r]->is_links_dirty()) {
+			dirty_regions.push_back(regions[r]);
 		}
-
-		// Group all edges per key.
-		Map<gd::EdgeKey, Vector<gd::Edge::Connection>> connections;
-		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
-			gd::Polygon &poly(polygons[poly_id]);
-
-			for (size_t p(0); p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
-
-				Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
-				}
-			}
+	}
+	if (!dirty_regions.empty()) {
+		_link_regions(dirty_regions);
+		for (size_t r(0); r < rebuilt_regions.size(); r++) {
+			_split_region_clusters(rebuilt_regions[r]);
 		}
-
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				free_edges.push_back(E.value[0]);
-			}
+		for (size_t r(0); r < dirty_regions.size(); r++) {
+			dirty_regions[r]->set_links_dirty(false);
 		}
+		regions_changed = true;
+	}
 
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
-
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
-
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
-
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
-
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
-				}
-
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
-
-				// Add the connection to the region_connection map.
-				free_edge.polygon->owner->get_connections().push_back(new_connection);
-			}
-		}
+	if (regions_changed) {
+		_update_polygons();
+		_build_clusters();
 
 		// Update the update ID.
 		map_update_id = (map_update_id + 1) % 9999999;
@@ -658,7 +1110,10 @@ void NavMap::sync() {
 
 	regenerate_polygons = false;
 	regenerate_links = false;
+	regions_changed = false;
 	agents_dirty = false;
+
+	last_sync_usec = OS::get_singleton()->get_ticks_usec() - sync_begin_usec;
 }
 
 void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
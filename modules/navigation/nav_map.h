@@ -33,6 +33,7 @@
 
 #include "nav_rid.h"
 
+#include "core/math/aabb.h"
 #include "core/math/math_defs.h"
 #include "core/templates/map.h"
 #include "nav_utils.h"
@@ -56,11 +57,33 @@ class NavMap : public NavRid {
 
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
+	/// Set when the polygons of the map changed, so their ids and clusters must be updated.
+	bool regions_changed = false;
 
 	std::vector<NavRegion *> regions;
 
-	/// Map polygons
-	std::vector<gd::Polygon> polygons;
+	/// Map polygons, owned by their region and indexed by their id. The polygons
+	/// of regions removed since the last sync are null.
+	std::vector<gd::Polygon *> polygons;
+
+	/// The polygon edges of all regions grouped per key. It is kept across
+	/// syncs, so that only the edges of the changed regions are hashed again.
+	Map<gd::EdgeKey, Vector<gd::Edge::Connection>> edge_connections;
+
+	/// Clusters of connected polygons of a region. The portals between them
+	/// form the abstract graph searched first by long path queries, which then
+	/// only refine the path over the polygons of the clusters it goes through.
+	struct Cluster {
+		NavRegion *owner = nullptr;
+		std::vector<uint32_t> portals;
+	};
+	struct ClusterPortal {
+		uint32_t clusters[2] = { 0, 0 };
+		Vector3 position;
+	};
+	std::vector<Cluster> clusters;
+	std::vector<ClusterPortal> cluster_portals;
+	bool use_clusters = true;
 
 	/// Rvo world
 	RVO::KdTree rvo;
@@ -80,6 +103,9 @@ class NavMap : public NavRid {
 	/// Change the id each time the map is updated.
 	uint32_t map_update_id = 0;
 
+	/// Time spent in the last `sync`.
+	uint64_t last_sync_usec = 0;
+
 public:
 	NavMap() {}
 
@@ -98,6 +124,19 @@ public:
 		return edge_connection_margin;
 	}
 
+	void set_use_clusters(bool p_use_clusters) {
+		use_clusters = p_use_clusters;
+	}
+	bool get_use_clusters() const {
+		return use_clusters;
+	}
+	uint32_t get_cluster_count() const {
+		return clusters.size();
+	}
+	uint32_t get_polygon_count() const {
+		return polygons.size();
+	}
+
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
 	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers = 1) const;
@@ -126,12 +165,37 @@ public:
 	uint32_t get_map_update_id() const {
 		return map_update_id;
 	}
+	uint64_t get_last_sync_usec() const {
+		return last_sync_usec;
+	}
 
 	void sync();
 	void step(real_t p_deltatime);
 	void dispatch_callbacks();
 
 private:
+	/// Finds the closest point to `p_point` on the polygons of the regions
+	/// matching `p_layers`, or on all polygons when `p_layers` is 0.
+	const gd::Polygon *_get_closest_polygon(const Vector3 &p_point, uint32_t p_layers, Vector3 &r_point, Vector3 &r_normal) const;
+
+	bool _is_region_near(const NavRegion *p_region, const NavRegion *p_other) const;
+	/// Removes the edges of the region from the map and the links of the near regions to it.
+	void _unlink_region(NavRegion *p_region);
+	void _add_region_edges(NavRegion *p_region);
+	void _mark_near_regions_links_dirty(NavRegion *p_region);
+	/// Rebuilds the connections of the given regions, and of the near regions to them.
+	void _link_regions(const std::vector<NavRegion *> &p_regions);
+	void _connect_free_edges(const gd::Edge::Connection &p_edge, const gd::Edge::Connection &p_other_edge) const;
+	/// Splits the spatial clusters of the region in their connected parts.
+	void _split_region_clusters(NavRegion *p_region);
+	void _update_polygons();
+
+	void _build_clusters();
+	/// Marks the clusters of the shortest route from the begin to the end polygon over the cluster graph.
+	bool _get_cluster_corridor(const gd::Polygon *p_begin_poly, const gd::Polygon *p_end_poly, const Vector3 &p_begin_point, const Vector3 &p_end_point, uint32_t p_layers, std::vector<uint8_t> &r_corridor) const;
+	/// A* over the polygons, restricted to the clusters of `p_corridor` when given.
+	bool _find_path(const gd::Polygon *p_begin_poly, const gd::Polygon *p_end_poly, const Vector3 &p_begin_point, const Vector3 &p_end_point, const Vector3 &p_destination, bool p_optimize, uint32_t p_layers, const std::vector<uint8_t> *p_corridor, Vector<Vector3> &r_path) const;
+
 	void compute_single_step(uint32_t index, RvoAgent **agent);
 	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
 };
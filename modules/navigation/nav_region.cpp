@@ -32,11 +32,20 @@
 
 #include "nav_map.h"
 
+#include <algorithm>
+
 void NavRegion::set_map(NavMap *p_map) {
 	map = p_map;
 	polygons_dirty = true;
+	links_dirty = true;
 	if (!map) {
+		// The polygons are linked to the ones of the previous map.
 		connections.clear();
+		polygons.clear();
+		polygon_bvh.clear();
+		polygon_bvh_indices.clear();
+		cluster_count = 0;
+		aabb = AABB();
 	}
 }
 
@@ -90,6 +99,10 @@ void NavRegion::update_polygons() {
 		return;
 	}
 	polygons.clear();
+	polygon_bvh.clear();
+	polygon_bvh_indices.clear();
+	cluster_count = 0;
+	aabb = AABB();
 	polygons_dirty = false;
 
 	if (map == nullptr) {
@@ -154,4 +167,169 @@ void NavRegion::update_polygons() {
 			p.center = center / float(mesh_poly.size());
 		}
 	}
+
+	update_clusters();
+	update_polygon_bvh();
+}
+
+static void _split_clusters(std::vector<gd::Polygon> &r_polygons, std::vector<uint32_t> &r_ids, uint32_t p_begin, uint32_t p_end, uint32_t &r_cluster_count) {
+	if (p_end - p_begin <= NavRegion::MAX_CLUSTER_POLYGONS) {
+		for (uint32_t i = p_begin; i < p_end; i++) {
+			r_polygons[r_ids[i]].region_cluster = r_cluster_count;
+		}
+		r_cluster_count++;
+		return;
+	}
+
+	// Split at the median of the longest axis.
+	AABB aabb(r_polygons[r_ids[p_begin]].center, Vector3());
+	for (uint32_t i = p_begin + 1; i < p_end; i++) {
+		aabb.expand_to(r_polygons[r_ids[i]].center);
+	}
+	const Vector3::Axis axis = Vector3::Axis(aabb.get_longest_axis_index());
+	const uint32_t middle = (p_begin + p_end) / 2;
+	std::nth_element(
+			r_ids.begin() + p_begin,
+			r_ids.begin() + middle,
+			r_ids.begin() + p_end,
+			[&](uint32_t p_a, uint32_t p_b) {
+				return r_polygons[p_a].center[axis] < r_polygons[p_b].center[axis];
+			});
+
+	_split_clusters(r_polygons, r_ids, p_begin, middle, r_cluster_count);
+	_split_clusters(r_polygons, r_ids, middle, p_end, r_cluster_count);
+}
+
+void NavRegion::update_clusters() {
+	cluster_count = 0;
+	if (polygons.empty()) {
+		return;
+	}
+
+	std::vector<uint32_t> ids(polygons.size());
+	for (size_t i(0); i < polygons.size(); i++) {
+		ids[i] = i;
+	}
+	_split_clusters(polygons, ids, 0, polygons.size(), cluster_count);
+}
+
+void NavRegion::update_polygon_bvh() {
+	polygon_bvh.clear();
+	polygon_bvh_indices.resize(polygons.size());
+	if (polygons.empty()) {
+		return;
+	}
+
+	std::vector<AABB> aabbs(polygons.size());
+	std::vector<Vector3> centers(polygons.size());
+	for (size_t i(0); i < polygons.size(); i++) {
+		const gd::Polygon &p = polygons[i];
+		AABB polygon_aabb;
+		if (!p.points.empty()) {
+			polygon_aabb.position = p.points[0].pos;
+			for (size_t point_id = 1; point_id < p.points.size(); point_id++) {
+				polygon_aabb.expand_to(p.points[point_id].pos);
+			}
+		}
+		aabbs[i] = polygon_aabb;
+		centers[i] = polygon_aabb.get_center();
+		polygon_bvh_indices[i] = i;
+	}
+
+	polygon_bvh.reserve(polygons.size() / 2 + 1);
+	_build_polygon_bvh_node(0, polygons.size(), aabbs, centers);
+	aabb = polygon_bvh[0].aabb;
+}
+
+uint32_t NavRegion::_build_polygon_bvh_node(uint32_t p_begin, uint32_t p_end, const std::vector<AABB> &p_aabbs, const std::vector<Vector3> &p_centers) {
+	const uint32_t MAX_LEAF_POLYGONS = 4;
+
+	const uint32_t node_id = polygon_bvh.size();
+	polygon_bvh.push_back(PolygonBVHNode());
+
+	AABB node_aabb = p_aabbs[polygon_bvh_indices[p_begin]];
+	for (uint32_t i = p_begin + 1; i < p_end; i++) {
+		node_aabb.merge_with(p_aabbs[polygon_bvh_indices[i]]);
+	}
+	polygon_bvh[node_id].aabb = node_aabb;
+
+	if (p_end - p_begin <= MAX_LEAF_POLYGONS) {
+		polygon_bvh[node_id].index = p_begin;
+		polygon_bvh[node_id].count = p_end - p_begin;
+		return node_id;
+	}
+
+	// Split at the median of the longest axis.
+	const Vector3::Axis axis = Vector3::Axis(node_aabb.get_longest_axis_index());
+	const uint32_t middle = (p_begin + p_end) / 2;
+	std::nth_element(
+			polygon_bvh_indices.begin() + p_begin,
+			polygon_bvh_indices.begin() + middle,
+			polygon_bvh_indices.begin() + p_end,
+			[&](uint32_t p_a, uint32_t p_b) {
+				return p_centers[p_a][axis] < p_centers[p_b][axis];
+			});
+
+	_build_polygon_bvh_node(p_begin, middle, p_aabbs, p_centers);
+	const uint32_t second_child = _build_polygon_bvh_node(middle, p_end, p_aabbs, p_centers);
+	polygon_bvh[node_id].index = second_child;
+	return node_id;
+}
+
+static _FORCE_INLINE_ real_t _aabb_distance_squared_to(const AABB &p_aabb, const Vector3 &p_point) {
+	const Vector3 closest = p_point.clamp(p_aabb.position, p_aabb.position + p_aabb.size);
+	return closest.distance_squared_to(p_point);
+}
+
+const gd::Polygon *NavRegion::get_closest_polygon(const Vector3 &p_point, real_t &r_closest_distance_squared, Vector3 &r_point, Vector3 &r_normal) const {
+	const gd::Polygon *closest_polygon = nullptr;
+
+	if (polygon_bvh.empty()) {
+		return nullptr;
+	}
+
+	// The tree is balanced, so its depth is logarithmic in the polygon count.
+	uint32_t stack[64];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0) {
+		const PolygonBVHNode &node = polygon_bvh[stack[--stack_size]];
+		if (_aabb_distance_squared_to(node.aabb, p_point) >= r_closest_distance_squared) {
+			continue;
+		}
+
+		if (node.count == 0) {
+			// Visit the closest child first, so that it is popped first.
+			const uint32_t first_child = &node - polygon_bvh.data() + 1;
+			const uint32_t second_child = node.index;
+			if (_aabb_distance_squared_to(polygon_bvh[first_child].aabb, p_point) < _aabb_distance_squared_to(polygon_bvh[second_child].aabb, p_point)) {
+				stack[stack_size++] = second_child;
+				stack[stack_size++] = first_child;
+			} else {
+				stack[stack_size++] = first_child;
+				stack[stack_size++] = second_child;
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.index; i < node.index + node.count; i++) {
+			const gd::Polygon &p = polygons[polygon_bvh_indices[i]];
+
+			// For each face check the distance to the point
+			for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
+				const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				const Vector3 inters = f.get_closest_point_to(p_point);
+				const real_t ds = inters.distance_squared_to(p_point);
+				if (ds < r_closest_distance_squared) {
+					r_point = inters;
+					r_normal = f.get_plane().normal;
+					closest_polygon = &p;
+					r_closest_distance_squared = ds;
+				}
+			}
+		}
+	}
+
+	return closest_polygon;
 }
@@ -31,6 +31,7 @@
 #ifndef NAV_REGION_H
 #define NAV_REGION_H
 
+#include "core/math/aabb.h"
 #include "scene/resources/navigation_mesh.h"
 
 #include "nav_rid.h"
@@ -49,9 +50,26 @@ class NavRegion : public NavRid {
 	Vector<gd::Edge::Connection> connections;
 
 	bool polygons_dirty = true;
+	/// Set by the map when the connections of this region must be rebuilt.
+	bool links_dirty = true;
 
 	/// Cache
 	std::vector<gd::Polygon> polygons;
+	uint32_t cluster_count = 0;
+	AABB aabb;
+
+	/// Bounding volume hierarchy over the polygons, used to find the closest
+	/// polygon to a point. Nodes are stored depth first, so the first child
+	/// of a branch directly follows it.
+	struct PolygonBVHNode {
+		AABB aabb;
+		/// Index of the second child for branches, of the first polygon index for leaves.
+		uint32_t index = 0;
+		/// Number of polygons of a leaf, 0 for branches.
+		uint32_t count = 0;
+	};
+	std::vector<PolygonBVHNode> polygon_bvh;
+	std::vector<uint32_t> polygon_bvh_indices;
 
 public:
 	NavRegion() {}
@@ -60,6 +78,17 @@ public:
 		polygons_dirty = true;
 	}
 
+	bool is_dirty() const {
+		return polygons_dirty;
+	}
+
+	void set_links_dirty(bool p_dirty) {
+		links_dirty = p_dirty;
+	}
+	bool is_links_dirty() const {
+		return links_dirty;
+	}
+
 	void set_map(NavMap *p_map);
 	NavMap *get_map() const {
 		return map;
@@ -88,11 +117,36 @@ public:
 	std::vector<gd::Polygon> const &get_polygons() const {
 		return polygons;
 	}
+	/// The map links the polygons of its regions together.
+	std::vector<gd::Polygon> &get_polygons() {
+		return polygons;
+	}
+
+	/// Bounds of the polygons.
+	const AABB &get_aabb() const {
+		return aabb;
+	}
+
+	/// Finds the closest point to `p_point` on the polygons, if closer than `r_closest_distance_squared`.
+	const gd::Polygon *get_closest_polygon(const Vector3 &p_point, real_t &r_closest_distance_squared, Vector3 &r_point, Vector3 &r_normal) const;
+
+	/// The polygons are grouped in spatially coherent clusters of at most
+	/// `MAX_CLUSTER_POLYGONS` polygons, used by the map for hierarchical path queries.
+	static const uint32_t MAX_CLUSTER_POLYGONS = 64;
+	uint32_t get_cluster_count() const {
+		return cluster_count;
+	}
+	void set_cluster_count(uint32_t p_cluster_count) {
+		cluster_count = p_cluster_count;
+	}
 
 	bool sync();
 
 private:
 	void update_polygons();
+	void update_clusters();
+	void update_polygon_bvh();
+	uint32_t _build_polygon_bvh_node(uint32_t p_begin, uint32_t p_end, const std::vector<AABB> &p_aabbs, const std::vector<Vector3> &p_centers);
 };
 
 #endif // NAV_REGION_H
@@ -32,6 +32,7 @@
 #define NAV_UTILS_H
 
 #include "core/math/vector3.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/vector.h"
 
 #include <vector>
@@ -91,6 +92,13 @@ struct Edge {
 struct Polygon {
 	NavRegion *owner;
 
+	/// The index of this `Polygon` in the map polygons.
+	uint32_t id = 0;
+
+	/// The cluster of this `Polygon` in its region, and in the map.
+	uint32_t region_cluster = 0;
+	uint32_t cluster = 0;
+
 	/// The points of this `Polygon`
 	std::vector<Point> points;
 
@@ -117,8 +125,13 @@ struct NavigationPoly {
 
 	/// The entry location of this poly.
 	Vector3 entry;
-	/// The distance to the destination.
+	/// The distance traveled to reach this poly.
 	float traveled_distance = 0.0;
+	/// The estimated distance from the entry to the destination.
+	float distance_to_destination = 0.0;
+
+	/// The index of this poly in the open heap, or UINT32_MAX when it isn't in it.
+	uint32_t heap_index = UINT32_MAX;
 
 	NavigationPoly(const Polygon *p_poly) :
 			poly(p_poly) {}
@@ -132,6 +145,126 @@ struct NavigationPoly {
 	}
 };
 
+/// Orders the navigation polys of a path query by their estimated total cost,
+/// the least costly one ending up at the top of the heap.
+struct NavPolyTravelCostGreaterThan {
+	const std::vector<NavigationPoly> *navigation_polys = nullptr;
+
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		const NavigationPoly &a = (*navigation_polys)[p_a];
+		const NavigationPoly &b = (*navigation_polys)[p_b];
+		return a.traveled_distance + a.distance_to_destination > b.traveled_distance + b.distance_to_destination;
+	}
+};
+
+struct NavPolyHeapIndexer {
+	std::vector<NavigationPoly> *navigation_polys = nullptr;
+
+	void operator()(uint32_t p_poly, uint32_t p_heap_index) const {
+		(*navigation_polys)[p_poly].heap_index = p_heap_index;
+	}
+};
+
+/// Binary heap keeping track of the position of its elements through
+/// `Indexer`, so that elements whose priority increased can be moved up.
+/// `LessThan(a, b)` is true when `a` has a lower priority than `b`.
+template <typename T, typename LessThan, typename Indexer>
+class Heap {
+	LocalVector<T> buffer;
+	LessThan less_than;
+	Indexer indexer;
+
+public:
+	uint32_t size() const {
+		return buffer.size();
+	}
+
+	bool is_empty() const {
+		return buffer.is_empty();
+	}
+
+	void reserve(uint32_t p_size) {
+		buffer.reserve(p_size);
+	}
+
+	void push(const T &p_element) {
+		buffer.push_back(p_element);
+		indexer(p_element, buffer.size() - 1);
+		_shift_up(buffer.size() - 1);
+	}
+
+	T pop() {
+		ERR_FAIL_COND_V_MSG(buffer.is_empty(), T(), "Can't pop an empty heap.");
+		T top = buffer[0];
+		indexer(top, UINT32_MAX);
+		uint32_t last = buffer.size() - 1;
+		if (last > 0) {
+			buffer[0] = buffer[last];
+			indexer(buffer[0], 0);
+		}
+		buffer.remove_at(last);
+		if (!buffer.is_empty()) {
+			_shift_down(0);
+		}
+		return top;
+	}
+
+	/// Restores the heap after the priority of the element at `p_index` increased.
+	void shift(uint32_t p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, buffer.size());
+		_shift_up(p_index);
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < buffer.size(); i++) {
+			indexer(buffer[i], UINT32_MAX);
+		}
+		buffer.clear();
+	}
+
+	Heap(const LessThan &p_less_than, const Indexer &p_indexer) :
+			less_than(p_less_than),
+			indexer(p_indexer) {}
+
+private:
+	void _shift_up(uint32_t p_index) {
+		T element = buffer[p_index];
+		while (p_index > 0) {
+			uint32_t parent = (p_index - 1) / 2;
+			if (!less_than(buffer[parent], element)) {
+				break;
+			}
+			buffer[p_index] = buffer[parent];
+			indexer(buffer[p_index], p_index);
+			p_index = parent;
+		}
+		buffer[p_index] = element;
+		indexer(element, p_index);
+	}
+
+	void _shift_down(uint32_t p_index) {
+		T element = buffer[p_index];
+		const uint32_t count = buffer.size();
+		while (true) {
+			uint32_t child = p_index * 2 + 1;
+			if (child >= count) {
+				break;
+			}
+			if (child + 1 < count && less_than(buffer[child], buffer[child + 1])) {
+				child++;
+			}
+			if (!less_than(element, buffer[child])) {
+				break;
+			}
+			buffer[p_index] = buffer[child];
+			indexer(buffer[p_index], p_index);
+			p_index = child;
+		}
+		buffer[p_index] = element;
+		indexer(element, p_index);
+	}
+};
+
 struct ClosestPointQueryResult {
 	Vector3 point;
 	Vector3 normal;
@@ -34,6 +34,7 @@
 
 #include "core/math/convex_hull.h"
 #include "core/os/thread.h"
+#include "core/os/worker_thread_pool.h"
 #include "scene/3d/collision_shape_3d.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/3d/multimesh_instance_3d.h"
@@ -48,6 +49,8 @@
 #include "scene/resources/sphere_shape_3d.h"
 #include "scene/resources/world_boundary_shape_3d.h"
 
+#include <algorithm>
+
 #ifdef TOOLS_ENABLED
 #include "editor/editor_node.h"
 #endif
@@ -370,62 +373,28 @@ void NavigationMeshGenerator::_parse_geometry(const Transform3D &p_navmesh_trans
 	}
 }
 
-void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh) {
-	Vector<Vector3> nav_vertices;
+void NavigationMeshGenerator::_setup_bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node, BakeJob &r_job) {
+	r_job.nav_mesh = p_nav_mesh;
+	r_job.nav_mesh_id = p_nav_mesh->get_instance_id();
 
-	for (int i = 0; i < p_detail_mesh->nverts; i++) {
-		const float *v = &p_detail_mesh->verts[i * 3];
-		nav_vertices.push_back(Vector3(v[0], v[1], v[2]));
-	}
-	p_nav_mesh->set_vertices(nav_vertices);
+	List<Node *> parse_nodes;
 
-	for (int i = 0; i < p_detail_mesh->nmeshes; i++) {
-		const unsigned int *m = &p_detail_mesh->meshes[i * 4];
-		const unsigned int bverts = m[0];
-		const unsigned int btris = m[2];
-		const unsigned int ntris = m[3];
-		const unsigned char *tris = &p_detail_mesh->tris[btris * 4];
-		for (unsigned int j = 0; j < ntris; j++) {
-			Vector<int> nav_indices;
-			nav_indices.resize(3);
-			// Polygon order in recast is opposite than godot's
-			nav_indices.write[0] = ((int)(bverts + tris[j * 4 + 0]));
-			nav_indices.write[1] = ((int)(bverts + tris[j * 4 + 2]));
-			nav_indices.write[2] = ((int)(bverts + tris[j * 4 + 1]));
-			p_nav_mesh->add_polygon(nav_indices);
-		}
+	if (p_nav_mesh->get_source_geometry_mode() == NavigationMesh::SOURCE_GEOMETRY_NAVMESH_CHILDREN) {
+		parse_nodes.push_back(p_node);
+	} else {
+		p_node->get_tree()->get_nodes_in_group(p_nav_mesh->get_source_group_name(), &parse_nodes);
 	}
-}
 
-void NavigationMeshGenerator::_build_recast_navigation_mesh(
-		Ref<NavigationMesh> p_nav_mesh,
-#ifdef TOOLS_ENABLED
-		EditorProgress *ep,
-#endif
-		rcHeightfield *hf,
-		rcCompactHeightfield *chf,
-		rcContourSet *cset,
-		rcPolyMesh *poly_mesh,
-		rcPolyMeshDetail *detail_mesh,
-		Vector<float> &vertices,
-		Vector<int> &indices) {
-	rcContext ctx;
-
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Setting up Configuration..."), 1);
+	Transform3D navmesh_xform = Object::cast_to<Node3D>(p_node)->get_global_transform().affine_inverse();
+	for (Node *E : parse_nodes) {
+		NavigationMesh::ParsedGeometryType geometry_type = p_nav_mesh->get_parsed_geometry_type();
+		uint32_t collision_mask = p_nav_mesh->get_collision_mask();
+		bool recurse_children = p_nav_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
+		_parse_geometry(navmesh_xform, E, r_job.vertices, r_job.indices, geometry_type, collision_mask, recurse_children);
 	}
-#endif
 
-	const float *verts = vertices.ptr();
-	const int nverts = vertices.size() / 3;
-	const int *tris = indices.ptr();
-	const int ntris = indices.size() / 3;
-
-	float bmin[3], bmax[3];
-	rcCalcBounds(verts, nverts, bmin, bmax);
-
-	rcConfig cfg;
+	BakeSettings &settings = r_job.settings;
+	rcConfig &cfg = settings.cfg;
 	memset(&cfg, 0, sizeof(cfg));
 
 	cfg.cs = p_nav_mesh->get_cell_size();
@@ -442,136 +411,505 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	cfg.detailSampleDist = p_nav_mesh->get_detail_sample_distance() < 0.9f ? 0 : p_nav_mesh->get_cell_size() * p_nav_mesh->get_detail_sample_distance();
 	cfg.detailSampleMaxError = p_nav_mesh->get_cell_height() * p_nav_mesh->get_detail_sample_max_error();
 
-	cfg.bmin[0] = bmin[0];
-	cfg.bmin[1] = bmin[1];
-	cfg.bmin[2] = bmin[2];
-	cfg.bmax[0] = bmax[0];
-	cfg.bmax[1] = bmax[1];
-	cfg.bmax[2] = bmax[2];
+	// The tiles are rasterized with a border, so that the walkable area is eroded the same way on both sides of their edges.
+	cfg.tileSize = p_nav_mesh->get_tile_size();
+	cfg.borderSize = cfg.tileSize > 0 ? cfg.walkableRadius + 3 : 0;
+
+	settings.partition_type = p_nav_mesh->get_sample_partition_type();
+	settings.filter_low_hanging_obstacles = p_nav_mesh->get_filter_low_hanging_obstacles();
+	settings.filter_ledge_spans = p_nav_mesh->get_filter_ledge_spans();
+	settings.filter_walkable_low_height_spans = p_nav_mesh->get_filter_walkable_low_height_spans();
+
+	uint32_t hash = hash_djb2_one_float(cfg.cs);
+	hash = hash_djb2_one_float(cfg.ch, hash);
+	hash = hash_djb2_one_float(cfg.walkableSlopeAngle, hash);
+	hash = hash_djb2_one_32(cfg.walkableHeight, hash);
+	hash = hash_djb2_one_32(cfg.walkableClimb, hash);
+	hash = hash_djb2_one_32(cfg.walkableRadius, hash);
+	hash = hash_djb2_one_32(cfg.maxEdgeLen, hash);
+	hash = hash_djb2_one_float(cfg.maxSimplificationError, hash);
+	hash = hash_djb2_one_32(cfg.minRegionArea, hash);
+	hash = hash_djb2_one_32(cfg.mergeRegionArea, hash);
+	hash = hash_djb2_one_32(cfg.maxVertsPerPoly, hash);
+	hash = hash_djb2_one_float(cfg.detailSampleDist, hash);
+	hash = hash_djb2_one_float(cfg.detailSampleMaxError, hash);
+	hash = hash_djb2_one_32(cfg.tileSize, hash);
+	hash = hash_djb2_one_32(settings.partition_type, hash);
+	hash = hash_djb2_one_32(settings.filter_low_hanging_obstacles, hash);
+	hash = hash_djb2_one_32(settings.filter_ledge_spans, hash);
+	hash = hash_djb2_one_32(settings.filter_walkable_low_height_spans, hash);
+	settings.hash = hash;
+}
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Calculating grid size..."), 2);
+void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, BakedTile &r_tile) {
+	r_tile.vertices.resize(p_detail_mesh->nverts);
+	Vector3 *vertices = r_tile.vertices.ptrw();
+	for (int i = 0; i < p_detail_mesh->nverts; i++) {
+		const float *v = &p_detail_mesh->verts[i * 3];
+		vertices[i] = Vector3(v[0], v[1], v[2]);
 	}
-#endif
-	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Creating heightfield..."), 3);
+	r_tile.triangles.clear();
+	for (int i = 0; i < p_detail_mesh->nmeshes; i++) {
+		const unsigned int *m = &p_detail_mesh->meshes[i * 4];
+		const unsigned int bverts = m[0];
+		const unsigned int btris = m[2];
+		const unsigned int ntris = m[3];
+		const unsigned char *tris = &p_detail_mesh->tris[btris * 4];
+		for (unsigned int j = 0; j < ntris; j++) {
+			// Polygon order in recast is opposite than godot's
+			r_tile.triangles.push_back((int)(bverts + tris[j * 4 + 0]));
+			r_tile.triangles.push_back((int)(bverts + tris[j * 4 + 2]));
+			r_tile.triangles.push_back((int)(bverts + tris[j * 4 + 1]));
+		}
 	}
-#endif
-	hf = rcAllocHeightfield();
+}
 
-	ERR_FAIL_COND(!hf);
-	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
+namespace {
+// Frees the Recast data of a build, including when it fails halfway.
+struct RecastBuild {
+	rcHeightfield *hf = nullptr;
+	rcCompactHeightfield *chf = nullptr;
+	rcContourSet *cset = nullptr;
+	rcPolyMesh *poly_mesh = nullptr;
+	rcPolyMeshDetail *detail_mesh = nullptr;
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Marking walkable triangles..."), 4);
+	~RecastBuild() {
+		rcFreeHeightField(hf);
+		rcFreeCompactHeightfield(chf);
+		rcFreeContourSet(cset);
+		rcFreePolyMesh(poly_mesh);
+		rcFreePolyMeshDetail(detail_mesh);
 	}
-#endif
+};
+} // namespace
+
+void NavigationMeshGenerator::_build_recast_navigation_mesh(const BakeSettings &p_settings, const rcConfig &p_cfg, const float *p_vertices, int p_vertex_count, const int *p_triangles, int p_triangle_count, BakedTile &r_tile) {
+	rcContext ctx;
+	RecastBuild build;
+	const rcConfig &cfg = p_cfg;
+
+	build.hf = rcAllocHeightfield();
+
+	ERR_FAIL_COND(!build.hf);
+	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *build.hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
+
 	{
 		Vector<unsigned char> tri_areas;
-		tri_areas.resize(ntris);
+		tri_areas.resize(p_triangle_count);
 
 		ERR_FAIL_COND(tri_areas.size() == 0);
 
-		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
-		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris, ntris, tri_areas.ptrw());
+		memset(tri_areas.ptrw(), 0, p_triangle_count * sizeof(unsigned char));
+		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, p_vertices, p_vertex_count, p_triangles, p_triangle_count, tri_areas.ptrw());
 
-		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb));
+		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, p_vertices, p_vertex_count, p_triangles, tri_areas.ptr(), p_triangle_count, *build.hf, cfg.walkableClimb));
 	}
 
-	if (p_nav_mesh->get_filter_low_hanging_obstacles()) {
-		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *hf);
+	if (p_settings.filter_low_hanging_obstacles) {
+		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *build.hf);
 	}
-	if (p_nav_mesh->get_filter_ledge_spans()) {
-		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf);
+	if (p_settings.filter_ledge_spans) {
+		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *build.hf);
 	}
-	if (p_nav_mesh->get_filter_walkable_low_height_spans()) {
-		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *hf);
+	if (p_settings.filter_walkable_low_height_spans) {
+		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *build.hf);
 	}
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Constructing compact heightfield..."), 5);
-	}
-#endif
+	build.chf = rcAllocCompactHeightfield();
 
-	chf = rcAllocCompactHeightfield();
+	ERR_FAIL_COND(!build.chf);
+	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *build.hf, *build.chf));
 
-	ERR_FAIL_COND(!chf);
-	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf));
+	rcFreeHeightField(build.hf);
+	build.hf = nullptr;
 
-	rcFreeHeightField(hf);
-	hf = nullptr;
+	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *build.chf));
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Eroding walkable area..."), 6);
+	if (p_settings.partition_type == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
+		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *build.chf));
+		ERR_FAIL_COND(!rcBuildRegions(&ctx, *build.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
+	} else if (p_settings.partition_type == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
+		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *build.chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
+	} else {
+		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *build.chf, cfg.borderSize, cfg.minRegionArea));
 	}
-#endif
 
-	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf));
+	build.cset = rcAllocContourSet();
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Partitioning..."), 7);
+	ERR_FAIL_COND(!build.cset);
+	ERR_FAIL_COND(!rcBuildContours(&ctx, *build.chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *build.cset));
+
+	build.poly_mesh = rcAllocPolyMesh();
+	ERR_FAIL_COND(!build.poly_mesh);
+	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *build.cset, cfg.maxVertsPerPoly, *build.poly_mesh));
+
+	build.detail_mesh = rcAllocPolyMeshDetail();
+	ERR_FAIL_COND(!build.detail_mesh);
+	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *build.poly_mesh, *build.chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *build.detail_mesh));
+
+	_convert_detail_mesh_to_native_navigation_mesh(build.detail_mesh, r_tile);
+}
+
+static _FORCE_INLINE_ uint64_t _get_tile_key(int p_x, int p_z) {
+	return (uint64_t(uint32_t(p_x)) << 32) | uint32_t(p_z);
+}
+
+void NavigationMeshGenerator::_bake_tiles(BakeJob &r_job) {
+	const int vertex_count = r_job.vertices.size() / 3;
+	const int triangle_count = r_job.indices.size() / 3;
+	if (vertex_count == 0 || triangle_count == 0) {
+		return;
 	}
-#endif
 
-	if (p_nav_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
-		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea));
-	} else if (p_nav_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea));
+	const float *verts = r_job.vertices.ptr();
+	const int *tris = r_job.indices.ptr();
+	rcCalcBounds(verts, vertex_count, r_job.bmin, r_job.bmax);
+
+	// Find the triangles overlapping each tile, including its border.
+	const rcConfig &cfg = r_job.settings.cfg;
+	if (cfg.tileSize == 0) {
+		r_job.tile_keys.push_back(0);
+		r_job.tile_triangles.resize(1);
+		for (int i = 0; i < triangle_count; i++) {
+			r_job.tile_triangles[0].push_back(i);
+		}
 	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, 0, cfg.minRegionArea));
+		const float tile_width = cfg.tileSize * cfg.cs;
+		const float border = cfg.borderSize * cfg.cs;
+		const int begin_x = (int)Math::floor(r_job.bmin[0] / tile_width);
+		const int begin_z = (int)Math::floor(r_job.bmin[2] / tile_width);
+		const int end_x = (int)Math::floor(r_job.bmax[0] / tile_width);
+		const int end_z = (int)Math::floor(r_job.bmax[2] / tile_width);
+		const int size_x = end_x - begin_x + 1;
+
+		r_job.tile_keys.resize(size_x * (end_z - begin_z + 1));
+		r_job.tile_triangles.resize(r_job.tile_keys.size());
+		for (int z = begin_z; z <= end_z; z++) {
+			for (int x = begin_x; x <= end_x; x++) {
+				r_job.tile_keys[(z - begin_z) * size_x + x - begin_x] = _get_tile_key(x, z);
+			}
+		}
+
+		for (int i = 0; i < triangle_count; i++) {
+			const float *a = &verts[tris[i * 3 + 0] * 3];
+			const float *b = &verts[tris[i * 3 + 1] * 3];
+			const float *c = &verts[tris[i * 3 + 2] * 3];
+			const int triangle_begin_x = MAX(begin_x, (int)Math::floor((MIN(a[0], MIN(b[0], c[0])) - border) / tile_width));
+			const int triangle_begin_z = MAX(begin_z, (int)Math::floor((MIN(a[2], MIN(b[2], c[2])) - border) / tile_width));
+			const int triangle_end_x = MIN(end_x, (int)Math::floor((MAX(a[0], MAX(b[0], c[0])) + border) / tile_width));
+			const int triangle_end_z = MIN(end_z, (int)Math::floor((MAX(a[2], MAX(b[2], c[2])) + border) / tile_width));
+			for (int z = triangle_begin_z; z <= triangle_end_z; z++) {
+				for (int x = triangle_begin_x; x <= triangle_end_x; x++) {
+					r_job.tile_triangles[(z - begin_z) * size_x + x - begin_x].push_back(i);
+				}
+			}
+		}
 	}
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Creating contours..."), 8);
+	// Only the tiles whose geometry changed since the last bake are built again.
+	r_job.tiles.resize(r_job.tile_keys.size());
+	for (uint32_t i = 0; i < r_job.tile_keys.size(); i++) {
+		uint32_t hash = hash_djb2_one_64(r_job.tile_keys[i], r_job.settings.hash);
+		const LocalVector<int> &triangle_ids = r_job.tile_triangles[i];
+		for (uint32_t j = 0; j < triangle_ids.size(); j++) {
+			for (int k = 0; k < 3; k++) {
+				const float *v = &verts[tris[triangle_ids[j] * 3 + k] * 3];
+				hash = hash_djb2_one_float(v[0], hash);
+				hash = hash_djb2_one_float(v[1], hash);
+				hash = hash_djb2_one_float(v[2], hash);
+			}
+		}
+		r_job.tiles[i].geometry_hash = hash;
 	}
-#endif
 
-	cset = rcAllocContourSet();
+	{
+		MutexLock lock(tile_cache_mutex);
+		const TileCache *cache = tile_caches.getptr(r_job.nav_mesh_id);
+		for (uint32_t i = 0; i < r_job.tiles.size(); i++) {
+			if (r_job.tile_triangles[i].is_empty()) {
+				continue;
+			}
+			const BakedTile *cached_tile = cache && cache->settings_hash == r_job.settings.hash ? cache->tiles.getptr(r_job.tile_keys[i]) : nullptr;
+			if (cached_tile && cached_tile->geometry_hash == r_job.tiles[i].geometry_hash) {
+				r_job.tiles[i] = *cached_tile;
+			} else {
+				r_job.tiles_to_build.push_back(i);
+			}
+		}
+	}
 
-	ERR_FAIL_COND(!cset);
-	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset));
+	// Without threads support, the waiting thread builds all the tiles itself.
+	WorkerThreadPool::get_singleton()->do_work(r_job.tiles_to_build.size(), this, &NavigationMeshGenerator::_build_tile, &r_job);
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Creating polymesh..."), 9);
+	{
+		MutexLock lock(tile_cache_mutex);
+
+		// Forget the tiles of the navigation meshes that were freed.
+		LocalVector<ObjectID> freed_nav_meshes;
+		for (const ObjectID *E = tile_caches.next(nullptr); E; E = tile_caches.next(E)) {
+			if (ObjectDB::get_instance(*E) == nullptr) {
+				freed_nav_meshes.push_back(*E);
+			}
+		}
+		for (uint32_t i = 0; i < freed_nav_meshes.size(); i++) {
+			tile_caches.erase(freed_nav_meshes[i]);
+		}
+
+		TileCache &cache = tile_caches[r_job.nav_mesh_id];
+		cache.settings_hash = r_job.settings.hash;
+		cache.tiles.clear();
+		for (uint32_t i = 0; i < r_job.tiles.size(); i++) {
+			if (!r_job.tile_triangles[i].is_empty()) {
+				cache.tiles[r_job.tile_keys[i]] = r_job.tiles[i];
+			}
+		}
 	}
-#endif
 
-	poly_mesh = rcAllocPolyMesh();
-	ERR_FAIL_COND(!poly_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh));
+	_merge_tiles(r_job);
+}
 
-	detail_mesh = rcAllocPolyMeshDetail();
-	ERR_FAIL_COND(!detail_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh));
+void NavigationMeshGenerator::_build_tile(uint32_t p_index, BakeJob *p_job) {
+	const uint32_t tile_id = p_job->tiles_to_build[p_index];
+	const LocalVector<int> &triangle_ids = p_job->tile_triangles[tile_id];
+	const float *verts = p_job->vertices.ptr();
+	const int *indices = p_job->indices.ptr();
+
+	LocalVector<int> triangles;
+	triangles.resize(triangle_ids.size() * 3);
+	float min_y = p_job->bmax[1];
+	float max_y = p_job->bmin[1];
+	for (uint32_t i = 0; i < triangle_ids.size(); i++) {
+		for (int k = 0; k < 3; k++) {
+			const int index = indices[triangle_ids[i] * 3 + k];
+			triangles[i * 3 + k] = index;
+			min_y = MIN(min_y, verts[index * 3 + 1]);
+			max_y = MAX(max_y, verts[index * 3 + 1]);
+		}
+	}
 
-	rcFreeCompactHeightfield(chf);
-	chf = nullptr;
-	rcFreeContourSet(cset);
-	cset = nullptr;
+	rcConfig cfg = p_job->settings.cfg;
+	if (cfg.tileSize == 0) {
+		rcVcopy(cfg.bmin, p_job->bmin);
+		rcVcopy(cfg.bmax, p_job->bmax);
+		rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+	} else {
+		const uint64_t key = p_job->tile_keys[tile_id];
+		const int x = int32_t(key >> 32);
+		const int z = int32_t(key & 0xFFFFFFFF);
+		const float tile_width = cfg.tileSize * cfg.cs;
+		const float border = cfg.borderSize * cfg.cs;
+
+		// The heights are aligned on the cell height, so that the neighbor tiles sample the same spans.
+		cfg.bmin[0] = x * tile_width - border;
+		cfg.bmin[1] = Math::floor(min_y / cfg.ch) * cfg.ch;
+		cfg.bmin[2] = z * tile_width - border;
+		cfg.bmax[0] = (x + 1) * tile_width + border;
+		cfg.bmax[1] = max_y;
+		cfg.bmax[2] = (z + 1) * tile_width + border;
+		cfg.width = cfg.tileSize + cfg.borderSize * 2;
+		cfg.height = cfg.tileSize + cfg.borderSize * 2;
+	}
+
+	_build_recast_navigation_mesh(p_job->settings, cfg, verts, p_job->vertices.size() / 3, triangles.ptr(), triangle_ids.size(), p_job->tiles[tile_id]);
+}
 
-#ifdef TOOLS_ENABLED
-	if (ep) {
-		ep->step(TTR("Converting to native navigation mesh..."), 10);
+void NavigationMeshGenerator::_merge_tiles(BakeJob &r_job) {
+	Vector<Vector3> &vertices = r_job.result_vertices;
+	LocalVector<LocalVector<int>> polygons;
+	for (uint32_t t = 0; t < r_job.tiles.size(); t++) {
+		const BakedTile &tile = r_job.tiles[t];
+		const int offset = vertices.size();
+		vertices.append_array(tile.vertices);
+		for (int i = 0; i + 2 < tile.triangles.size(); i += 3) {
+			LocalVector<int> polygon;
+			polygon.push_back(offset + tile.triangles[i + 0]);
+			polygon.push_back(offset + tile.triangles[i + 1]);
+			polygon.push_back(offset + tile.triangles[i + 2]);
+			polygons.push_back(polygon);
+		}
 	}
-#endif
 
-	_convert_detail_mesh_to_native_navigation_mesh(detail_mesh, p_nav_mesh);
+	const rcConfig &cfg = r_job.settings.cfg;
+	if (cfg.tileSize > 0 && r_job.tiles.size() > 1) {
+		// The tiles are built independently, so the vertices on both sides
+		// of their borders don't match. Weld the vertices at the same place,
+		// then split the border edges at the vertices of the other side, so
+		// that the polygons of the neighbor tiles share their edges.
+		const Vector3 *v = vertices.ptr();
+		const float tile_width = cfg.tileSize * cfg.cs;
+		const float epsilon = cfg.cs * 0.01;
+		const float height_tolerance = MAX(cfg.walkableClimb, 1) * cfg.ch;
+
+		// The vertices on each tile border, keyed by the axis and the index of the border.
+		auto get_border_key = [&](int p_vertex, Vector3::Axis p_axis, uint64_t &r_key) {
+			const int border = (int)Math::round(v[p_vertex][p_axis] / tile_width);
+			if (Math::abs(v[p_vertex][p_axis] - border * tile_width) > epsilon) {
+				return false;
+			}
+			r_key = (uint64_t(p_axis) << 32) | uint32_t(border);
+			return true;
+		};
+		HashMap<uint64_t, LocalVector<int>> borders;
+		for (int i = 0; i < vertices.size(); i++) {
+			uint64_t key;
+			if (get_border_key(i, Vector3::AXIS_X, key)) {
+				borders[key].push_back(i);
+			}
+			if (get_border_key(i, Vector3::AXIS_Z, key)) {
+				borders[key].push_back(i);
+			}
+		}
+
+		LocalVector<int> welded;
+		welded.resize(vertices.size());
+		for (int i = 0; i < vertices.size(); i++) {
+			welded[i] = i;
+		}
+		auto find_welded = [&](int p_vertex) {
+			while (welded[p_vertex] != p_vertex) {
+				p_vertex = welded[p_vertex];
+			}
+			return p_vertex;
+		};
+
+		for (const uint64_t *E = borders.next(nullptr); E; E = borders.next(E)) {
+			// Sort the vertices along the border.
+			LocalVector<int> &border_vertices = borders[*E];
+			const Vector3::Axis along = (*E >> 32) == Vector3::AXIS_X ? Vector3::AXIS_Z : Vector3::AXIS_X;
+			std::sort(border_vertices.ptr(), border_vertices.ptr() + border_vertices.size(), [&](int p_a, int p_b) {
+				return v[p_a][along] < v[p_b][along];
+			});
+
+			for (uint32_t i = 0; i < border_vertices.size(); i++) {
+				for (uint32_t j = i + 1; j < border_vertices.size() && v[border_vertices[j]][along] - v[border_vertices[i]][along] <= epsilon; j++) {
+					if (Math::abs(v[border_vertices[j]].y - v[border_vertices[i]].y) <= height_tolerance) {
+						const int a = find_welded(border_vertices[i]);
+						const int b = find_welded(border_vertices[j]);
+						if (a != b) {
+							welded[MAX(a, b)] = MIN(a, b);
+						}
+					}
+				}
+			}
+		}
+		for (int i = 0; i < vertices.size(); i++) {
+			welded[i] = find_welded(i);
+		}
+		for (const uint64_t *E = borders.next(nullptr); E; E = borders.next(E)) {
+			LocalVector<int> &border_vertices = borders[*E];
+			LocalVector<int> unique_vertices;
+			for (uint32_t i = 0; i < border_vertices.size(); i++) {
+				if (welded[border_vertices[i]] == border_vertices[i]) {
+					unique_vertices.push_back(border_vertices[i]);
+				}
+			}
+			border_vertices = unique_vertices;
+		}
+
+		for (uint32_t p = 0; p < polygons.size(); p++) {
+			const LocalVector<int> &polygon = polygons[p];
+			LocalVector<int> stitched;
+			for (uint32_t i = 0; i < polygon.size(); i++) {
+				const int a = welded[polygon[i]];
+				const int b = welded[polygon[(i + 1) % polygon.size()]];
+				if (stitched.is_empty() || stitched[stitched.size() - 1] != a) {
+					stitched.push_back(a);
+				}
+
+				const Vector3::Axis axes[2] = { Vector3::AXIS_X, Vector3::AXIS_Z };
+				for (int k = 0; k < 2; k++) {
+					uint64_t key_a, key_b;
+					if (!get_border_key(a, axes[k], key_a) || !get_border_key(b, axes[k], key_b) || key_a != key_b) {
+						continue;
+					}
+
+					// Add the vertices of the border between the two ones of the edge, in order.
+					const Vector3::Axis along = axes[k] == Vector3::AXIS_X ? Vector3::AXIS_Z : Vector3::AXIS_X;
+					const LocalVector<int> &border_vertices = borders[key_a];
+					const real_t begin = v[a][along];
+					const real_t end = v[b][along];
+					const bool forward = begin < end;
+					for (uint32_t j = 0; j < border_vertices.size(); j++) {
+						const int c = border_vertices[forward ? j : border_vertices.size() - 1 - j];
+						const real_t position = v[c][along];
+						if (c == a || c == b || position <= MIN(begin, end) + epsilon || position >= MAX(begin, end) - epsilon) {
+							continue;
+						}
+						const real_t height = Math::lerp(v[a].y, v[b].y, (position - begin) / (end - begin));
+						if (Math::abs(v[c].y - height) <= height_tolerance) {
+							stitched.push_back(c);
+						}
+					}
+				}
+			}
+			if (stitched.size() > 1 && stitched[stitched.size() - 1] == stitched[0]) {
+				stitched.remove_at(stitched.size() - 1);
+			}
+			polygons[p] = stitched;
+		}
+	}
+
+	for (uint32_t p = 0; p < polygons.size(); p++) {
+		if (polygons[p].size() < 3) {
+			continue;
+		}
+		Vector<int> polygon;
+		polygon.resize(polygons[p].size());
+		for (uint32_t i = 0; i < polygons[p].size(); i++) {
+			polygon.write[i] = polygons[p][i];
+		}
+		r_job.result_polygons.push_back(polygon);
+	}
+}
+
+void NavigationMeshGenerator::_apply_bake(BakeJob &r_job) {
+	r_job.nav_mesh->clear_polygons();
+	r_job.nav_mesh->set_vertices(r_job.result_vertices);
+	for (int i = 0; i < r_job.result_polygons.size(); i++) {
+		r_job.nav_mesh->add_polygon(r_job.result_polygons[i]);
+	}
+}
+
+void NavigationMeshGenerator::_bake_thread_function(void *p_user) {
+	NavigationMeshGenerator *generator = static_cast<NavigationMeshGenerator *>(p_user);
+	while (true) {
+		generator->bake_semaphore.wait();
+		if (generator->exit_bake_thread.is_set()) {
+			break;
+		}
+
+		BakeJob *job = nullptr;
+		{
+			MutexLock lock(generator->bake_queue_mutex);
+			ERR_CONTINUE(generator->queued_bakes.is_empty());
+			job = generator->queued_bakes[0];
+			generator->queued_bakes.remove_at(0);
+		}
+
+		generator->_bake_tiles(*job);
+
+		{
+			MutexLock lock(generator->bake_queue_mutex);
+			generator->finished_bakes.push_back(job);
+		}
+		generator->call_deferred(SNAME("_bake_async_finished"));
+	}
+}
+
+void NavigationMeshGenerator::_bake_async_finished() {
+	LocalVector<BakeJob *> jobs;
+	{
+		MutexLock lock(bake_queue_mutex);
+		jobs = finished_bakes;
+		finished_bakes.clear();
+	}
 
-	rcFreePolyMesh(poly_mesh);
-	poly_mesh = nullptr;
-	rcFreePolyMeshDetail(detail_mesh);
-	detail_mesh = nullptr;
+	for (uint32_t i = 0; i < jobs.size(); i++) {
+		_apply_bake(*jobs[i]);
+		emit_signal(SNAME("bake_finished"), jobs[i]->nav_mesh);
+		memdelete(jobs[i]);
+	}
 }
 
 NavigationMeshGenerator *NavigationMeshGenerator::get_singleton() {
@@ -583,6 +921,17 @@ NavigationMeshGenerator::NavigationMeshGenerator() {
 }
 
 NavigationMeshGenerator::~NavigationMeshGenerator() {
+	if (bake_thread.is_started()) {
+		exit_bake_thread.set();
+		bake_semaphore.post();
+		bake_thread.wait_to_finish();
+	}
+	for (uint32_t i = 0; i < queued_bakes.size(); i++) {
+		memdelete(queued_bakes[i]);
+	}
+	for (uint32_t i = 0; i < finished_bakes.size(); i++) {
+		memdelete(finished_bakes[i]);
+	}
 }
 
 void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node) {
@@ -591,7 +940,7 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 #ifdef TOOLS_ENABLED
 	EditorProgress *ep(nullptr);
 	if (Engine::get_singleton()->is_editor_hint()) {
-		ep = memnew(EditorProgress("bake", TTR("Navigation Mesh Generator Setup:"), 11));
+		ep = memnew(EditorProgress("bake", TTR("Navigation Mesh Generator Setup:"), 3));
 	}
 
 	if (ep) {
@@ -599,64 +948,28 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 	}
 #endif
 
-	Vector<float> vertices;
-	Vector<int> indices;
-
-	List<Node *> parse_nodes;
-
-	if (p_nav_mesh->get_source_geometry_mode() == NavigationMesh::SOURCE_GEOMETRY_NAVMESH_CHILDREN) {
-		parse_nodes.push_back(p_node);
-	} else {
-		p_node->get_tree()->get_nodes_in_group(p_nav_mesh->get_source_group_name(), &parse_nodes);
-	}
+	BakeJob job;
+	_setup_bake(p_nav_mesh, p_node, job);
 
-	Transform3D navmesh_xform = Object::cast_to<Node3D>(p_node)->get_global_transform().affine_inverse();
-	for (Node *E : parse_nodes) {
-		NavigationMesh::ParsedGeometryType geometry_type = p_nav_mesh->get_parsed_geometry_type();
-		uint32_t collision_mask = p_nav_mesh->get_collision_mask();
-		bool recurse_children = p_nav_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
-		_parse_geometry(navmesh_xform, E, vertices, indices, geometry_type, collision_mask, recurse_children);
+#ifdef TOOLS_ENABLED
+	if (ep) {
+		ep->step(TTR("Baking tiles..."), 1);
 	}
+#endif
 
-	if (vertices.size() > 0 && indices.size() > 0) {
-		rcHeightfield *hf = nullptr;
-		rcCompactHeightfield *chf = nullptr;
-		rcContourSet *cset = nullptr;
-		rcPolyMesh *poly_mesh = nullptr;
-		rcPolyMeshDetail *detail_mesh = nullptr;
+	_bake_tiles(job);
 
-		_build_recast_navigation_mesh(
-				p_nav_mesh,
 #ifdef TOOLS_ENABLED
-				ep,
+	if (ep) {
+		ep->step(TTR("Converting to native navigation mesh..."), 2);
+	}
 #endif
-				hf,
-				chf,
-				cset,
-				poly_mesh,
-				detail_mesh,
-				vertices,
-				indices);
-
-		rcFreeHeightField(hf);
-		hf = nullptr;
-
-		rcFreeCompactHeightfield(chf);
-		chf = nullptr;
-
-		rcFreeContourSet(cset);
-		cset = nullptr;
 
-		rcFreePolyMesh(poly_mesh);
-		poly_mesh = nullptr;
-
-		rcFreePolyMeshDetail(detail_mesh);
-		detail_mesh = nullptr;
-	}
+	_apply_bake(job);
 
 #ifdef TOOLS_ENABLED
 	if (ep) {
-		ep->step(TTR("Done!"), 11);
+		ep->step(TTR("Done!"), 3);
 	}
 
 	if (ep) {
@@ -665,6 +978,27 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 #endif
 }
 
+void NavigationMeshGenerator::bake_async(Ref<NavigationMesh> p_nav_mesh, Node *p_node) {
+	ERR_FAIL_COND_MSG(!p_nav_mesh.is_valid(), "Invalid navigation mesh.");
+
+	// The scene is parsed right away, only the Recast build runs in the background.
+	BakeJob *job = memnew(BakeJob);
+	_setup_bake(p_nav_mesh, p_node, *job);
+
+#ifdef NO_THREADS
+	_bake_tiles(*job);
+	finished_bakes.push_back(job);
+	call_deferred(SNAME("_bake_async_finished"));
+#else
+	MutexLock lock(bake_queue_mutex);
+	queued_bakes.push_back(job);
+	if (!bake_thread.is_started()) {
+		bake_thread.start(_bake_thread_function, this);
+	}
+	bake_semaphore.post();
+#endif
+}
+
 void NavigationMeshGenerator::clear(Ref<NavigationMesh> p_nav_mesh) {
 	if (p_nav_mesh.is_valid()) {
 		p_nav_mesh->clear_polygons();
@@ -674,7 +1008,11 @@ void NavigationMeshGenerator::clear(Ref<NavigationMesh> p_nav_mesh) {
 
 void NavigationMeshGenerator::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("bake", "nav_mesh", "root_node"), &NavigationMeshGenerator::bake);
+	ClassDB::bind_method(D_METHOD("bake_async", "nav_mesh", "root_node"), &NavigationMeshGenerator::bake_async);
 	ClassDB::bind_method(D_METHOD("clear", "nav_mesh"), &NavigationMeshGenerator::clear);
+	ClassDB::bind_method(D_METHOD("_bake_async_finished"), &NavigationMeshGenerator::_bake_async_finished);
+
+	ADD_SIGNAL(MethodInfo("bake_finished", PropertyInfo(Variant::OBJECT, "nav_mesh", PROPERTY_HINT_RESOURCE_TYPE, "NavigationMesh")));
 }
 
 #endif
@@ -33,6 +33,12 @@
 
 #ifndef _3D_DISABLED
 
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "scene/3d/navigation_region_3d.h"
 
 #include <Recast.h>
@@ -46,6 +52,62 @@ class NavigationMeshGenerator : public Object {
 
 	static NavigationMeshGenerator *singleton;
 
+	/// The navigation mesh settings used by a bake, read on the thread starting it.
+	struct BakeSettings {
+		rcConfig cfg;
+		NavigationMesh::SamplePartitionType partition_type = NavigationMesh::SAMPLE_PARTITION_WATERSHED;
+		bool filter_low_hanging_obstacles = false;
+		bool filter_ledge_spans = false;
+		bool filter_walkable_low_height_spans = false;
+		uint32_t hash = 0;
+	};
+
+	/// The polygons baked for a tile, reused while the geometry overlapping it doesn't change.
+	struct BakedTile {
+		uint32_t geometry_hash = 0;
+		Vector<Vector3> vertices;
+		Vector<int> triangles;
+	};
+
+	struct TileCache {
+		uint32_t settings_hash = 0;
+		HashMap<uint64_t, BakedTile> tiles;
+	};
+
+	struct BakeJob {
+		Ref<NavigationMesh> nav_mesh;
+		ObjectID nav_mesh_id;
+		BakeSettings settings;
+		Vector<float> vertices;
+		Vector<int> indices;
+
+		/// The tiles overlapping the geometry, with the triangles overlapping each of them.
+		LocalVector<uint64_t> tile_keys;
+		LocalVector<LocalVector<int>> tile_triangles;
+		LocalVector<BakedTile> tiles;
+		LocalVector<uint32_t> tiles_to_build;
+		float bmin[3] = { 0, 0, 0 };
+		float bmax[3] = { 0, 0, 0 };
+
+		Vector<Vector3> result_vertices;
+		Vector<Vector<int>> result_polygons;
+	};
+
+	/// The tiles of the last bake of each navigation mesh.
+	Mutex tile_cache_mutex;
+	HashMap<ObjectID, TileCache> tile_caches;
+
+	/// The asynchronous bakes run one after the other on `bake_thread`.
+	Mutex bake_queue_mutex;
+	Semaphore bake_semaphore;
+	Thread bake_thread;
+	SafeFlag exit_bake_thread;
+	LocalVector<BakeJob *> queued_bakes;
+	LocalVector<BakeJob *> finished_bakes;
+
+	static void _bake_thread_function(void *p_user);
+	void _bake_async_finished();
+
 protected:
 	static void _bind_methods();
 
@@ -54,19 +116,15 @@ protected:
 	static void _add_faces(const PackedVector3Array &p_faces, const Transform3D &p_xform, Vector<float> &p_vertices, Vector<int> &p_indices);
 	static void _parse_geometry(const Transform3D &p_navmesh_transform, Node *p_node, Vector<float> &p_vertices, Vector<int> &p_indices, NavigationMesh::ParsedGeometryType p_generate_from, uint32_t p_collision_mask, bool p_recurse_children);
 
-	static void _convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh);
-	static void _build_recast_navigation_mesh(
-			Ref<NavigationMesh> p_nav_mesh,
-#ifdef TOOLS_ENABLED
-			EditorProgress *ep,
-#endif
-			rcHeightfield *hf,
-			rcCompactHeightfield *chf,
-			rcContourSet *cset,
-			rcPolyMesh *poly_mesh,
-			rcPolyMeshDetail *detail_mesh,
-			Vector<float> &vertices,
-			Vector<int> &indices);
+	/// Reads the geometry and the settings of the bake on the calling thread, which must be allowed to access the scene.
+	static void _setup_bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node, BakeJob &r_job);
+	static void _convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, BakedTile &r_tile);
+	static void _build_recast_navigation_mesh(const BakeSettings &p_settings, const rcConfig &p_cfg, const float *p_vertices, int p_vertex_count, const int *p_triangles, int p_triangle_count, BakedTile &r_tile);
+	static void _merge_tiles(BakeJob &r_job);
+
+	void _bake_tiles(BakeJob &r_job);
+	void _build_tile(uint32_t p_index, BakeJob *p_job);
+	void _apply_bake(BakeJob &r_job);
 
 public:
 	static NavigationMeshGenerator *get_singleton();
@@ -75,6 +133,8 @@ public:
 	~NavigationMeshGenerator();
 
 	void bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node);
+	/// Parses the geometry, then bakes it on a background thread and emits `bake_finished` once done.
+	void bake_async(Ref<NavigationMesh> p_nav_mesh, Node *p_node);
 	void clear(Ref<NavigationMesh> p_nav_mesh);
 };
 
@@ -0,0 +1,364 @@
+/*************************************************************************/
+/*  test_navigation_map.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAVIGATION_MAP_H
+#define TEST_NAVIGATION_MAP_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/nav_region.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationMap {
+
+// A flat grid of 1x1 quads, without the cells for which `p_is_hole` is true.
+static Ref<NavigationMesh> _make_grid_mesh(int p_size, bool (*p_is_hole)(int, int) = nullptr) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+	mesh->set_vertices(vertices);
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			if (p_is_hole && p_is_hole(x, z)) {
+				continue;
+			}
+			Vector<int> polygon;
+			int first = z * (p_size + 1) + x;
+			polygon.push_back(first);
+			polygon.push_back(first + p_size + 1);
+			polygon.push_back(first + p_size + 2);
+			polygon.push_back(first + 1);
+			mesh->add_polygon(polygon);
+		}
+	}
+	return mesh;
+}
+
+static bool _is_wall_with_gap(int p_x, int p_z) {
+	return p_x == 5 && p_z < 9;
+}
+
+static bool _is_wall(int p_x, int p_z) {
+	return p_x == 5;
+}
+
+TEST_CASE("[Navigation] Closest points match a brute-force search") {
+	NavMap map;
+	NavRegion region;
+	region.set_map(&map);
+	region.set_mesh(_make_grid_mesh(16, _is_wall_with_gap));
+	region.set_transform(Transform3D(Basis(Vector3(0, 1, 0), 0.3), Vector3(3, 1, -2)));
+	map.add_region(&region);
+	map.sync();
+
+	RandomPCG rng(42);
+	for (int i = 0; i < 200; i++) {
+		Vector3 point(rng.random(-10.0f, 30.0f), rng.random(-5.0f, 5.0f), rng.random(-10.0f, 30.0f));
+
+		real_t closest_ds = 1e20;
+		for (const gd::Polygon &polygon : region.get_polygons()) {
+			for (size_t point_id = 2; point_id < polygon.points.size(); point_id++) {
+				const Face3 f(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+				closest_ds = MIN(closest_ds, f.get_closest_point_to(point).distance_squared_to(point));
+			}
+		}
+
+		CHECK(map.get_closest_point(point).distance_squared_to(point) == doctest::Approx(closest_ds));
+	}
+}
+
+TEST_CASE("[Navigation] Paths go around holes") {
+	NavMap map;
+	NavRegion region;
+	region.set_map(&map);
+	region.set_mesh(_make_grid_mesh(10, _is_wall_with_gap));
+	map.add_region(&region);
+	map.sync();
+
+	const Vector3 origin(2.5, 0, 0.5);
+	const Vector3 destination(7.5, 0, 0.5);
+	for (int optimize = 0; optimize < 2; optimize++) {
+		Vector<Vector3> path = map.get_path(origin, destination, optimize);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[0].is_equal_approx(origin));
+		CHECK(path[path.size() - 1].is_equal_approx(destination));
+
+		real_t max_z = 0.0;
+		for (int i = 0; i < path.size(); i++) {
+			max_z = MAX(max_z, path[i].z);
+		}
+		CHECK(max_z >= 9.0);
+	}
+
+	// Straight through the open part of the grid. The funnel keeps the points
+	// where the path crosses the edges of the polygons, but they stay on the line.
+	Vector<Vector3> path = map.get_path(Vector3(0.5, 0, 9.5), Vector3(9.5, 0, 9.5), true);
+	REQUIRE(path.size() >= 2);
+	CHECK(path[path.size() - 1].is_equal_approx(Vector3(9.5, 0, 9.5)));
+	for (int i = 0; i < path.size(); i++) {
+		CHECK(path[i].z == doctest::Approx(9.5));
+	}
+}
+
+TEST_CASE("[Navigation] Paths to unreachable destinations end at the closest reachable point") {
+	NavMap map;
+	NavRegion region;
+	region.set_map(&map);
+	region.set_mesh(_make_grid_mesh(10, _is_wall));
+	map.add_region(&region);
+	map.sync();
+
+	Vector<Vector3> path = map.get_path(Vector3(2.5, 0, 0.5), Vector3(7.5, 0, 0.5), true);
+	REQUIRE(path.size() >= 2);
+	CHECK(path[path.size() - 1].is_equal_approx(Vector3(5, 0, 0.5)));
+}
+
+static bool _is_maze_wall(int p_x, int p_z) {
+	// Walls every 16 cells, with openings at alternating ends.
+	if (p_x % 16 == 8) {
+		return (p_x / 16) % 2 == 0 ? p_z < 56 : p_z >= 8;
+	}
+	return false;
+}
+
+static real_t _get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0.0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+TEST_CASE("[Navigation] Hierarchical paths are close to the flat ones") {
+	NavMap map;
+	NavRegion region;
+	region.set_map(&map);
+	region.set_mesh(_make_grid_mesh(64, _is_maze_wall));
+	map.add_region(&region);
+	map.sync();
+	CHECK(map.get_cluster_count() > 1);
+
+	RandomPCG rng(3);
+	for (int i = 0; i < 50; i++) {
+		Vector3 origin(rng.random(0.0f, 64.0f), 0, rng.random(0.0f, 64.0f));
+		Vector3 destination(rng.random(0.0f, 64.0f), 0, rng.random(0.0f, 64.0f));
+
+		map.set_use_clusters(false);
+		Vector<Vector3> flat_path = map.get_path(origin, destination, true);
+		map.set_use_clusters(true);
+		Vector<Vector3> path = map.get_path(origin, destination, true);
+
+		REQUIRE(flat_path.size() >= 2);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[0].is_equal_approx(flat_path[0]));
+		CHECK(path[path.size() - 1].is_equal_approx(flat_path[flat_path.size() - 1]));
+		CHECK(_get_path_length(path) <= _get_path_length(flat_path) * 1.25 + 1.0);
+	}
+}
+
+static const int TILE_SIZE = 8;
+static const int TILE_COUNT = 4;
+
+// The tiles touch along x, and are apart by less than the edge connection margin along z.
+static Transform3D _get_tile_transform(int p_x, int p_z) {
+	return Transform3D(Basis(), Vector3(p_x * TILE_SIZE, 0, p_z * (TILE_SIZE + 0.5)));
+}
+
+static int _get_connection_count(NavRegion &p_region) {
+	int count = 0;
+	for (const gd::Polygon &polygon : p_region.get_polygons()) {
+		for (const gd::Edge &edge : polygon.edges) {
+			count += edge.connections.size();
+		}
+	}
+	return count;
+}
+
+TEST_CASE("[Navigation] Syncing changed regions matches a full rebuild") {
+	const Ref<NavigationMesh> mesh = _make_grid_mesh(TILE_SIZE);
+	const Ref<NavigationMesh> wall_mesh = _make_grid_mesh(TILE_SIZE, _is_wall);
+
+	NavMap map;
+	map.set_edge_connection_margin(1.0);
+	NavRegion regions[TILE_COUNT * TILE_COUNT];
+	for (int i = 0; i < TILE_COUNT * TILE_COUNT; i++) {
+		regions[i].set_map(&map);
+		regions[i].set_mesh(mesh);
+		regions[i].set_transform(_get_tile_transform(i % TILE_COUNT, i / TILE_COUNT));
+		map.add_region(&regions[i]);
+	}
+	map.sync();
+	const uint32_t map_update_id = map.get_map_update_id();
+
+	// Nothing changed.
+	map.sync();
+	CHECK(map.get_map_update_id() == map_update_id);
+
+	// Change the mesh of a tile, move another one and remove a third one.
+	regions[5].set_mesh(wall_mesh);
+	regions[6].set_transform(_get_tile_transform(2, 1).translated(Vector3(0, 0, 0.25)));
+	map.remove_region(&regions[9]);
+	regions[9].set_map(nullptr);
+	map.sync();
+	CHECK(map.get_map_update_id() != map_update_id);
+
+	NavMap rebuilt_map;
+	rebuilt_map.set_edge_connection_margin(1.0);
+	NavRegion rebuilt_regions[TILE_COUNT * TILE_COUNT];
+	for (int i = 0; i < TILE_COUNT * TILE_COUNT; i++) {
+		if (i == 9) {
+			continue;
+		}
+		rebuilt_regions[i].set_map(&rebuilt_map);
+		rebuilt_regions[i].set_mesh(regions[i].get_mesh());
+		rebuilt_regions[i].set_transform(regions[i].get_transform());
+		rebuilt_map.add_region(&rebuilt_regions[i]);
+	}
+	rebuilt_map.sync();
+
+	CHECK(map.get_polygon_count() == rebuilt_map.get_polygon_count());
+	CHECK(map.get_cluster_count() == rebuilt_map.get_cluster_count());
+	for (int i = 0; i < TILE_COUNT * TILE_COUNT; i++) {
+		CHECK(regions[i].get_connections_count() == rebuilt_regions[i].get_connections_count());
+		CHECK(_get_connection_count(regions[i]) == _get_connection_count(rebuilt_regions[i]));
+	}
+
+	RandomPCG rng(5);
+	const float extent = TILE_COUNT * (TILE_SIZE + 0.5);
+	for (int i = 0; i < 50; i++) {
+		Vector3 origin(rng.random(0.0f, extent), 0, rng.random(0.0f, extent));
+		Vector3 destination(rng.random(0.0f, extent), 0, rng.random(0.0f, extent));
+
+		Vector<Vector3> path = map.get_path(origin, destination, true);
+		Vector<Vector3> rebuilt_path = rebuilt_map.get_path(origin, destination, true);
+		REQUIRE(path.size() >= 2);
+		REQUIRE(rebuilt_path.size() >= 2);
+		CHECK(path[0].is_equal_approx(rebuilt_path[0]));
+		CHECK(path[path.size() - 1].is_equal_approx(rebuilt_path[rebuilt_path.size() - 1]));
+		CHECK(_get_path_length(path) == doctest::Approx(_get_path_length(rebuilt_path)).epsilon(0.05));
+	}
+}
+
+TEST_CASE("[Navigation] Removed regions are not used before the next sync") {
+	const Ref<NavigationMesh> mesh = _make_grid_mesh(TILE_SIZE);
+
+	NavMap map;
+	NavRegion regions[2];
+	for (int i = 0; i < 2; i++) {
+		regions[i].set_map(&map);
+		regions[i].set_mesh(mesh);
+		regions[i].set_transform(_get_tile_transform(i, 0));
+		map.add_region(&regions[i]);
+	}
+	map.sync();
+
+	// Clearing the map of the region frees its polygons.
+	map.remove_region(&regions[1]);
+	regions[1].set_map(nullptr);
+	CHECK(regions[1].get_polygons().empty());
+
+	Vector<Vector3> path = map.get_path(Vector3(0.5, 0, 0.5), Vector3(TILE_SIZE * 2 - 0.5, 0, 0.5), true);
+	REQUIRE(path.size() >= 2);
+	CHECK(path[path.size() - 1].x <= TILE_SIZE + CMP_EPSILON);
+
+	map.sync();
+	CHECK(map.get_polygon_count() == regions[0].get_polygons().size());
+}
+
+// Benchmarks, run with --no-skip to print timings.
+
+TEST_CASE("[Navigation][Benchmark] Path queries" * doctest::skip()) {
+	const int sizes[] = { 32, 128, 512 };
+	for (int size : sizes) {
+		NavMap map;
+		NavRegion region;
+		region.set_map(&map);
+		region.set_mesh(_make_grid_mesh(size));
+		map.add_region(&region);
+		map.sync();
+
+		for (int use_clusters = 0; use_clusters < 2; use_clusters++) {
+			map.set_use_clusters(use_clusters);
+
+			RandomPCG rng(7);
+			const int query_count = 200;
+			int points = 0;
+			const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < query_count; i++) {
+				Vector3 origin(rng.random(0.0f, float(size)), 0, rng.random(0.0f, float(size)));
+				Vector3 destination(rng.random(0.0f, float(size)), 0, rng.random(0.0f, float(size)));
+				points += map.get_path(origin, destination, true).size();
+			}
+			const uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+			print_line(vformat("Path queries on %d polygons (%s): %d queries/sec, %d points", size * size, use_clusters ? "hierarchical" : "flat", query_count * 1000000 / elapsed, points));
+		}
+	}
+}
+
+TEST_CASE("[Navigation][Benchmark] Sync after a tile change" * doctest::skip()) {
+	const Ref<NavigationMesh> mesh = _make_grid_mesh(16);
+	const Ref<NavigationMesh> wall_mesh = _make_grid_mesh(16, _is_wall);
+	const int tile_counts[] = { 8, 24 };
+	for (int tile_count : tile_counts) {
+		NavMap map;
+		map.set_edge_connection_margin(1.0);
+		std::vector<NavRegion> regions(tile_count * tile_count);
+		for (int i = 0; i < tile_count * tile_count; i++) {
+			regions[i].set_map(&map);
+			regions[i].set_mesh(mesh);
+			regions[i].set_transform(Transform3D(Basis(), Vector3((i % tile_count) * 16, 0, (i / tile_count) * 16.5)));
+			map.add_region(&regions[i]);
+		}
+		map.sync();
+		const uint64_t full_sync_usec = map.get_last_sync_usec();
+
+		// Stream a tile in the middle of the map in and out.
+		const int iterations = 20;
+		uint64_t tile_sync_usec = 0;
+		for (int i = 0; i < iterations; i++) {
+			regions[regions.size() / 2].set_mesh(i % 2 == 0 ? wall_mesh : mesh);
+			map.sync();
+			tile_sync_usec += map.get_last_sync_usec();
+		}
+		print_line(vformat("Sync of %d tiles, %d polygons: %d usec full, %d usec after a tile change", tile_count * tile_count, map.get_polygon_count(), full_sync_usec, tile_sync_usec / iterations));
+	}
+}
+
+} // namespace TestNavigationMap
+
+#endif // TEST_NAVIGATION_MAP_H
@@ -0,0 +1,130 @@
+/*************************************************************************/
+/*  test_navigation_mesh_generator.h                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAVIGATION_MESH_GENERATOR_H
+#define TEST_NAVIGATION_MESH_GENERATOR_H
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/nav_region.h"
+#include "modules/navigation/navigation_mesh_generator.h"
+#include "scene/3d/collision_shape_3d.h"
+#include "scene/3d/physics_body_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/concave_polygon_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationMeshGenerator {
+
+class BakeReceiver : public Object {
+public:
+	int bake_count = 0;
+
+	void bake_finished(Ref<NavigationMesh> p_nav_mesh) {
+		bake_count++;
+	}
+};
+
+TEST_CASE("[SceneTree][Navigation] Tiled navigation mesh bakes") {
+	Node3D *root = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(root);
+
+	// The ground is a collider, as the meshes can't be read back without a renderer.
+	StaticBody3D *ground = memnew(StaticBody3D);
+	CollisionShape3D *ground_shape = memnew(CollisionShape3D);
+	Ref<ConcavePolygonShape3D> plane;
+	plane.instantiate();
+	Vector<Vector3> faces;
+	faces.push_back(Vector3(-20, 0, -20));
+	faces.push_back(Vector3(20, 0, -20));
+	faces.push_back(Vector3(20, 0, 20));
+	faces.push_back(Vector3(-20, 0, -20));
+	faces.push_back(Vector3(20, 0, 20));
+	faces.push_back(Vector3(-20, 0, 20));
+	plane->set_faces(faces);
+	ground_shape->set_shape(plane);
+	ground->add_child(ground_shape);
+	root->add_child(ground);
+
+	NavigationMeshGenerator *generator = NavigationMeshGenerator::get_singleton();
+	Ref<NavigationMesh> nav_mesh;
+	nav_mesh.instantiate();
+	nav_mesh->set_parsed_geometry_type(NavigationMesh::PARSED_GEOMETRY_STATIC_COLLIDERS);
+	nav_mesh->set_tile_size(32);
+	generator->bake(nav_mesh, root);
+	REQUIRE(nav_mesh->get_polygon_count() > 0);
+
+	SUBCASE("Paths cross the tile borders") {
+		NavMap map;
+		NavRegion region;
+		region.set_map(&map);
+		region.set_mesh(nav_mesh);
+		map.add_region(&region);
+		map.sync();
+
+		const Vector3 destination(15, 0, 14);
+		Vector<Vector3> path = map.get_path(Vector3(-15, 0, -13), destination, true);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[path.size() - 1].distance_to(destination) < 0.5);
+	}
+
+	SUBCASE("Baking the same geometry again gives the same navigation mesh") {
+		const Vector<Vector3> vertices = nav_mesh->get_vertices();
+		const int polygon_count = nav_mesh->get_polygon_count();
+		generator->bake(nav_mesh, root);
+		CHECK(nav_mesh->get_vertices() == vertices);
+		CHECK(nav_mesh->get_polygon_count() == polygon_count);
+	}
+
+	SUBCASE("Asynchronous bakes emit a signal once done") {
+		BakeReceiver receiver;
+		generator->connect("bake_finished", callable_mp(&receiver, &BakeReceiver::bake_finished));
+
+		// Move the ground, so that all the tiles are baked again.
+		ground->set_position(Vector3(0.5, 0, 0));
+		generator->bake_async(nav_mesh, root);
+		for (int i = 0; i < 10000 && receiver.bake_count == 0; i++) {
+			OS::get_singleton()->delay_usec(1000);
+			MessageQueue::get_singleton()->flush();
+		}
+		CHECK(receiver.bake_count == 1);
+		CHECK(nav_mesh->get_polygon_count() > 0);
+
+		generator->disconnect("bake_finished", callable_mp(&receiver, &BakeReceiver::bake_finished));
+	}
+
+	memdelete(root);
+}
+
+} // namespace TestNavigationMeshGenerator
+
+#endif // TEST_NAVIGATION_MESH_GENERATOR_H
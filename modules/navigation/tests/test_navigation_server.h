@@ -0,0 +1,108 @@
+/*************************************************************************/
+/*  test_navigation_server.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAVIGATION_SERVER_H
+#define TEST_NAVIGATION_SERVER_H
+
+#include "modules/navigation/tests/test_navigation_map.h"
+#include "servers/navigation_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationServer {
+
+class PathQueryReceiver : public Object {
+public:
+	Array paths;
+
+	void path_query_done(uint32_t p_ticket) {
+		paths = NavigationServer3D::get_singleton()->path_query_get_paths(p_ticket);
+	}
+};
+
+TEST_CASE("[SceneTree][Navigation] Batched path queries") {
+	NavigationServer3D *server = NavigationServer3D::get_singleton_mut();
+	RID map = server->map_create();
+	server->map_set_active(map, true);
+	RID region = server->region_create();
+	server->region_set_map(region, map);
+	server->region_set_navmesh(region, TestNavigationMap::_make_grid_mesh(10, TestNavigationMap::_is_wall_with_gap));
+	server->process(0.0);
+
+	Vector<Vector3> origins;
+	Vector<Vector3> destinations;
+	for (int i = 0; i < 32; i++) {
+		origins.push_back(Vector3(0.5 + (i % 5), 0, 0.5 + i / 4));
+		destinations.push_back(Vector3(9.5 - (i % 4), 0, 0.5 + (i % 9)));
+	}
+
+	SUBCASE("Polled ticket") {
+		uint32_t ticket = server->map_query_paths(map, origins, destinations, true);
+		REQUIRE(ticket != 0);
+		CHECK_FALSE(server->path_query_is_done(ticket));
+
+		// The queries start after the next sync and finish at the following one.
+		server->process(0.0);
+		CHECK_FALSE(server->path_query_is_done(ticket));
+		server->process(0.0);
+		REQUIRE(server->path_query_is_done(ticket));
+
+		Array paths = server->path_query_get_paths(ticket);
+		REQUIRE(paths.size() == origins.size());
+		for (int i = 0; i < origins.size(); i++) {
+			Vector<Vector3> path = paths[i];
+			CHECK(path == server->map_get_path(map, origins[i], destinations[i], true));
+		}
+		CHECK_FALSE(server->path_query_is_done(ticket));
+	}
+
+	SUBCASE("Callback") {
+		PathQueryReceiver receiver;
+		uint32_t ticket = server->map_query_paths(map, origins, destinations, false, 1, callable_mp(&receiver, &PathQueryReceiver::path_query_done));
+		server->process(0.0);
+		server->process(0.0);
+
+		REQUIRE(receiver.paths.size() == origins.size());
+		for (int i = 0; i < origins.size(); i++) {
+			Vector<Vector3> path = receiver.paths[i];
+			CHECK(path == server->map_get_path(map, origins[i], destinations[i], false));
+		}
+		// The paths are only kept during the callback.
+		CHECK_FALSE(server->path_query_is_done(ticket));
+	}
+
+	server->free(region);
+	server->free(map);
+	server->process(0.0);
+}
+
+} // namespace TestNavigationServer
+
+#endif // TEST_NAVIGATION_SERVER_H
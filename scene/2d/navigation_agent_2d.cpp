@@ -58,6 +58,9 @@ void NavigationAgent2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_path_max_distance", "max_speed"), &NavigationAgent2D::set_path_max_distance);
 	ClassDB::bind_method(D_METHOD("get_path_max_distance"), &NavigationAgent2D::get_path_max_distance);
 
+	ClassDB::bind_method(D_METHOD("set_use_async_path_queries", "enabled"), &NavigationAgent2D::set_use_async_path_queries);
+	ClassDB::bind_method(D_METHOD("get_use_async_path_queries"), &NavigationAgent2D::get_use_async_path_queries);
+
 	ClassDB::bind_method(D_METHOD("set_target_location", "location"), &NavigationAgent2D::set_target_location);
 	ClassDB::bind_method(D_METHOD("get_target_location"), &NavigationAgent2D::get_target_location);
 	ClassDB::bind_method(D_METHOD("get_next_location"), &NavigationAgent2D::get_next_location);
@@ -79,6 +82,7 @@ void NavigationAgent2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "time_horizon", PROPERTY_HINT_RANGE, "0.1,10000,0.01"), "set_time_horizon", "get_time_horizon");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "max_speed", PROPERTY_HINT_RANGE, "0.1,100000,0.01"), "set_max_speed", "get_max_speed");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "path_max_distance", PROPERTY_HINT_RANGE, "10,100,1"), "set_path_max_distance", "get_path_max_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_async_path_queries"), "set_use_async_path_queries", "get_use_async_path_queries");
 
 	ADD_SIGNAL(MethodInfo("path_changed"));
 	ADD_SIGNAL(MethodInfo("target_reached"));
@@ -172,12 +176,19 @@ real_t NavigationAgent2D::get_path_max_distance() {
 	return path_max_distance;
 }
 
+void NavigationAgent2D::set_use_async_path_queries(bool p_enabled) {
+	use_async_path_queries = p_enabled;
+	path_query_ticket = 0;
+}
+
 void NavigationAgent2D::set_target_location(Vector2 p_location) {
 	target_location = p_location;
 	navigation_path.clear();
 	target_reached = false;
 	navigation_finished = false;
 	update_frame_id = 0;
+	// Ignore the path to the previous target.
+	path_query_ticket = 0;
 }
 
 Vector2 NavigationAgent2D::get_target_location() const {
@@ -286,10 +297,21 @@ void NavigationAgent2D::update_navigation() {
 	}
 
 	if (reload_path) {
-		navigation_path = NavigationServer2D::get_singleton()->map_get_path(agent_parent->get_world_2d()->get_navigation_map(), o, target_location, true, navigable_layers);
-		navigation_finished = false;
-		nav_path_index = 0;
-		emit_signal(SNAME("path_changed"));
+		if (use_async_path_queries) {
+			// Keep following the current path until the new one is ready.
+			if (path_query_ticket == 0) {
+				Vector<Vector2> origins;
+				origins.push_back(o);
+				Vector<Vector2> destinations;
+				destinations.push_back(target_location);
+				path_query_ticket = NavigationServer2D::get_singleton()->map_query_paths(agent_parent->get_world_2d()->get_navigation_map(), origins, destinations, true, navigable_layers, callable_mp(this, &NavigationAgent2D::_path_query_done));
+			}
+		} else {
+			navigation_path = NavigationServer2D::get_singleton()->map_get_path(agent_parent->get_world_2d()->get_navigation_map(), o, target_location, true, navigable_layers);
+			navigation_finished = false;
+			nav_path_index = 0;
+			emit_signal(SNAME("path_changed"));
+		}
 	}
 
 	if (navigation_path.size() == 0) {
@@ -312,6 +334,20 @@ void NavigationAgent2D::update_navigation() {
 	}
 }
 
+void NavigationAgent2D::_path_query_done(uint32_t p_ticket) {
+	if (p_ticket != path_query_ticket) {
+		// The target changed since this query was made.
+		return;
+	}
+	path_query_ticket = 0;
+
+	Array paths = NavigationServer2D::get_singleton()->path_query_get_paths(p_ticket);
+	navigation_path = paths.is_empty() ? Vector<Vector2>() : Vector<Vector2>(paths[0]);
+	navigation_finished = false;
+	nav_path_index = 0;
+	emit_signal(SNAME("path_changed"));
+}
+
 void NavigationAgent2D::_check_distance_to_target() {
 	if (!target_reached) {
 		if (distance_to_target() < target_desired_distance) {
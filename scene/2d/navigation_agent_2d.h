@@ -65,6 +65,10 @@ class NavigationAgent2D : public Node {
 	// No initialized on purpose
 	uint32_t update_frame_id;
 
+	bool use_async_path_queries = false;
+	/// Ticket of the path query in flight, 0 when there is none.
+	uint32_t path_query_ticket = 0;
+
 protected:
 	static void _bind_methods();
 	void _notification(int p_what);
@@ -113,6 +117,11 @@ public:
 	void set_path_max_distance(real_t p_pmd);
 	real_t get_path_max_distance();
 
+	void set_use_async_path_queries(bool p_enabled);
+	bool get_use_async_path_queries() const {
+		return use_async_path_queries;
+	}
+
 	void set_target_location(Vector2 p_location);
 	Vector2 get_target_location() const;
 
@@ -139,6 +148,7 @@ public:
 
 private:
 	void update_navigation();
+	void _path_query_done(uint32_t p_ticket);
 	void _check_distance_to_target();
 };
 
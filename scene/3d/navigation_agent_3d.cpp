@@ -62,6 +62,9 @@ void NavigationAgent3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_path_max_distance", "max_speed"), &NavigationAgent3D::set_path_max_distance);
 	ClassDB::bind_method(D_METHOD("get_path_max_distance"), &NavigationAgent3D::get_path_max_distance);
 
+	ClassDB::bind_method(D_METHOD("set_use_async_path_queries", "enabled"), &NavigationAgent3D::set_use_async_path_queries);
+	ClassDB::bind_method(D_METHOD("get_use_async_path_queries"), &NavigationAgent3D::get_use_async_path_queries);
+
 	ClassDB::bind_method(D_METHOD("set_target_location", "location"), &NavigationAgent3D::set_target_location);
 	ClassDB::bind_method(D_METHOD("get_target_location"), &NavigationAgent3D::get_target_location);
 	ClassDB::bind_method(D_METHOD("get_next_location"), &NavigationAgent3D::get_next_location);
@@ -84,6 +87,7 @@ void NavigationAgent3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "time_horizon", PROPERTY_HINT_RANGE, "0.01,100,0.01"), "set_time_horizon", "get_time_horizon");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "max_speed", PROPERTY_HINT_RANGE, "0.1,10000,0.01"), "set_max_speed", "get_max_speed");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "path_max_distance", PROPERTY_HINT_RANGE, "0.01,100,0.1"), "set_path_max_distance", "get_path_max_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_async_path_queries"), "set_use_async_path_queries", "get_use_async_path_queries");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "ignore_y"), "set_ignore_y", "get_ignore_y");
 
 	ADD_SIGNAL(MethodInfo("path_changed"));
@@ -179,12 +183,19 @@ real_t NavigationAgent3D::get_path_max_distance() {
 	return path_max_distance;
 }
 
+void NavigationAgent3D::set_use_async_path_queries(bool p_enabled) {
+	use_async_path_queries = p_enabled;
+	path_query_ticket = 0;
+}
+
 void NavigationAgent3D::set_target_location(Vector3 p_location) {
 	target_location = p_location;
 	navigation_path.clear();
 	target_reached = false;
 	navigation_finished = false;
 	update_frame_id = 0;
+	// Ignore the path to the previous target.
+	path_query_ticket = 0;
 }
 
 Vector3 NavigationAgent3D::get_target_location() const {
@@ -294,10 +305,21 @@ void NavigationAgent3D::update_navigation() {
 	}
 
 	if (reload_path) {
-		navigation_path = NavigationServer3D::get_singleton()->map_get_path(agent_parent->get_world_3d()->get_navigation_map(), o, target_location, true);
-		navigation_finished = false;
-		nav_path_index = 0;
-		emit_signal(SNAME("path_changed"));
+		if (use_async_path_queries) {
+			// Keep following the current path until the new one is ready.
+			if (path_query_ticket == 0) {
+				Vector<Vector3> origins;
+				origins.push_back(o);
+				Vector<Vector3> destinations;
+				destinations.push_back(target_location);
+				path_query_ticket = NavigationServer3D::get_singleton()->map_query_paths(agent_parent->get_world_3d()->get_navigation_map(), origins, destinations, true, 1, callable_mp(this, &NavigationAgent3D::_path_query_done));
+			}
+		} else {
+			navigation_path = NavigationServer3D::get_singleton()->map_get_path(agent_parent->get_world_3d()->get_navigation_map(), o, target_location, true);
+			navigation_finished = false;
+			nav_path_index = 0;
+			emit_signal(SNAME("path_changed"));
+		}
 	}
 
 	if (navigation_path.size() == 0) {
@@ -320,6 +342,20 @@ void NavigationAgent3D::update_navigation() {
 	}
 }
 
+void NavigationAgent3D::_path_query_done(uint32_t p_ticket) {
+	if (p_ticket != path_query_ticket) {
+		// The target changed since this query was made.
+		return;
+	}
+	path_query_ticket = 0;
+
+	Array paths = NavigationServer3D::get_singleton()->path_query_get_paths(p_ticket);
+	navigation_path = paths.is_empty() ? Vector<Vector3>() : Vector<Vector3>(paths[0]);
+	navigation_finished = false;
+	nav_path_index = 0;
+	emit_signal(SNAME("path_changed"));
+}
+
 void NavigationAgent3D::_check_distance_to_target() {
 	if (!target_reached) {
 		if (distance_to_target() < target_desired_distance) {
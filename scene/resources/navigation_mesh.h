@@ -84,6 +84,7 @@ public:
 protected:
 	float cell_size = 0.3f;
 	float cell_height = 0.2f;
+	int tile_size = 0;
 	float agent_height = 2.0f;
 	float agent_radius = 1.0f;
 	float agent_max_climb = 0.9f;
@@ -133,6 +134,9 @@ public:
 	void set_cell_height(float p_value);
 	float get_cell_height() const;
 
+	void set_tile_size(int p_value);
+	int get_tile_size() const;
+
 	void set_agent_height(float p_value);
 	float get_agent_height() const;
 
@@ -144,6 +144,11 @@ void PhysicsServer3DExtension::_bind_methods() {
 	GDVIRTUAL_BIND(_space_create);
 	GDVIRTUAL_BIND(_space_set_active, "space", "active");
 	GDVIRTUAL_BIND(_space_is_active, "space");
+	GDVIRTUAL_BIND(_space_set_deterministic, "space", "deterministic");
+	GDVIRTUAL_BIND(_space_is_deterministic, "space");
+	GDVIRTUAL_BIND(_space_get_state_hash, "space");
+	GDVIRTUAL_BIND(_space_save_snapshot, "space");
+	GDVIRTUAL_BIND(_space_restore_snapshot, "space", "snapshot");
 	GDVIRTUAL_BIND(_space_set_param, "space", "param", "value");
 	GDVIRTUAL_BIND(_space_get_param, "space", "param");
 	GDVIRTUAL_BIND(_space_get_direct_state, "space");
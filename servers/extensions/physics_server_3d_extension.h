@@ -236,6 +236,11 @@ public:
 	EXBIND0R(RID, space_create)
 	EXBIND2(space_set_active, RID, bool)
 	EXBIND1RC(bool, space_is_active, RID)
+	EXBIND2(space_set_deterministic, RID, bool)
+	EXBIND1RC(bool, space_is_deterministic, RID)
+	EXBIND1RC(int64_t, space_get_state_hash, RID)
+	EXBIND1RC(Vector<uint8_t>, space_save_snapshot, RID)
+	EXBIND2R(bool, space_restore_snapshot, RID, const Vector<uint8_t> &)
 
 	EXBIND3(space_set_param, RID, SpaceParameter, real_t)
 	EXBIND2RC(real_t, space_get_param, RID, SpaceParameter)
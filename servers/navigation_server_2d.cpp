@@ -126,6 +126,15 @@ static Vector<Vector2> vector_v3_to_v2(const Vector<Vector3> &d) {
 	return nd;
 }
 
+static Vector<Vector3> vector_v2_to_v3(const Vector<Vector2> &d) {
+	Vector<Vector3> nd;
+	nd.resize(d.size());
+	for (int i(0); i < nd.size(); i++) {
+		nd.write[i] = v2_to_v3(d[i]);
+	}
+	return nd;
+}
+
 static Transform3D trf2_to_trf3(const Transform2D &d) {
 	Vector3 o(v2_to_v3(d.get_origin()));
 	Basis b;
@@ -167,6 +176,9 @@ void NavigationServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_set_edge_connection_margin", "map", "margin"), &NavigationServer2D::map_set_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer2D::map_get_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize", "layers"), &NavigationServer2D::map_get_path, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("map_query_paths", "map", "origins", "destinations", "optimize", "layers", "callback"), &NavigationServer2D::map_query_paths, DEFVAL(1), DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("path_query_is_done", "ticket"), &NavigationServer2D::path_query_is_done);
+	ClassDB::bind_method(D_METHOD("path_query_get_paths", "ticket"), &NavigationServer2D::path_query_get_paths);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer2D::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_owner", "map", "to_point"), &NavigationServer2D::map_get_closest_point_owner);
 
@@ -222,6 +234,20 @@ real_t FORWARD_1_C(map_get_edge_connection_margin, RID, p_map, rid_to_rid);
 
 Vector<Vector2> FORWARD_5_R_C(vector_v3_to_v2, map_get_path, RID, p_map, Vector2, p_origin, Vector2, p_destination, bool, p_optimize, uint32_t, p_layers, rid_to_rid, v2_to_v3, v2_to_v3, bool_to_bool, uint32_to_uint32);
 
+uint32_t NavigationServer2D::map_query_paths(RID p_map, const Vector<Vector2> &p_origins, const Vector<Vector2> &p_destinations, bool p_optimize, uint32_t p_layers, const Callable &p_callback) const {
+	return NavigationServer3D::get_singleton()->map_query_paths(p_map, vector_v2_to_v3(p_origins), vector_v2_to_v3(p_destinations), p_optimize, p_layers, p_callback);
+}
+
+bool FORWARD_1_C(path_query_is_done, uint32_t, p_ticket, uint32_to_uint32);
+
+Array NavigationServer2D::path_query_get_paths(uint32_t p_ticket) const {
+	Array paths = NavigationServer3D::get_singleton()->path_query_get_paths(p_ticket);
+	for (int i = 0; i < paths.size(); i++) {
+		paths[i] = vector_v3_to_v2(paths[i]);
+	}
+	return paths;
+}
+
 Vector2 FORWARD_2_R_C(v3_to_v2, map_get_closest_point, RID, p_map, const Vector2 &, p_point, rid_to_rid, v2_to_v3);
 RID FORWARD_2_C(map_get_closest_point_owner, RID, p_map, const Vector2 &, p_point, rid_to_rid, v2_to_v3);
 
@@ -77,6 +77,11 @@ public:
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector2> map_get_path(RID p_map, Vector2 p_origin, Vector2 p_destination, bool p_optimize, uint32_t p_layers = 1) const;
 
+	/// Queues a batch of path queries, see `NavigationServer3D::map_query_paths`.
+	virtual uint32_t map_query_paths(RID p_map, const Vector<Vector2> &p_origins, const Vector<Vector2> &p_destinations, bool p_optimize, uint32_t p_layers = 1, const Callable &p_callback = Callable()) const;
+	virtual bool path_query_is_done(uint32_t p_ticket) const;
+	virtual Array path_query_get_paths(uint32_t p_ticket) const;
+
 	virtual Vector2 map_get_closest_point(RID p_map, const Vector2 &p_point) const;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector2 &p_point) const;
 
@@ -86,6 +86,18 @@ public:
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigable_layers = 1) const = 0;
 
+	/// Queues a batch of path queries, processed on worker threads after the
+	/// next map sync. Returns the ticket identifying the batch. The callback,
+	/// if any, is called with the ticket once the paths are ready, and the
+	/// paths are only kept during the callback.
+	virtual uint32_t map_query_paths(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, uint32_t p_navigable_layers = 1, const Callable &p_callback = Callable()) const = 0;
+
+	/// Returns true when the paths of this batch of queries are ready.
+	virtual bool path_query_is_done(uint32_t p_ticket) const = 0;
+
+	/// Returns the paths of this batch of queries, in the order of the queries, and releases them.
+	virtual Array path_query_get_paths(uint32_t p_ticket) const = 0;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const = 0;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const = 0;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
@@ -186,10 +198,21 @@ public:
 	/// Note: This function is not thread safe.
 	virtual void process(real_t delta_time) = 0;
 
+	enum ProcessInfo {
+		INFO_ACTIVE_MAPS,
+		INFO_POLYGON_COUNT,
+		INFO_SYNC_TIME_USEC,
+	};
+
+	/// Statistics of the last process of the active maps.
+	virtual int get_process_info(ProcessInfo p_info) const = 0;
+
 	NavigationServer3D();
 	virtual ~NavigationServer3D();
 };
 
+VARIANT_ENUM_CAST(NavigationServer3D::ProcessInfo);
+
 typedef NavigationServer3D *(*NavigationServer3DCallback)();
 
 /// Manager used for the server singleton registration
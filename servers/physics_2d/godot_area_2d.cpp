@@ -30,8 +30,13 @@
 
 #include "godot_area_2d.h"
 #include "godot_body_2d.h"
+#include "godot_constraint_2d.h"
 #include "godot_space_2d.h"
 
+bool GodotArea2D::ConstraintOrder::operator()(const GodotConstraint2D *p_a, const GodotConstraint2D *p_b) const {
+	return p_a->get_creation_index() < p_b->get_creation_index();
+}
+
 GodotArea2D::BodyKey::BodyKey(GodotBody2D *p_body, uint32_t p_body_shape, uint32_t p_area_shape) {
 	rid = p_body->get_self();
 	instance_id = p_body->get_instance_id();
@@ -94,7 +94,15 @@ class GodotArea2D : public GodotCollisionObject2D {
 	Map<BodyKey, BodyState> monitored_bodies;
 	Map<BodyKey, BodyState> monitored_areas;
 
-	Set<GodotConstraint2D *> constraints;
+public:
+	// Orders constraints by creation rather than by address, see GodotConstraint2D::get_creation_index().
+	struct ConstraintOrder {
+		bool operator()(const GodotConstraint2D *p_a, const GodotConstraint2D *p_b) const;
+	};
+	typedef Set<GodotConstraint2D *, ConstraintOrder> ConstraintSet;
+
+private:
+	ConstraintSet constraints;
 
 	virtual void _shapes_changed();
 	void _queue_monitor_update();
@@ -143,7 +151,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(GodotConstraint2D *p_constraint) { constraints.insert(p_constraint); }
 	_FORCE_INLINE_ void remove_constraint(GodotConstraint2D *p_constraint) { constraints.erase(p_constraint); }
-	_FORCE_INLINE_ const Set<GodotConstraint2D *> &get_constraints() const { return constraints; }
+	_FORCE_INLINE_ const ConstraintSet &get_constraints() const { return constraints; }
 	_FORCE_INLINE_ void clear_constraints() { constraints.clear(); }
 
 	void set_monitorable(bool p_monitorable);
@@ -366,6 +366,37 @@ void GodotBody2D::set_state(PhysicsServer2D::BodyState p_state, const Variant &p
 	}
 }
 
+void GodotBody2D::save_state_snapshot(StateSnapshot &r_snapshot) const {
+	r_snapshot.transform = get_transform();
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.prev_linear_velocity = prev_linear_velocity;
+	r_snapshot.prev_angular_velocity = prev_angular_velocity;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+}
+
+void GodotBody2D::restore_state_snapshot(const StateSnapshot &p_snapshot) {
+	// Most bodies don't move between a snapshot and its restore when resimulating,
+	// skip the broadphase update for them.
+	if (get_transform() != p_snapshot.transform) {
+		_set_transform(p_snapshot.transform);
+		_set_inv_transform(p_snapshot.transform.affine_inverse());
+		_update_transform_dependent();
+	}
+	new_transform = p_snapshot.transform;
+
+	linear_velocity = p_snapshot.linear_velocity;
+	angular_velocity = p_snapshot.angular_velocity;
+	prev_linear_velocity = p_snapshot.prev_linear_velocity;
+	prev_angular_velocity = p_snapshot.prev_angular_velocity;
+	biased_linear_velocity = Vector2();
+	biased_angular_velocity = 0.0;
+	still_time = p_snapshot.still_time;
+
+	set_active(p_snapshot.active);
+}
+
 Variant GodotBody2D::get_state(PhysicsServer2D::BodyState p_state) const {
 	switch (p_state) {
 		case PhysicsServer2D::BODY_STATE_TRANSFORM: {
@@ -156,6 +156,20 @@ class GodotBody2D : public GodotCollisionObject2D {
 	friend class GodotPhysicsDirectBodyState2D; // i give up, too many functions to expose
 
 public:
+	// State changed by stepping, saved in space snapshots.
+	struct StateSnapshot {
+		Transform2D transform;
+		Vector2 linear_velocity;
+		real_t angular_velocity = 0.0;
+		Vector2 prev_linear_velocity;
+		real_t prev_angular_velocity = 0.0;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void save_state_snapshot(StateSnapshot &r_snapshot) const;
+	void restore_state_snapshot(const StateSnapshot &p_snapshot);
+
 	void set_state_sync_callback(void *p_instance, PhysicsServer2D::BodyStateCallback p_callback);
 	void set_force_integration_callback(const Callable &p_callable, const Variant &p_udata = Variant());
 
@@ -571,6 +571,41 @@ void GodotBodyPair2D::solve(real_t p_step) {
 	}
 }
 
+GodotConstraint2D::ContactCacheKey GodotBodyPair2D::get_contact_cache_key() const {
+	ContactCacheKey key;
+	key.object_A = A->get_self().get_id();
+	key.object_B = B->get_self().get_id();
+	key.shape_A = shape_A;
+	key.shape_B = shape_B;
+	return key;
+}
+
+void GodotBodyPair2D::save_contact_cache(uint8_t *r_cache) const {
+	ContactCache cache;
+	cache.sep_axis = sep_axis;
+	cache.contact_count = contact_count;
+	for (int i = 0; i < contact_count; i++) {
+		cache.contacts[i] = contacts[i];
+	}
+	memcpy(r_cache, &cache, sizeof(ContactCache));
+}
+
+void GodotBodyPair2D::restore_contact_cache(const uint8_t *p_cache) {
+	if (!p_cache) {
+		sep_axis = Vector2();
+		contact_count = 0;
+		return;
+	}
+
+	ContactCache cache;
+	memcpy(&cache, p_cache, sizeof(ContactCache));
+	sep_axis = cache.sep_axis;
+	contact_count = CLAMP(cache.contact_count, 0, (int)MAX_CONTACTS);
+	for (int i = 0; i < contact_count; i++) {
+		contacts[i] = cache.contacts[i];
+	}
+}
+
 GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B) :
 		GodotConstraint2D(_arr, 2) {
 	A = p_A;
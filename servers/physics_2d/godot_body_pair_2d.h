@@ -83,6 +83,12 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	bool oneway_disabled = false;
 	bool report_contacts_only = false;
 
+	struct ContactCache {
+		Vector2 sep_axis;
+		int contact_count = 0;
+		Contact contacts[MAX_CONTACTS];
+	};
+
 	bool _test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2D &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2D &p_xform_B);
 	void _validate_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
@@ -93,6 +99,11 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint32_t get_contact_cache_size() const override { return sizeof(ContactCache); }
+	virtual ContactCacheKey get_contact_cache_key() const override;
+	virtual void save_contact_cache(uint8_t *r_cache) const override;
+	virtual void restore_contact_cache(const uint8_t *p_cache) override;
+
 	GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B);
 	~GodotBodyPair2D();
 };
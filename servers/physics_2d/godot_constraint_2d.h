@@ -33,10 +33,14 @@
 
 #include "godot_body_2d.h"
 
+#include "core/templates/hashfuncs.h"
+#include "core/templates/safe_refcount.h"
+
 class GodotConstraint2D {
 	GodotBody2D **_body_ptr;
 	int _body_count;
 	uint64_t island_step = 0;
+	uint64_t creation_index = 0;
 	bool disabled_collisions_between_bodies = true;
 
 	RID self;
@@ -45,6 +49,13 @@ protected:
 	GodotConstraint2D(GodotBody2D **p_body_ptr = nullptr, int p_body_count = 0) {
 		_body_ptr = p_body_ptr;
 		_body_count = p_body_count;
+		creation_index = _next_creation_index();
+	}
+
+private:
+	static uint64_t _next_creation_index() {
+		static SafeNumeric<uint64_t> counter;
+		return counter.increment();
 	}
 
 public:
@@ -54,6 +65,29 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
+	// Unlike addresses, this follows the order constraints were created in.
+	_FORCE_INLINE_ uint64_t get_creation_index() const { return creation_index; }
+
+	// Identifies the contacts between two shapes in space snapshots, so they can be
+	// restored into a pair that was freed and created again since.
+	struct ContactCacheKey {
+		uint64_t object_A = 0;
+		uint64_t object_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+
+		_FORCE_INLINE_ bool operator==(const ContactCacheKey &p_key) const {
+			return object_A == p_key.object_A && object_B == p_key.object_B && shape_A == p_key.shape_A && shape_B == p_key.shape_B;
+		}
+
+		static _FORCE_INLINE_ uint32_t hash(const ContactCacheKey &p_key) {
+			uint64_t h = hash_djb2_one_64(p_key.object_A);
+			h = hash_djb2_one_64(p_key.object_B, h);
+			h = hash_djb2_one_64(((uint64_t)(uint32_t)p_key.shape_A << 32) | (uint32_t)p_key.shape_B, h);
+			return (uint32_t)h;
+		}
+	};
+
 	_FORCE_INLINE_ GodotBody2D **get_body_ptr() const { return _body_ptr; }
 	_FORCE_INLINE_ int get_body_count() const { return _body_count; }
 
@@ -64,6 +98,13 @@ public:
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// Contact state kept between steps, saved in space snapshots. Constraints without
+	// any return a size of 0. Restoring from nullptr resets the state.
+	virtual uint32_t get_contact_cache_size() const { return 0; }
+	virtual ContactCacheKey get_contact_cache_key() const { return ContactCacheKey(); }
+	virtual void save_contact_cache(uint8_t *r_cache) const {}
+	virtual void restore_contact_cache(const uint8_t *p_cache) {}
+
 	virtual ~GodotConstraint2D() {}
 };
 
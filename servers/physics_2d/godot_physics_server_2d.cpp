@@ -245,6 +245,44 @@ bool GodotPhysicsServer2D::space_is_active(RID p_space) const {
 	return active_spaces.has(space);
 }
 
+void GodotPhysicsServer2D::space_set_deterministic(RID p_space, bool p_deterministic) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND(!space);
+
+	space->set_deterministic(p_deterministic);
+}
+
+bool GodotPhysicsServer2D::space_is_deterministic(RID p_space) const {
+	const GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, false);
+
+	return space->is_deterministic();
+}
+
+int64_t GodotPhysicsServer2D::space_get_state_hash(RID p_space) const {
+	const GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, 0);
+
+	return (int64_t)space->get_state_hash();
+}
+
+Vector<uint8_t> GodotPhysicsServer2D::space_save_snapshot(RID p_space) const {
+	const GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, Vector<uint8_t>());
+
+	Vector<uint8_t> snapshot;
+	space->save_snapshot(snapshot);
+	return snapshot;
+}
+
+bool GodotPhysicsServer2D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, false);
+	ERR_FAIL_COND_V_MSG(space->is_locked(), false, "Space snapshots can't be restored while the space is being stepped.");
+
+	return space->restore_snapshot(p_snapshot);
+}
+
 void GodotPhysicsServer2D::space_set_param(RID p_space, SpaceParameter p_param, real_t p_value) {
 	GodotSpace2D *space = space_owner.get_or_null(p_space);
 	ERR_FAIL_COND(!space);
@@ -34,6 +34,7 @@
 #include "godot_physics_server_2d.h"
 
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/templates/pair.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
@@ -114,17 +115,13 @@ int GodotPhysicsDirectSpaceState2D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+static bool _intersect_ray_candidates(const PhysicsDirectSpaceState2D::RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D *const *p_objects, const int *p_subindices, int p_amount, PhysicsDirectSpaceState2D::RayResult &r_result) {
 	Vector2 begin, end;
 	Vector2 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -133,18 +130,18 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject2D *res_obj;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject2D *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_subindices[i];
 		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -203,39 +200,41 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
-int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
-	if (p_result_max <= 0) {
-		return 0;
-	}
+bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
 
-	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_COND_V(!shape, 0);
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
+	return _intersect_ray_candidates(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
+
+static Rect2 _get_shape_query_aabb(const PhysicsDirectSpaceState2D::ShapeParameters &p_parameters, const GodotShape2D *p_shape, const Transform2D &p_transform) {
+	Rect2 aabb = p_transform.xform(p_shape->get_aabb());
 	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
+	return aabb;
+}
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
+static int _intersect_shape_candidates(const PhysicsDirectSpaceState2D::ShapeParameters &p_parameters, const GodotShape2D *p_shape, const Transform2D &p_transform, GodotCollisionObject2D *const *p_objects, const int *p_subindices, int p_amount, PhysicsDirectSpaceState2D::ShapeResult *r_results, int p_result_max) {
 	int cc = 0;
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 		if (cc >= p_result_max) {
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject2D *col_obj = p_objects[i];
+		int shape_idx = p_subindices[i];
 
-		if (!GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!GodotCollisionSolver2D::solve(p_shape, p_transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
@@ -252,6 +251,153 @@ int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
+int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
+	if (p_result_max <= 0) {
+		return 0;
+	}
+
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_COND_V(!shape, 0);
+
+	Rect2 aabb = _get_shape_query_aabb(p_parameters, shape, p_parameters.transform);
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	return _intersect_shape_candidates(p_parameters, shape, p_parameters.transform, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_results, p_result_max);
+}
+
+// Sort key interleaving the bits of a point quantized within the batch bounds, so nearby queries end up next to each other.
+static uint32_t _get_batch_sort_key(const Vector2 &p_point, const Rect2 &p_bounds) {
+	uint32_t key = 0;
+	for (int i = 0; i < 2; i++) {
+		real_t extent = p_bounds.size[i];
+		uint32_t q = extent > 0 ? uint32_t(CLAMP((p_point[i] - p_bounds.position[i]) / extent, 0.0, 1.0) * 65535) : 0;
+		for (int b = 0; b < 16; b++) {
+			key |= ((q >> b) & 1) << (b * 2 + i);
+		}
+	}
+	return key;
+}
+
+void GodotPhysicsDirectSpaceState2D::_sort_batch(const Vector2 *p_points, int p_stride, int p_count, LocalVector<uint32_t> &r_order) {
+	Rect2 bounds(p_points[0], Vector2());
+	for (int i = 1; i < p_count; i++) {
+		bounds.expand_to(p_points[i * p_stride]);
+	}
+
+	LocalVector<BatchSortItem> items;
+	items.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		items[i].key = _get_batch_sort_key(p_points[i * p_stride], bounds);
+		items[i].index = i;
+	}
+	items.sort();
+
+	r_order.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		r_order[i] = items[i].index;
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::_intersect_rays_thread(uint32_t p_index, RayBatch *p_batch) {
+	uint32_t ray = p_batch->order[p_batch->first + p_index];
+	uint32_t offset = p_batch->offsets[p_index];
+	uint32_t amount = p_batch->offsets[p_index + 1] - offset;
+
+	RayResult &result = p_batch->results[ray];
+	result = RayResult();
+	_intersect_ray_candidates(*p_batch->parameters, p_batch->segments[ray * 2 + 0], p_batch->segments[ray * 2 + 1], p_batch->objects.ptr() + offset, p_batch->subindices.ptr() + offset, amount, result);
+}
+
+void GodotPhysicsDirectSpaceState2D::intersect_rays(const RayParameters &p_parameters, const Vector2 *p_segments, int p_ray_count, RayResult *r_results) {
+	ERR_FAIL_COND(space->locked);
+	if (p_ray_count <= 0) {
+		return;
+	}
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.segments = p_segments;
+	batch.results = r_results;
+	_sort_batch(p_segments, 2, p_ray_count, batch.order);
+
+	// The broadphase uses shared scratch buffers, so candidates are culled on this thread
+	// and only the narrow phase of each ray runs on the worker threads.
+	for (batch.first = 0; batch.first < (uint32_t)p_ray_count; batch.first += BATCH_SIZE) {
+		uint32_t count = MIN((uint32_t)BATCH_SIZE, p_ray_count - batch.first);
+		batch.clear_candidates();
+		for (uint32_t i = 0; i < count; i++) {
+			uint32_t ray = batch.order[batch.first + i];
+			int amount = space->broadphase->cull_segment(p_segments[ray * 2 + 0], p_segments[ray * 2 + 1], space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+			batch.add_candidates(space->intersection_query_results, space->intersection_query_subindex_results, amount);
+		}
+
+		if (count < BATCH_THREADING_THRESHOLD) {
+			for (uint32_t i = 0; i < count; i++) {
+				_intersect_rays_thread(i, &batch);
+			}
+		} else {
+			WorkerThreadPool::get_singleton()->do_work(count, this, &GodotPhysicsDirectSpaceState2D::_intersect_rays_thread, &batch);
+		}
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::_intersect_shapes_thread(uint32_t p_index, ShapeBatch *p_batch) {
+	uint32_t query = p_batch->order[p_batch->first + p_index];
+	uint32_t offset = p_batch->offsets[p_index];
+	uint32_t amount = p_batch->offsets[p_index + 1] - offset;
+
+	p_batch->result_counts[query] = _intersect_shape_candidates(*p_batch->parameters, p_batch->shape, p_batch->transforms[query], p_batch->objects.ptr() + offset, p_batch->subindices.ptr() + offset, amount, p_batch->results + query * p_batch->result_max, p_batch->result_max);
+}
+
+void GodotPhysicsDirectSpaceState2D::intersect_shapes(const ShapeParameters &p_parameters, const Transform2D *p_transforms, int p_query_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	// Queries that fail validation report no results.
+	for (int i = 0; i < p_query_count; i++) {
+		r_result_counts[i] = 0;
+	}
+	ERR_FAIL_COND(space->locked);
+	if (p_query_count <= 0 || p_result_max <= 0) {
+		return;
+	}
+
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_COND(!shape);
+
+	ShapeBatch batch;
+	batch.parameters = &p_parameters;
+	batch.shape = shape;
+	batch.transforms = p_transforms;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+
+	LocalVector<Vector2> origins;
+	origins.resize(p_query_count);
+	for (int i = 0; i < p_query_count; i++) {
+		origins[i] = p_transforms[i].get_origin();
+	}
+	_sort_batch(origins.ptr(), 1, p_query_count, batch.order);
+
+	// Same split as intersect_rays(): cull here, solve on the worker threads.
+	for (batch.first = 0; batch.first < (uint32_t)p_query_count; batch.first += BATCH_SIZE) {
+		uint32_t count = MIN((uint32_t)BATCH_SIZE, p_query_count - batch.first);
+		batch.clear_candidates();
+		for (uint32_t i = 0; i < count; i++) {
+			uint32_t query = batch.order[batch.first + i];
+			int amount = space->broadphase->cull_aabb(_get_shape_query_aabb(p_parameters, shape, p_transforms[query]), space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+			batch.add_candidates(space->intersection_query_results, space->intersection_query_subindex_results, amount);
+		}
+
+		if (count < BATCH_THREADING_THRESHOLD) {
+			for (uint32_t i = 0; i < count; i++) {
+				_intersect_shapes_thread(i, &batch);
+			}
+		} else {
+			WorkerThreadPool::get_singleton()->do_work(count, this, &GodotPhysicsDirectSpaceState2D::_intersect_shapes_thread, &batch);
+		}
+	}
+}
+
 bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
 	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
 	ERR_FAIL_COND_V(!shape, false);
@@ -1022,6 +1168,7 @@ void *GodotSpace2D::_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A
 
 	} else {
 		GodotBodyPair2D *b = memnew(GodotBodyPair2D((GodotBody2D *)A, p_subindex_A, (GodotBody2D *)B, p_subindex_B));
+		self->_restore_pending_contact_cache(b);
 		return b;
 	}
 
@@ -1077,6 +1224,245 @@ const Set<GodotCollisionObject2D *> &GodotSpace2D::get_objects() const {
 	return objects;
 }
 
+static _FORCE_INLINE_ uint64_t _hash_vector2(const Vector2 &p_vector, uint64_t p_hash) {
+	p_hash = hash_djb2_one_float_64(p_vector.x, p_hash);
+	return hash_djb2_one_float_64(p_vector.y, p_hash);
+}
+
+uint64_t GodotSpace2D::get_state_hash() const {
+	// Objects are hashed in RID order rather than by address. RID ids themselves differ
+	// between processes and are only used for ordering.
+	LocalVector<const GodotCollisionObject2D *> sorted_objects;
+	sorted_objects.reserve(objects.size());
+	for (const Set<GodotCollisionObject2D *>::Element *E = objects.front(); E; E = E->next()) {
+		sorted_objects.push_back(E->get());
+	}
+
+	struct RIDOrder {
+		_FORCE_INLINE_ bool operator()(const GodotCollisionObject2D *p_a, const GodotCollisionObject2D *p_b) const {
+			return p_a->get_self().get_id() < p_b->get_self().get_id();
+		}
+	};
+	sorted_objects.sort_custom<RIDOrder>();
+
+	uint64_t hash = hash_djb2_one_64(sorted_objects.size());
+	for (uint32_t i = 0; i < sorted_objects.size(); i++) {
+		const GodotCollisionObject2D *object = sorted_objects[i];
+		hash = hash_djb2_one_64(object->get_type(), hash);
+
+		const Transform2D &transform = object->get_transform();
+		for (int j = 0; j < 3; j++) {
+			hash = _hash_vector2(transform.elements[j], hash);
+		}
+
+		if (object->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			const GodotBody2D *body = static_cast<const GodotBody2D *>(object);
+			hash = hash_djb2_one_64(body->get_mode(), hash);
+			hash = hash_djb2_one_64(body->is_active(), hash);
+			hash = _hash_vector2(body->get_linear_velocity(), hash);
+			hash = hash_djb2_one_float_64(body->get_angular_velocity(), hash);
+		}
+	}
+	return hash;
+}
+
+// Snapshots are plain copies of the engine structures. They are meant to be restored
+// in the same process, and aren't portable between builds.
+struct SpaceSnapshotHeader2D {
+	uint32_t version = 0;
+	uint32_t body_count = 0;
+	uint32_t contact_cache_count = 0;
+};
+
+struct SpaceSnapshotBody2D {
+	uint64_t id = 0;
+	GodotBody2D::StateSnapshot state;
+};
+
+struct SpaceSnapshotContactCache2D {
+	GodotConstraint2D::ContactCacheKey key;
+	uint32_t size = 0; // Followed by the cache itself.
+};
+
+void GodotSpace2D::_get_bodies_in_rid_order(LocalVector<GodotBody2D *> &r_bodies) const {
+	r_bodies.clear();
+	for (const Set<GodotCollisionObject2D *>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			r_bodies.push_back(static_cast<GodotBody2D *>(E->get()));
+		}
+	}
+
+	struct RIDOrder {
+		_FORCE_INLINE_ bool operator()(const GodotBody2D *p_a, const GodotBody2D *p_b) const {
+			return p_a->get_self().get_id() < p_b->get_self().get_id();
+		}
+	};
+	r_bodies.sort_custom<RIDOrder>();
+}
+
+void GodotSpace2D::save_snapshot(Vector<uint8_t> &r_snapshot) const {
+	LocalVector<GodotBody2D *> bodies;
+	_get_bodies_in_rid_order(bodies);
+
+	// Pairs are saved once, from their first body.
+	LocalVector<const GodotConstraint2D *> contact_constraints;
+	uint32_t contact_caches_size = 0;
+	for (uint32_t body_index = 0; body_index < bodies.size(); body_index++) {
+		const List<Pair<GodotConstraint2D *, int>> &constraint_list = bodies[body_index]->get_constraint_list();
+		for (const List<Pair<GodotConstraint2D *, int>>::Element *E = constraint_list.front(); E; E = E->next()) {
+			const GodotConstraint2D *constraint = E->get().first;
+			uint32_t cache_size = constraint->get_contact_cache_size();
+			if (cache_size == 0 || E->get().second != 0) {
+				continue;
+			}
+			contact_constraints.push_back(constraint);
+			contact_caches_size += sizeof(SpaceSnapshotContactCache2D) + cache_size;
+		}
+	}
+	// Caches still waiting for their pair are carried over, in case it comes back after this snapshot is restored.
+	for (const GodotConstraint2D::ContactCacheKey *K = pending_contact_caches.next(nullptr); K; K = pending_contact_caches.next(K)) {
+		contact_caches_size += sizeof(SpaceSnapshotContactCache2D) + pending_contact_caches[*K].size();
+	}
+
+	r_snapshot.resize(sizeof(SpaceSnapshotHeader2D) + bodies.size() * sizeof(SpaceSnapshotBody2D) + contact_caches_size);
+	uint8_t *w = r_snapshot.ptrw();
+
+	SpaceSnapshotHeader2D header;
+	header.version = SNAPSHOT_VERSION;
+	header.body_count = bodies.size();
+	header.contact_cache_count = contact_constraints.size() + pending_contact_caches.size();
+	memcpy(w, &header, sizeof(SpaceSnapshotHeader2D));
+	w += sizeof(SpaceSnapshotHeader2D);
+
+	for (uint32_t body_index = 0; body_index < bodies.size(); body_index++) {
+		SpaceSnapshotBody2D body_snapshot;
+		body_snapshot.id = bodies[body_index]->get_self().get_id();
+		bodies[body_index]->save_state_snapshot(body_snapshot.state);
+		memcpy(w, &body_snapshot, sizeof(SpaceSnapshotBody2D));
+		w += sizeof(SpaceSnapshotBody2D);
+	}
+
+	for (uint32_t constraint_index = 0; constraint_index < contact_constraints.size(); constraint_index++) {
+		const GodotConstraint2D *constraint = contact_constraints[constraint_index];
+		SpaceSnapshotContactCache2D cache_header;
+		cache_header.key = constraint->get_contact_cache_key();
+		cache_header.size = constraint->get_contact_cache_size();
+		memcpy(w, &cache_header, sizeof(SpaceSnapshotContactCache2D));
+		w += sizeof(SpaceSnapshotContactCache2D);
+		constraint->save_contact_cache(w);
+		w += cache_header.size;
+	}
+
+	for (const GodotConstraint2D::ContactCacheKey *K = pending_contact_caches.next(nullptr); K; K = pending_contact_caches.next(K)) {
+		const Vector<uint8_t> &cache = pending_contact_caches[*K];
+		SpaceSnapshotContactCache2D cache_header;
+		cache_header.key = *K;
+		cache_header.size = cache.size();
+		memcpy(w, &cache_header, sizeof(SpaceSnapshotContactCache2D));
+		w += sizeof(SpaceSnapshotContactCache2D);
+		memcpy(w, cache.ptr(), cache_header.size);
+		w += cache_header.size;
+	}
+}
+
+bool GodotSpace2D::restore_snapshot(const Vector<uint8_t> &p_snapshot) {
+	const uint8_t *r = p_snapshot.ptr();
+	const uint8_t *r_end = r + p_snapshot.size();
+
+	ERR_FAIL_COND_V_MSG(p_snapshot.size() < (int)sizeof(SpaceSnapshotHeader2D), false, "Invalid physics space snapshot.");
+	SpaceSnapshotHeader2D header;
+	memcpy(&header, r, sizeof(SpaceSnapshotHeader2D));
+	r += sizeof(SpaceSnapshotHeader2D);
+	ERR_FAIL_COND_V_MSG(header.version != SNAPSHOT_VERSION, false, "Invalid physics space snapshot.");
+	ERR_FAIL_COND_V_MSG((uint64_t)(r_end - r) < (uint64_t)header.body_count * sizeof(SpaceSnapshotBody2D), false, "Invalid physics space snapshot.");
+
+	// Validate the contact caches before changing anything.
+	struct ContactCacheData {
+		const uint8_t *data = nullptr;
+		uint32_t size = 0;
+		bool restored = false;
+	};
+	HashMap<GodotConstraint2D::ContactCacheKey, ContactCacheData, GodotConstraint2D::ContactCacheKey> contact_caches;
+	const uint8_t *c = r + header.body_count * sizeof(SpaceSnapshotBody2D);
+	for (uint32_t cache_index = 0; cache_index < header.contact_cache_count; cache_index++) {
+		ERR_FAIL_COND_V_MSG(r_end - c < (int64_t)sizeof(SpaceSnapshotContactCache2D), false, "Invalid physics space snapshot.");
+		SpaceSnapshotContactCache2D cache_header;
+		memcpy(&cache_header, c, sizeof(SpaceSnapshotContactCache2D));
+		c += sizeof(SpaceSnapshotContactCache2D);
+		ERR_FAIL_COND_V_MSG((uint64_t)(r_end - c) < cache_header.size, false, "Invalid physics space snapshot.");
+		ContactCacheData cache_data;
+		cache_data.data = c;
+		cache_data.size = cache_header.size;
+		contact_caches.set(cache_header.key, cache_data);
+		c += cache_header.size;
+	}
+
+	// Both lists are in RID order, bodies created or freed since the snapshot are skipped.
+	LocalVector<GodotBody2D *> bodies;
+	_get_bodies_in_rid_order(bodies);
+
+	uint32_t body_index = 0;
+	for (uint32_t snapshot_index = 0; snapshot_index < header.body_count; snapshot_index++) {
+		SpaceSnapshotBody2D body_snapshot;
+		memcpy(&body_snapshot, r, sizeof(SpaceSnapshotBody2D));
+		r += sizeof(SpaceSnapshotBody2D);
+
+		while (body_index < bodies.size() && bodies[body_index]->get_self().get_id() < body_snapshot.id) {
+			body_index++;
+		}
+		if (body_index < bodies.size() && bodies[body_index]->get_self().get_id() == body_snapshot.id) {
+			bodies[body_index]->restore_state_snapshot(body_snapshot.state);
+			body_index++;
+		}
+	}
+
+	// Pairs that didn't exist when the snapshot was taken start without contacts.
+	for (body_index = 0; body_index < bodies.size(); body_index++) {
+		const List<Pair<GodotConstraint2D *, int>> &constraint_list = bodies[body_index]->get_constraint_list();
+		for (const List<Pair<GodotConstraint2D *, int>>::Element *E = constraint_list.front(); E; E = E->next()) {
+			GodotConstraint2D *constraint = E->get().first;
+			if (constraint->get_contact_cache_size() == 0 || E->get().second != 0) {
+				continue;
+			}
+			ContactCacheData *cache_data = contact_caches.getptr(constraint->get_contact_cache_key());
+			bool valid = cache_data && cache_data->size == constraint->get_contact_cache_size();
+			constraint->restore_contact_cache(valid ? cache_data->data : nullptr);
+			if (valid) {
+				cache_data->restored = true;
+			}
+		}
+	}
+
+	// Pairs that were removed since are created again by the broadphase in the next step,
+	// and get their contacts back then.
+	pending_contact_caches.clear();
+	for (const GodotConstraint2D::ContactCacheKey *K = contact_caches.next(nullptr); K; K = contact_caches.next(K)) {
+		const ContactCacheData &cache_data = contact_caches[*K];
+		if (cache_data.restored) {
+			continue;
+		}
+		Vector<uint8_t> cache;
+		cache.resize(cache_data.size);
+		memcpy(cache.ptrw(), cache_data.data, cache_data.size);
+		pending_contact_caches.set(*K, cache);
+	}
+
+	return true;
+}
+
+void GodotSpace2D::_restore_pending_contact_cache(GodotConstraint2D *p_constraint) {
+	if (pending_contact_caches.is_empty()) {
+		return;
+	}
+
+	GodotConstraint2D::ContactCacheKey key = p_constraint->get_contact_cache_key();
+	const Vector<uint8_t> *cache = pending_contact_caches.getptr(key);
+	if (cache && (uint32_t)cache->size() == p_constraint->get_contact_cache_size()) {
+		p_constraint->restore_contact_cache(cache->ptr());
+		pending_contact_caches.erase(key);
+	}
+}
+
 void GodotSpace2D::body_add_to_state_query_list(SelfList<GodotBody2D> *p_body) {
 	state_query_list.add(p_body);
 }
@@ -1130,6 +1516,9 @@ void GodotSpace2D::setup() {
 
 void GodotSpace2D::update() {
 	broadphase->update();
+
+	// Pairs of the last restored snapshot that weren't created again by now are gone.
+	pending_contact_caches.clear();
 }
 
 void GodotSpace2D::set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_value) {
@@ -40,17 +40,77 @@
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/typedefs.h"
 
 class GodotPhysicsDirectSpaceState2D : public PhysicsDirectSpaceState2D {
 	GDCLASS(GodotPhysicsDirectSpaceState2D, PhysicsDirectSpaceState2D);
 
+	enum {
+		BATCH_SIZE = 1024,
+		BATCH_THREADING_THRESHOLD = 32,
+	};
+
+	struct BatchSortItem {
+		uint32_t key = 0;
+		uint32_t index = 0;
+
+		bool operator<(const BatchSortItem &p_other) const { return key < p_other.key; }
+	};
+
+	// Batched queries in coherent order, and the broadphase candidates of the slice
+	// [first, first + BATCH_SIZE) being solved. Candidates of query first + i are in
+	// [offsets[i], offsets[i + 1]).
+	struct QueryBatch {
+		LocalVector<uint32_t> order;
+		uint32_t first = 0;
+		LocalVector<GodotCollisionObject2D *> objects;
+		LocalVector<int> subindices;
+		LocalVector<uint32_t> offsets;
+
+		void clear_candidates() {
+			objects.clear();
+			subindices.clear();
+			offsets.clear();
+			offsets.push_back(0);
+		}
+
+		void add_candidates(GodotCollisionObject2D *const *p_objects, const int *p_subindices, int p_amount) {
+			for (int i = 0; i < p_amount; i++) {
+				objects.push_back(p_objects[i]);
+				subindices.push_back(p_subindices[i]);
+			}
+			offsets.push_back(objects.size());
+		}
+	};
+
+	struct RayBatch : public QueryBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector2 *segments = nullptr;
+		RayResult *results = nullptr;
+	};
+
+	struct ShapeBatch : public QueryBatch {
+		const ShapeParameters *parameters = nullptr;
+		const GodotShape2D *shape = nullptr;
+		const Transform2D *transforms = nullptr;
+		ShapeResult *results = nullptr;
+		int result_max = 0;
+		int *result_counts = nullptr;
+	};
+
+	static void _sort_batch(const Vector2 *p_points, int p_stride, int p_count, LocalVector<uint32_t> &r_order);
+	void _intersect_rays_thread(uint32_t p_index, RayBatch *p_batch);
+	void _intersect_shapes_thread(uint32_t p_index, ShapeBatch *p_batch);
+
 public:
 	GodotSpace2D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector2 *p_segments, int p_ray_count, RayResult *r_results) override;
+	virtual void intersect_shapes(const ShapeParameters &p_parameters, const Transform2D *p_transforms, int p_query_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
@@ -104,6 +164,19 @@ private:
 	real_t contact_bias = 0.0;
 	real_t constraint_bias = 0.0;
 
+	bool deterministic = false;
+
+	enum {
+		SNAPSHOT_VERSION = 1
+	};
+
+	void _get_bodies_in_rid_order(LocalVector<GodotBody2D *> &r_bodies) const;
+
+	// Contact caches of the last restored snapshot whose pair didn't exist at the time. They
+	// are handed to the pair if the broadphase creates it again in the next step.
+	HashMap<GodotConstraint2D::ContactCacheKey, Vector<uint8_t>, GodotConstraint2D::ContactCacheKey> pending_contact_caches;
+	void _restore_pending_contact_cache(GodotConstraint2D *p_constraint);
+
 	enum {
 		INTERSECTION_QUERY_MAX = 2048
 	};
@@ -157,6 +230,9 @@ public:
 	void add_object(GodotCollisionObject2D *p_object);
 	void remove_object(GodotCollisionObject2D *p_object);
 	const Set<GodotCollisionObject2D *> &get_objects() const;
+	uint64_t get_state_hash() const;
+	void save_snapshot(Vector<uint8_t> &r_snapshot) const;
+	bool restore_snapshot(const Vector<uint8_t> &p_snapshot);
 
 	_FORCE_INLINE_ int get_solver_iterations() const { return solver_iterations; }
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
@@ -182,6 +258,9 @@ public:
 	void set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_value);
 	real_t get_param(PhysicsServer2D::SpaceParameter p_param) const;
 
+	void set_deterministic(bool p_deterministic) { deterministic = p_deterministic; }
+	bool is_deterministic() const { return deterministic; }
+
 	void set_island_count(int p_island_count) { island_count = p_island_count; }
 	int get_island_count() const { return island_count; }
 
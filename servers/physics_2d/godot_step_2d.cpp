@@ -31,6 +31,7 @@
 #include "godot_step_2d.h"
 
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 
 #define BODY_ISLAND_COUNT_RESERVE 128
 #define BODY_ISLAND_SIZE_RESERVE 512
@@ -38,6 +39,24 @@
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
+struct CreationOrder {
+	_FORCE_INLINE_ bool operator()(const GodotBody2D *p_a, const GodotBody2D *p_b) const {
+		return p_a->get_self().get_id() < p_b->get_self().get_id();
+	}
+};
+
+// The active list is in wake up order. Deterministic spaces go through it in
+// RID (creation) order instead.
+static void _get_active_bodies(const SelfList<GodotBody2D>::List &p_list, bool p_deterministic, LocalVector<GodotBody2D *> &r_bodies) {
+	r_bodies.clear();
+	for (const SelfList<GodotBody2D> *E = p_list.first(); E; E = E->next()) {
+		r_bodies.push_back(E->self());
+	}
+	if (p_deterministic) {
+		r_bodies.sort_custom<CreationOrder>();
+	}
+}
+
 void GodotStep2D::_populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
 
@@ -134,23 +153,21 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	iterations = p_space->get_solver_iterations();
 	delta = p_delta;
 
-	const SelfList<GodotBody2D>::List *body_list = &p_space->get_active_body_list();
+	const SelfList<GodotBody2D>::List &body_list = p_space->get_active_body_list();
+
+	const bool deterministic = p_space->is_deterministic();
 
 	/* INTEGRATE FORCES */
 
 	uint64_t profile_begtime = OS::get_singleton()->get_ticks_usec();
 	uint64_t profile_endtime = 0;
 
-	int active_count = 0;
-
-	const SelfList<GodotBody2D> *b = body_list->first();
-	while (b) {
-		b->self()->integrate_forces(p_delta);
-		b = b->next();
-		active_count++;
+	_get_active_bodies(body_list, deterministic, active_bodies);
+	for (uint32_t body_index = 0; body_index < active_bodies.size(); ++body_index) {
+		active_bodies[body_index]->integrate_forces(p_delta);
 	}
 
-	p_space->set_active_objects(active_count);
+	p_space->set_active_objects(active_bodies.size());
 
 	// Update the broadphase to register collision pairs.
 	p_space->update();
@@ -168,7 +185,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	const SelfList<GodotArea2D>::List &aml = p_space->get_moved_area_list();
 
 	while (aml.first()) {
-		for (const Set<GodotConstraint2D *>::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
+		for (const GodotArea2D::ConstraintSet::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
 			GodotConstraint2D *constraint = E->get();
 			if (constraint->get_island_step() == _step) {
 				continue;
@@ -191,12 +208,12 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
 
-	b = body_list->first();
+	_get_active_bodies(body_list, deterministic, active_bodies);
 
 	uint32_t body_island_count = 0;
 
-	while (b) {
-		GodotBody2D *body = b->self();
+	for (uint32_t body_index = 0; body_index < active_bodies.size(); ++body_index) {
+		GodotBody2D *body = active_bodies[body_index];
 
 		if (body->get_island_step() != _step) {
 			++body_island_count;
@@ -225,7 +242,6 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 				--island_count;
 			}
 		}
-		b = b->next();
 	}
 
 	p_space->set_island_count((int)island_count);
@@ -239,7 +255,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
 	uint32_t total_contraint_count = all_constraints.size();
-	work_pool.do_work(total_contraint_count, this, &GodotStep2D::_setup_contraint, nullptr);
+	WorkerThreadPool::get_singleton()->do_work(total_contraint_count, this, &GodotStep2D::_setup_contraint, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -258,7 +274,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
-	work_pool.do_work(island_count, this, &GodotStep2D::_solve_island, nullptr);
+	WorkerThreadPool::get_singleton()->do_work(island_count, this, &GodotStep2D::_solve_island, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -268,11 +284,10 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* INTEGRATE VELOCITIES */
 
-	b = body_list->first();
-	while (b) {
-		const SelfList<GodotBody2D> *n = b->next();
-		b->self()->integrate_velocities(p_delta);
-		b = n; // in case it shuts itself down
+	// Islands can wake up bodies, they start integrating this step.
+	_get_active_bodies(body_list, deterministic, active_bodies);
+	for (uint32_t body_index = 0; body_index < active_bodies.size(); ++body_index) {
+		active_bodies[body_index]->integrate_velocities(p_delta);
 	}
 
 	/* SLEEP / WAKE UP ISLANDS */
@@ -297,10 +312,4 @@ GodotStep2D::GodotStep2D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
-
-	work_pool.init();
-}
-
-GodotStep2D::~GodotStep2D() {
-	work_pool.finish();
 }
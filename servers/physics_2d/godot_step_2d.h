@@ -34,7 +34,6 @@
 #include "godot_space_2d.h"
 
 #include "core/templates/local_vector.h"
-#include "core/templates/thread_work_pool.h"
 
 class GodotStep2D {
 	uint64_t _step = 1;
@@ -42,11 +41,10 @@ class GodotStep2D {
 	int iterations = 0;
 	real_t delta = 0.0;
 
-	ThreadWorkPool work_pool;
-
 	LocalVector<LocalVector<GodotBody2D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint2D *>> constraint_islands;
 	LocalVector<GodotConstraint2D *> all_constraints;
+	LocalVector<GodotBody2D *> active_bodies;
 
 	void _populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island);
 	void _setup_contraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
@@ -57,7 +55,6 @@ class GodotStep2D {
 public:
 	void step(GodotSpace2D *p_space, real_t p_delta);
 	GodotStep2D();
-	~GodotStep2D();
 };
 
 #endif // GODOT_STEP_2D_H
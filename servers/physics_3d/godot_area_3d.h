@@ -32,6 +32,7 @@
 #define GODOT_AREA_3D_H
 
 #include "godot_collision_object_3d.h"
+#include "godot_constraint_3d.h"
 
 #include "core/templates/self_list.h"
 #include "servers/physics_server_3d.h"
@@ -39,7 +40,6 @@
 class GodotSpace3D;
 class GodotBody3D;
 class GodotSoftBody3D;
-class GodotConstraint3D;
 
 class GodotArea3D : public GodotCollisionObject3D {
 	PhysicsServer3D::AreaSpaceOverrideMode gravity_override_mode = PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED;
@@ -100,7 +100,7 @@ class GodotArea3D : public GodotCollisionObject3D {
 	Map<BodyKey, BodyState> monitored_bodies;
 	Map<BodyKey, BodyState> monitored_areas;
 
-	Set<GodotConstraint3D *> constraints;
+	GodotConstraint3D::OrderedSet constraints;
 
 	virtual void _shapes_changed();
 	void _queue_monitor_update();
@@ -164,7 +164,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(GodotConstraint3D *p_constraint) { constraints.insert(p_constraint); }
 	_FORCE_INLINE_ void remove_constraint(GodotConstraint3D *p_constraint) { constraints.erase(p_constraint); }
-	_FORCE_INLINE_ const Set<GodotConstraint3D *> &get_constraints() const { return constraints; }
+	_FORCE_INLINE_ const GodotConstraint3D::OrderedSet &get_constraints() const { return constraints; }
 	_FORCE_INLINE_ void clear_constraints() { constraints.clear(); }
 
 	void set_monitorable(bool p_monitorable);
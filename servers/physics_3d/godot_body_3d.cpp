@@ -187,6 +187,10 @@ void GodotBody3D::set_active(bool p_active) {
 	} else if (get_space()) {
 		get_space()->body_remove_from_active_list(&active_list);
 	}
+
+	if (get_space() && !sleep_state_update_list.in_list()) {
+		get_space()->body_add_to_sleep_state_update_list(&sleep_state_update_list);
+	}
 }
 
 void GodotBody3D::set_param(PhysicsServer3D::BodyParameter p_param, const Variant &p_value) {
@@ -415,6 +419,38 @@ void GodotBody3D::set_state(PhysicsServer3D::BodyState p_state, const Variant &p
 	}
 }
 
+void GodotBody3D::save_state_snapshot(StateSnapshot &r_snapshot) const {
+	r_snapshot.transform = get_transform();
+	r_snapshot.inv_transform = get_inv_transform();
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.prev_linear_velocity = prev_linear_velocity;
+	r_snapshot.prev_angular_velocity = prev_angular_velocity;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+}
+
+void GodotBody3D::restore_state_snapshot(const StateSnapshot &p_snapshot) {
+	// Most bodies don't move between a snapshot and its restore when resimulating,
+	// skip the broadphase update for them.
+	if (get_transform() != p_snapshot.transform) {
+		_set_transform(p_snapshot.transform);
+		_update_transform_dependent();
+	}
+	_set_inv_transform(p_snapshot.inv_transform);
+	new_transform = p_snapshot.transform;
+
+	linear_velocity = p_snapshot.linear_velocity;
+	angular_velocity = p_snapshot.angular_velocity;
+	prev_linear_velocity = p_snapshot.prev_linear_velocity;
+	prev_angular_velocity = p_snapshot.prev_angular_velocity;
+	biased_linear_velocity = Vector3();
+	biased_angular_velocity = Vector3();
+	still_time = p_snapshot.still_time;
+
+	set_active(p_snapshot.active);
+}
+
 Variant GodotBody3D::get_state(PhysicsServer3D::BodyState p_state) const {
 	switch (p_state) {
 		case PhysicsServer3D::BODY_STATE_TRANSFORM: {
@@ -448,6 +484,9 @@ void GodotBody3D::set_space(GodotSpace3D *p_space) {
 		if (direct_state_query_list.in_list()) {
 			get_space()->body_remove_from_state_query_list(&direct_state_query_list);
 		}
+		if (sleep_state_update_list.in_list()) {
+			get_space()->body_remove_from_sleep_state_update_list(&sleep_state_update_list);
+		}
 	}
 
 	_set_space(p_space);
@@ -457,6 +496,9 @@ void GodotBody3D::set_space(GodotSpace3D *p_space) {
 		if (active) {
 			get_space()->body_add_to_active_list(&active_list);
 		}
+		if (is_sleeping() == active) {
+			get_space()->body_add_to_sleep_state_update_list(&sleep_state_update_list);
+		}
 	}
 }
 
@@ -608,6 +650,7 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 	prev_angular_velocity = angular_velocity;
 
 	Vector3 motion;
+	real_t motion_angle = 0.0;
 	bool do_motion = false;
 
 	if (mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
@@ -652,6 +695,7 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 
 		if (continuous_cd) {
 			motion = linear_velocity * p_step;
+			motion_angle = angular_velocity.length() * p_step;
 			do_motion = true;
 		}
 	}
@@ -663,7 +707,7 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 	biased_linear_velocity = Vector3();
 
 	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+		_update_shapes_with_motion(motion, motion_angle, get_transform().origin + center_of_mass);
 	}
 
 	contact_count = 0;
@@ -704,6 +748,11 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 		return;
 	}
 
+	// Continuous collision detection stops the body at its earliest time of impact, the
+	// velocity is kept for the contact to be solved in the next step.
+	real_t step = p_step * ccd_motion_limit;
+	ccd_motion_limit = 1.0;
+
 	Vector3 total_angular_velocity = angular_velocity + biased_angular_velocity;
 
 	real_t ang_vel = total_angular_velocity.length();
@@ -711,7 +760,7 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 
 	if (!Math::is_zero_approx(ang_vel)) {
 		Vector3 ang_vel_axis = total_angular_velocity / ang_vel;
-		Basis rot(ang_vel_axis, ang_vel * p_step);
+		Basis rot(ang_vel_axis, ang_vel * step);
 		Basis identity3(1, 0, 0, 0, 1, 0, 0, 0, 1);
 		transform.origin += ((identity3 - rot) * transform.basis).xform(center_of_mass_local);
 		transform.basis = rot * transform.basis;
@@ -725,7 +774,7 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 		}
 	}*/
 
-	transform.origin += total_linear_velocity * p_step;
+	transform.origin += total_linear_velocity * step;
 
 	_set_transform(transform);
 	_set_inv_transform(get_transform().inverse());
@@ -822,7 +871,8 @@ GodotBody3D::GodotBody3D() :
 		GodotCollisionObject3D(TYPE_BODY),
 		active_list(this),
 		mass_properties_update_list(this),
-		direct_state_query_list(this) {
+		direct_state_query_list(this),
+		sleep_state_update_list(this) {
 	_set_static(false);
 }
 
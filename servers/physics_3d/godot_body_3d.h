@@ -33,10 +33,10 @@
 
 #include "godot_area_3d.h"
 #include "godot_collision_object_3d.h"
+#include "godot_constraint_3d.h"
 
 #include "core/templates/vset.h"
 
-class GodotConstraint3D;
 class GodotPhysicsDirectBodyState3D;
 
 class GodotBody3D : public GodotCollisionObject3D {
@@ -99,12 +99,14 @@ class GodotBody3D : public GodotCollisionObject3D {
 	SelfList<GodotBody3D> active_list;
 	SelfList<GodotBody3D> mass_properties_update_list;
 	SelfList<GodotBody3D> direct_state_query_list;
+	SelfList<GodotBody3D> sleep_state_update_list;
 
 	VSet<RID> exceptions;
 	bool omit_force_integration = false;
 	bool active = true;
 
 	bool continuous_cd = false;
+	real_t ccd_motion_limit = 1.0;
 	bool can_sleep = true;
 	bool first_time_kinematic = false;
 
@@ -112,7 +114,7 @@ class GodotBody3D : public GodotCollisionObject3D {
 	virtual void _shapes_changed();
 	Transform3D new_transform;
 
-	Map<GodotConstraint3D *, int> constraint_map;
+	GodotConstraint3D::OrderedMap<int> constraint_map;
 
 	Vector<AreaCMP> areas;
 
@@ -150,6 +152,21 @@ class GodotBody3D : public GodotCollisionObject3D {
 	friend class GodotPhysicsDirectBodyState3D; // i give up, too many functions to expose
 
 public:
+	// State changed by stepping, saved in space snapshots.
+	struct StateSnapshot {
+		Transform3D transform;
+		Transform3D inv_transform; // Saved too, as it's computed differently depending on how the transform was set.
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 prev_linear_velocity;
+		Vector3 prev_angular_velocity;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void save_state_snapshot(StateSnapshot &r_snapshot) const;
+	void restore_state_snapshot(const StateSnapshot &p_snapshot);
+
 	void set_state_sync_callback(void *p_instance, PhysicsServer3D::BodyStateCallback p_callback);
 	void set_force_integration_callback(const Callable &p_callable, const Variant &p_udata = Variant());
 
@@ -196,7 +213,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(GodotConstraint3D *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
 	_FORCE_INLINE_ void remove_constraint(GodotConstraint3D *p_constraint) { constraint_map.erase(p_constraint); }
-	const Map<GodotConstraint3D *, int> &get_constraint_map() const { return constraint_map; }
+	const GodotConstraint3D::OrderedMap<int> &get_constraint_map() const { return constraint_map; }
 	_FORCE_INLINE_ void clear_constraint_map() { constraint_map.clear(); }
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration = p_omit_force_integration; }
@@ -282,6 +299,10 @@ public:
 	void set_active(bool p_active);
 	_FORCE_INLINE_ bool is_active() const { return active; }
 
+	// Moves the shapes to the broadphase tree matching the active state.
+	// Deferred to the next broadphase update, as bodies can be woken during the step.
+	_FORCE_INLINE_ void update_sleep_state() { _set_sleeping(!active); }
+
 	_FORCE_INLINE_ void wakeup() {
 		if ((!get_space()) || mode == PhysicsServer3D::BODY_MODE_STATIC || mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 			return;
@@ -300,6 +321,8 @@ public:
 
 	_FORCE_INLINE_ void set_continuous_collision_detection(bool p_enable) { continuous_cd = p_enable; }
 	_FORCE_INLINE_ bool is_continuous_collision_detection_enabled() const { return continuous_cd; }
+	// Fraction of the step's motion to integrate, set to the earliest time of impact.
+	_FORCE_INLINE_ void limit_ccd_motion(real_t p_fraction) { ccd_motion_limit = MIN(ccd_motion_limit, p_fraction); }
 
 	void set_space(GodotSpace3D *p_space);
 
@@ -38,6 +38,27 @@
 #define MIN_VELOCITY 0.0001
 #define MAX_BIAS_ROTATION (Math_PI / 8)
 
+int GodotBodyContact3D::_find_recycled_contact(const Contact *p_contacts, int p_contact_count, const Contact &p_contact, real_t p_recycle_radius) {
+	real_t best_distance = p_recycle_radius * p_recycle_radius;
+	int best = -1;
+
+	for (int i = 0; i < p_contact_count; i++) {
+		const Contact &c = p_contacts[i];
+		if (c.used || c.index_A != p_contact.index_A || c.index_B != p_contact.index_B) {
+			// Already claimed by another new contact, or from other features.
+			continue;
+		}
+
+		real_t distance = MAX(c.local_A.distance_squared_to(p_contact.local_A), c.local_B.distance_squared_to(p_contact.local_B));
+		if (distance < best_distance) {
+			best_distance = distance;
+			best = i;
+		}
+	}
+
+	return best;
+}
+
 void GodotBodyPair3D::_contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, void *p_userdata) {
 	GodotBodyPair3D *pair = (GodotBodyPair3D *)p_userdata;
 	pair->contact_added_callback(p_point_A, p_index_A, p_point_B, p_index_B);
@@ -59,20 +80,19 @@ void GodotBodyPair3D::contact_added_callback(const Vector3 &p_point_A, int p_ind
 	contact.normal = (p_point_A - p_point_B).normalized();
 	contact.used = true;
 
-	// Attempt to determine if the contact will be reused.
+	// Attempt to determine if the contact will be reused: match it with the closest
+	// cached contact from the same features that wasn't claimed yet this step, so
+	// its accumulated impulses warm start the solver.
 	real_t contact_recycle_radius = space->get_contact_recycle_radius();
-
-	for (int i = 0; i < contact_count; i++) {
-		Contact &c = contacts[i];
-		if (c.local_A.distance_squared_to(local_A) < (contact_recycle_radius * contact_recycle_radius) &&
-				c.local_B.distance_squared_to(local_B) < (contact_recycle_radius * contact_recycle_radius)) {
-			contact.acc_normal_impulse = c.acc_normal_impulse;
-			contact.acc_bias_impulse = c.acc_bias_impulse;
-			contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
-			contact.acc_tangent_impulse = c.acc_tangent_impulse;
-			c = contact;
-			return;
-		}
+	int recycled = _find_recycled_contact(contacts, contact_count, contact, contact_recycle_radius);
+	if (recycled >= 0) {
+		Contact &c = contacts[recycled];
+		contact.acc_normal_impulse = c.acc_normal_impulse;
+		contact.acc_bias_impulse = c.acc_bias_impulse;
+		contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+		contact.acc_tangent_impulse = c.acc_tangent_impulse;
+		c = contact;
+		return;
 	}
 
 	// Figure out if the contact amount must be reduced to fit the new contact.
@@ -161,50 +181,101 @@ void GodotBodyPair3D::validate_contacts() {
 	}
 }
 
+GodotCollisionSolver3D::ShapeMotion GodotBodyPair3D::_get_ccd_motion(real_t p_step, const GodotBody3D *p_body) const {
+	// Shape transforms are relative to A's origin.
+	GodotCollisionSolver3D::ShapeMotion motion;
+	if (p_body->get_mode() > PhysicsServer3D::BODY_MODE_STATIC) {
+		motion.linear = p_body->get_linear_velocity() * p_step;
+		motion.angular = p_body->get_angular_velocity() * p_step;
+	}
+	motion.pivot = p_body->get_transform().origin - A->get_transform().origin + p_body->get_center_of_mass();
+	return motion;
+}
+
 bool GodotBodyPair3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B) {
-	Vector3 motion = p_A->get_linear_velocity() * p_step;
-	real_t mlen = motion.length();
-	if (mlen < CMP_EPSILON) {
+	GodotCollisionSolver3D::ShapeMotion motion_A = _get_ccd_motion(p_step, p_A);
+	GodotCollisionSolver3D::ShapeMotion motion_B = _get_ccd_motion(p_step, p_B);
+
+	const GodotShape3D *shape_A_ptr = p_A->get_shape(p_shape_A);
+	const GodotShape3D *shape_B_ptr = p_B->get_shape(p_shape_B);
+
+	AABB aabb_A = p_xform_A.xform(shape_A_ptr->get_aabb());
+
+	// How far points of A can move relative to B, rotation is bounded by the AABB size.
+	real_t sweep = (motion_A.linear - motion_B.linear).length() + motion_A.angular.length() * aabb_A.size.length();
+	if (motion_B.angular != Vector3()) {
+		sweep += motion_B.angular.length() * p_xform_B.xform(shape_B_ptr->get_aabb()).size.length();
+	}
+	if (sweep < CMP_EPSILON) {
 		return false;
 	}
 
-	Vector3 mnormal = motion / mlen;
+	// Did it move enough to even attempt the time of impact query? Let's say it should
+	// move more than 1/3 of the thinnest of the two objects, concave shapes have no thickness.
+	real_t thickness = aabb_A.size[aabb_A.size.min_axis_index()];
+	if (shape_B_ptr->is_concave()) {
+		thickness = 0.0;
+	} else if (shape_B_ptr->get_type() != PhysicsServer3D::SHAPE_WORLD_BOUNDARY) {
+		AABB aabb_B = p_xform_B.xform(shape_B_ptr->get_aabb());
+		thickness = MIN(thickness, aabb_B.size[aabb_B.size.min_axis_index()]);
+	}
+	bool fast_object = sweep > thickness * 0.3;
+	if (!fast_object) {
+		return false;
+	}
 
-	real_t min, max;
-	p_A->get_shape(p_shape_A)->project_range(mnormal, p_xform_A, min, max);
+	real_t max_penetration = space->get_contact_max_allowed_penetration();
 
-	// Did it move enough in this direction to even attempt raycast?
-	// Let's say it should move more than 1/3 the size of the object in that axis.
-	bool fast_object = mlen > (max - min) * 0.3;
-	if (!fast_object) {
+	real_t toi = 1.0;
+	if (!GodotCollisionSolver3D::solve_time_of_impact(shape_A_ptr, p_xform_A, motion_A, shape_B_ptr, p_xform_B, motion_B, max_penetration * 0.5, toi)) {
 		return false;
 	}
 
-	// Going too fast in that direction.
+	// Stop at the time of impact, and go just far enough into the other object for the
+	// contact to be detected next step. The velocity is kept, so the solver handles the
+	// impact there instead of it being damped here.
+	p_A->limit_ccd_motion(MIN(toi + max_penetration / sweep, (real_t)1.0));
+
+	return true;
+}
+
+bool GodotBodyPair3D::_test_ccd_core(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B) {
+	// Already touching, but the contacts only stop the points that touch. A fast body
+	// can keep most of its velocity and go through a thin object in the same step, when
+	// it spins or only hits with a corner. Make sure a sphere inside the shape doesn't.
+	const GodotShape3D *shape_A_ptr = p_A->get_shape(p_shape_A);
+	const GodotShape3D *shape_B_ptr = p_B->get_shape(p_shape_B);
 
-	// Cast a segment from support in motion normal, in the same direction of motion by motion length.
-	// Support is the worst case collision point, so real collision happened before.
-	Vector3 s = p_A->get_shape(p_shape_A)->get_support(p_xform_A.basis.xform(mnormal).normalized());
-	Vector3 from = p_xform_A.xform(s);
-	Vector3 to = from + motion;
+	const AABB local_aabb = shape_A_ptr->get_aabb();
+	const real_t radius = local_aabb.size[local_aabb.size.min_axis_index()] * 0.25;
+	const Vector3 center = p_xform_A.xform(local_aabb.get_center());
 
-	Transform3D from_inv = p_xform_B.affine_inverse();
+	GodotCollisionSolver3D::ShapeMotion motion_A = _get_ccd_motion(p_step, p_A);
+	GodotCollisionSolver3D::ShapeMotion motion_B = _get_ccd_motion(p_step, p_B);
+
+	// Only when the sphere can move through its own size.
+	real_t sweep = (motion_A.linear - motion_B.linear).length() + motion_A.angular.length() * center.distance_to(motion_A.pivot);
+	if (motion_B.angular != Vector3()) {
+		sweep += motion_B.angular.length() * p_xform_B.xform(shape_B_ptr->get_aabb()).size.length();
+	}
+	if (sweep < radius) {
+		return false;
+	}
 
-	// Start from a little inside the bounding box.
-	Vector3 local_from = from_inv.xform(from - mnormal * mlen * 0.1);
-	Vector3 local_to = from_inv.xform(to);
+	GodotSphereShape3D core;
+	core.set_data(radius);
 
-	Vector3 rpos, rnorm;
-	if (!p_B->get_shape(p_shape_B)->intersect_segment(local_from, local_to, rpos, rnorm, true)) {
+	real_t toi = 1.0;
+	if (!GodotCollisionSolver3D::solve_time_of_impact(&core, Transform3D(Basis(), center), motion_A, shape_B_ptr, p_xform_B, motion_B, 0.0, toi)) {
 		return false;
 	}
 
-	// Shorten the linear velocity so it does not hit, but gets close enough,
-	// next frame will hit softly or soft enough.
-	Vector3 hitpos = p_xform_B.xform(rpos);
+	if (toi <= 0.0) {
+		// Already that deep, leave it to the contacts.
+		return false;
+	}
 
-	real_t newlen = hitpos.distance_to(from) - (max - min) * 0.01;
-	p_A->set_linear_velocity((mnormal * newlen) / p_step);
+	p_A->limit_ccd_motion(toi);
 
 	return true;
 }
@@ -255,43 +326,56 @@ bool GodotBodyPair3D::setup(real_t p_step) {
 
 	collided = GodotCollisionSolver3D::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
 
-	if (!collided) {
-		if (A->is_continuous_collision_detection_enabled() && collide_A) {
-			check_ccd = true;
-			return true;
-		}
+	if (A->is_continuous_collision_detection_enabled() && collide_A) {
+		check_ccd = true;
+	}
 
-		if (B->is_continuous_collision_detection_enabled() && collide_B) {
-			check_ccd = true;
-			return true;
-		}
+	if (B->is_continuous_collision_detection_enabled() && collide_B) {
+		check_ccd = true;
+	}
+
+	return collided || check_ccd;
+}
 
+bool GodotBodyPair3D::is_pre_solve_thread_safe() const {
+	// Only dynamic bodies are owned by the island, others can be touched by other islands.
+	if (A->can_report_contacts() && A->get_mode() <= PhysicsServer3D::BODY_MODE_KINEMATIC) {
 		return false;
 	}
-
-	return true;
+	if (B->can_report_contacts() && B->get_mode() <= PhysicsServer3D::BODY_MODE_KINEMATIC) {
+		return false;
+	}
+	return !space->is_debugging_contacts();
 }
 
 bool GodotBodyPair3D::pre_solve(real_t p_step) {
-	if (!collided) {
-		if (check_ccd) {
-			const Vector3 &offset_A = A->get_transform().get_origin();
-			Transform3D xform_Au = Transform3D(A->get_transform().basis, Vector3());
-			Transform3D xform_A = xform_Au * A->get_shape_transform(shape_A);
+	if (check_ccd) {
+		const Vector3 &offset_A = A->get_transform().get_origin();
+		Transform3D xform_Au = Transform3D(A->get_transform().basis, Vector3());
+		Transform3D xform_A = xform_Au * A->get_shape_transform(shape_A);
 
-			Transform3D xform_Bu = B->get_transform();
-			xform_Bu.origin -= offset_A;
-			Transform3D xform_B = xform_Bu * B->get_shape_transform(shape_B);
+		Transform3D xform_Bu = B->get_transform();
+		xform_Bu.origin -= offset_A;
+		Transform3D xform_B = xform_Bu * B->get_shape_transform(shape_B);
 
-			if (A->is_continuous_collision_detection_enabled() && collide_A) {
+		if (A->is_continuous_collision_detection_enabled() && collide_A) {
+			if (collided) {
+				_test_ccd_core(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
+			} else {
 				_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
 			}
+		}
 
-			if (B->is_continuous_collision_detection_enabled() && collide_B) {
+		if (B->is_continuous_collision_detection_enabled() && collide_B) {
+			if (collided) {
+				_test_ccd_core(p_step, B, shape_B, xform_B, A, shape_A, xform_A);
+			} else {
 				_test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A);
 			}
 		}
+	}
 
+	if (!collided) {
 		return false;
 	}
 
@@ -404,6 +488,8 @@ bool GodotBodyPair3D::pre_solve(real_t p_step) {
 }
 
 void GodotBodyPair3D::solve(real_t p_step) {
+	residual = 0.0;
+
 	if (!collided) {
 		return;
 	}
@@ -441,6 +527,7 @@ void GodotBodyPair3D::solve(real_t p_step) {
 			c.acc_bias_impulse = MAX(jbnOld + jbn, 0.0f);
 
 			Vector3 jb = c.normal * (c.acc_bias_impulse - jbnOld);
+			residual = MAX(residual, Math::abs(c.acc_bias_impulse - jbnOld));
 
 			if (collide_A) {
 				A->apply_bias_impulse(-jb, c.rA + A->get_center_of_mass(), max_bias_av);
@@ -486,6 +573,7 @@ void GodotBodyPair3D::solve(real_t p_step) {
 			c.acc_normal_impulse = MAX(jnOld + jn, 0.0f);
 
 			Vector3 j = c.normal * (c.acc_normal_impulse - jnOld);
+			residual = MAX(residual, Math::abs(c.acc_normal_impulse - jnOld));
 
 			if (collide_A) {
 				A->apply_impulse(-j, c.rA + A->get_center_of_mass());
@@ -532,6 +620,7 @@ void GodotBodyPair3D::solve(real_t p_step) {
 			}
 
 			jt = c.acc_tangent_impulse - jtOld;
+			residual = MAX(residual, jt.length());
 
 			if (collide_A) {
 				A->apply_impulse(-jt, c.rA + A->get_center_of_mass());
@@ -545,6 +634,41 @@ void GodotBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+GodotConstraint3D::ContactCacheKey GodotBodyPair3D::get_contact_cache_key() const {
+	ContactCacheKey key;
+	key.object_A = A->get_self().get_id();
+	key.object_B = B->get_self().get_id();
+	key.shape_A = shape_A;
+	key.shape_B = shape_B;
+	return key;
+}
+
+void GodotBodyPair3D::save_contact_cache(uint8_t *r_cache) const {
+	ContactCache cache;
+	cache.sep_axis = sep_axis;
+	cache.contact_count = contact_count;
+	for (int i = 0; i < contact_count; i++) {
+		cache.contacts[i] = contacts[i];
+	}
+	memcpy(r_cache, &cache, sizeof(ContactCache));
+}
+
+void GodotBodyPair3D::restore_contact_cache(const uint8_t *p_cache) {
+	if (!p_cache) {
+		sep_axis = Vector3();
+		contact_count = 0;
+		return;
+	}
+
+	ContactCache cache;
+	memcpy(&cache, p_cache, sizeof(ContactCache));
+	sep_axis = cache.sep_axis;
+	contact_count = CLAMP(cache.contact_count, 0, (int)MAX_CONTACTS);
+	for (int i = 0; i < contact_count; i++) {
+		contacts[i] = cache.contacts[i];
+	}
+}
+
 GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B) :
 		GodotBodyContact3D(_arr, 2) {
 	A = p_A;
@@ -677,6 +801,17 @@ bool GodotBodySoftBodyPair3D::setup(real_t p_step) {
 	return collided;
 }
 
+bool GodotBodySoftBodyPair3D::is_pre_solve_thread_safe() const {
+	if (body->can_report_contacts() && body->get_mode() <= PhysicsServer3D::BODY_MODE_KINEMATIC) {
+		return false;
+	}
+	// Waking the body up edits the space's active and sleep state lists.
+	if (body_collides && !body->is_active()) {
+		return false;
+	}
+	return !space->is_debugging_contacts();
+}
+
 bool GodotBodySoftBodyPair3D::pre_solve(real_t p_step) {
 	if (!collided) {
 		return false;
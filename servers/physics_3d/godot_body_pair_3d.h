@@ -32,6 +32,7 @@
 #define GODOT_BODY_PAIR_3D_H
 
 #include "godot_body_3d.h"
+#include "godot_collision_solver_3d.h"
 #include "godot_constraint_3d.h"
 #include "godot_soft_body_3d.h"
 
@@ -64,6 +65,11 @@ protected:
 
 	GodotSpace3D *space = nullptr;
 
+	// Largest impulse change applied by the last solve() call.
+	real_t residual = 0.0;
+
+	static int _find_recycled_contact(const Contact *p_contacts, int p_contact_count, const Contact &p_contact, real_t p_recycle_radius);
+
 	GodotBodyContact3D(GodotBody3D **p_body_ptr = nullptr, int p_body_count = 0) :
 			GodotConstraint3D(p_body_ptr, p_body_count) {
 	}
@@ -96,17 +102,32 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	struct ContactCache {
+		Vector3 sep_axis;
+		int contact_count = 0;
+		Contact contacts[MAX_CONTACTS];
+	};
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B);
 
 	void validate_contacts();
+	GodotCollisionSolver3D::ShapeMotion _get_ccd_motion(real_t p_step, const GodotBody3D *p_body) const;
 	bool _test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
+	bool _test_ccd_core(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
 
 public:
 	virtual bool setup(real_t p_step) override;
+	virtual bool is_pre_solve_thread_safe() const override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
+	virtual real_t get_solve_residual() const override { return residual; }
+
+	virtual uint32_t get_contact_cache_size() const override { return sizeof(ContactCache); }
+	virtual ContactCacheKey get_contact_cache_key() const override;
+	virtual void save_contact_cache(uint8_t *r_cache) const override;
+	virtual void restore_contact_cache(const uint8_t *p_cache) override;
 
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
 	~GodotBodyPair3D();
@@ -133,6 +154,7 @@ class GodotBodySoftBodyPair3D : public GodotBodyContact3D {
 
 public:
 	virtual bool setup(real_t p_step) override;
+	virtual bool is_pre_solve_thread_safe() const override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
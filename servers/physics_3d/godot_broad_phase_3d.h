@@ -51,6 +51,8 @@ public:
 	virtual ID create(GodotCollisionObject3D *p_object_, int p_subindex = 0, const AABB &p_aabb = AABB(), bool p_static = false) = 0;
 	virtual void move(ID p_id, const AABB &p_aabb) = 0;
 	virtual void set_static(ID p_id, bool p_static) = 0;
+	// Sleeping objects are kept apart from the awake ones, but still pair with them.
+	virtual void set_sleeping(ID p_id, bool p_sleeping) = 0;
 	virtual void remove(ID p_id) = 0;
 
 	virtual GodotCollisionObject3D *get_object(ID p_id) const = 0;
@@ -66,6 +68,9 @@ public:
 
 	virtual void update() = 0;
 
+	// Candidate pairs tested since the broadphase was created.
+	virtual uint64_t get_pair_test_count() const = 0;
+
 	virtual ~GodotBroadPhase3D();
 };
 
@@ -34,7 +34,7 @@
 
 GodotBroadPhase3DBVH::ID GodotBroadPhase3DBVH::create(GodotCollisionObject3D *p_object, int p_subindex, const AABB &p_aabb, bool p_static) {
 	uint32_t tree_id = p_static ? TREE_STATIC : TREE_DYNAMIC;
-	uint32_t tree_collision_mask = p_static ? TREE_FLAG_DYNAMIC : (TREE_FLAG_STATIC | TREE_FLAG_DYNAMIC);
+	uint32_t tree_collision_mask = p_static ? STATIC_COLLISION_MASK : DYNAMIC_COLLISION_MASK;
 	ID oid = bvh.create(p_object, true, tree_id, tree_collision_mask, p_aabb, p_subindex); // Pair everything, don't care?
 	return oid + 1;
 }
@@ -45,10 +45,18 @@ void GodotBroadPhase3DBVH::move(ID p_id, const AABB &p_aabb) {
 
 void GodotBroadPhase3DBVH::set_static(ID p_id, bool p_static) {
 	uint32_t tree_id = p_static ? TREE_STATIC : TREE_DYNAMIC;
-	uint32_t tree_collision_mask = p_static ? TREE_FLAG_DYNAMIC : (TREE_FLAG_STATIC | TREE_FLAG_DYNAMIC);
+	uint32_t tree_collision_mask = p_static ? STATIC_COLLISION_MASK : DYNAMIC_COLLISION_MASK;
 	bvh.set_tree(p_id - 1, tree_id, tree_collision_mask, false);
 }
 
+void GodotBroadPhase3DBVH::set_sleeping(ID p_id, bool p_sleeping) {
+	if (bvh.get_tree_id(p_id - 1) == TREE_STATIC) {
+		return;
+	}
+	uint32_t tree_id = p_sleeping ? TREE_SLEEPING : TREE_DYNAMIC;
+	bvh.set_tree(p_id - 1, tree_id, DYNAMIC_COLLISION_MASK, false);
+}
+
 void GodotBroadPhase3DBVH::remove(ID p_id) {
 	bvh.erase(p_id - 1);
 }
@@ -61,7 +69,7 @@ GodotCollisionObject3D *GodotBroadPhase3DBVH::get_object(ID p_id) const {
 
 bool GodotBroadPhase3DBVH::is_static(ID p_id) const {
 	uint32_t tree_id = bvh.get_tree_id(p_id - 1);
-	return tree_id == 0;
+	return tree_id == TREE_STATIC;
 }
 
 int GodotBroadPhase3DBVH::get_subindex(ID p_id) const {
@@ -112,6 +120,10 @@ void GodotBroadPhase3DBVH::update() {
 	bvh.update();
 }
 
+uint64_t GodotBroadPhase3DBVH::get_pair_test_count() const {
+	return bvh.get_pair_test_count();
+}
+
 GodotBroadPhase3D *GodotBroadPhase3DBVH::_create() {
 	return memnew(GodotBroadPhase3DBVH);
 }
@@ -119,4 +131,6 @@ GodotBroadPhase3D *GodotBroadPhase3DBVH::_create() {
 GodotBroadPhase3DBVH::GodotBroadPhase3DBVH() {
 	bvh.set_pair_callback(_pair_callback, this);
 	bvh.set_unpair_callback(_unpair_callback, this);
+	// The pair test only reads collision layers and masks.
+	bvh.params_set_parallel_pairing(true);
 }
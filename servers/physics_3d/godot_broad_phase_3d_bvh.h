@@ -53,17 +53,29 @@ class GodotBroadPhase3DBVH : public GodotBroadPhase3D {
 		}
 	};
 
+	// Only items that move are pair tested, so static and sleeping objects are
+	// kept out of the dynamic tree to keep its refits and culls small.
 	enum Tree {
 		TREE_STATIC = 0,
 		TREE_DYNAMIC = 1,
+		TREE_SLEEPING = 2,
+		TREE_MAX,
 	};
 
 	enum TreeFlag {
 		TREE_FLAG_STATIC = 1 << TREE_STATIC,
 		TREE_FLAG_DYNAMIC = 1 << TREE_DYNAMIC,
+		TREE_FLAG_SLEEPING = 1 << TREE_SLEEPING,
 	};
 
-	BVH_Manager<GodotCollisionObject3D, 2, true, 128, UserPairTestFunction<GodotCollisionObject3D>, UserCullTestFunction<GodotCollisionObject3D>> bvh;
+	// Static objects don't pair with each other. Sleeping objects keep all their pairs,
+	// so islands stay connected and contacts are kept while they sleep.
+	enum TreeCollisionMask {
+		STATIC_COLLISION_MASK = TREE_FLAG_DYNAMIC | TREE_FLAG_SLEEPING,
+		DYNAMIC_COLLISION_MASK = TREE_FLAG_STATIC | TREE_FLAG_DYNAMIC | TREE_FLAG_SLEEPING,
+	};
+
+	BVH_Manager<GodotCollisionObject3D, TREE_MAX, true, 128, UserPairTestFunction<GodotCollisionObject3D>, UserCullTestFunction<GodotCollisionObject3D>> bvh;
 
 	static void *_pair_callback(void *, uint32_t, GodotCollisionObject3D *, int, uint32_t, GodotCollisionObject3D *, int);
 	static void _unpair_callback(void *, uint32_t, GodotCollisionObject3D *, int, uint32_t, GodotCollisionObject3D *, int, void *);
@@ -78,6 +90,7 @@ public:
 	virtual ID create(GodotCollisionObject3D *p_object, int p_subindex = 0, const AABB &p_aabb = AABB(), bool p_static = false);
 	virtual void move(ID p_id, const AABB &p_aabb);
 	virtual void set_static(ID p_id, bool p_static);
+	virtual void set_sleeping(ID p_id, bool p_sleeping);
 	virtual void remove(ID p_id);
 
 	virtual GodotCollisionObject3D *get_object(ID p_id) const;
@@ -93,6 +106,8 @@ public:
 
 	virtual void update();
 
+	virtual uint64_t get_pair_test_count() const;
+
 	static GodotBroadPhase3D *_create();
 	GodotBroadPhase3DBVH();
 };
@@ -138,6 +138,26 @@ void GodotCollisionObject3D::_set_static(bool p_static) {
 		const Shape &s = shapes[i];
 		if (s.bpid > 0) {
 			space->get_broadphase()->set_static(s.bpid, _static);
+			if (_sleeping) {
+				space->get_broadphase()->set_sleeping(s.bpid, true);
+			}
+		}
+	}
+}
+
+void GodotCollisionObject3D::_set_sleeping(bool p_sleeping) {
+	if (_sleeping == p_sleeping) {
+		return;
+	}
+	_sleeping = p_sleeping;
+
+	if (!space) {
+		return;
+	}
+	for (int i = 0; i < get_shape_count(); i++) {
+		const Shape &s = shapes[i];
+		if (s.bpid > 0) {
+			space->get_broadphase()->set_sleeping(s.bpid, _sleeping);
 		}
 	}
 }
@@ -176,13 +196,16 @@ void GodotCollisionObject3D::_update_shapes() {
 		if (s.bpid == 0) {
 			s.bpid = space->get_broadphase()->create(this, i, shape_aabb, _static);
 			space->get_broadphase()->set_static(s.bpid, _static);
+			if (_sleeping) {
+				space->get_broadphase()->set_sleeping(s.bpid, true);
+			}
 		}
 
 		space->get_broadphase()->move(s.bpid, shape_aabb);
 	}
 }
 
-void GodotCollisionObject3D::_update_shapes_with_motion(const Vector3 &p_motion) {
+void GodotCollisionObject3D::_update_shapes_with_motion(const Vector3 &p_motion, real_t p_angle, const Vector3 &p_pivot) {
 	if (!space) {
 		return;
 	}
@@ -197,12 +220,23 @@ void GodotCollisionObject3D::_update_shapes_with_motion(const Vector3 &p_motion)
 		AABB shape_aabb = s.shape->get_aabb();
 		Transform3D xform = transform * s.xform;
 		shape_aabb = xform.xform(shape_aabb);
+		if (p_angle > 0.0) {
+			// Rotating moves points by at most the arc length around the pivot.
+			real_t radius_squared = 0.0;
+			for (int j = 0; j < 8; j++) {
+				radius_squared = MAX(radius_squared, shape_aabb.get_endpoint(j).distance_squared_to(p_pivot));
+			}
+			shape_aabb.grow_by(MIN(p_angle, (real_t)Math_PI) * Math::sqrt(radius_squared));
+		}
 		shape_aabb.merge_with(AABB(shape_aabb.position + p_motion, shape_aabb.size)); //use motion
 		s.aabb_cache = shape_aabb;
 
 		if (s.bpid == 0) {
 			s.bpid = space->get_broadphase()->create(this, i, shape_aabb, _static);
 			space->get_broadphase()->set_static(s.bpid, _static);
+			if (_sleeping) {
+				space->get_broadphase()->set_sleeping(s.bpid, true);
+			}
 		}
 
 		space->get_broadphase()->move(s.bpid, shape_aabb);
@@ -75,13 +75,14 @@ private:
 	Transform3D transform;
 	Transform3D inv_transform;
 	bool _static = true;
+	bool _sleeping = false;
 
 	SelfList<GodotCollisionObject3D> pending_shape_update_list;
 
 	void _update_shapes();
 
 protected:
-	void _update_shapes_with_motion(const Vector3 &p_motion);
+	void _update_shapes_with_motion(const Vector3 &p_motion, real_t p_angle = 0.0, const Vector3 &p_pivot = Vector3());
 	void _unregister_shapes();
 
 	_FORCE_INLINE_ void _set_transform(const Transform3D &p_transform, bool p_update_shapes = true) {
@@ -97,6 +98,7 @@ protected:
 	}
 	_FORCE_INLINE_ void _set_inv_transform(const Transform3D &p_transform) { inv_transform = p_transform; }
 	void _set_static(bool p_static);
+	void _set_sleeping(bool p_sleeping);
 
 	virtual void _shapes_changed() = 0;
 	void _set_space(GodotSpace3D *p_space);
@@ -179,6 +181,7 @@ public:
 	virtual void set_space(GodotSpace3D *p_space) = 0;
 
 	_FORCE_INLINE_ bool is_static() const { return _static; }
+	_FORCE_INLINE_ bool is_sleeping() const { return _sleeping; }
 
 	virtual ~GodotCollisionObject3D() {}
 };
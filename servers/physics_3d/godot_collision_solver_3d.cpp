@@ -570,3 +570,149 @@ bool GodotCollisionSolver3D::solve_distance(const GodotShape3D *p_shape_A, const
 		return gjk_epa_calculate_distance(p_shape_A, p_transform_A, p_shape_B, p_transform_B, r_point_A, r_point_B); //should pass sepaxis..
 	}
 }
+
+#define TIME_OF_IMPACT_MAX_ITERATIONS 32
+
+static _FORCE_INLINE_ Transform3D _get_transform_at_time(const Transform3D &p_transform, const GodotCollisionSolver3D::ShapeMotion &p_motion, real_t p_time) {
+	Transform3D transform = p_transform;
+	real_t angle = p_motion.angular.length() * p_time;
+	if (!Math::is_zero_approx(angle)) {
+		Basis rot(p_motion.angular.normalized(), angle);
+		transform.basis = rot * transform.basis;
+		transform.origin = p_motion.pivot + rot.xform(transform.origin - p_motion.pivot);
+	}
+	transform.origin += p_motion.linear * p_time;
+	return transform;
+}
+
+// Farthest a point of the shape is from the pivot, bounds how far rotating moves it.
+static real_t _get_motion_radius(const GodotShape3D *p_shape, const Transform3D &p_transform, const GodotCollisionSolver3D::ShapeMotion &p_motion) {
+	if (p_motion.angular == Vector3()) {
+		return 0.0; // Also keeps unbounded shapes out of it.
+	}
+
+	AABB aabb = p_transform.xform(p_shape->get_aabb());
+	real_t radius_squared = 0.0;
+	for (int i = 0; i < 8; i++) {
+		radius_squared = MAX(radius_squared, aabb.get_endpoint(i).distance_squared_to(p_motion.pivot));
+	}
+	return Math::sqrt(radius_squared);
+}
+
+bool GodotCollisionSolver3D::solve_time_of_impact_convex(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const ShapeMotion &p_motion_A, real_t p_radius_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, const ShapeMotion &p_motion_B, real_t p_radius_B, real_t p_tolerance, real_t &r_toi) {
+	// Conservative advancement: the closest points can't approach faster than the relative
+	// linear motion along their direction plus the rotation of the farthest points, so
+	// advancing by the distance over that bound never steps through the other shape.
+	const Vector3 linear_motion = p_motion_A.linear - p_motion_B.linear;
+	const real_t angular_bound = p_motion_A.angular.length() * p_radius_A + p_motion_B.angular.length() * p_radius_B;
+
+	real_t time = 0.0;
+	for (int iteration = 0; iteration < TIME_OF_IMPACT_MAX_ITERATIONS; iteration++) {
+		Transform3D transform_A = _get_transform_at_time(p_transform_A, p_motion_A, time);
+		Transform3D transform_B = _get_transform_at_time(p_transform_B, p_motion_B, time);
+
+		Vector3 point_A, point_B;
+		if (!solve_distance(p_shape_A, transform_A, p_shape_B, transform_B, point_A, point_B, AABB())) {
+			r_toi = time; // Overlapping.
+			return true;
+		}
+
+		Vector3 direction = point_B - point_A;
+		real_t distance = direction.length();
+		if (distance <= p_tolerance) {
+			r_toi = time;
+			return true;
+		}
+
+		real_t approach_bound = linear_motion.dot(direction / distance) + angular_bound;
+		if (approach_bound <= CMP_EPSILON) {
+			return false; // Moving apart.
+		}
+
+		time += distance / approach_bound;
+		if (time >= r_toi) {
+			return false; // No impact in the motion, or later than one found already.
+		}
+	}
+
+	// Not converged, the time reached is still safe to move to.
+	r_toi = time;
+	return true;
+}
+
+struct _ConcaveTimeOfImpactInfo {
+	const GodotShape3D *shape_A = nullptr;
+	const Transform3D *transform_A = nullptr;
+	const GodotCollisionSolver3D::ShapeMotion *motion_A = nullptr;
+	real_t radius_A = 0.0;
+	const Transform3D *transform_B = nullptr;
+	const GodotCollisionSolver3D::ShapeMotion *motion_B = nullptr;
+	real_t radius_B = 0.0;
+	real_t tolerance = 0.0;
+	real_t toi = 1.0;
+	bool collided = false;
+};
+
+bool GodotCollisionSolver3D::concave_time_of_impact_callback(void *p_userdata, GodotShape3D *p_convex) {
+	_ConcaveTimeOfImpactInfo &info = *(_ConcaveTimeOfImpactInfo *)(p_userdata);
+
+	if (solve_time_of_impact_convex(info.shape_A, *info.transform_A, *info.motion_A, info.radius_A, p_convex, *info.transform_B, *info.motion_B, info.radius_B, info.tolerance, info.toi)) {
+		info.collided = true;
+	}
+
+	// Nothing can come earlier than already touching.
+	return info.collided && info.toi == 0.0;
+}
+
+bool GodotCollisionSolver3D::solve_time_of_impact(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const ShapeMotion &p_motion_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, const ShapeMotion &p_motion_B, real_t p_tolerance, real_t &r_toi) {
+	if (p_shape_A->is_concave() && !p_shape_B->is_concave()) {
+		return solve_time_of_impact(p_shape_B, p_transform_B, p_motion_B, p_shape_A, p_transform_A, p_motion_A, p_tolerance, r_toi);
+	}
+
+	// Only shapes with a support function, and the world boundary handled by solve_distance().
+	switch (p_shape_A->get_type()) {
+		case PhysicsServer3D::SHAPE_WORLD_BOUNDARY:
+		case PhysicsServer3D::SHAPE_SEPARATION_RAY:
+		case PhysicsServer3D::SHAPE_SOFT_BODY:
+		case PhysicsServer3D::SHAPE_CONCAVE_POLYGON:
+		case PhysicsServer3D::SHAPE_HEIGHTMAP:
+			return false;
+		default:
+			break;
+	}
+	if (p_shape_B->get_type() == PhysicsServer3D::SHAPE_SEPARATION_RAY || p_shape_B->get_type() == PhysicsServer3D::SHAPE_SOFT_BODY) {
+		return false;
+	}
+
+	real_t radius_A = _get_motion_radius(p_shape_A, p_transform_A, p_motion_A);
+	real_t radius_B = _get_motion_radius(p_shape_B, p_transform_B, p_motion_B);
+
+	if (!p_shape_B->is_concave()) {
+		r_toi = 1.0;
+		return solve_time_of_impact_convex(p_shape_A, p_transform_A, p_motion_A, radius_A, p_shape_B, p_transform_B, p_motion_B, radius_B, p_tolerance, r_toi);
+	}
+
+	// Only the triangles in reach of the whole motion of A, relative to B, can be hit.
+	AABB sweep_aabb = p_transform_A.xform(p_shape_A->get_aabb());
+	sweep_aabb.merge_with(AABB(sweep_aabb.position + p_motion_A.linear, sweep_aabb.size));
+	sweep_aabb.grow_by(p_motion_A.angular.length() * radius_A + p_motion_B.linear.length() + p_motion_B.angular.length() * radius_B + p_tolerance);
+
+	Transform3D inv_transform_B = p_transform_B.affine_inverse();
+	AABB local_aabb = inv_transform_B.xform(sweep_aabb);
+
+	_ConcaveTimeOfImpactInfo info;
+	info.shape_A = p_shape_A;
+	info.transform_A = &p_transform_A;
+	info.motion_A = &p_motion_A;
+	info.radius_A = radius_A;
+	info.transform_B = &p_transform_B;
+	info.motion_B = &p_motion_B;
+	info.radius_B = radius_B;
+	info.tolerance = p_tolerance;
+
+	const GodotConcaveShape3D *concave_B = static_cast<const GodotConcaveShape3D *>(p_shape_B);
+	concave_B->cull(local_aabb, concave_time_of_impact_callback, &info, false);
+
+	r_toi = info.toi;
+	return info.collided;
+}
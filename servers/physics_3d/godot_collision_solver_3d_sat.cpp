@@ -31,6 +31,7 @@
 #include "godot_collision_solver_3d_sat.h"
 
 #include "gjk_epa.h"
+#include "godot_simd_3d.h"
 
 #include "core/math/geometry_3d.h"
 
@@ -626,19 +627,27 @@ public:
 		}
 	}
 
-	_FORCE_INLINE_ bool test_axis(const Vector3 &p_axis) {
-		Vector3 axis = p_axis;
-
-		if (axis.is_equal_approx(Vector3())) {
+	static _FORCE_INLINE_ Vector3 validate_axis(const Vector3 &p_axis) {
+		if (p_axis.is_equal_approx(Vector3())) {
 			// strange case, try an upwards separator
-			axis = Vector3(0.0, 1.0, 0.0);
+			return Vector3(0.0, 1.0, 0.0);
 		}
+		return p_axis;
+	}
+
+	_FORCE_INLINE_ bool test_axis(const Vector3 &p_axis) {
+		Vector3 axis = validate_axis(p_axis);
 
 		real_t min_A, max_A, min_B, max_B;
 
 		shape_A->project_range(axis, *transform_A, min_A, max_A);
 		shape_B->project_range(axis, *transform_B, min_B, max_B);
 
+		return test_axis_range(axis, min_A, max_A, min_B, max_B);
+	}
+
+	// Same as test_axis(), for a validated axis the shapes were already projected on.
+	_FORCE_INLINE_ bool test_axis_range(const Vector3 &axis, real_t min_A, real_t max_A, real_t min_B, real_t max_B) {
 		if (withMargin) {
 			min_A -= margin_A;
 			max_A += margin_A;
@@ -1060,27 +1069,19 @@ static void _collision_box_box(const GodotShape3D *p_a, const Transform3D &p_tra
 		return;
 	}
 
-	// test faces of A
+	// Gather the face axes of A and B and their combined edges, so both boxes
+	// are projected on all of them in one batch, then test them in order.
+	Vector3 axes[15];
+	int axis_count = 0;
 
 	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_a.basis.get_axis(i).normalized();
-
-		if (!separator.test_axis(axis)) {
-			return;
-		}
+		axes[axis_count++] = separator.validate_axis(p_transform_a.basis.get_axis(i).normalized());
 	}
 
-	// test faces of B
-
 	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_b.basis.get_axis(i).normalized();
-
-		if (!separator.test_axis(axis)) {
-			return;
-		}
+		axes[axis_count++] = separator.validate_axis(p_transform_b.basis.get_axis(i).normalized());
 	}
 
-	// test combined edges
 	for (int i = 0; i < 3; i++) {
 		for (int j = 0; j < 3; j++) {
 			Vector3 axis = p_transform_a.basis.get_axis(i).cross(p_transform_b.basis.get_axis(j));
@@ -1088,11 +1089,17 @@ static void _collision_box_box(const GodotShape3D *p_a, const Transform3D &p_tra
 			if (Math::is_zero_approx(axis.length_squared())) {
 				continue;
 			}
-			axis.normalize();
+			axes[axis_count++] = separator.validate_axis(axis.normalized());
+		}
+	}
 
-			if (!separator.test_axis(axis)) {
-				return;
-			}
+	real_t min_A[15], max_A[15], min_B[15], max_B[15];
+	GodotSIMD3D::project_box(box_A->get_half_extents(), p_transform_a, axes, axis_count, min_A, max_A);
+	GodotSIMD3D::project_box(box_B->get_half_extents(), p_transform_b, axes, axis_count, min_B, max_B);
+
+	for (int i = 0; i < axis_count; i++) {
+		if (!separator.test_axis_range(axes[i], min_A[i], max_A[i], min_B[i], max_B[i])) {
+			return;
 		}
 	}
 
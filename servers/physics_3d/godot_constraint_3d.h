@@ -31,6 +31,13 @@
 #ifndef GODOT_CONSTRAINT_3D_H
 #define GODOT_CONSTRAINT_3D_H
 
+#include "core/math/math_defs.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/map.h"
+#include "core/templates/rid.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/set.h"
+
 class GodotBody3D;
 class GodotSoftBody3D;
 
@@ -38,6 +45,7 @@ class GodotConstraint3D {
 	GodotBody3D **_body_ptr;
 	int _body_count;
 	uint64_t island_step;
+	uint64_t creation_index;
 	int priority;
 	bool disabled_collisions_between_bodies;
 
@@ -50,6 +58,13 @@ protected:
 		island_step = 0;
 		priority = 1;
 		disabled_collisions_between_bodies = true;
+		creation_index = _next_creation_index();
+	}
+
+private:
+	static uint64_t _next_creation_index() {
+		static SafeNumeric<uint64_t> counter;
+		return counter.increment();
 	}
 
 public:
@@ -59,6 +74,38 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
+	// Constraints are created in the same order for the same sequence of steps,
+	// unlike their addresses, so containers are ordered by this instead.
+	_FORCE_INLINE_ uint64_t get_creation_index() const { return creation_index; }
+
+	struct CreationComparator {
+		_FORCE_INLINE_ bool operator()(const GodotConstraint3D *p_a, const GodotConstraint3D *p_b) const { return p_a->creation_index < p_b->creation_index; }
+	};
+
+	typedef Set<GodotConstraint3D *, CreationComparator> OrderedSet;
+	template <class V>
+	using OrderedMap = Map<GodotConstraint3D *, V, CreationComparator>;
+
+	// Identifies the contacts between two shapes in space snapshots, so they can be
+	// restored into a pair that was freed and created again since.
+	struct ContactCacheKey {
+		uint64_t object_A = 0;
+		uint64_t object_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+
+		_FORCE_INLINE_ bool operator==(const ContactCacheKey &p_key) const {
+			return object_A == p_key.object_A && object_B == p_key.object_B && shape_A == p_key.shape_A && shape_B == p_key.shape_B;
+		}
+
+		static _FORCE_INLINE_ uint32_t hash(const ContactCacheKey &p_key) {
+			uint64_t h = hash_djb2_one_64(p_key.object_A);
+			h = hash_djb2_one_64(p_key.object_B, h);
+			h = hash_djb2_one_64(((uint64_t)(uint32_t)p_key.shape_A << 32) | (uint32_t)p_key.shape_B, h);
+			return (uint32_t)h;
+		}
+	};
+
 	_FORCE_INLINE_ GodotBody3D **get_body_ptr() const { return _body_ptr; }
 	_FORCE_INLINE_ int get_body_count() const { return _body_count; }
 
@@ -72,8 +119,21 @@ public:
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
 	virtual bool setup(real_t p_step) = 0;
+	// Islands are pre-solved in parallel, constraints that write to objects shared between
+	// islands (areas, contact reports of static bodies, debug contacts) must opt out.
+	virtual bool is_pre_solve_thread_safe() const { return true; }
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
+	// Largest impulse change applied by the last solve(), so islands can stop iterating once
+	// it's small enough. Negative when not tracked, which keeps the island iterating.
+	virtual real_t get_solve_residual() const { return -1.0; }
+
+	// Contact state kept between steps, saved in space snapshots. Constraints without
+	// any return a size of 0. Restoring from nullptr resets the state.
+	virtual uint32_t get_contact_cache_size() const { return 0; }
+	virtual ContactCacheKey get_contact_cache_key() const { return ContactCacheKey(); }
+	virtual void save_contact_cache(uint8_t *r_cache) const {}
+	virtual void restore_contact_cache(const uint8_t *p_cache) {}
 
 	virtual ~GodotConstraint3D() {}
 };
@@ -175,6 +175,44 @@ bool GodotPhysicsServer3D::space_is_active(RID p_space) const {
 	return active_spaces.has(space);
 }
 
+void GodotPhysicsServer3D::space_set_deterministic(RID p_space, bool p_deterministic) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND(!space);
+
+	space->set_deterministic(p_deterministic);
+}
+
+bool GodotPhysicsServer3D::space_is_deterministic(RID p_space) const {
+	const GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, false);
+
+	return space->is_deterministic();
+}
+
+int64_t GodotPhysicsServer3D::space_get_state_hash(RID p_space) const {
+	const GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, 0);
+
+	return (int64_t)space->get_state_hash();
+}
+
+Vector<uint8_t> GodotPhysicsServer3D::space_save_snapshot(RID p_space) const {
+	const GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, Vector<uint8_t>());
+
+	Vector<uint8_t> snapshot;
+	space->save_snapshot(snapshot);
+	return snapshot;
+}
+
+bool GodotPhysicsServer3D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, false);
+	ERR_FAIL_COND_V_MSG(space->is_locked(), false, "Space snapshots can't be restored while the space is being stepped.");
+
+	return space->restore_snapshot(p_snapshot);
+}
+
 void GodotPhysicsServer3D::space_set_param(RID p_space, SpaceParameter p_param, real_t p_value) {
 	GodotSpace3D *space = space_owner.get_or_null(p_space);
 	ERR_FAIL_COND(!space);
@@ -1611,11 +1649,15 @@ void GodotPhysicsServer3D::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	broadphase_pair_tests = 0;
+	broadphase_time = 0;
 	for (Set<const GodotSpace3D *>::Element *E = active_spaces.front(); E; E = E->next()) {
 		stepper->step((GodotSpace3D *)E->get(), p_step);
 		island_count += E->get()->get_island_count();
 		active_objects += E->get()->get_active_objects();
 		collision_pairs += E->get()->get_collision_pairs();
+		broadphase_pair_tests += E->get()->get_broadphase_pair_tests();
+		broadphase_time += E->get()->get_elapsed_time(GodotSpace3D::ELAPSED_TIME_BROADPHASE);
 	}
 #endif
 }
@@ -1646,6 +1688,7 @@ void GodotPhysicsServer3D::flush_queries() {
 		uint64_t total_time[GodotSpace3D::ELAPSED_TIME_MAX];
 		static const char *time_name[GodotSpace3D::ELAPSED_TIME_MAX] = {
 			"integrate_forces",
+			"broadphase",
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
@@ -1696,6 +1739,12 @@ int GodotPhysicsServer3D::get_process_info(ProcessInfo p_info) {
 		case INFO_ISLAND_COUNT: {
 			return island_count;
 		} break;
+		case INFO_BROADPHASE_PAIR_TESTS: {
+			return broadphase_pair_tests;
+		} break;
+		case INFO_BROADPHASE_TIME_USEC: {
+			return broadphase_time;
+		} break;
 	}
 
 	return 0;
@@ -48,6 +48,8 @@ class GodotPhysicsServer3D : public PhysicsServer3D {
 	int island_count = 0;
 	int active_objects = 0;
 	int collision_pairs = 0;
+	int broadphase_pair_tests = 0;
+	uint64_t broadphase_time = 0;
 
 	bool using_threads = false;
 	bool doing_sync = false;
@@ -106,6 +108,11 @@ public:
 	virtual RID space_create() override;
 	virtual void space_set_active(RID p_space, bool p_active) override;
 	virtual bool space_is_active(RID p_space) const override;
+	virtual void space_set_deterministic(RID p_space, bool p_deterministic) override;
+	virtual bool space_is_deterministic(RID p_space) const override;
+	virtual int64_t space_get_state_hash(RID p_space) const override;
+	virtual Vector<uint8_t> space_save_snapshot(RID p_space) const override;
+	virtual bool space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override;
 
 	virtual void space_set_param(RID p_space, SpaceParameter p_param, real_t p_value) override;
 	virtual real_t space_get_param(RID p_space, SpaceParameter p_param) const override;
@@ -30,6 +30,8 @@
 
 #include "godot_shape_3d.h"
 
+#include "godot_simd_3d.h"
+
 #include "core/io/image.h"
 #include "core/math/convex_hull.h"
 #include "core/math/geometry_3d.h"
@@ -845,43 +847,23 @@ void GodotConvexPolygonShape3D::project_range(const Vector3 &p_normal, const Tra
 		return;
 	}
 
-	const Vector3 *vrts = &mesh.vertices[0];
-
-	for (int i = 0; i < vertex_count; i++) {
-		real_t d = p_normal.dot(p_transform.xform(vrts[i]));
+	// Project on the axis in local space, so the vertices don't need to be transformed.
+	Vector3 local_normal = p_transform.basis.xform_inv(p_normal);
+	real_t distance = p_normal.dot(p_transform.origin);
 
-		if (i == 0 || d > r_max) {
-			r_max = d;
-		}
-		if (i == 0 || d < r_min) {
-			r_min = d;
-		}
-	}
+	GodotSIMD3D::project_points(mesh.vertices.ptr(), vertex_count, local_normal, r_min, r_max);
+	r_min += distance;
+	r_max += distance;
 }
 
 Vector3 GodotConvexPolygonShape3D::get_support(const Vector3 &p_normal) const {
-	Vector3 n = p_normal;
-
-	int vert_support_idx = -1;
-	real_t support_max = 0;
-
 	int vertex_count = mesh.vertices.size();
 	if (vertex_count == 0) {
 		return Vector3();
 	}
 
-	const Vector3 *vrts = &mesh.vertices[0];
-
-	for (int i = 0; i < vertex_count; i++) {
-		real_t d = n.dot(vrts[i]);
-
-		if (i == 0 || d > support_max) {
-			support_max = d;
-			vert_support_idx = i;
-		}
-	}
-
-	return vrts[vert_support_idx];
+	const Vector3 *vrts = mesh.vertices.ptr();
+	return vrts[GodotSIMD3D::support_point(vrts, vertex_count, p_normal)];
 }
 
 void GodotConvexPolygonShape3D::get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const {
@@ -898,17 +880,7 @@ void GodotConvexPolygonShape3D::get_supports(const Vector3 &p_normal, int p_max,
 	ERR_FAIL_COND_MSG(vc == 0, "Convex polygon shape has no vertices.");
 
 	//find vertex first
-	real_t max = 0;
-	int vtx = 0;
-
-	for (int i = 0; i < vc; i++) {
-		real_t d = p_normal.dot(vertices[i]);
-
-		if (i == 0 || d > max) {
-			max = d;
-			vtx = i;
-		}
-	}
+	int vtx = GodotSIMD3D::support_point(vertices, vc, p_normal);
 
 	for (int i = 0; i < fc; i++) {
 		if (faces[i].plane.normal.dot(p_normal) > face_support_threshold) {
@@ -1700,41 +1672,6 @@ _FORCE_INLINE_ bool _heightmap_cell_cull_segment(_HeightmapSegmentCullParams &p_
 	return false;
 }
 
-_FORCE_INLINE_ bool _heightmap_chunk_cull_segment(_HeightmapSegmentCullParams &p_params, const _HeightmapGridCullState &p_state) {
-	const GodotHeightMapShape3D::Range &chunk = p_params.heightmap->_get_bounds_chunk(p_state.x, p_state.z);
-
-	Vector3 enter_pos;
-	Vector3 exit_pos;
-
-	if (p_state.length_flat > CMP_EPSILON) {
-		real_t flat_to_3d = p_state.length / p_state.length_flat;
-		real_t enter_param = p_state.prev_dist * flat_to_3d;
-		real_t exit_param = p_state.dist * flat_to_3d;
-		enter_pos = p_params.from + p_params.dir * enter_param;
-		exit_pos = p_params.from + p_params.dir * exit_param;
-	} else {
-		// Consider the ray vertical.
-		// (though we shouldn't reach this often because there is an early check up-front)
-		enter_pos = p_params.from;
-		exit_pos = p_params.to;
-	}
-
-	// Transform positions to heightmap space.
-	enter_pos *= GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE;
-	exit_pos *= GodotHeightMapShape3D::BOUNDS_CHUNK_SIZE;
-
-	// We did enter the flat projection of the AABB,
-	// but we have to check if we intersect it on the vertical axis.
-	if ((enter_pos.y > chunk.max) && (exit_pos.y > chunk.max)) {
-		return false;
-	}
-	if ((enter_pos.y < chunk.min) && (exit_pos.y < chunk.min)) {
-		return false;
-	}
-
-	return p_params.heightmap->_intersect_grid_segment(_heightmap_cell_cull_segment, enter_pos, exit_pos, p_params.heightmap->width, p_params.heightmap->depth, p_params.heightmap->local_origin, p_params.result, p_params.normal);
-}
-
 template <typename ProcessFunction>
 bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal) const {
 	Vector3 delta = (p_end - p_begin);
@@ -1804,11 +1741,12 @@ bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process,
 	int x = Math::floor(local_begin.x);
 	int z = Math::floor(local_begin.z);
 
-	// Workaround cases where the ray starts at an integer position.
+	// Workaround cases where the ray starts at an integer position, or just before it,
+	// as segments clipped to the quadtree leaves do.
 	if (Math::is_zero_approx(cross_x)) {
 		cross_x += delta_x;
-		// If going backwards, we should ignore the position we would get by the above flooring,
-		// because the ray is not heading in that direction.
+		// Start in the cell the ray is heading into, whatever side of the lane the flooring ended up on.
+		x = Math::round(local_begin.x);
 		if (x_step == -1) {
 			x -= 1;
 		}
@@ -1816,6 +1754,7 @@ bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process,
 
 	if (Math::is_zero_approx(cross_z)) {
 		cross_z += delta_z;
+		z = Math::round(local_begin.z);
 		if (z_step == -1) {
 			z -= 1;
 		}
@@ -1876,6 +1815,99 @@ bool GodotHeightMapShape3D::_intersect_grid_segment(ProcessFunction &p_process,
 	return false;
 }
 
+// Narrows [r_enter, r_exit] to the part of the segment over the rectangle, in the XZ plane.
+static _FORCE_INLINE_ bool _heightmap_clip_segment(const Vector3 &p_begin, const Vector3 &p_delta, real_t p_min_x, real_t p_max_x, real_t p_min_z, real_t p_max_z, real_t &r_enter, real_t &r_exit) {
+	const real_t rect_min[2] = { p_min_x, p_min_z };
+	const real_t rect_max[2] = { p_max_x, p_max_z };
+	const real_t begin[2] = { p_begin.x, p_begin.z };
+	const real_t delta[2] = { p_delta.x, p_delta.z };
+
+	for (int i = 0; i < 2; i++) {
+		if (Math::abs(delta[i]) < CMP_EPSILON) {
+			if (begin[i] < rect_min[i] || begin[i] > rect_max[i]) {
+				return false;
+			}
+			continue;
+		}
+
+		real_t t0 = (rect_min[i] - begin[i]) / delta[i];
+		real_t t1 = (rect_max[i] - begin[i]) / delta[i];
+		if (t0 > t1) {
+			SWAP(t0, t1);
+		}
+		r_enter = MAX(r_enter, t0);
+		r_exit = MIN(r_exit, t1);
+		if (r_enter > r_exit) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool GodotHeightMapShape3D::_intersect_bounds_segment(int p_level, int p_x, int p_z, const Vector3 &p_begin, const Vector3 &p_delta, real_t p_enter, real_t p_exit, Vector3 &r_point, Vector3 &r_normal) const {
+	// p_begin is in heightmap space, where cell (x, z) spans [x, x + 1] x [z, z + 1].
+	const int size = BOUNDS_LEAF_SIZE << p_level;
+	real_t enter = p_enter;
+	real_t exit = p_exit;
+	if (!_heightmap_clip_segment(p_begin, p_delta, p_x * size, MIN((p_x + 1) * size, width - 1), p_z * size, MIN((p_z + 1) * size, depth - 1), enter, exit)) {
+		return false;
+	}
+
+	// Skip nodes the segment passes entirely above or below.
+	const Range &range = _get_bounds(p_level, p_x, p_z);
+	real_t enter_y = p_begin.y + p_delta.y * enter;
+	real_t exit_y = p_begin.y + p_delta.y * exit;
+	if (MIN(enter_y, exit_y) > range.max || MAX(enter_y, exit_y) < range.min) {
+		return false;
+	}
+
+	if (p_level == 0) {
+		// Walk the cells of the leaf.
+		Vector3 from = p_begin + p_delta * enter - local_origin;
+		Vector3 to = p_begin + p_delta * exit - local_origin;
+		return _intersect_grid_segment(_heightmap_cell_cull_segment, from, to, width, depth, local_origin, r_point, r_normal);
+	}
+
+	// Visit the children in the order the segment enters them, so the first hit is the closest.
+	struct Child {
+		real_t enter = 0.0;
+		int x = 0;
+		int z = 0;
+	};
+	Child children[4];
+	int child_count = 0;
+
+	const BoundsLevel &child_level = bounds_levels[p_level - 1];
+	const int child_size = size >> 1;
+	for (int child_z = p_z * 2; child_z < MIN(p_z * 2 + 2, child_level.depth); child_z++) {
+		for (int child_x = p_x * 2; child_x < MIN(p_x * 2 + 2, child_level.width); child_x++) {
+			real_t child_enter = enter;
+			real_t child_exit = exit;
+			if (!_heightmap_clip_segment(p_begin, p_delta, child_x * child_size, MIN((child_x + 1) * child_size, width - 1), child_z * child_size, MIN((child_z + 1) * child_size, depth - 1), child_enter, child_exit)) {
+				continue;
+			}
+
+			int index = child_count++;
+			while (index > 0 && children[index - 1].enter > child_enter) {
+				children[index] = children[index - 1];
+				index--;
+			}
+			children[index].enter = child_enter;
+			children[index].x = child_x;
+			children[index].z = child_z;
+		}
+	}
+
+	for (int i = 0; i < child_count; i++) {
+		if (_intersect_bounds_segment(p_level - 1, children[i].x, children[i].z, p_begin, p_delta, enter, exit, r_point, r_normal)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal, bool p_hit_back_faces) const {
 	if (heights.is_empty()) {
 		return false;
@@ -1912,21 +1944,19 @@ bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vect
 			r_normal = params.normal;
 			return true;
 		}
-	} else if (bounds_grid.is_empty()) {
+	} else if (bounds_levels.is_empty()) {
 		// Process all cells intersecting the flat projection of the ray.
 		return _intersect_grid_segment(_heightmap_cell_cull_segment, p_begin, p_end, width, depth, local_origin, r_point, r_normal);
 	} else {
 		Vector3 ray_diff = (p_end - p_begin);
 		real_t length_flat_sqr = ray_diff.x * ray_diff.x + ray_diff.z * ray_diff.z;
-		if (length_flat_sqr < BOUNDS_CHUNK_SIZE * BOUNDS_CHUNK_SIZE) {
-			// Don't use chunks, the ray is too short in the plane.
+		if (length_flat_sqr < BOUNDS_LEAF_SIZE * BOUNDS_LEAF_SIZE) {
+			// Don't use the quadtree, the ray is too short in the plane.
 			return _intersect_grid_segment(_heightmap_cell_cull_segment, p_begin, p_end, width, depth, local_origin, r_point, r_normal);
 		} else {
-			// The ray is long, run raycast on a higher-level grid.
-			Vector3 bounds_from = p_begin / BOUNDS_CHUNK_SIZE;
-			Vector3 bounds_to = p_end / BOUNDS_CHUNK_SIZE;
-			Vector3 bounds_offset = local_origin / BOUNDS_CHUNK_SIZE;
-			return _intersect_grid_segment(_heightmap_chunk_cull_segment, bounds_from, bounds_to, bounds_grid_width, bounds_grid_depth, bounds_offset, r_point, r_normal);
+			// The ray is long, descend the quadtree from the root, skipping the nodes it
+			// passes above or below.
+			return _intersect_bounds_segment(bounds_levels.size() - 1, 0, 0, local_begin, ray_diff, 0.0, 1.0, r_point, r_normal);
 		}
 	}
 
@@ -1982,27 +2012,57 @@ void GodotHeightMapShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callb
 	int start_z = MAX(0, aabb_min[2]);
 	int end_z = MIN(depth - 1, aabb_max[2]);
 
+	if (start_x >= end_x || start_z >= end_z) {
+		return;
+	}
+
+	const real_t min_y = local_aabb.position.y;
+	const real_t max_y = local_aabb.position.y + local_aabb.size.y;
+
 	GodotFaceShape3D face;
 	face.backface_collision = !p_invert_backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
-	for (int z = start_z; z < end_z; z++) {
-		for (int x = start_x; x < end_x; x++) {
-			// First triangle.
-			_get_point(x, z, face.vertex[0]);
-			_get_point(x + 1, z, face.vertex[1]);
-			_get_point(x, z + 1, face.vertex[2]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
-				return;
+	// Go through the cells leaf by leaf, skipping the leaves and cells entirely above or
+	// below the AABB.
+	for (int leaf_z = start_z / BOUNDS_LEAF_SIZE; leaf_z <= (end_z - 1) / BOUNDS_LEAF_SIZE; leaf_z++) {
+		for (int leaf_x = start_x / BOUNDS_LEAF_SIZE; leaf_x <= (end_x - 1) / BOUNDS_LEAF_SIZE; leaf_x++) {
+			if (!bounds_levels.is_empty()) {
+				const Range &range = _get_bounds(0, leaf_x, leaf_z);
+				if (range.min > max_y || range.max < min_y) {
+					continue;
+				}
 			}
 
-			// Second triangle.
-			face.vertex[0] = face.vertex[1];
-			_get_point(x + 1, z + 1, face.vertex[1]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
-				return;
+			int leaf_end_z = MIN((leaf_z + 1) * BOUNDS_LEAF_SIZE, end_z);
+			int leaf_end_x = MIN((leaf_x + 1) * BOUNDS_LEAF_SIZE, end_x);
+			for (int z = MAX(leaf_z * BOUNDS_LEAF_SIZE, start_z); z < leaf_end_z; z++) {
+				for (int x = MAX(leaf_x * BOUNDS_LEAF_SIZE, start_x); x < leaf_end_x; x++) {
+					real_t height_00 = _get_height(x, z);
+					real_t height_10 = _get_height(x + 1, z);
+					real_t height_01 = _get_height(x, z + 1);
+					real_t height_11 = _get_height(x + 1, z + 1);
+					if (MIN(MIN(height_00, height_10), MIN(height_01, height_11)) > max_y || MAX(MAX(height_00, height_10), MAX(height_01, height_11)) < min_y) {
+						continue;
+					}
+
+					// First triangle.
+					_get_point(x, z, face.vertex[0]);
+					_get_point(x + 1, z, face.vertex[1]);
+					_get_point(x, z + 1, face.vertex[2]);
+					face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+					if (p_callback(p_userdata, &face)) {
+						return;
+					}
+
+					// Second triangle.
+					face.vertex[0] = face.vertex[1];
+					_get_point(x + 1, z + 1, face.vertex[1]);
+					face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+					if (p_callback(p_userdata, &face)) {
+						return;
+					}
+				}
 			}
 		}
 	}
@@ -2019,58 +2079,71 @@ Vector3 GodotHeightMapShape3D::get_moment_of_inertia(real_t p_mass) const {
 }
 
 void GodotHeightMapShape3D::_build_accelerator() {
-	bounds_grid.clear();
-
-	bounds_grid_width = width / BOUNDS_CHUNK_SIZE;
-	bounds_grid_depth = depth / BOUNDS_CHUNK_SIZE;
+	bounds_levels.clear();
 
-	if (width % BOUNDS_CHUNK_SIZE > 0) {
-		++bounds_grid_width; // In case terrain size isn't dividable by chunk size.
+	if (width < 2 || depth < 2) {
+		return;
 	}
 
-	if (depth % BOUNDS_CHUNK_SIZE > 0) {
-		++bounds_grid_depth;
+	// In case the cell count isn't dividable by the leaf size.
+	int level_width = (width - 1 + BOUNDS_LEAF_SIZE - 1) / BOUNDS_LEAF_SIZE;
+	int level_depth = (depth - 1 + BOUNDS_LEAF_SIZE - 1) / BOUNDS_LEAF_SIZE;
+
+	if (level_width * level_depth < 2) {
+		// Just one leaf.
+		return;
 	}
 
-	uint32_t bound_grid_size = (uint32_t)(bounds_grid_width * bounds_grid_depth);
+	while (true) {
+		BoundsLevel level;
+		level.width = level_width;
+		level.depth = level_depth;
+		level.ranges.resize(level_width * level_depth);
+		bounds_levels.push_back(level);
 
-	if (bound_grid_size < 2) {
-		// Grid is empty or just one chunk.
-		return;
+		if (level_width == 1 && level_depth == 1) {
+			break;
+		}
+		level_width = (level_width + 1) / 2;
+		level_depth = (level_depth + 1) / 2;
 	}
 
-	bounds_grid.resize(bound_grid_size);
+	_update_accelerator(0, 0, width - 1, depth - 1);
+}
 
-	// Compute min and max height for all chunks.
-	for (int cz = 0; cz < bounds_grid_depth; ++cz) {
-		int z0 = cz * BOUNDS_CHUNK_SIZE;
+void GodotHeightMapShape3D::_update_accelerator(int p_begin_x, int p_begin_z, int p_end_x, int p_end_z) {
+	// Recomputes the nodes over the cells in [p_begin, p_end), from the leaves up.
+	if (bounds_levels.is_empty() || p_begin_x >= p_end_x || p_begin_z >= p_end_z) {
+		return;
+	}
 
-		for (int cx = 0; cx < bounds_grid_width; ++cx) {
-			int x0 = cx * BOUNDS_CHUNK_SIZE;
+	int begin_x = p_begin_x / BOUNDS_LEAF_SIZE;
+	int begin_z = p_begin_z / BOUNDS_LEAF_SIZE;
+	int end_x = (p_end_x - 1) / BOUNDS_LEAF_SIZE;
+	int end_z = (p_end_z - 1) / BOUNDS_LEAF_SIZE;
+
+	// Leaves include the points on their far edges, which they share with the next leaves.
+	// Otherwise a gap would open between a leaf and its neighbor:
+	//
+	//   Left        Right
+	// 0---0---0---1---1---1
+	// |   |   |   |   |   |
+	// 0---0---0---1---1---1
+	//           x
+	//
+	// If the range of the Left leaf did not include the 1s, it would fail tests at x.
+	BoundsLevel &leaves = bounds_levels[0];
+	for (int leaf_z = begin_z; leaf_z <= end_z; leaf_z++) {
+		int z0 = leaf_z * BOUNDS_LEAF_SIZE;
+		int z_max = MIN(z0 + BOUNDS_LEAF_SIZE + 1, depth);
+
+		for (int leaf_x = begin_x; leaf_x <= end_x; leaf_x++) {
+			int x0 = leaf_x * BOUNDS_LEAF_SIZE;
+			int x_max = MIN(x0 + BOUNDS_LEAF_SIZE + 1, width);
 
 			Range r;
-
 			r.min = _get_height(x0, z0);
 			r.max = r.min;
-
-			// Compute min and max height for this chunk.
-			// We have to include one extra cell to account for neighbors.
-			// Here is why:
-			// Say we have a flat terrain, and a plateau that fits a chunk perfectly.
-			//
-			//   Left        Right
-			// 0---0---0---1---1---1
-			// |   |   |   |   |   |
-			// 0---0---0---1---1---1
-			// |   |   |   |   |   |
-			// 0---0---0---1---1---1
-			//           x
-			//
-			// If the AABB for the Left chunk did not share vertices with the Right,
-			// then we would fail collision tests at x due to a gap.
-			//
-			int z_max = MIN(z0 + BOUNDS_CHUNK_SIZE + 1, depth);
-			int x_max = MIN(x0 + BOUNDS_CHUNK_SIZE + 1, width);
 			for (int z = z0; z < z_max; ++z) {
 				for (int x = x0; x < x_max; ++x) {
 					real_t height = _get_height(x, z);
@@ -2082,7 +2155,31 @@ void GodotHeightMapShape3D::_build_accelerator() {
 				}
 			}
 
-			bounds_grid[cx + cz * bounds_grid_width] = r;
+			leaves.ranges[leaf_x + leaf_z * leaves.width] = r;
+		}
+	}
+
+	for (uint32_t level_index = 1; level_index < bounds_levels.size(); level_index++) {
+		const BoundsLevel &children = bounds_levels[level_index - 1];
+		BoundsLevel &level = bounds_levels[level_index];
+
+		begin_x /= 2;
+		begin_z /= 2;
+		end_x /= 2;
+		end_z /= 2;
+
+		for (int z = begin_z; z <= end_z; z++) {
+			for (int x = begin_x; x <= end_x; x++) {
+				Range r = children.ranges[(x * 2) + (z * 2) * children.width];
+				for (int child_z = z * 2; child_z < MIN(z * 2 + 2, children.depth); child_z++) {
+					for (int child_x = x * 2; child_x < MIN(x * 2 + 2, children.width); child_x++) {
+						const Range &child = children.ranges[child_x + child_z * children.width];
+						r.min = MIN(r.min, child.min);
+						r.max = MAX(r.max, child.max);
+					}
+				}
+				level.ranges[x + z * level.width] = r;
+			}
 		}
 	}
 }
@@ -2108,6 +2205,36 @@ void GodotHeightMapShape3D::_setup(const Vector<real_t> &p_heights, int p_width,
 	configure(aabb);
 }
 
+void GodotHeightMapShape3D::update_region(const Rect2i &p_region, const Vector<real_t> &p_heights) {
+	ERR_FAIL_COND(p_region.position.x < 0 || p_region.position.y < 0);
+	ERR_FAIL_COND(p_region.position.x + p_region.size.x > width || p_region.position.y + p_region.size.y > depth);
+	ERR_FAIL_COND(p_region.size.x <= 0 || p_region.size.y <= 0);
+	ERR_FAIL_COND(p_heights.size() != p_region.size.x * p_region.size.y);
+
+	AABB aabb = get_aabb();
+	real_t min_height = aabb.position.y;
+	real_t max_height = aabb.position.y + aabb.size.y;
+
+	real_t *w = heights.ptrw();
+	const real_t *r = p_heights.ptr();
+	for (int z = 0; z < p_region.size.y; z++) {
+		for (int x = 0; x < p_region.size.x; x++) {
+			real_t height = r[z * p_region.size.x + x];
+			w[(p_region.position.y + z) * width + p_region.position.x + x] = height;
+			min_height = MIN(min_height, height);
+			max_height = MAX(max_height, height);
+		}
+	}
+
+	// Points are shared by the cells on both sides of them.
+	_update_accelerator(MAX(p_region.position.x - 1, 0), MAX(p_region.position.y - 1, 0), MIN(p_region.position.x + p_region.size.x, width - 1), MIN(p_region.position.y + p_region.size.y, depth - 1));
+
+	// The AABB only grows, shrinking it would only churn the broadphase.
+	aabb.position.y = min_height;
+	aabb.size.y = max_height - min_height;
+	configure(aabb);
+}
+
 void GodotHeightMapShape3D::set_data(const Variant &p_data) {
 	ERR_FAIL_COND(p_data.get_type() != Variant::DICTIONARY);
 
@@ -2154,6 +2281,13 @@ void GodotHeightMapShape3D::set_data(const Variant &p_data) {
 #endif
 	}
 
+	if (d.has("region")) {
+		// Only the heights of the points in the region are given.
+		ERR_FAIL_COND_MSG(width != get_width() || depth != get_depth(), "Heightmap regions can only be updated without resizing the heightmap.");
+		update_region(d["region"], heights_buffer);
+		return;
+	}
+
 	// Compute min and max heights or use precomputed values.
 	real_t min_height = 0.0;
 	real_t max_height = 0.0;
@@ -2161,9 +2295,9 @@ void GodotHeightMapShape3D::set_data(const Variant &p_data) {
 		min_height = d["min_height"];
 		max_height = d["max_height"];
 	} else {
-		int heights_size = heights.size();
+		int heights_size = heights_buffer.size();
 		for (int i = 0; i < heights_size; ++i) {
-			real_t h = heights[i];
+			real_t h = heights_buffer[i];
 			if (h < min_height) {
 				min_height = h;
 			} else if (h > max_height) {
@@ -386,19 +386,25 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 	int depth = 0;
 	Vector3 local_origin;
 
-	// Accelerator.
+	// Accelerator, a quadtree of height ranges stored as min/max mips. Level 0 holds
+	// the range of each block of BOUNDS_LEAF_SIZE x BOUNDS_LEAF_SIZE cells, and each
+	// next level merges 2 x 2 nodes of the previous one, up to a single root.
 	struct Range {
 		real_t min = 0.0;
 		real_t max = 0.0;
 	};
-	LocalVector<Range> bounds_grid;
-	int bounds_grid_width = 0;
-	int bounds_grid_depth = 0;
+	struct BoundsLevel {
+		LocalVector<Range> ranges;
+		int width = 0;
+		int depth = 0;
+	};
+	LocalVector<BoundsLevel> bounds_levels;
 
-	static const int BOUNDS_CHUNK_SIZE = 16;
+	static const int BOUNDS_LEAF_SIZE = 4;
 
-	_FORCE_INLINE_ const Range &_get_bounds_chunk(int p_x, int p_z) const {
-		return bounds_grid[(p_z * bounds_grid_width) + p_x];
+	_FORCE_INLINE_ const Range &_get_bounds(int p_level, int p_x, int p_z) const {
+		const BoundsLevel &level = bounds_levels[p_level];
+		return level.ranges[(p_z * level.width) + p_x];
 	}
 
 	_FORCE_INLINE_ real_t _get_height(int p_x, int p_z) const {
@@ -414,6 +420,8 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 	void _get_cell(const Vector3 &p_point, int &r_x, int &r_y, int &r_z) const;
 
 	void _build_accelerator();
+	void _update_accelerator(int p_begin_x, int p_begin_z, int p_end_x, int p_end_z);
+	bool _intersect_bounds_segment(int p_level, int p_x, int p_z, const Vector3 &p_begin, const Vector3 &p_delta, real_t p_enter, real_t p_exit, Vector3 &r_point, Vector3 &r_normal) const;
 
 	template <typename ProcessFunction>
 	bool _intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal) const;
@@ -425,6 +433,9 @@ public:
 	int get_width() const;
 	int get_depth() const;
 
+	// Replaces the heights of the points in the region, without rebuilding the whole accelerator.
+	void update_region(const Rect2i &p_region, const Vector<real_t> &p_heights);
+
 	virtual PhysicsServer3D::ShapeType get_type() const override { return PhysicsServer3D::SHAPE_HEIGHTMAP; }
 
 	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override;
@@ -0,0 +1,359 @@
+/*************************************************************************/
+/*  godot_simd_3d.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "godot_simd_3d.h"
+
+#if defined(GODOT_SIMD_3D_SSE2)
+#include <emmintrin.h>
+#elif defined(GODOT_SIMD_3D_NEON)
+#include <arm_neon.h>
+#endif
+
+void GodotSIMD3D::project_points_scalar(const Vector3 *p_points, int p_count, const Vector3 &p_axis, real_t &r_min, real_t &r_max) {
+	r_min = r_max = p_axis.dot(p_points[0]);
+	for (int i = 1; i < p_count; i++) {
+		real_t d = p_axis.dot(p_points[i]);
+		if (d > r_max) {
+			r_max = d;
+		}
+		if (d < r_min) {
+			r_min = d;
+		}
+	}
+}
+
+int GodotSIMD3D::support_point_scalar(const Vector3 *p_points, int p_count, const Vector3 &p_dir) {
+	int support = 0;
+	real_t support_max = p_dir.dot(p_points[0]);
+	for (int i = 1; i < p_count; i++) {
+		real_t d = p_dir.dot(p_points[i]);
+		if (d > support_max) {
+			support_max = d;
+			support = i;
+		}
+	}
+	return support;
+}
+
+void GodotSIMD3D::project_box_scalar(const Vector3 &p_half_extents, const Transform3D &p_transform, const Vector3 *p_axes, int p_axis_count, real_t *r_min, real_t *r_max) {
+	for (int i = 0; i < p_axis_count; i++) {
+		// Same as GodotBoxShape3D::project_range().
+		Vector3 local_axis = p_transform.basis.xform_inv(p_axes[i]);
+		real_t length = local_axis.abs().dot(p_half_extents);
+		real_t distance = p_axes[i].dot(p_transform.origin);
+		r_min[i] = distance - length;
+		r_max[i] = distance + length;
+	}
+}
+
+void GodotSIMD3D::multiply_add_scalar(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count) {
+	for (int i = 0; i < p_count; i++) {
+		r_result[i] = p_a[i] + p_b[i] * p_scale;
+	}
+}
+
+void GodotSIMD3D::scaled_difference_scalar(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count) {
+	for (int i = 0; i < p_count; i++) {
+		r_result[i] = (p_a[i] - p_b[i]) * p_scale;
+	}
+}
+
+#if defined(GODOT_SIMD_3D_SSE2) || defined(GODOT_SIMD_3D_NEON)
+
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be packed floats for the vectorized kernels.");
+
+#if defined(GODOT_SIMD_3D_SSE2)
+
+typedef __m128 float4;
+
+// Loads four consecutive Vector3 and transposes them into x, y and z lanes.
+static _FORCE_INLINE_ void _load_xyz4(const Vector3 *p_points, float4 &r_x, float4 &r_y, float4 &r_z) {
+	const float *f = (const float *)p_points;
+	__m128 a = _mm_loadu_ps(f + 0); // x0 y0 z0 x1
+	__m128 b = _mm_loadu_ps(f + 4); // y1 z1 x2 y2
+	__m128 c = _mm_loadu_ps(f + 8); // z2 x3 y3 z3
+	r_x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+	r_y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	r_z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+#define F4_SPLAT(m_value) _mm_set1_ps(m_value)
+#define F4_ADD(m_a, m_b) _mm_add_ps(m_a, m_b)
+#define F4_SUB(m_a, m_b) _mm_sub_ps(m_a, m_b)
+#define F4_MUL(m_a, m_b) _mm_mul_ps(m_a, m_b)
+#define F4_MIN(m_a, m_b) _mm_min_ps(m_a, m_b)
+#define F4_MAX(m_a, m_b) _mm_max_ps(m_a, m_b)
+#define F4_ABS(m_a) _mm_andnot_ps(_mm_set1_ps(-0.0f), m_a)
+#define F4_LOAD(m_ptr) _mm_loadu_ps(m_ptr)
+#define F4_STORE(m_ptr, m_a) _mm_storeu_ps(m_ptr, m_a)
+
+#else
+
+typedef float32x4_t float4;
+
+static _FORCE_INLINE_ void _load_xyz4(const Vector3 *p_points, float4 &r_x, float4 &r_y, float4 &r_z) {
+	float32x4x3_t xyz = vld3q_f32((const float *)p_points);
+	r_x = xyz.val[0];
+	r_y = xyz.val[1];
+	r_z = xyz.val[2];
+}
+
+#define F4_SPLAT(m_value) vdupq_n_f32(m_value)
+#define F4_ADD(m_a, m_b) vaddq_f32(m_a, m_b)
+#define F4_SUB(m_a, m_b) vsubq_f32(m_a, m_b)
+#define F4_MUL(m_a, m_b) vmulq_f32(m_a, m_b)
+#define F4_MIN(m_a, m_b) vminq_f32(m_a, m_b)
+#define F4_MAX(m_a, m_b) vmaxq_f32(m_a, m_b)
+#define F4_ABS(m_a) vabsq_f32(m_a)
+#define F4_LOAD(m_ptr) vld1q_f32(m_ptr)
+#define F4_STORE(m_ptr, m_a) vst1q_f32(m_ptr, m_a)
+
+#endif
+
+// Summed in the same order as Vector3::dot(), so results match the scalar path.
+static _FORCE_INLINE_ float4 _dot4(const float4 &p_x, const float4 &p_y, const float4 &p_z, const float4 &p_axis_x, const float4 &p_axis_y, const float4 &p_axis_z) {
+	return F4_ADD(F4_ADD(F4_MUL(p_axis_x, p_x), F4_MUL(p_axis_y, p_y)), F4_MUL(p_axis_z, p_z));
+}
+
+void GodotSIMD3D::project_points(const Vector3 *p_points, int p_count, const Vector3 &p_axis, real_t &r_min, real_t &r_max) {
+	if (p_count < 8) {
+		project_points_scalar(p_points, p_count, p_axis, r_min, r_max);
+		return;
+	}
+
+	const float4 axis_x = F4_SPLAT(p_axis.x);
+	const float4 axis_y = F4_SPLAT(p_axis.y);
+	const float4 axis_z = F4_SPLAT(p_axis.z);
+
+	float4 x, y, z;
+	_load_xyz4(p_points, x, y, z);
+	float4 d_min = _dot4(x, y, z, axis_x, axis_y, axis_z);
+	float4 d_max = d_min;
+
+	int i = 4;
+	for (; i + 4 <= p_count; i += 4) {
+		_load_xyz4(p_points + i, x, y, z);
+		float4 d = _dot4(x, y, z, axis_x, axis_y, axis_z);
+		d_min = F4_MIN(d_min, d);
+		d_max = F4_MAX(d_max, d);
+	}
+
+	float mins[4], maxs[4];
+	F4_STORE(mins, d_min);
+	F4_STORE(maxs, d_max);
+	r_min = MIN(MIN(mins[0], mins[1]), MIN(mins[2], mins[3]));
+	r_max = MAX(MAX(maxs[0], maxs[1]), MAX(maxs[2], maxs[3]));
+
+	for (; i < p_count; i++) {
+		real_t d = p_axis.dot(p_points[i]);
+		if (d > r_max) {
+			r_max = d;
+		}
+		if (d < r_min) {
+			r_min = d;
+		}
+	}
+}
+
+int GodotSIMD3D::support_point(const Vector3 *p_points, int p_count, const Vector3 &p_dir) {
+	if (p_count < 8) {
+		return support_point_scalar(p_points, p_count, p_dir);
+	}
+
+	const float4 dir_x = F4_SPLAT(p_dir.x);
+	const float4 dir_y = F4_SPLAT(p_dir.y);
+	const float4 dir_z = F4_SPLAT(p_dir.z);
+
+	float4 x, y, z;
+	_load_xyz4(p_points, x, y, z);
+	float4 d_max = _dot4(x, y, z, dir_x, dir_y, dir_z);
+
+	// Each lane keeps its first maximum, like the scalar loop does.
+#if defined(GODOT_SIMD_3D_SSE2)
+	__m128i index = _mm_set_epi32(3, 2, 1, 0);
+	__m128i best_index = index;
+	const __m128i step = _mm_set1_epi32(4);
+#else
+	static const uint32_t first_indices[4] = { 0, 1, 2, 3 };
+	uint32x4_t index = vld1q_u32(first_indices);
+	uint32x4_t best_index = index;
+	const uint32x4_t step = vdupq_n_u32(4);
+#endif
+
+	int i = 4;
+	for (; i + 4 <= p_count; i += 4) {
+		_load_xyz4(p_points + i, x, y, z);
+		float4 d = _dot4(x, y, z, dir_x, dir_y, dir_z);
+#if defined(GODOT_SIMD_3D_SSE2)
+		index = _mm_add_epi32(index, step);
+		__m128 greater = _mm_cmpgt_ps(d, d_max);
+		d_max = _mm_or_ps(_mm_and_ps(greater, d), _mm_andnot_ps(greater, d_max));
+		__m128i greater_mask = _mm_castps_si128(greater);
+		best_index = _mm_or_si128(_mm_and_si128(greater_mask, index), _mm_andnot_si128(greater_mask, best_index));
+#else
+		index = vaddq_u32(index, step);
+		uint32x4_t greater = vcgtq_f32(d, d_max);
+		d_max = vbslq_f32(greater, d, d_max);
+		best_index = vbslq_u32(greater, index, best_index);
+#endif
+	}
+
+	float maxs[4];
+	int32_t indices[4];
+	F4_STORE(maxs, d_max);
+#if defined(GODOT_SIMD_3D_SSE2)
+	_mm_storeu_si128((__m128i *)indices, best_index);
+#else
+	vst1q_u32((uint32_t *)indices, best_index);
+#endif
+
+	// Ties between lanes go to the lowest index.
+	int support = indices[0];
+	real_t support_max = maxs[0];
+	for (int lane = 1; lane < 4; lane++) {
+		if (maxs[lane] > support_max || (maxs[lane] == support_max && indices[lane] < support)) {
+			support_max = maxs[lane];
+			support = indices[lane];
+		}
+	}
+
+	for (; i < p_count; i++) {
+		real_t d = p_dir.dot(p_points[i]);
+		if (d > support_max) {
+			support_max = d;
+			support = i;
+		}
+	}
+	return support;
+}
+
+void GodotSIMD3D::project_box(const Vector3 &p_half_extents, const Transform3D &p_transform, const Vector3 *p_axes, int p_axis_count, real_t *r_min, real_t *r_max) {
+	const Basis &basis = p_transform.basis;
+	const Vector3 &origin = p_transform.origin;
+
+	int i = 0;
+	for (; i + 4 <= p_axis_count; i += 4) {
+		float4 x, y, z;
+		_load_xyz4(p_axes + i, x, y, z);
+
+		// Basis::xform_inv() of the four axes, one column at a time.
+		float4 local_x = F4_ADD(F4_ADD(F4_MUL(F4_SPLAT(basis.elements[0][0]), x), F4_MUL(F4_SPLAT(basis.elements[1][0]), y)), F4_MUL(F4_SPLAT(basis.elements[2][0]), z));
+		float4 local_y = F4_ADD(F4_ADD(F4_MUL(F4_SPLAT(basis.elements[0][1]), x), F4_MUL(F4_SPLAT(basis.elements[1][1]), y)), F4_MUL(F4_SPLAT(basis.elements[2][1]), z));
+		float4 local_z = F4_ADD(F4_ADD(F4_MUL(F4_SPLAT(basis.elements[0][2]), x), F4_MUL(F4_SPLAT(basis.elements[1][2]), y)), F4_MUL(F4_SPLAT(basis.elements[2][2]), z));
+
+		float4 length = _dot4(F4_ABS(local_x), F4_ABS(local_y), F4_ABS(local_z), F4_SPLAT(p_half_extents.x), F4_SPLAT(p_half_extents.y), F4_SPLAT(p_half_extents.z));
+		float4 distance = _dot4(F4_SPLAT(origin.x), F4_SPLAT(origin.y), F4_SPLAT(origin.z), x, y, z);
+
+		F4_STORE(r_min + i, F4_SUB(distance, length));
+		F4_STORE(r_max + i, F4_ADD(distance, length));
+	}
+
+	project_box_scalar(p_half_extents, p_transform, p_axes + i, p_axis_count - i, r_min + i, r_max + i);
+}
+
+// The element-wise kernels below run over the components as a flat float array,
+// four at a time, with the remaining vectors done by the scalar loop.
+
+void GodotSIMD3D::multiply_add(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count) {
+	float *result = (float *)r_result;
+	const float *a = (const float *)p_a;
+	const float *b = (const float *)p_b;
+	const float4 scale = F4_SPLAT(p_scale);
+
+	// Four vectors per round, as three float4.
+	int i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		const int offset = i * 3;
+		F4_STORE(result + offset, F4_ADD(F4_LOAD(a + offset), F4_MUL(F4_LOAD(b + offset), scale)));
+		F4_STORE(result + offset + 4, F4_ADD(F4_LOAD(a + offset + 4), F4_MUL(F4_LOAD(b + offset + 4), scale)));
+		F4_STORE(result + offset + 8, F4_ADD(F4_LOAD(a + offset + 8), F4_MUL(F4_LOAD(b + offset + 8), scale)));
+	}
+
+	multiply_add_scalar(r_result + i, p_a + i, p_b + i, p_scale, p_count - i);
+}
+
+void GodotSIMD3D::scaled_difference(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count) {
+	float *result = (float *)r_result;
+	const float *a = (const float *)p_a;
+	const float *b = (const float *)p_b;
+	const float4 scale = F4_SPLAT(p_scale);
+
+	int i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		const int offset = i * 3;
+		F4_STORE(result + offset, F4_MUL(F4_SUB(F4_LOAD(a + offset), F4_LOAD(b + offset)), scale));
+		F4_STORE(result + offset + 4, F4_MUL(F4_SUB(F4_LOAD(a + offset + 4), F4_LOAD(b + offset + 4)), scale));
+		F4_STORE(result + offset + 8, F4_MUL(F4_SUB(F4_LOAD(a + offset + 8), F4_LOAD(b + offset + 8)), scale));
+	}
+
+	scaled_difference_scalar(r_result + i, p_a + i, p_b + i, p_scale, p_count - i);
+}
+
+bool GodotSIMD3D::is_vectorized() {
+	return true;
+}
+
+#undef F4_SPLAT
+#undef F4_ADD
+#undef F4_SUB
+#undef F4_MUL
+#undef F4_MIN
+#undef F4_MAX
+#undef F4_ABS
+#undef F4_LOAD
+#undef F4_STORE
+
+#else
+
+void GodotSIMD3D::project_points(const Vector3 *p_points, int p_count, const Vector3 &p_axis, real_t &r_min, real_t &r_max) {
+	project_points_scalar(p_points, p_count, p_axis, r_min, r_max);
+}
+
+int GodotSIMD3D::support_point(const Vector3 *p_points, int p_count, const Vector3 &p_dir) {
+	return support_point_scalar(p_points, p_count, p_dir);
+}
+
+void GodotSIMD3D::project_box(const Vector3 &p_half_extents, const Transform3D &p_transform, const Vector3 *p_axes, int p_axis_count, real_t *r_min, real_t *r_max) {
+	project_box_scalar(p_half_extents, p_transform, p_axes, p_axis_count, r_min, r_max);
+}
+
+void GodotSIMD3D::multiply_add(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count) {
+	multiply_add_scalar(r_result, p_a, p_b, p_scale, p_count);
+}
+
+void GodotSIMD3D::scaled_difference(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count) {
+	scaled_difference_scalar(r_result, p_a, p_b, p_scale, p_count);
+}
+
+bool GodotSIMD3D::is_vectorized() {
+	return false;
+}
+
+#endif
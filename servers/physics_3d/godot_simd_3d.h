@@ -0,0 +1,70 @@
+/*************************************************************************/
+/*  godot_simd_3d.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GODOT_SIMD_3D_H
+#define GODOT_SIMD_3D_H
+
+#include "core/math/transform_3d.h"
+
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GODOT_SIMD_3D_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define GODOT_SIMD_3D_NEON
+#endif
+#endif
+
+// Kernels over arrays of Vector3, used by the SAT axis tests, the GJK support
+// function and the soft body node integration. The vectorized variants are selected
+// at build time and give the same results as the scalar ones, which are always built
+// as a reference.
+class GodotSIMD3D {
+public:
+	// Projection range of p_points (p_count > 0) on p_axis.
+	static void project_points(const Vector3 *p_points, int p_count, const Vector3 &p_axis, real_t &r_min, real_t &r_max);
+	// Index of the first of p_points (p_count > 0) furthest along p_dir.
+	static int support_point(const Vector3 *p_points, int p_count, const Vector3 &p_dir);
+	// Projection ranges of a transformed box on each of p_axes.
+	static void project_box(const Vector3 &p_half_extents, const Transform3D &p_transform, const Vector3 *p_axes, int p_axis_count, real_t *r_min, real_t *r_max);
+	// r_result[i] = p_a[i] + p_b[i] * p_scale. r_result may be p_a.
+	static void multiply_add(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count);
+	// r_result[i] = (p_a[i] - p_b[i]) * p_scale. r_result may be p_a.
+	static void scaled_difference(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count);
+
+	static void project_points_scalar(const Vector3 *p_points, int p_count, const Vector3 &p_axis, real_t &r_min, real_t &r_max);
+	static int support_point_scalar(const Vector3 *p_points, int p_count, const Vector3 &p_dir);
+	static void project_box_scalar(const Vector3 &p_half_extents, const Transform3D &p_transform, const Vector3 *p_axes, int p_axis_count, real_t *r_min, real_t *r_max);
+	static void multiply_add_scalar(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count);
+	static void scaled_difference_scalar(Vector3 *r_result, const Vector3 *p_a, const Vector3 *p_b, real_t p_scale, int p_count);
+
+	static bool is_vectorized();
+};
+
+#endif // GODOT_SIMD_3D_H
@@ -30,9 +30,11 @@
 
 #include "godot_soft_body_3d.h"
 
+#include "godot_simd_3d.h"
 #include "godot_space_3d.h"
 
 #include "core/math/geometry_3d.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/templates/map.h"
 #include "servers/rendering_server.h"
 
@@ -54,6 +56,42 @@ subject to the following restrictions:
 */
 ///btSoftBody implementation by Nathanael Presson
 
+void GodotSoftBody3D::Nodes::resize(uint32_t p_size) {
+	const uint32_t old_size = size();
+
+	s.resize(p_size);
+	x.resize(p_size);
+	q.resize(p_size);
+	f.resize(p_size);
+	v.resize(p_size);
+	bv.resize(p_size);
+	n.resize(p_size);
+	area.resize(p_size);
+	im.resize(p_size);
+	leaf.resize(p_size);
+	index.resize(p_size);
+
+	for (uint32_t i = old_size; i < p_size; ++i) {
+		area[i] = 0.0;
+		im[i] = 0.0;
+		index[i] = i;
+	}
+}
+
+void GodotSoftBody3D::Nodes::clear() {
+	s.clear();
+	x.clear();
+	q.clear();
+	f.clear();
+	v.clear();
+	bv.clear();
+	n.clear();
+	area.clear();
+	im.clear();
+	leaf.clear();
+	index.clear();
+}
+
 GodotSoftBody3D::GodotSoftBody3D() :
 		GodotCollisionObject3D(TYPE_SOFT_BODY),
 		active_list(this) {
@@ -155,9 +193,8 @@ void GodotSoftBody3D::update_rendering_server(PhysicsServer3DRenderingServerHand
 	const uint32_t vertex_count = map_visual_to_physics.size();
 	for (uint32_t i = 0; i < vertex_count; ++i) {
 		const uint32_t node_index = map_visual_to_physics[i];
-		const Node &node = nodes[node_index];
-		const Vector3 &vertex_position = node.x;
-		const Vector3 &vertex_normal = node.n;
+		const Vector3 &vertex_position = nodes.x[node_index];
+		const Vector3 &vertex_normal = nodes.n[node_index];
 
 		p_rendering_server_handler->set_vertex(i, &vertex_position);
 		p_rendering_server_handler->set_normal(i, &vertex_normal);
@@ -169,26 +206,31 @@ void GodotSoftBody3D::update_rendering_server(PhysicsServer3DRenderingServerHand
 void GodotSoftBody3D::update_normals_and_centroids() {
 	uint32_t i, ni;
 
+	const Vector3 *positions = nodes.x.ptr();
+	Vector3 *normals = nodes.n.ptr();
+
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		nodes[i].n = Vector3();
+		normals[i] = Vector3();
 	}
 
 	for (i = 0, ni = faces.size(); i < ni; ++i) {
 		Face &face = faces[i];
-		const Vector3 n = vec3_cross(face.n[0]->x - face.n[2]->x, face.n[0]->x - face.n[1]->x);
-		face.n[0]->n += n;
-		face.n[1]->n += n;
-		face.n[2]->n += n;
+		const Vector3 &x0 = positions[face.n[0]];
+		const Vector3 &x1 = positions[face.n[1]];
+		const Vector3 &x2 = positions[face.n[2]];
+		const Vector3 n = vec3_cross(x0 - x2, x0 - x1);
+		normals[face.n[0]] += n;
+		normals[face.n[1]] += n;
+		normals[face.n[2]] += n;
 		face.normal = n;
 		face.normal.normalize();
-		face.centroid = 0.33333333333 * (face.n[0]->x + face.n[1]->x + face.n[2]->x);
+		face.centroid = 0.33333333333 * (x0 + x1 + x2);
 	}
 
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		real_t len = node.n.length();
+		real_t len = normals[i].length();
 		if (len > CMP_EPSILON) {
-			node.n /= len;
+			normals[i] /= len;
 		}
 	}
 }
@@ -208,15 +250,15 @@ void GodotSoftBody3D::update_bounds() {
 	bool first = true;
 	bool moved = false;
 	for (uint32_t node_index = 0; node_index < nodes_count; ++node_index) {
-		const Node &node = nodes[node_index];
-		if (!prev_bounds.has_point(node.x)) {
+		const Vector3 &position = nodes.x[node_index];
+		if (!prev_bounds.has_point(position)) {
 			moved = true;
 		}
 		if (first) {
-			bounds.position = node.x;
+			bounds.position = position;
 			first = false;
 		} else {
-			bounds.expand_to(node.x);
+			bounds.expand_to(position);
 		}
 	}
 
@@ -238,9 +280,9 @@ void GodotSoftBody3D::update_area() {
 	for (i = 0, ni = faces.size(); i < ni; ++i) {
 		Face &face = faces[i];
 
-		const Vector3 &x0 = face.n[0]->x;
-		const Vector3 &x1 = face.n[1]->x;
-		const Vector3 &x2 = face.n[2]->x;
+		const Vector3 &x0 = nodes.x[face.n[0]];
+		const Vector3 &x1 = nodes.x[face.n[1]];
+		const Vector3 &x2 = nodes.x[face.n[2]];
 
 		const Vector3 a = x1 - x0;
 		const Vector3 b = x2 - x0;
@@ -256,23 +298,23 @@ void GodotSoftBody3D::update_area() {
 	}
 
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		nodes[i].area = 0.0;
+		nodes.area[i] = 0.0;
 	}
 
 	for (i = 0, ni = faces.size(); i < ni; ++i) {
 		const Face &face = faces[i];
 		for (int j = 0; j < 3; ++j) {
-			const int index = (int)(face.n[j] - &nodes[0]);
+			const uint32_t index = face.n[j];
 			counts[index]++;
-			face.n[j]->area += Math::abs(face.ra);
+			nodes.area[index] += Math::abs(face.ra);
 		}
 	}
 
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
 		if (counts[i] > 0) {
-			nodes[i].area /= (real_t)counts[i];
+			nodes.area[i] /= (real_t)counts[i];
 		} else {
-			nodes[i].area = 0.0;
+			nodes.area[i] = 0.0;
 		}
 	}
 }
@@ -280,7 +322,7 @@ void GodotSoftBody3D::update_area() {
 void GodotSoftBody3D::reset_link_rest_lengths() {
 	for (uint32_t i = 0, ni = links.size(); i < ni; ++i) {
 		Link &link = links[i];
-		link.rl = (link.n[0]->x - link.n[1]->x).length();
+		link.rl = (nodes.x[link.n[0]] - nodes.x[link.n[1]]).length();
 		link.c1 = link.rl * link.rl;
 	}
 }
@@ -289,7 +331,7 @@ void GodotSoftBody3D::update_link_constants() {
 	real_t inv_linear_stiffness = 1.0 / linear_stiffness;
 	for (uint32_t i = 0, ni = links.size(); i < ni; ++i) {
 		Link &link = links[i];
-		link.c0 = (link.n[0]->im + link.n[1]->im) * inv_linear_stiffness;
+		link.c0 = (nodes.im[link.n[0]] + nodes.im[link.n[1]]) * inv_linear_stiffness;
 	}
 }
 
@@ -301,15 +343,15 @@ void GodotSoftBody3D::apply_nodes_transform(const Transform3D &p_transform) {
 	uint32_t node_count = nodes.size();
 	Vector3 leaf_size = Vector3(collision_margin, collision_margin, collision_margin) * 2.0;
 	for (uint32_t node_index = 0; node_index < node_count; ++node_index) {
-		Node &node = nodes[node_index];
+		Vector3 &position = nodes.x[node_index];
 
-		node.x = p_transform.xform(node.x);
-		node.q = node.x;
-		node.v = Vector3();
-		node.bv = Vector3();
+		position = p_transform.xform(position);
+		nodes.q[node_index] = position;
+		nodes.v[node_index] = Vector3();
+		nodes.bv[node_index] = Vector3();
 
-		AABB node_aabb(node.x, leaf_size);
-		node_tree.update(node.leaf, node_aabb);
+		AABB node_aabb(position, leaf_size);
+		node_tree.update(nodes.leaf[node_index], node_aabb);
 	}
 
 	face_tree.clear();
@@ -330,7 +372,7 @@ Vector3 GodotSoftBody3D::get_vertex_position(int p_index) const {
 	uint32_t node_index = map_visual_to_physics[p_index];
 
 	ERR_FAIL_COND_V(node_index >= nodes.size(), Vector3());
-	return nodes[node_index].x;
+	return nodes.x[node_index];
 }
 
 void GodotSoftBody3D::set_vertex_position(int p_index, const Vector3 &p_position) {
@@ -344,9 +386,8 @@ void GodotSoftBody3D::set_vertex_position(int p_index, const Vector3 &p_position
 	uint32_t node_index = map_visual_to_physics[p_index];
 
 	ERR_FAIL_COND(node_index >= nodes.size());
-	Node &node = nodes[node_index];
-	node.q = node.x;
-	node.x = p_position;
+	nodes.q[node_index] = nodes.x[node_index];
+	nodes.x[node_index] = p_position;
 }
 
 void GodotSoftBody3D::pin_vertex(int p_index) {
@@ -363,8 +404,7 @@ void GodotSoftBody3D::pin_vertex(int p_index) {
 		uint32_t node_index = map_visual_to_physics[p_index];
 
 		ERR_FAIL_COND(node_index >= nodes.size());
-		Node &node = nodes[node_index];
-		node.im = 0.0;
+		nodes.im[node_index] = 0.0;
 	}
 }
 
@@ -383,8 +423,7 @@ void GodotSoftBody3D::unpin_vertex(int p_index) {
 				ERR_FAIL_COND(node_index >= nodes.size());
 				real_t inv_node_mass = nodes.size() * inv_total_mass;
 
-				Node &node = nodes[node_index];
-				node.im = inv_node_mass;
+				nodes.im[node_index] = inv_node_mass;
 			}
 
 			return;
@@ -403,8 +442,7 @@ void GodotSoftBody3D::unpin_all_vertices() {
 			uint32_t node_index = map_visual_to_physics[pinned_vertex];
 
 			ERR_CONTINUE(node_index >= nodes.size());
-			Node &node = nodes[node_index];
-			node.im = inv_node_mass;
+			nodes.im[node_index] = inv_node_mass;
 		}
 	}
 
@@ -430,34 +468,32 @@ uint32_t GodotSoftBody3D::get_node_count() const {
 
 real_t GodotSoftBody3D::get_node_inv_mass(uint32_t p_node_index) const {
 	ERR_FAIL_COND_V(p_node_index >= nodes.size(), 0.0);
-	return nodes[p_node_index].im;
+	return nodes.im[p_node_index];
 }
 
 Vector3 GodotSoftBody3D::get_node_position(uint32_t p_node_index) const {
 	ERR_FAIL_COND_V(p_node_index >= nodes.size(), Vector3());
-	return nodes[p_node_index].x;
+	return nodes.x[p_node_index];
 }
 
 Vector3 GodotSoftBody3D::get_node_velocity(uint32_t p_node_index) const {
 	ERR_FAIL_COND_V(p_node_index >= nodes.size(), Vector3());
-	return nodes[p_node_index].v;
+	return nodes.v[p_node_index];
 }
 
 Vector3 GodotSoftBody3D::get_node_biased_velocity(uint32_t p_node_index) const {
 	ERR_FAIL_COND_V(p_node_index >= nodes.size(), Vector3());
-	return nodes[p_node_index].bv;
+	return nodes.bv[p_node_index];
 }
 
 void GodotSoftBody3D::apply_node_impulse(uint32_t p_node_index, const Vector3 &p_impulse) {
 	ERR_FAIL_COND(p_node_index >= nodes.size());
-	Node &node = nodes[p_node_index];
-	node.v += p_impulse * node.im;
+	nodes.v[p_node_index] += p_impulse * nodes.im[p_node_index];
 }
 
 void GodotSoftBody3D::apply_node_bias_impulse(uint32_t p_node_index, const Vector3 &p_impulse) {
 	ERR_FAIL_COND(p_node_index >= nodes.size());
-	Node &node = nodes[p_node_index];
-	node.bv += p_impulse * node.im;
+	nodes.bv[p_node_index] += p_impulse * nodes.im[p_node_index];
 }
 
 uint32_t GodotSoftBody3D::get_face_count() const {
@@ -467,9 +503,9 @@ uint32_t GodotSoftBody3D::get_face_count() const {
 void GodotSoftBody3D::get_face_points(uint32_t p_face_index, Vector3 &r_point_1, Vector3 &r_point_2, Vector3 &r_point_3) const {
 	ERR_FAIL_COND(p_face_index >= faces.size());
 	const Face &face = faces[p_face_index];
-	r_point_1 = face.n[0]->x;
-	r_point_2 = face.n[1]->x;
-	r_point_3 = face.n[2]->x;
+	r_point_1 = nodes.x[face.n[0]];
+	r_point_2 = nodes.x[face.n[1]];
+	r_point_3 = nodes.x[face.n[2]];
 }
 
 Vector3 GodotSoftBody3D::get_face_normal(uint32_t p_face_index) const {
@@ -540,16 +576,13 @@ bool GodotSoftBody3D::create_from_trimesh(const Vector<int> &p_indices, const Ve
 	real_t inv_node_mass = node_count * inv_total_mass;
 	Vector3 leaf_size = Vector3(collision_margin, collision_margin, collision_margin) * 2.0;
 	for (uint32_t i = 0; i < node_count; ++i) {
-		Node &node = nodes[i];
-		node.s = vertices[i];
-		node.x = node.s;
-		node.q = node.s;
-		node.im = inv_node_mass;
+		nodes.s[i] = vertices[i];
+		nodes.x[i] = vertices[i];
+		nodes.q[i] = vertices[i];
+		nodes.im[i] = inv_node_mass;
 
-		AABB node_aabb(node.x, leaf_size);
-		node.leaf = node_tree.insert(node_aabb, &node);
-
-		node.index = i;
+		AABB node_aabb(vertices[i], leaf_size);
+		nodes.leaf[i] = node_tree.insert(node_aabb, &nodes.index[i]);
 	}
 
 	// Create links and faces from triangles.
@@ -583,12 +616,11 @@ bool GodotSoftBody3D::create_from_trimesh(const Vector<int> &p_indices, const Ve
 		uint32_t node_index = map_visual_to_physics[pinned_vertex];
 
 		ERR_CONTINUE(node_index >= node_count);
-		Node &node = nodes[node_index];
-		node.im = 0.0;
+		nodes.im[node_index] = 0.0;
 	}
 
 	generate_bending_constraints(2);
-	reoptimize_link_order();
+	color_links();
 
 	update_constants();
 	update_normals_and_centroids();
@@ -620,8 +652,8 @@ void GodotSoftBody3D::generate_bending_constraints(int p_distance) {
 			}
 		}
 		for (i = 0; i < links.size(); ++i) {
-			const int ia = (int)(links[i].n[0] - &nodes[0]);
-			const int ib = (int)(links[i].n[1] - &nodes[0]);
+			const int ia = links[i].n[0];
+			const int ib = links[i].n[1];
 			int idx = ib * n + ia;
 			int idx_inv = ia * n + ib;
 			adj[idx] = 1;
@@ -636,8 +668,8 @@ void GodotSoftBody3D::generate_bending_constraints(int p_distance) {
 			node_links.resize(nodes.size());
 
 			for (i = 0; i < links.size(); ++i) {
-				const int ia = (int)(links[i].n[0] - &nodes[0]);
-				const int ib = (int)(links[i].n[1] - &nodes[0]);
+				const int ia = links[i].n[0];
+				const int ib = links[i].n[1];
 				if (node_links[ia].find(ib) == -1) {
 					node_links[ia].push_back(ib);
 				}
@@ -696,135 +728,62 @@ void GodotSoftBody3D::generate_bending_constraints(int p_distance) {
 	}
 }
 
-//===================================================================
-//
-//
-// This function takes in a list of interdependent Links and tries
-// to maximize the distance between calculation
-// of dependent links. This increases the amount of parallelism that can
-// be exploited by out-of-order instruction processors with large but
-// (inevitably) finite instruction windows.
-//
-//===================================================================
-
-// A small structure to track lists of dependent link calculations.
-class LinkDeps {
-public:
-	// A link calculation that is dependent on this one.
-	// Positive values = "input A" while negative values = "input B".
-	int value;
-	// Next dependence in the list.
-	LinkDeps *next;
-};
-typedef LinkDeps *LinkDepsPtr;
-
-void GodotSoftBody3D::reoptimize_link_order() {
-	const int reop_not_dependent = -1;
-	const int reop_node_complete = -2;
-
-	uint32_t i, link_count = links.size(), node_count = nodes.size();
-	Link *lr;
-	int ar, br;
-	Node *node0 = &(nodes[0]);
-	Node *node1 = &(nodes[1]);
-	LinkDepsPtr link_dep;
-	int ready_list_head, ready_list_tail, link_num, link_dep_frees, dep_link;
-
-	// Allocate temporary buffers.
-	int *node_written_at = memnew_arr(int, node_count + 1); // What link calculation produced this node's current values?
-	int *link_dep_A = memnew_arr(int, link_count); // Link calculation input is dependent upon prior calculation #N
-	int *link_dep_B = memnew_arr(int, link_count);
-	int *ready_list = memnew_arr(int, link_count); // List of ready-to-process link calculations (# of links, maximum)
-	LinkDeps *link_dep_free_list = memnew_arr(LinkDeps, 2 * link_count); // Dependent-on-me list elements (2x# of links, maximum)
-	LinkDepsPtr *link_dep_list_starts = memnew_arr(LinkDepsPtr, link_count); // Start nodes of dependent-on-me lists, one for each link
-
-	// Copy the original, unsorted links to a side buffer.
-	Link *link_buffer = memnew_arr(Link, link_count);
-	memcpy(link_buffer, &(links[0]), sizeof(Link) * link_count);
-
-	// Clear out the node setup and ready list.
-	for (i = 0; i < node_count + 1; i++) {
-		node_written_at[i] = reop_not_dependent;
-	}
-	for (i = 0; i < link_count; i++) {
-		link_dep_list_starts[i] = nullptr;
-	}
-	ready_list_head = ready_list_tail = link_dep_frees = 0;
-
-	// Initial link analysis to set up data structures.
-	for (i = 0; i < link_count; i++) {
-		// Note which prior link calculations we are dependent upon & build up dependence lists.
-		lr = &(links[i]);
-		ar = (lr->n[0] - node0) / (node1 - node0);
-		br = (lr->n[1] - node0) / (node1 - node0);
-		if (node_written_at[ar] > reop_not_dependent) {
-			link_dep_A[i] = node_written_at[ar];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = i;
-			link_dep->next = link_dep_list_starts[node_written_at[ar]];
-			link_dep_list_starts[node_written_at[ar]] = link_dep;
-		} else {
-			link_dep_A[i] = reop_not_dependent;
-		}
-		if (node_written_at[br] > reop_not_dependent) {
-			link_dep_B[i] = node_written_at[br];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = -(int)(i + 1);
-			link_dep->next = link_dep_list_starts[node_written_at[br]];
-			link_dep_list_starts[node_written_at[br]] = link_dep;
-		} else {
-			link_dep_B[i] = reop_not_dependent;
-		}
+// Greedy edge coloring: each link gets the lowest color that neither of its nodes
+// uses yet, then links are stably sorted by color into batches. Links within a batch
+// touch distinct nodes, so they can be solved in any order or in parallel, and the
+// result does not depend on how the batch is split.
+void GodotSoftBody3D::color_links() {
+	const uint32_t link_count = links.size();
 
-		// Add this link to the initial ready list, if it is not dependent on any other links.
-		if ((link_dep_A[i] == reop_not_dependent) && (link_dep_B[i] == reop_not_dependent)) {
-			ready_list[ready_list_tail++] = i;
-			link_dep_A[i] = link_dep_B[i] = reop_node_complete; // Probably not needed now.
+	link_batches.clear();
+	if (link_count == 0) {
+		return;
+	}
+
+	LocalVector<LocalVector<uint32_t>> node_colors;
+	node_colors.resize(nodes.size());
+
+	LocalVector<uint32_t> link_colors;
+	link_colors.resize(link_count);
+
+	LocalVector<uint32_t> color_counts;
+
+	for (uint32_t i = 0; i < link_count; ++i) {
+		LocalVector<uint32_t> &colors_a = node_colors[links[i].n[0]];
+		LocalVector<uint32_t> &colors_b = node_colors[links[i].n[1]];
+
+		uint32_t color = 0;
+		while (colors_a.find(color) != -1 || colors_b.find(color) != -1) {
+			color++;
 		}
+		colors_a.push_back(color);
+		colors_b.push_back(color);
+		link_colors[i] = color;
 
-		// Update the nodes to mark which ones are calculated by this link.
-		node_written_at[ar] = node_written_at[br] = i;
-	}
-
-	// Process the ready list and create the sorted list of links:
-	// -- By treating the ready list as a queue, we maximize the distance between any
-	//    inter-dependent node calculations.
-	// -- All other (non-related) nodes in the ready list will automatically be inserted
-	//    in between each set of inter-dependent link calculations by this loop.
-	i = 0;
-	while (ready_list_head != ready_list_tail) {
-		// Use ready list to select the next link to process.
-		link_num = ready_list[ready_list_head++];
-		// Copy the next-to-calculate link back into the original link array.
-		links[i++] = link_buffer[link_num];
-
-		// Free up any link inputs that are dependent on this one.
-		link_dep = link_dep_list_starts[link_num];
-		while (link_dep) {
-			dep_link = link_dep->value;
-			if (dep_link >= 0) {
-				link_dep_A[dep_link] = reop_not_dependent;
-			} else {
-				dep_link = -dep_link - 1;
-				link_dep_B[dep_link] = reop_not_dependent;
-			}
-			// Add this dependent link calculation to the ready list if *both* inputs are clear.
-			if ((link_dep_A[dep_link] == reop_not_dependent) && (link_dep_B[dep_link] == reop_not_dependent)) {
-				ready_list[ready_list_tail++] = dep_link;
-				link_dep_A[dep_link] = link_dep_B[dep_link] = reop_node_complete; // Probably not needed now.
-			}
-			link_dep = link_dep->next;
+		if (color >= color_counts.size()) {
+			color_counts.resize(color + 1);
+			color_counts[color] = 0;
 		}
+		color_counts[color]++;
 	}
 
-	// Delete the temporary buffers.
-	memdelete_arr(node_written_at);
-	memdelete_arr(link_dep_A);
-	memdelete_arr(link_dep_B);
-	memdelete_arr(ready_list);
-	memdelete_arr(link_dep_free_list);
-	memdelete_arr(link_dep_list_starts);
-	memdelete_arr(link_buffer);
+	link_batches.resize(color_counts.size() + 1);
+	link_batches[0] = 0;
+	for (uint32_t color = 0; color < color_counts.size(); ++color) {
+		link_batches[color + 1] = link_batches[color] + color_counts[color];
+	}
+
+	LocalVector<uint32_t> write_offsets;
+	write_offsets.resize(color_counts.size());
+	memcpy(write_offsets.ptr(), link_batches.ptr(), write_offsets.size() * sizeof(uint32_t));
+
+	LocalVector<Link> sorted_links;
+	sorted_links.resize(link_count);
+	for (uint32_t i = 0; i < link_count; ++i) {
+		sorted_links[write_offsets[link_colors[i]]++] = links[i];
+	}
+
+	links = sorted_links;
 }
 
 void GodotSoftBody3D::append_link(uint32_t p_node1, uint32_t p_node2) {
@@ -832,13 +791,10 @@ void GodotSoftBody3D::append_link(uint32_t p_node1, uint32_t p_node2) {
 		return;
 	}
 
-	Node *node1 = &nodes[p_node1];
-	Node *node2 = &nodes[p_node2];
-
 	Link link;
-	link.n[0] = node1;
-	link.n[1] = node2;
-	link.rl = (node1->x - node2->x).length();
+	link.n[0] = p_node1;
+	link.n[1] = p_node2;
+	link.rl = (nodes.x[p_node1] - nodes.x[p_node2]).length();
 
 	links.push_back(link);
 }
@@ -854,14 +810,10 @@ void GodotSoftBody3D::append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p
 		return;
 	}
 
-	Node *node1 = &nodes[p_node1];
-	Node *node2 = &nodes[p_node2];
-	Node *node3 = &nodes[p_node3];
-
 	Face face;
-	face.n[0] = node1;
-	face.n[1] = node2;
-	face.n[2] = node3;
+	face.n[0] = p_node1;
+	face.n[1] = p_node2;
+	face.n[2] = p_node3;
 
 	face.index = faces.size();
 
@@ -881,8 +833,7 @@ void GodotSoftBody3D::set_total_mass(real_t p_val) {
 
 	uint32_t node_count = nodes.size();
 	for (uint32_t node_index = 0; node_index < node_count; ++node_index) {
-		Node &node = nodes[node_index];
-		node.im *= mass_factor;
+		nodes.im[node_index] *= mass_factor;
 	}
 
 	update_constants();
@@ -910,14 +861,13 @@ void GodotSoftBody3D::set_drag_coefficient(real_t p_val) {
 
 void GodotSoftBody3D::add_velocity(const Vector3 &p_velocity) {
 	for (uint32_t i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		if (node.im > 0) {
-			node.v += p_velocity;
+		if (nodes.im[i] > 0) {
+			nodes.v[i] += p_velocity;
 		}
 	}
 }
 
-void GodotSoftBody3D::apply_forces(const LocalVector<GodotArea3D *> &p_wind_areas) {
+void GodotSoftBody3D::apply_forces(const FrameLocalVector<GodotArea3D *> &p_wind_areas) {
 	if (nodes.is_empty()) {
 		return;
 	}
@@ -926,7 +876,7 @@ void GodotSoftBody3D::apply_forces(const LocalVector<GodotArea3D *> &p_wind_area
 	int32_t j;
 
 	real_t volume = 0.0;
-	const Vector3 &org = nodes[0].x;
+	const Vector3 &org = nodes.x[0];
 
 	// Iterate over faces (try not to iterate elsewhere if possible).
 	for (i = 0, ni = faces.size(); i < ni; ++i) {
@@ -935,7 +885,7 @@ void GodotSoftBody3D::apply_forces(const LocalVector<GodotArea3D *> &p_wind_area
 		Vector3 wind_force(0, 0, 0);
 
 		// Compute volume.
-		volume += vec3_dot(face.n[0]->x - org, vec3_cross(face.n[1]->x - org, face.n[2]->x - org));
+		volume += vec3_dot(nodes.x[face.n[0]] - org, vec3_cross(nodes.x[face.n[1]] - org, nodes.x[face.n[2]] - org));
 
 		// Compute nodal forces from area winds.
 		int wind_area_count = p_wind_areas.size();
@@ -945,8 +895,7 @@ void GodotSoftBody3D::apply_forces(const LocalVector<GodotArea3D *> &p_wind_area
 			}
 
 			for (j = 0; j < 3; j++) {
-				Node *current_node = face.n[j];
-				current_node->f += wind_force;
+				nodes.f[face.n[j]] += wind_force;
 			}
 		}
 	}
@@ -956,9 +905,8 @@ void GodotSoftBody3D::apply_forces(const LocalVector<GodotArea3D *> &p_wind_area
 	if (pressure_coefficient > CMP_EPSILON) {
 		real_t ivolumetp = 1.0 / Math::abs(volume) * pressure_coefficient;
 		for (i = 0, ni = nodes.size(); i < ni; ++i) {
-			Node &node = nodes[i];
-			if (node.im > 0) {
-				node.f += node.n * (node.area * ivolumetp);
+			if (nodes.im[i] > 0) {
+				nodes.f[i] += nodes.n[i] * (nodes.area[i] * ivolumetp);
 			}
 		}
 	}
@@ -984,7 +932,7 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	bool gravity_done = false;
 	Vector3 gravity;
 
-	LocalVector<GodotArea3D *> wind_areas;
+	FrameLocalVector<GodotArea3D *> wind_areas;
 
 	int ac = areas.size();
 	if (ac) {
@@ -1043,16 +991,18 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 
 	// Integrate.
 	uint32_t i, ni;
-	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		node.q = node.x;
-		Vector3 delta_v = node.f * node.im * p_delta;
+	const uint32_t node_count = nodes.size();
+	memcpy(nodes.q.ptr(), nodes.x.ptr(), node_count * sizeof(Vector3));
+	for (i = 0; i < node_count; ++i) {
+		Vector3 delta_v = nodes.f[i] * nodes.im[i] * p_delta;
 		for (int c = 0; c < 3; c++) {
 			delta_v[c] = CLAMP(delta_v[c], -clamp_delta_v, clamp_delta_v);
 		}
-		node.v += delta_v;
-		node.x += node.v * p_delta;
-		node.f = Vector3();
+		nodes.v[i] += delta_v;
+	}
+	GodotSIMD3D::multiply_add(nodes.x.ptr(), nodes.x.ptr(), nodes.v.ptr(), p_delta, node_count);
+	for (i = 0; i < node_count; ++i) {
+		nodes.f[i] = Vector3();
 	}
 
 	// Bounds and tree update.
@@ -1060,13 +1010,13 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 
 	// Node tree update.
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		const Node &node = nodes[i];
+		const Vector3 &position = nodes.x[i];
 
-		AABB node_aabb(node.x, Vector3());
-		node_aabb.expand_to(node.x + node.v * p_delta);
+		AABB node_aabb(position, Vector3());
+		node_aabb.expand_to(position + nodes.v[i] * p_delta);
 		node_aabb.grow_by(collision_margin);
 
-		node_tree.update(node.leaf, node_aabb);
+		node_tree.update(nodes.leaf[i], node_aabb);
 	}
 
 	// Face tree update.
@@ -1086,15 +1036,14 @@ void GodotSoftBody3D::solve_constraints(real_t p_delta) {
 
 	for (i = 0, ni = links.size(); i < ni; ++i) {
 		Link &link = links[i];
-		link.c3 = link.n[1]->q - link.n[0]->q;
+		link.c3 = nodes.q[link.n[1]] - nodes.q[link.n[0]];
 		link.c2 = 1 / (link.c3.length_squared() * link.c0);
 	}
 
+	const uint32_t node_count = nodes.size();
+
 	// Solve velocities.
-	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		node.x = node.q + node.v * p_delta;
-	}
+	GodotSIMD3D::multiply_add(nodes.x.ptr(), nodes.q.ptr(), nodes.v.ptr(), p_delta, node_count);
 
 	// Solve positions.
 	for (int isolve = 0; isolve < iteration_count; ++isolve) {
@@ -1102,37 +1051,58 @@ void GodotSoftBody3D::solve_constraints(real_t p_delta) {
 		solve_links(1.0, ti);
 	}
 	const real_t vc = (1.0 - damping_coefficient) * inv_delta;
-	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-
-		node.x += node.bv * p_delta;
-		node.bv = Vector3();
-
-		node.v = (node.x - node.q) * vc;
-
-		node.q = node.x;
+	GodotSIMD3D::multiply_add(nodes.x.ptr(), nodes.x.ptr(), nodes.bv.ptr(), p_delta, node_count);
+	for (i = 0; i < node_count; ++i) {
+		nodes.bv[i] = Vector3();
 	}
+	GodotSIMD3D::scaled_difference(nodes.v.ptr(), nodes.x.ptr(), nodes.q.ptr(), vc, node_count);
+	memcpy(nodes.q.ptr(), nodes.x.ptr(), node_count * sizeof(Vector3));
 
 	update_normals_and_centroids();
 }
 
 void GodotSoftBody3D::solve_links(real_t kst, real_t ti) {
-	for (uint32_t i = 0, ni = links.size(); i < ni; ++i) {
-		Link &link = links[i];
+	for (uint32_t batch = 0; batch + 1 < link_batches.size(); ++batch) {
+		const uint32_t begin = link_batches[batch];
+		const uint32_t end = link_batches[batch + 1];
+		if (end - begin < LINK_PARALLEL_THRESHOLD) {
+			_solve_link_range(begin, end, kst);
+			continue;
+		}
+
+		link_solve_begin = begin;
+		link_solve_end = end;
+		link_solve_stiffness = kst;
+		const uint32_t chunk_count = (end - begin + LINK_CHUNK_SIZE - 1) / LINK_CHUNK_SIZE;
+		WorkerThreadPool::get_singleton()->do_work(chunk_count, this, &GodotSoftBody3D::_solve_link_chunk, nullptr);
+	}
+}
+
+void GodotSoftBody3D::_solve_link_range(uint32_t p_begin, uint32_t p_end, real_t p_stiffness) {
+	Vector3 *positions = nodes.x.ptr();
+	const real_t *inv_masses = nodes.im.ptr();
+
+	for (uint32_t i = p_begin; i < p_end; ++i) {
+		const Link &link = links[i];
 		if (link.c0 > 0) {
-			Node &node_a = *link.n[0];
-			Node &node_b = *link.n[1];
-			const Vector3 del = node_b.x - node_a.x;
+			const uint32_t a = link.n[0];
+			const uint32_t b = link.n[1];
+			const Vector3 del = positions[b] - positions[a];
 			const real_t len = del.length_squared();
 			if (link.c1 + len > CMP_EPSILON) {
-				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * kst;
-				node_a.x -= del * (k * node_a.im);
-				node_b.x += del * (k * node_b.im);
+				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * p_stiffness;
+				positions[a] -= del * (k * inv_masses[a]);
+				positions[b] += del * (k * inv_masses[b]);
 			}
 		}
 	}
 }
 
+void GodotSoftBody3D::_solve_link_chunk(uint32_t p_chunk, void *p_userdata) {
+	const uint32_t begin = link_solve_begin + p_chunk * LINK_CHUNK_SIZE;
+	_solve_link_range(begin, MIN(begin + LINK_CHUNK_SIZE, link_solve_end), link_solve_stiffness);
+}
+
 struct AABBQueryResult {
 	const GodotSoftBody3D *soft_body = nullptr;
 	void *userdata = nullptr;
@@ -1182,9 +1152,9 @@ void GodotSoftBody3D::initialize_face_tree() {
 
 		AABB face_aabb;
 
-		face_aabb.position = face.n[0]->x;
-		face_aabb.expand_to(face.n[1]->x);
-		face_aabb.expand_to(face.n[2]->x);
+		face_aabb.position = nodes.x[face.n[0]];
+		face_aabb.expand_to(nodes.x[face.n[1]]);
+		face_aabb.expand_to(nodes.x[face.n[2]]);
 
 		face_aabb.grow_by(collision_margin);
 
@@ -1198,17 +1168,17 @@ void GodotSoftBody3D::update_face_tree(real_t p_delta) {
 
 		AABB face_aabb;
 
-		const Node *node0 = face.n[0];
-		face_aabb.position = node0->x;
-		face_aabb.expand_to(node0->x + node0->v * p_delta);
+		const uint32_t node0 = face.n[0];
+		face_aabb.position = nodes.x[node0];
+		face_aabb.expand_to(nodes.x[node0] + nodes.v[node0] * p_delta);
 
-		const Node *node1 = face.n[1];
-		face_aabb.expand_to(node1->x);
-		face_aabb.expand_to(node1->x + node1->v * p_delta);
+		const uint32_t node1 = face.n[1];
+		face_aabb.expand_to(nodes.x[node1]);
+		face_aabb.expand_to(nodes.x[node1] + nodes.v[node1] * p_delta);
 
-		const Node *node2 = face.n[2];
-		face_aabb.expand_to(node2->x);
-		face_aabb.expand_to(node2->x + node2->v * p_delta);
+		const uint32_t node2 = face.n[2];
+		face_aabb.expand_to(nodes.x[node2]);
+		face_aabb.expand_to(nodes.x[node2] + nodes.v[node2] * p_delta);
 
 		face_aabb.grow_by(collision_margin);
 
@@ -1244,6 +1214,7 @@ void GodotSoftBody3D::destroy() {
 
 	nodes.clear();
 	links.clear();
+	link_batches.clear();
 	faces.clear();
 
 	bounds = AABB();
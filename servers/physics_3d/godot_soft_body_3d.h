@@ -33,36 +33,44 @@
 
 #include "godot_area_3d.h"
 #include "godot_collision_object_3d.h"
+#include "godot_constraint_3d.h"
 
 #include "core/math/aabb.h"
 #include "core/math/dynamic_bvh.h"
 #include "core/math/vector3.h"
+#include "core/os/frame_allocator.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/set.h"
 #include "core/templates/vset.h"
 
-class GodotConstraint3D;
-
 class GodotSoftBody3D : public GodotCollisionObject3D {
 	RID soft_mesh;
 
-	struct Node {
-		Vector3 s; // Source position
-		Vector3 x; // Position
-		Vector3 q; // Previous step position/Test position
-		Vector3 f; // Force accumulator
-		Vector3 v; // Velocity
-		Vector3 bv; // Biased Velocity
-		Vector3 n; // Normal
-		real_t area = 0.0; // Area
-		real_t im = 0.0; // 1/mass
-		DynamicBVH::ID leaf; // Leaf data
-		uint32_t index = 0;
+	// Node state, one array per field so that the solver passes only stream through
+	// the data they use.
+	struct Nodes {
+		LocalVector<Vector3> s; // Source position
+		LocalVector<Vector3> x; // Position
+		LocalVector<Vector3> q; // Previous step position/Test position
+		LocalVector<Vector3> f; // Force accumulator
+		LocalVector<Vector3> v; // Velocity
+		LocalVector<Vector3> bv; // Biased Velocity
+		LocalVector<Vector3> n; // Normal
+		LocalVector<real_t> area; // Area
+		LocalVector<real_t> im; // 1/mass
+		LocalVector<DynamicBVH::ID> leaf; // Leaf data
+		LocalVector<uint32_t> index; // Leaf userdata
+
+		_FORCE_INLINE_ uint32_t size() const { return x.size(); }
+		_FORCE_INLINE_ bool is_empty() const { return x.is_empty(); }
+
+		void resize(uint32_t p_size);
+		void clear();
 	};
 
 	struct Link {
 		Vector3 c3; // gradient
-		Node *n[2] = { nullptr, nullptr }; // Node pointers
+		uint32_t n[2] = { 0, 0 }; // Node indices
 		real_t rl = 0.0; // Rest length
 		real_t c0 = 0.0; // (ima+imb)*kLST
 		real_t c1 = 0.0; // rl^2
@@ -71,17 +79,32 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 
 	struct Face {
 		Vector3 centroid;
-		Node *n[3] = { nullptr, nullptr, nullptr }; // Node pointers
+		uint32_t n[3] = { 0, 0, 0 }; // Node indices
 		Vector3 normal; // Normal
 		real_t ra = 0.0; // Rest area
 		DynamicBVH::ID leaf; // Leaf data
 		uint32_t index = 0;
 	};
 
-	LocalVector<Node> nodes;
+	// Link batches of at least LINK_PARALLEL_THRESHOLD links are solved in chunks on the worker pool.
+	enum {
+		LINK_CHUNK_SIZE = 256,
+		LINK_PARALLEL_THRESHOLD = 2 * LINK_CHUNK_SIZE,
+	};
+
+	Nodes nodes;
 	LocalVector<Link> links;
 	LocalVector<Face> faces;
 
+	// Links are sorted into batches that share no node (see color_links()).
+	// Start of each batch in links, followed by links.size().
+	LocalVector<uint32_t> link_batches;
+
+	// Batch being solved on the worker pool.
+	uint32_t link_solve_begin = 0;
+	uint32_t link_solve_end = 0;
+	real_t link_solve_stiffness = 0.0;
+
 	DynamicBVH node_tree;
 	DynamicBVH face_tree;
 
@@ -103,7 +126,7 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 
 	SelfList<GodotSoftBody3D> active_list;
 
-	Set<GodotConstraint3D *> constraints;
+	GodotConstraint3D::OrderedSet constraints;
 
 	Vector<AreaCMP> areas;
 
@@ -123,7 +146,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(GodotConstraint3D *p_constraint) { constraints.insert(p_constraint); }
 	_FORCE_INLINE_ void remove_constraint(GodotConstraint3D *p_constraint) { constraints.erase(p_constraint); }
-	_FORCE_INLINE_ const Set<GodotConstraint3D *> &get_constraints() const { return constraints; }
+	_FORCE_INLINE_ const GodotConstraint3D::OrderedSet &get_constraints() const { return constraints; }
 	_FORCE_INLINE_ void clear_constraints() { constraints.clear(); }
 
 	_FORCE_INLINE_ void add_exception(const RID &p_exception) { exceptions.insert(p_exception); }
@@ -204,7 +227,7 @@ public:
 	void predict_motion(real_t p_delta);
 	void solve_constraints(real_t p_delta);
 
-	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return ((Node *)p_node)->index; }
+	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return *(uint32_t *)p_node; }
 	_FORCE_INLINE_ uint32_t get_face_index(void *p_face) const { return ((Face *)p_face)->index; }
 
 	// Return true to stop the query.
@@ -214,6 +237,10 @@ public:
 	void query_aabb(const AABB &p_aabb, QueryResultCallback p_result_callback, void *p_userdata);
 	void query_ray(const Vector3 &p_from, const Vector3 &p_to, QueryResultCallback p_result_callback, void *p_userdata);
 
+	// Builds the nodes, links and faces. set_mesh() calls it with the first surface of the mesh.
+	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
+	_FORCE_INLINE_ uint32_t get_link_batch_count() const { return link_batches.is_empty() ? 0 : link_batches.size() - 1; }
+
 protected:
 	virtual void _shapes_changed();
 
@@ -229,15 +256,16 @@ private:
 
 	void add_velocity(const Vector3 &p_velocity);
 
-	void apply_forces(const LocalVector<GodotArea3D *> &p_wind_areas);
+	void apply_forces(const FrameLocalVector<GodotArea3D *> &p_wind_areas);
 
-	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 	void generate_bending_constraints(int p_distance);
-	void reoptimize_link_order();
+	void color_links();
 	void append_link(uint32_t p_node1, uint32_t p_node2);
 	void append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p_node3);
 
 	void solve_links(real_t kst, real_t ti);
+	void _solve_link_range(uint32_t p_begin, uint32_t p_end, real_t p_stiffness);
+	void _solve_link_chunk(uint32_t p_chunk, void *p_userdata);
 
 	void initialize_face_tree();
 	void update_face_tree(real_t p_delta);
@@ -34,6 +34,7 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/worker_thread_pool.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -105,17 +106,13 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+static bool _intersect_ray_candidates(const PhysicsDirectSpaceState3D::RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_objects, const int *p_subindices, int p_amount, PhysicsDirectSpaceState3D::RayResult &r_result) {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -124,22 +121,22 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject3D *res_obj;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(p_objects[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_subindices[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -200,41 +197,38 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
-int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
-	if (p_result_max <= 0) {
-		return 0;
-	}
-
-	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_COND_V(!shape, 0);
+bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
 
-	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	return _intersect_ray_candidates(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
 
+static int _intersect_shape_candidates(const PhysicsDirectSpaceState3D::ShapeParameters &p_parameters, const GodotShape3D *p_shape, const Transform3D &p_transform, GodotCollisionObject3D *const *p_objects, const int *p_subindices, int p_amount, PhysicsDirectSpaceState3D::ShapeResult *r_results, int p_result_max) {
 	int cc = 0;
 
 	//Transform3D ai = p_xform.affine_inverse();
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 		if (cc >= p_result_max) {
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
 		//area can't be picked by ray (default)
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject3D *col_obj = p_objects[i];
+		int shape_idx = p_subindices[i];
 
-		if (!GodotCollisionSolver3D::solve_static(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
+		if (!GodotCollisionSolver3D::solve_static(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
 			continue;
 		}
 
@@ -255,6 +249,154 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
+int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
+	if (p_result_max <= 0) {
+		return 0;
+	}
+
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_COND_V(!shape, 0);
+
+	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	return _intersect_shape_candidates(p_parameters, shape, p_parameters.transform, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_results, p_result_max);
+}
+
+// Sort key interleaving the bits of a point quantized within the batch bounds, so nearby queries end up next to each other.
+static uint32_t _get_batch_sort_key(const Vector3 &p_point, const AABB &p_bounds) {
+	uint32_t key = 0;
+	for (int i = 0; i < 3; i++) {
+		real_t extent = p_bounds.size[i];
+		uint32_t q = extent > 0 ? uint32_t(CLAMP((p_point[i] - p_bounds.position[i]) / extent, 0.0, 1.0) * 1023) : 0;
+		for (int b = 0; b < 10; b++) {
+			key |= ((q >> b) & 1) << (b * 3 + i);
+		}
+	}
+	return key;
+}
+
+void GodotPhysicsDirectSpaceState3D::_sort_batch(const Vector3 *p_points, int p_stride, int p_count, LocalVector<uint32_t> &r_order) {
+	AABB bounds(p_points[0], Vector3());
+	for (int i = 1; i < p_count; i++) {
+		bounds.expand_to(p_points[i * p_stride]);
+	}
+
+	LocalVector<BatchSortItem> items;
+	items.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		items[i].key = _get_batch_sort_key(p_points[i * p_stride], bounds);
+		items[i].index = i;
+	}
+	items.sort();
+
+	r_order.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		r_order[i] = items[i].index;
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_rays_thread(uint32_t p_index, RayBatch *p_batch) {
+	uint32_t ray = p_batch->order[p_batch->first + p_index];
+	uint32_t offset = p_batch->offsets[p_index];
+	uint32_t amount = p_batch->offsets[p_index + 1] - offset;
+
+	RayResult &result = p_batch->results[ray];
+	result = RayResult();
+	_intersect_ray_candidates(*p_batch->parameters, p_batch->segments[ray * 2 + 0], p_batch->segments[ray * 2 + 1], p_batch->objects.ptr() + offset, p_batch->subindices.ptr() + offset, amount, result);
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_segments, int p_ray_count, RayResult *r_results) {
+	ERR_FAIL_COND(space->locked);
+	if (p_ray_count <= 0) {
+		return;
+	}
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.segments = p_segments;
+	batch.results = r_results;
+	_sort_batch(p_segments, 2, p_ray_count, batch.order);
+
+	// The broadphase uses shared scratch buffers, so candidates are culled on this thread
+	// and only the narrow phase of each ray runs on the worker threads.
+	for (batch.first = 0; batch.first < (uint32_t)p_ray_count; batch.first += BATCH_SIZE) {
+		uint32_t count = MIN((uint32_t)BATCH_SIZE, p_ray_count - batch.first);
+		batch.clear_candidates();
+		for (uint32_t i = 0; i < count; i++) {
+			uint32_t ray = batch.order[batch.first + i];
+			int amount = space->broadphase->cull_segment(p_segments[ray * 2 + 0], p_segments[ray * 2 + 1], space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+			batch.add_candidates(space->intersection_query_results, space->intersection_query_subindex_results, amount);
+		}
+
+		if (count < BATCH_THREADING_THRESHOLD) {
+			for (uint32_t i = 0; i < count; i++) {
+				_intersect_rays_thread(i, &batch);
+			}
+		} else {
+			WorkerThreadPool::get_singleton()->do_work(count, this, &GodotPhysicsDirectSpaceState3D::_intersect_rays_thread, &batch);
+		}
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_shapes_thread(uint32_t p_index, ShapeBatch *p_batch) {
+	uint32_t query = p_batch->order[p_batch->first + p_index];
+	uint32_t offset = p_batch->offsets[p_index];
+	uint32_t amount = p_batch->offsets[p_index + 1] - offset;
+
+	p_batch->result_counts[query] = _intersect_shape_candidates(*p_batch->parameters, p_batch->shape, p_batch->transforms[query], p_batch->objects.ptr() + offset, p_batch->subindices.ptr() + offset, amount, p_batch->results + query * p_batch->result_max, p_batch->result_max);
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_query_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	// Queries that fail validation report no results.
+	for (int i = 0; i < p_query_count; i++) {
+		r_result_counts[i] = 0;
+	}
+	ERR_FAIL_COND(space->locked);
+	if (p_query_count <= 0 || p_result_max <= 0) {
+		return;
+	}
+
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_COND(!shape);
+
+	ShapeBatch batch;
+	batch.parameters = &p_parameters;
+	batch.shape = shape;
+	batch.transforms = p_transforms;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+
+	LocalVector<Vector3> origins;
+	origins.resize(p_query_count);
+	for (int i = 0; i < p_query_count; i++) {
+		origins[i] = p_transforms[i].origin;
+	}
+	_sort_batch(origins.ptr(), 1, p_query_count, batch.order);
+
+	// Same split as intersect_rays(): cull here, solve on the worker threads.
+	AABB shape_aabb = shape->get_aabb();
+	for (batch.first = 0; batch.first < (uint32_t)p_query_count; batch.first += BATCH_SIZE) {
+		uint32_t count = MIN((uint32_t)BATCH_SIZE, p_query_count - batch.first);
+		batch.clear_candidates();
+		for (uint32_t i = 0; i < count; i++) {
+			uint32_t query = batch.order[batch.first + i];
+			int amount = space->broadphase->cull_aabb(p_transforms[query].xform(shape_aabb), space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+			batch.add_candidates(space->intersection_query_results, space->intersection_query_subindex_results, amount);
+		}
+
+		if (count < BATCH_THREADING_THRESHOLD) {
+			for (uint32_t i = 0; i < count; i++) {
+				_intersect_shapes_thread(i, &batch);
+			}
+		} else {
+			WorkerThreadPool::get_singleton()->do_work(count, this, &GodotPhysicsDirectSpaceState3D::_intersect_shapes_thread, &batch);
+		}
+	}
+}
+
 bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
 	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
 	ERR_FAIL_COND_V(!shape, false);
@@ -1042,6 +1184,7 @@ void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A
 			return soft_pair;
 		} else {
 			GodotBodyPair3D *b = memnew(GodotBodyPair3D((GodotBody3D *)A, p_subindex_A, (GodotBody3D *)B, p_subindex_B));
+			self->_restore_pending_contact_cache(b);
 			return b;
 		}
 	} else {
@@ -1082,6 +1225,14 @@ void GodotSpace3D::body_remove_from_mass_properties_update_list(SelfList<GodotBo
 	mass_properties_update_list.remove(p_body);
 }
 
+void GodotSpace3D::body_add_to_sleep_state_update_list(SelfList<GodotBody3D> *p_body) {
+	sleep_state_update_list.add(p_body);
+}
+
+void GodotSpace3D::body_remove_from_sleep_state_update_list(SelfList<GodotBody3D> *p_body) {
+	sleep_state_update_list.remove(p_body);
+}
+
 GodotBroadPhase3D *GodotSpace3D::get_broadphase() {
 	return broadphase;
 }
@@ -1100,6 +1251,262 @@ const Set<GodotCollisionObject3D *> &GodotSpace3D::get_objects() const {
 	return objects;
 }
 
+static _FORCE_INLINE_ uint64_t _hash_vector3(const Vector3 &p_vector, uint64_t p_hash) {
+	p_hash = hash_djb2_one_float_64(p_vector.x, p_hash);
+	p_hash = hash_djb2_one_float_64(p_vector.y, p_hash);
+	return hash_djb2_one_float_64(p_vector.z, p_hash);
+}
+
+static _FORCE_INLINE_ uint64_t _hash_transform(const Transform3D &p_transform, uint64_t p_hash) {
+	for (int i = 0; i < 3; i++) {
+		p_hash = _hash_vector3(p_transform.basis.elements[i], p_hash);
+	}
+	return _hash_vector3(p_transform.origin, p_hash);
+}
+
+uint64_t GodotSpace3D::get_state_hash() const {
+	// Objects are hashed in RID order rather than by address. RID ids themselves differ
+	// between processes and are only used for ordering.
+	LocalVector<const GodotCollisionObject3D *> sorted_objects;
+	sorted_objects.reserve(objects.size());
+	for (const Set<GodotCollisionObject3D *>::Element *E = objects.front(); E; E = E->next()) {
+		sorted_objects.push_back(E->get());
+	}
+
+	struct RIDOrder {
+		_FORCE_INLINE_ bool operator()(const GodotCollisionObject3D *p_a, const GodotCollisionObject3D *p_b) const {
+			return p_a->get_self().get_id() < p_b->get_self().get_id();
+		}
+	};
+	sorted_objects.sort_custom<RIDOrder>();
+
+	uint64_t hash = hash_djb2_one_64(sorted_objects.size());
+	for (uint32_t i = 0; i < sorted_objects.size(); i++) {
+		const GodotCollisionObject3D *object = sorted_objects[i];
+		hash = hash_djb2_one_64(object->get_type(), hash);
+		hash = _hash_transform(object->get_transform(), hash);
+
+		switch (object->get_type()) {
+			case GodotCollisionObject3D::TYPE_BODY: {
+				const GodotBody3D *body = static_cast<const GodotBody3D *>(object);
+				hash = hash_djb2_one_64(body->get_mode(), hash);
+				hash = hash_djb2_one_64(body->is_active(), hash);
+				hash = _hash_vector3(body->get_linear_velocity(), hash);
+				hash = _hash_vector3(body->get_angular_velocity(), hash);
+			} break;
+			case GodotCollisionObject3D::TYPE_SOFT_BODY: {
+				const GodotSoftBody3D *soft_body = static_cast<const GodotSoftBody3D *>(object);
+				uint32_t node_count = soft_body->get_node_count();
+				hash = hash_djb2_one_64(node_count, hash);
+				for (uint32_t node_index = 0; node_index < node_count; node_index++) {
+					hash = _hash_vector3(soft_body->get_node_position(node_index), hash);
+					hash = _hash_vector3(soft_body->get_node_velocity(node_index), hash);
+				}
+			} break;
+			case GodotCollisionObject3D::TYPE_AREA: {
+			} break;
+		}
+	}
+	return hash;
+}
+
+// Snapshots are plain copies of the engine structures. They are meant to be restored
+// in the same process, and aren't portable between builds.
+struct SpaceSnapshotHeader3D {
+	uint32_t version = 0;
+	uint32_t body_count = 0;
+	uint32_t contact_cache_count = 0;
+};
+
+struct SpaceSnapshotBody3D {
+	uint64_t id = 0;
+	GodotBody3D::StateSnapshot state;
+};
+
+struct SpaceSnapshotContactCache3D {
+	GodotConstraint3D::ContactCacheKey key;
+	uint32_t size = 0; // Followed by the cache itself.
+};
+
+void GodotSpace3D::_get_bodies_in_rid_order(LocalVector<GodotBody3D *> &r_bodies) const {
+	r_bodies.clear();
+	for (const Set<GodotCollisionObject3D *>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+			r_bodies.push_back(static_cast<GodotBody3D *>(E->get()));
+		}
+	}
+
+	struct RIDOrder {
+		_FORCE_INLINE_ bool operator()(const GodotBody3D *p_a, const GodotBody3D *p_b) const {
+			return p_a->get_self().get_id() < p_b->get_self().get_id();
+		}
+	};
+	r_bodies.sort_custom<RIDOrder>();
+}
+
+void GodotSpace3D::save_snapshot(Vector<uint8_t> &r_snapshot) const {
+	LocalVector<GodotBody3D *> bodies;
+	_get_bodies_in_rid_order(bodies);
+
+	// Pairs are saved once, from their first body.
+	LocalVector<const GodotConstraint3D *> contact_constraints;
+	uint32_t contact_caches_size = 0;
+	for (uint32_t body_index = 0; body_index < bodies.size(); body_index++) {
+		const GodotConstraint3D::OrderedMap<int> &constraint_map = bodies[body_index]->get_constraint_map();
+		for (const GodotConstraint3D::OrderedMap<int>::Element *E = constraint_map.front(); E; E = E->next()) {
+			const GodotConstraint3D *constraint = E->key();
+			uint32_t cache_size = constraint->get_contact_cache_size();
+			if (cache_size == 0 || E->get() != 0) {
+				continue;
+			}
+			contact_constraints.push_back(constraint);
+			contact_caches_size += sizeof(SpaceSnapshotContactCache3D) + cache_size;
+		}
+	}
+	// Caches still waiting for their pair are carried over, in case it comes back after this snapshot is restored.
+	for (const GodotConstraint3D::ContactCacheKey *K = pending_contact_caches.next(nullptr); K; K = pending_contact_caches.next(K)) {
+		contact_caches_size += sizeof(SpaceSnapshotContactCache3D) + pending_contact_caches[*K].size();
+	}
+
+	r_snapshot.resize(sizeof(SpaceSnapshotHeader3D) + bodies.size() * sizeof(SpaceSnapshotBody3D) + contact_caches_size);
+	uint8_t *w = r_snapshot.ptrw();
+
+	SpaceSnapshotHeader3D header;
+	header.version = SNAPSHOT_VERSION;
+	header.body_count = bodies.size();
+	header.contact_cache_count = contact_constraints.size() + pending_contact_caches.size();
+	memcpy(w, &header, sizeof(SpaceSnapshotHeader3D));
+	w += sizeof(SpaceSnapshotHeader3D);
+
+	for (uint32_t body_index = 0; body_index < bodies.size(); body_index++) {
+		SpaceSnapshotBody3D body_snapshot;
+		body_snapshot.id = bodies[body_index]->get_self().get_id();
+		bodies[body_index]->save_state_snapshot(body_snapshot.state);
+		memcpy(w, &body_snapshot, sizeof(SpaceSnapshotBody3D));
+		w += sizeof(SpaceSnapshotBody3D);
+	}
+
+	for (uint32_t constraint_index = 0; constraint_index < contact_constraints.size(); constraint_index++) {
+		const GodotConstraint3D *constraint = contact_constraints[constraint_index];
+		SpaceSnapshotContactCache3D cache_header;
+		cache_header.key = constraint->get_contact_cache_key();
+		cache_header.size = constraint->get_contact_cache_size();
+		memcpy(w, &cache_header, sizeof(SpaceSnapshotContactCache3D));
+		w += sizeof(SpaceSnapshotContactCache3D);
+		constraint->save_contact_cache(w);
+		w += cache_header.size;
+	}
+
+	for (const GodotConstraint3D::ContactCacheKey *K = pending_contact_caches.next(nullptr); K; K = pending_contact_caches.next(K)) {
+		const Vector<uint8_t> &cache = pending_contact_caches[*K];
+		SpaceSnapshotContactCache3D cache_header;
+		cache_header.key = *K;
+		cache_header.size = cache.size();
+		memcpy(w, &cache_header, sizeof(SpaceSnapshotContactCache3D));
+		w += sizeof(SpaceSnapshotContactCache3D);
+		memcpy(w, cache.ptr(), cache_header.size);
+		w += cache_header.size;
+	}
+}
+
+bool GodotSpace3D::restore_snapshot(const Vector<uint8_t> &p_snapshot) {
+	const uint8_t *r = p_snapshot.ptr();
+	const uint8_t *r_end = r + p_snapshot.size();
+
+	ERR_FAIL_COND_V_MSG(p_snapshot.size() < (int)sizeof(SpaceSnapshotHeader3D), false, "Invalid physics space snapshot.");
+	SpaceSnapshotHeader3D header;
+	memcpy(&header, r, sizeof(SpaceSnapshotHeader3D));
+	r += sizeof(SpaceSnapshotHeader3D);
+	ERR_FAIL_COND_V_MSG(header.version != SNAPSHOT_VERSION, false, "Invalid physics space snapshot.");
+	ERR_FAIL_COND_V_MSG((uint64_t)(r_end - r) < (uint64_t)header.body_count * sizeof(SpaceSnapshotBody3D), false, "Invalid physics space snapshot.");
+
+	// Validate the contact caches before changing anything.
+	struct ContactCacheData {
+		const uint8_t *data = nullptr;
+		uint32_t size = 0;
+		bool restored = false;
+	};
+	HashMap<GodotConstraint3D::ContactCacheKey, ContactCacheData, GodotConstraint3D::ContactCacheKey> contact_caches;
+	const uint8_t *c = r + header.body_count * sizeof(SpaceSnapshotBody3D);
+	for (uint32_t cache_index = 0; cache_index < header.contact_cache_count; cache_index++) {
+		ERR_FAIL_COND_V_MSG(r_end - c < (int64_t)sizeof(SpaceSnapshotContactCache3D), false, "Invalid physics space snapshot.");
+		SpaceSnapshotContactCache3D cache_header;
+		memcpy(&cache_header, c, sizeof(SpaceSnapshotContactCache3D));
+		c += sizeof(SpaceSnapshotContactCache3D);
+		ERR_FAIL_COND_V_MSG((uint64_t)(r_end - c) < cache_header.size, false, "Invalid physics space snapshot.");
+		ContactCacheData cache_data;
+		cache_data.data = c;
+		cache_data.size = cache_header.size;
+		contact_caches.set(cache_header.key, cache_data);
+		c += cache_header.size;
+	}
+
+	// Both lists are in RID order, bodies created or freed since the snapshot are skipped.
+	LocalVector<GodotBody3D *> bodies;
+	_get_bodies_in_rid_order(bodies);
+
+	uint32_t body_index = 0;
+	for (uint32_t snapshot_index = 0; snapshot_index < header.body_count; snapshot_index++) {
+		SpaceSnapshotBody3D body_snapshot;
+		memcpy(&body_snapshot, r, sizeof(SpaceSnapshotBody3D));
+		r += sizeof(SpaceSnapshotBody3D);
+
+		while (body_index < bodies.size() && bodies[body_index]->get_self().get_id() < body_snapshot.id) {
+			body_index++;
+		}
+		if (body_index < bodies.size() && bodies[body_index]->get_self().get_id() == body_snapshot.id) {
+			bodies[body_index]->restore_state_snapshot(body_snapshot.state);
+			body_index++;
+		}
+	}
+
+	// Pairs that didn't exist when the snapshot was taken start without contacts.
+	for (body_index = 0; body_index < bodies.size(); body_index++) {
+		const GodotConstraint3D::OrderedMap<int> &constraint_map = bodies[body_index]->get_constraint_map();
+		for (const GodotConstraint3D::OrderedMap<int>::Element *E = constraint_map.front(); E; E = E->next()) {
+			GodotConstraint3D *constraint = E->key();
+			if (constraint->get_contact_cache_size() == 0 || E->get() != 0) {
+				continue;
+			}
+			ContactCacheData *cache_data = contact_caches.getptr(constraint->get_contact_cache_key());
+			bool valid = cache_data && cache_data->size == constraint->get_contact_cache_size();
+			constraint->restore_contact_cache(valid ? cache_data->data : nullptr);
+			if (valid) {
+				cache_data->restored = true;
+			}
+		}
+	}
+
+	// Pairs that were removed since are created again by the broadphase in the next step,
+	// and get their contacts back then.
+	pending_contact_caches.clear();
+	for (const GodotConstraint3D::ContactCacheKey *K = contact_caches.next(nullptr); K; K = contact_caches.next(K)) {
+		const ContactCacheData &cache_data = contact_caches[*K];
+		if (cache_data.restored) {
+			continue;
+		}
+		Vector<uint8_t> cache;
+		cache.resize(cache_data.size);
+		memcpy(cache.ptrw(), cache_data.data, cache_data.size);
+		pending_contact_caches.set(*K, cache);
+	}
+
+	return true;
+}
+
+void GodotSpace3D::_restore_pending_contact_cache(GodotConstraint3D *p_constraint) {
+	if (pending_contact_caches.is_empty()) {
+		return;
+	}
+
+	GodotConstraint3D::ContactCacheKey key = p_constraint->get_contact_cache_key();
+	const Vector<uint8_t> *cache = pending_contact_caches.getptr(key);
+	if (cache && (uint32_t)cache->size() == p_constraint->get_contact_cache_size()) {
+		p_constraint->restore_contact_cache(cache->ptr());
+		pending_contact_caches.erase(key);
+	}
+}
+
 void GodotSpace3D::body_add_to_state_query_list(SelfList<GodotBody3D> *p_body) {
 	state_query_list.add(p_body);
 }
@@ -1163,7 +1570,19 @@ void GodotSpace3D::setup() {
 }
 
 void GodotSpace3D::update() {
+	while (sleep_state_update_list.first()) {
+		sleep_state_update_list.first()->self()->update_sleep_state();
+		sleep_state_update_list.remove(sleep_state_update_list.first());
+	}
+
 	broadphase->update();
+
+	// Pairs of the last restored snapshot that weren't created again by now are gone.
+	pending_contact_caches.clear();
+
+	uint64_t pair_test_total = broadphase->get_pair_test_count();
+	broadphase_pair_tests = pair_test_total - broadphase_pair_test_total;
+	broadphase_pair_test_total = pair_test_total;
 }
 
 void GodotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value) {
@@ -1192,6 +1611,9 @@ void GodotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_v
 		case PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS:
 			solver_iterations = p_value;
 			break;
+		case PhysicsServer3D::SPACE_PARAM_SOLVER_RESIDUAL_THRESHOLD:
+			solver_residual_threshold = p_value;
+			break;
 	}
 }
 
@@ -1213,6 +1635,8 @@ real_t GodotSpace3D::get_param(PhysicsServer3D::SpaceParameter p_param) const {
 			return body_time_to_sleep;
 		case PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS:
 			return solver_iterations;
+		case PhysicsServer3D::SPACE_PARAM_SOLVER_RESIDUAL_THRESHOLD:
+			return solver_residual_threshold;
 	}
 	return 0;
 }
@@ -1242,6 +1666,9 @@ GodotSpace3D::GodotSpace3D() {
 	solver_iterations = GLOBAL_DEF("physics/3d/solver/solver_iterations", 16);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/solver/solver_iterations", PropertyInfo(Variant::INT, "physics/3d/solver/solver_iterations", PROPERTY_HINT_RANGE, "1,32,1,or_greater"));
 
+	solver_residual_threshold = GLOBAL_DEF("physics/3d/solver/residual_threshold", 0.0);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/solver/residual_threshold", PropertyInfo(Variant::FLOAT, "physics/3d/solver/residual_threshold", PROPERTY_HINT_RANGE, "0,0.1,0.0001,or_greater"));
+
 	contact_recycle_radius = GLOBAL_DEF("physics/3d/solver/contact_recycle_radius", 0.01);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/solver/contact_recycle_radius", PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,0.1,0.01,or_greater"));
 
@@ -41,17 +41,77 @@
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/typedefs.h"
 
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	enum {
+		BATCH_SIZE = 1024,
+		BATCH_THREADING_THRESHOLD = 32,
+	};
+
+	struct BatchSortItem {
+		uint32_t key = 0;
+		uint32_t index = 0;
+
+		bool operator<(const BatchSortItem &p_other) const { return key < p_other.key; }
+	};
+
+	// Batched queries in coherent order, and the broadphase candidates of the slice
+	// [first, first + BATCH_SIZE) being solved. Candidates of query first + i are in
+	// [offsets[i], offsets[i + 1]).
+	struct QueryBatch {
+		LocalVector<uint32_t> order;
+		uint32_t first = 0;
+		LocalVector<GodotCollisionObject3D *> objects;
+		LocalVector<int> subindices;
+		LocalVector<uint32_t> offsets;
+
+		void clear_candidates() {
+			objects.clear();
+			subindices.clear();
+			offsets.clear();
+			offsets.push_back(0);
+		}
+
+		void add_candidates(GodotCollisionObject3D *const *p_objects, const int *p_subindices, int p_amount) {
+			for (int i = 0; i < p_amount; i++) {
+				objects.push_back(p_objects[i]);
+				subindices.push_back(p_subindices[i]);
+			}
+			offsets.push_back(objects.size());
+		}
+	};
+
+	struct RayBatch : public QueryBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector3 *segments = nullptr;
+		RayResult *results = nullptr;
+	};
+
+	struct ShapeBatch : public QueryBatch {
+		const ShapeParameters *parameters = nullptr;
+		const GodotShape3D *shape = nullptr;
+		const Transform3D *transforms = nullptr;
+		ShapeResult *results = nullptr;
+		int result_max = 0;
+		int *result_counts = nullptr;
+	};
+
+	static void _sort_batch(const Vector3 *p_points, int p_stride, int p_count, LocalVector<uint32_t> &r_order);
+	void _intersect_rays_thread(uint32_t p_index, RayBatch *p_batch);
+	void _intersect_shapes_thread(uint32_t p_index, ShapeBatch *p_batch);
+
 public:
 	GodotSpace3D *space;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector3 *p_segments, int p_ray_count, RayResult *r_results) override;
+	virtual void intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_query_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
@@ -64,6 +124,7 @@ class GodotSpace3D {
 public:
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
+		ELAPSED_TIME_BROADPHASE,
 		ELAPSED_TIME_GENERATE_ISLANDS,
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
@@ -82,6 +143,7 @@ private:
 	SelfList<GodotBody3D>::List active_list;
 	SelfList<GodotBody3D>::List mass_properties_update_list;
 	SelfList<GodotBody3D>::List state_query_list;
+	SelfList<GodotBody3D>::List sleep_state_update_list;
 	SelfList<GodotArea3D>::List monitor_query_list;
 	SelfList<GodotArea3D>::List area_moved_list;
 	SelfList<GodotSoftBody3D>::List active_soft_body_list;
@@ -94,12 +156,26 @@ private:
 	GodotArea3D *area = nullptr;
 
 	int solver_iterations = 0;
+	real_t solver_residual_threshold = 0.0;
 
 	real_t contact_recycle_radius = 0.0;
 	real_t contact_max_separation = 0.0;
 	real_t contact_max_allowed_penetration = 0.0;
 	real_t contact_bias = 0.0;
 
+	bool deterministic = false;
+
+	enum {
+		SNAPSHOT_VERSION = 1
+	};
+
+	void _get_bodies_in_rid_order(LocalVector<GodotBody3D *> &r_bodies) const;
+
+	// Contact caches of the last restored snapshot whose pair didn't exist at the time. They
+	// are handed to the pair if the broadphase creates it again in the next step.
+	HashMap<GodotConstraint3D::ContactCacheKey, Vector<uint8_t>, GodotConstraint3D::ContactCacheKey> pending_contact_caches;
+	void _restore_pending_contact_cache(GodotConstraint3D *p_constraint);
+
 	enum {
 		INTERSECTION_QUERY_MAX = 2048
 	};
@@ -118,6 +194,8 @@ private:
 	int island_count = 0;
 	int active_objects = 0;
 	int collision_pairs = 0;
+	int broadphase_pair_tests = 0;
+	uint64_t broadphase_pair_test_total = 0;
 
 	RID static_global_body;
 
@@ -144,6 +222,9 @@ public:
 	void body_add_to_state_query_list(SelfList<GodotBody3D> *p_body);
 	void body_remove_from_state_query_list(SelfList<GodotBody3D> *p_body);
 
+	void body_add_to_sleep_state_update_list(SelfList<GodotBody3D> *p_body);
+	void body_remove_from_sleep_state_update_list(SelfList<GodotBody3D> *p_body);
+
 	void area_add_to_monitor_query_list(SelfList<GodotArea3D> *p_area);
 	void area_remove_from_monitor_query_list(SelfList<GodotArea3D> *p_area);
 	void area_add_to_moved_list(SelfList<GodotArea3D> *p_area);
@@ -159,8 +240,12 @@ public:
 	void add_object(GodotCollisionObject3D *p_object);
 	void remove_object(GodotCollisionObject3D *p_object);
 	const Set<GodotCollisionObject3D *> &get_objects() const;
+	uint64_t get_state_hash() const;
+	void save_snapshot(Vector<uint8_t> &r_snapshot) const;
+	bool restore_snapshot(const Vector<uint8_t> &p_snapshot);
 
 	_FORCE_INLINE_ int get_solver_iterations() const { return solver_iterations; }
+	_FORCE_INLINE_ real_t get_solver_residual_threshold() const { return solver_residual_threshold; }
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
@@ -183,6 +268,9 @@ public:
 	void set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value);
 	real_t get_param(PhysicsServer3D::SpaceParameter p_param) const;
 
+	void set_deterministic(bool p_deterministic) { deterministic = p_deterministic; }
+	bool is_deterministic() const { return deterministic; }
+
 	void set_island_count(int p_island_count) { island_count = p_island_count; }
 	int get_island_count() const { return island_count; }
 
@@ -190,6 +278,7 @@ public:
 	int get_active_objects() const { return active_objects; }
 
 	int get_collision_pairs() const { return collision_pairs; }
+	int get_broadphase_pair_tests() const { return broadphase_pair_tests; }
 
 	GodotPhysicsDirectSpaceState3D *get_direct_state();
 
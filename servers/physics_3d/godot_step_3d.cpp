@@ -33,6 +33,7 @@
 #include "godot_joint_3d.h"
 
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 
 #define BODY_ISLAND_COUNT_RESERVE 128
 #define BODY_ISLAND_SIZE_RESERVE 512
@@ -40,6 +41,27 @@
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
+struct CreationOrder {
+	_FORCE_INLINE_ bool operator()(const GodotCollisionObject3D *p_a, const GodotCollisionObject3D *p_b) const {
+		return p_a->get_self().get_id() < p_b->get_self().get_id();
+	}
+};
+
+// Active lists are in wake up order, which depends on the history of the space
+// and not only on its state. Bodies are only woken on the main thread: the area
+// and soft body pairs that wake them are pre-solved serially.
+// Deterministic spaces go through the lists in RID (creation) order instead.
+template <class T>
+static void _get_active_objects(const typename SelfList<T>::List &p_list, bool p_deterministic, LocalVector<T *> &r_objects) {
+	r_objects.clear();
+	for (const SelfList<T> *E = p_list.first(); E; E = E->next()) {
+		r_objects.push_back(E->self());
+	}
+	if (p_deterministic) {
+		r_objects.template sort_custom<CreationOrder>();
+	}
+}
+
 void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
 
@@ -87,7 +109,7 @@ void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D
 void GodotStep3D::_populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_soft_body->set_island_step(_step);
 
-	for (Set<GodotConstraint3D *>::Element *E = p_soft_body->get_constraints().front(); E; E = E->next()) {
+	for (GodotConstraint3D::OrderedSet::Element *E = p_soft_body->get_constraints().front(); E; E = E->next()) {
 		GodotConstraint3D *constraint = (GodotConstraint3D *)E->get();
 		if (constraint->get_island_step() == _step) {
 			continue; // Already processed.
@@ -116,13 +138,34 @@ void GodotStep3D::_setup_contraint(uint32_t p_constraint_index, void *p_userdata
 	constraint->setup(delta);
 }
 
-void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const {
+void GodotStep3D::_pre_solve_island(uint32_t p_island_index, void *p_userdata) {
+	LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[p_island_index];
+
+	uint32_t constraint_count = constraint_island.size();
+	uint32_t valid_constraint_count = 0;
+	bool has_serial_constraints = false;
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		GodotConstraint3D *constraint = constraint_island[constraint_index];
+		if (!constraint->is_pre_solve_thread_safe()) {
+			// Keep it in place, it's pre-solved by _pre_solve_island_serial.
+			constraint_island[valid_constraint_count++] = constraint;
+			has_serial_constraints = true;
+		} else if (constraint->pre_solve(delta)) {
+			// Keep this constraint for solving.
+			constraint_island[valid_constraint_count++] = constraint;
+		}
+	}
+	constraint_island.resize(valid_constraint_count);
+	serial_islands[p_island_index] = has_serial_constraints;
+}
+
+void GodotStep3D::_pre_solve_island_serial(LocalVector<GodotConstraint3D *> &p_constraint_island) const {
 	uint32_t constraint_count = p_constraint_island.size();
 	uint32_t valid_constraint_count = 0;
 	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
 		GodotConstraint3D *constraint = p_constraint_island[constraint_index];
-		if (p_constraint_island[constraint_index]->pre_solve(delta)) {
-			// Keep this constraint for solving.
+		if (constraint->is_pre_solve_thread_safe() || constraint->pre_solve(delta)) {
+			// Already pre-solved on threads, or kept for solving.
 			p_constraint_island[valid_constraint_count++] = constraint;
 		}
 	}
@@ -137,9 +180,18 @@ void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	uint32_t constraint_count = constraint_island.size();
 	while (constraint_count > 0) {
 		for (int i = 0; i < iterations; i++) {
-			// Go through all iterations.
+			// Go through all iterations, unless the island already converged.
+			bool converged = residual_threshold > 0.0;
 			for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
-				constraint_island[constraint_index]->solve(delta);
+				GodotConstraint3D *constraint = constraint_island[constraint_index];
+				constraint->solve(delta);
+				if (converged) {
+					real_t residual = constraint->get_solve_residual();
+					converged = residual >= 0.0 && residual < residual_threshold;
+				}
+			}
+			if (converged) {
+				break;
 			}
 		}
 
@@ -189,43 +241,47 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	p_space->set_last_step(p_delta);
 
 	iterations = p_space->get_solver_iterations();
+	residual_threshold = p_space->get_solver_residual_threshold();
 	delta = p_delta;
 
-	const SelfList<GodotBody3D>::List *body_list = &p_space->get_active_body_list();
+	const SelfList<GodotBody3D>::List &body_list = p_space->get_active_body_list();
+
+	const SelfList<GodotSoftBody3D>::List &soft_body_list = p_space->get_active_soft_body_list();
 
-	const SelfList<GodotSoftBody3D>::List *soft_body_list = &p_space->get_active_soft_body_list();
+	const bool deterministic = p_space->is_deterministic();
 
 	/* INTEGRATE FORCES */
 
 	uint64_t profile_begtime = OS::get_singleton()->get_ticks_usec();
 	uint64_t profile_endtime = 0;
 
-	int active_count = 0;
-
-	const SelfList<GodotBody3D> *b = body_list->first();
-	while (b) {
-		b->self()->integrate_forces(p_delta);
-		b = b->next();
-		active_count++;
+	_get_active_objects(body_list, deterministic, active_bodies);
+	for (uint32_t body_index = 0; body_index < active_bodies.size(); ++body_index) {
+		active_bodies[body_index]->integrate_forces(p_delta);
 	}
 
 	/* UPDATE SOFT BODY MOTION */
 
-	const SelfList<GodotSoftBody3D> *sb = soft_body_list->first();
-	while (sb) {
-		sb->self()->predict_motion(p_delta);
-		sb = sb->next();
-		active_count++;
+	_get_active_objects(soft_body_list, deterministic, active_soft_bodies);
+	for (uint32_t soft_body_index = 0; soft_body_index < active_soft_bodies.size(); ++soft_body_index) {
+		active_soft_bodies[soft_body_index]->predict_motion(p_delta);
 	}
 
+	int active_count = active_bodies.size() + active_soft_bodies.size();
 	p_space->set_active_objects(active_count);
 
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
+		profile_begtime = profile_endtime;
+	}
+
 	// Update the broadphase to register collision pairs.
 	p_space->update();
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
-		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_BROADPHASE, profile_endtime - profile_begtime);
 		profile_begtime = profile_endtime;
 	}
 
@@ -236,7 +292,7 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	const SelfList<GodotArea3D>::List &aml = p_space->get_moved_area_list();
 
 	while (aml.first()) {
-		for (const Set<GodotConstraint3D *>::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
+		for (const GodotConstraint3D::OrderedSet::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
 			GodotConstraint3D *constraint = E->get();
 			if (constraint->get_island_step() == _step) {
 				continue;
@@ -259,12 +315,12 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
 
-	b = body_list->first();
+	_get_active_objects(body_list, deterministic, active_bodies);
 
 	uint32_t body_island_count = 0;
 
-	while (b) {
-		GodotBody3D *body = b->self();
+	for (uint32_t body_index = 0; body_index < active_bodies.size(); ++body_index) {
+		GodotBody3D *body = active_bodies[body_index];
 
 		if (body->get_island_step() != _step) {
 			++body_island_count;
@@ -293,14 +349,14 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 				--island_count;
 			}
 		}
-		b = b->next();
 	}
 
 	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE SOFT BODIES */
 
-	sb = soft_body_list->first();
-	while (sb) {
-		GodotSoftBody3D *soft_body = sb->self();
+	_get_active_objects(soft_body_list, deterministic, active_soft_bodies);
+
+	for (uint32_t soft_body_index = 0; soft_body_index < active_soft_bodies.size(); ++soft_body_index) {
+		GodotSoftBody3D *soft_body = active_soft_bodies[soft_body_index];
 
 		if (soft_body->get_island_step() != _step) {
 			++body_island_count;
@@ -329,7 +385,6 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 				--island_count;
 			}
 		}
-		sb = sb->next();
 	}
 
 	p_space->set_island_count((int)island_count);
@@ -343,7 +398,7 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
 	uint32_t total_contraint_count = all_constraints.size();
-	work_pool.do_work(total_contraint_count, this, &GodotStep3D::_setup_contraint, nullptr);
+	WorkerThreadPool::get_singleton()->do_work(total_contraint_count, this, &GodotStep3D::_setup_contraint, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -353,16 +408,21 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* PRE-SOLVE CONSTRAINT ISLANDS */
 
-	// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
+	// Constraints that aren't thread safe are skipped here and pre-solved serially afterwards.
+	serial_islands.resize(island_count);
+	WorkerThreadPool::get_singleton()->do_work(island_count, this, &GodotStep3D::_pre_solve_island, nullptr);
+
 	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
-		_pre_solve_island(constraint_islands[island_index]);
+		if (serial_islands[island_index]) {
+			_pre_solve_island_serial(constraint_islands[island_index]);
+		}
 	}
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
-	work_pool.do_work(island_count, this, &GodotStep3D::_solve_island, nullptr);
+	WorkerThreadPool::get_singleton()->do_work(island_count, this, &GodotStep3D::_solve_island, nullptr);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -372,11 +432,10 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* INTEGRATE VELOCITIES */
 
-	b = body_list->first();
-	while (b) {
-		const SelfList<GodotBody3D> *n = b->next();
-		b->self()->integrate_velocities(p_delta);
-		b = n;
+	// Islands can wake up bodies, they start integrating this step.
+	_get_active_objects(body_list, deterministic, active_bodies);
+	for (uint32_t body_index = 0; body_index < active_bodies.size(); ++body_index) {
+		active_bodies[body_index]->integrate_velocities(p_delta);
 	}
 
 	/* SLEEP / WAKE UP ISLANDS */
@@ -387,10 +446,9 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* UPDATE SOFT BODY CONSTRAINTS */
 
-	sb = soft_body_list->first();
-	while (sb) {
-		sb->self()->solve_constraints(p_delta);
-		sb = sb->next();
+	_get_active_objects(soft_body_list, deterministic, active_soft_bodies);
+	for (uint32_t soft_body_index = 0; soft_body_index < active_soft_bodies.size(); ++soft_body_index) {
+		active_soft_bodies[soft_body_index]->solve_constraints(p_delta);
 	}
 
 	{ //profile
@@ -409,10 +467,4 @@ GodotStep3D::GodotStep3D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
-
-	work_pool.init();
-}
-
-GodotStep3D::~GodotStep3D() {
-	work_pool.finish();
 }
@@ -380,6 +380,82 @@ Array PhysicsDirectSpaceState2D::_intersect_shape(const Ref<PhysicsShapeQueryPar
 	return ret;
 }
 
+Dictionary PhysicsDirectSpaceState2D::_intersect_rays(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_segments) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_segments.size() % 2, Dictionary(), "Segments must be pairs of from and to points.");
+
+	int ray_count = p_segments.size() / 2;
+	Vector<RayResult> results;
+	results.resize(ray_count);
+	intersect_rays(p_ray_query->get_parameters(), p_segments.ptr(), ray_count, results.ptrw());
+
+	PackedVector2Array positions;
+	PackedVector2Array normals;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	positions.resize(ray_count);
+	normals.resize(ray_count);
+	collider_ids.resize(ray_count);
+	shapes.resize(ray_count);
+
+	Vector2 *positions_w = positions.ptrw();
+	Vector2 *normals_w = normals.ptrw();
+	int64_t *collider_ids_w = collider_ids.ptrw();
+	int32_t *shapes_w = shapes.ptrw();
+	for (int i = 0; i < ray_count; i++) {
+		const RayResult &result = results[i];
+		positions_w[i] = result.position;
+		normals_w[i] = result.normal;
+		collider_ids_w[i] = int64_t(result.collider_id);
+		shapes_w[i] = result.rid.is_valid() ? result.shape : -1;
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState2D::_intersect_shapes(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, int p_max_results) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results < 0, Dictionary());
+
+	const ShapeParameters &parameters = p_shape_query->get_parameters();
+	int query_count = p_origins.size();
+
+	Vector<Transform2D> transforms;
+	transforms.resize(query_count);
+	for (int i = 0; i < query_count; i++) {
+		transforms.write[i] = parameters.transform;
+		transforms.write[i].set_origin(p_origins[i]);
+	}
+
+	Vector<ShapeResult> results;
+	results.resize(query_count * p_max_results);
+	PackedInt32Array counts;
+	counts.resize(query_count);
+	counts.fill(0);
+	intersect_shapes(parameters, transforms.ptr(), query_count, results.ptrw(), p_max_results, counts.ptrw());
+
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	for (int i = 0; i < query_count; i++) {
+		for (int j = 0; j < counts[i]; j++) {
+			const ShapeResult &result = results[i * p_max_results + j];
+			collider_ids.push_back(int64_t(result.collider_id));
+			shapes.push_back(result.shape);
+		}
+	}
+
+	Dictionary d;
+	d["count"] = counts;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	return d;
+}
+
 Array PhysicsDirectSpaceState2D::_cast_motion(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
 
@@ -434,6 +510,24 @@ Dictionary PhysicsDirectSpaceState2D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+void PhysicsDirectSpaceState2D::intersect_rays(const RayParameters &p_parameters, const Vector2 *p_segments, int p_ray_count, RayResult *r_results) {
+	RayParameters parameters = p_parameters;
+	for (int i = 0; i < p_ray_count; i++) {
+		parameters.from = p_segments[i * 2 + 0];
+		parameters.to = p_segments[i * 2 + 1];
+		r_results[i] = RayResult();
+		intersect_ray(parameters, r_results[i]);
+	}
+}
+
+void PhysicsDirectSpaceState2D::intersect_shapes(const ShapeParameters &p_parameters, const Transform2D *p_transforms, int p_query_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_query_count; i++) {
+		parameters.transform = p_transforms[i];
+		r_result_counts[i] = intersect_shape(parameters, r_results + i * p_result_max, p_result_max);
+	}
+}
+
 PhysicsDirectSpaceState2D::PhysicsDirectSpaceState2D() {
 }
 
@@ -441,6 +535,8 @@ void PhysicsDirectSpaceState2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_point", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_intersect_point, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState2D::_intersect_ray);
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_intersect_shape, DEFVAL(32));
+	ClassDB::bind_method(D_METHOD("intersect_rays", "parameters", "segments"), &PhysicsDirectSpaceState2D::_intersect_rays);
+	ClassDB::bind_method(D_METHOD("intersect_shapes", "parameters", "origins", "max_results"), &PhysicsDirectSpaceState2D::_intersect_shapes, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState2D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState2D::_get_rest_info);
@@ -614,6 +710,11 @@ void PhysicsServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_create"), &PhysicsServer2D::space_create);
 	ClassDB::bind_method(D_METHOD("space_set_active", "space", "active"), &PhysicsServer2D::space_set_active);
 	ClassDB::bind_method(D_METHOD("space_is_active", "space"), &PhysicsServer2D::space_is_active);
+	ClassDB::bind_method(D_METHOD("space_set_deterministic", "space", "deterministic"), &PhysicsServer2D::space_set_deterministic);
+	ClassDB::bind_method(D_METHOD("space_is_deterministic", "space"), &PhysicsServer2D::space_is_deterministic);
+	ClassDB::bind_method(D_METHOD("space_get_state_hash", "space"), &PhysicsServer2D::space_get_state_hash);
+	ClassDB::bind_method(D_METHOD("space_save_snapshot", "space"), &PhysicsServer2D::space_save_snapshot);
+	ClassDB::bind_method(D_METHOD("space_restore_snapshot", "space", "snapshot"), &PhysicsServer2D::space_restore_snapshot);
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer2D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer2D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer2D::space_get_direct_state);
@@ -116,6 +116,8 @@ class PhysicsDirectSpaceState2D : public Object {
 	Dictionary _intersect_ray(const Ref<PhysicsRayQueryParameters2D> &p_ray_query);
 	Array _intersect_point(const Ref<PhysicsPointQueryParameters2D> &p_point_query, int p_max_results = 32);
 	Array _intersect_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results = 32);
+	Dictionary _intersect_rays(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_segments);
+	Dictionary _intersect_shapes(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, int p_max_results = 32);
 	Array _cast_motion(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query);
 	Array _collide_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query);
@@ -190,6 +192,13 @@ public:
 	};
 
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) = 0;
+
+	// Batched intersect_ray() and intersect_shape(), for servers that can share work between queries.
+	// Rays use the filters in p_parameters and read from/to pairs from p_segments; rays that
+	// hit nothing get an empty result. Shape query i is placed at p_transforms[i], stores up to
+	// p_result_max results from r_results[i * p_result_max] and their count in r_result_counts[i].
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector2 *p_segments, int p_ray_count, RayResult *r_results);
+	virtual void intersect_shapes(const ShapeParameters &p_parameters, const Transform2D *p_transforms, int p_query_count, ShapeResult *r_results, int p_result_max, int *r_result_counts);
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) = 0;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) = 0;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) = 0;
@@ -249,6 +258,11 @@ public:
 	virtual RID space_create() = 0;
 	virtual void space_set_active(RID p_space, bool p_active) = 0;
 	virtual bool space_is_active(RID p_space) const = 0;
+	virtual void space_set_deterministic(RID p_space, bool p_deterministic) = 0;
+	virtual bool space_is_deterministic(RID p_space) const = 0;
+	virtual int64_t space_get_state_hash(RID p_space) const = 0;
+	virtual Vector<uint8_t> space_save_snapshot(RID p_space) const = 0;
+	virtual bool space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) = 0;
 
 	enum SpaceParameter {
 		SPACE_PARAM_CONTACT_RECYCLE_RADIUS,
@@ -399,6 +399,81 @@ Array PhysicsDirectSpaceState3D::_intersect_shape(const Ref<PhysicsShapeQueryPar
 	return ret;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_rays(const Ref<PhysicsRayQueryParameters3D> &p_ray_query, const PackedVector3Array &p_segments) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_segments.size() % 2, Dictionary(), "Segments must be pairs of from and to points.");
+
+	int ray_count = p_segments.size() / 2;
+	Vector<RayResult> results;
+	results.resize(ray_count);
+	intersect_rays(p_ray_query->get_parameters(), p_segments.ptr(), ray_count, results.ptrw());
+
+	PackedVector3Array positions;
+	PackedVector3Array normals;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	positions.resize(ray_count);
+	normals.resize(ray_count);
+	collider_ids.resize(ray_count);
+	shapes.resize(ray_count);
+
+	Vector3 *positions_w = positions.ptrw();
+	Vector3 *normals_w = normals.ptrw();
+	int64_t *collider_ids_w = collider_ids.ptrw();
+	int32_t *shapes_w = shapes.ptrw();
+	for (int i = 0; i < ray_count; i++) {
+		const RayResult &result = results[i];
+		positions_w[i] = result.position;
+		normals_w[i] = result.normal;
+		collider_ids_w[i] = int64_t(result.collider_id);
+		shapes_w[i] = result.rid.is_valid() ? result.shape : -1;
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState3D::_intersect_shapes(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const PackedVector3Array &p_origins, int p_max_results) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results < 0, Dictionary());
+
+	const ShapeParameters &parameters = p_shape_query->get_parameters();
+	int query_count = p_origins.size();
+
+	Vector<Transform3D> transforms;
+	transforms.resize(query_count);
+	for (int i = 0; i < query_count; i++) {
+		transforms.write[i] = Transform3D(parameters.transform.basis, p_origins[i]);
+	}
+
+	Vector<ShapeResult> results;
+	results.resize(query_count * p_max_results);
+	PackedInt32Array counts;
+	counts.resize(query_count);
+	counts.fill(0);
+	intersect_shapes(parameters, transforms.ptr(), query_count, results.ptrw(), p_max_results, counts.ptrw());
+
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	for (int i = 0; i < query_count; i++) {
+		for (int j = 0; j < counts[i]; j++) {
+			const ShapeResult &result = results[i * p_max_results + j];
+			collider_ids.push_back(int64_t(result.collider_id));
+			shapes.push_back(result.shape);
+		}
+	}
+
+	Dictionary d;
+	d["count"] = counts;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	return d;
+}
+
 Array PhysicsDirectSpaceState3D::_cast_motion(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
 
@@ -453,6 +528,24 @@ Dictionary PhysicsDirectSpaceState3D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+void PhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_segments, int p_ray_count, RayResult *r_results) {
+	RayParameters parameters = p_parameters;
+	for (int i = 0; i < p_ray_count; i++) {
+		parameters.from = p_segments[i * 2 + 0];
+		parameters.to = p_segments[i * 2 + 1];
+		r_results[i] = RayResult();
+		intersect_ray(parameters, r_results[i]);
+	}
+}
+
+void PhysicsDirectSpaceState3D::intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_query_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_query_count; i++) {
+		parameters.transform = p_transforms[i];
+		r_result_counts[i] = intersect_shape(parameters, r_results + i * p_result_max, p_result_max);
+	}
+}
+
 PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 }
 
@@ -460,6 +553,8 @@ void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_point", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_point, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState3D::_intersect_ray);
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shape, DEFVAL(32));
+	ClassDB::bind_method(D_METHOD("intersect_rays", "parameters", "segments"), &PhysicsDirectSpaceState3D::_intersect_rays);
+	ClassDB::bind_method(D_METHOD("intersect_shapes", "parameters", "origins", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shapes, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState3D::_get_rest_info);
@@ -682,6 +777,11 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_create"), &PhysicsServer3D::space_create);
 	ClassDB::bind_method(D_METHOD("space_set_active", "space", "active"), &PhysicsServer3D::space_set_active);
 	ClassDB::bind_method(D_METHOD("space_is_active", "space"), &PhysicsServer3D::space_is_active);
+	ClassDB::bind_method(D_METHOD("space_set_deterministic", "space", "deterministic"), &PhysicsServer3D::space_set_deterministic);
+	ClassDB::bind_method(D_METHOD("space_is_deterministic", "space"), &PhysicsServer3D::space_is_deterministic);
+	ClassDB::bind_method(D_METHOD("space_get_state_hash", "space"), &PhysicsServer3D::space_get_state_hash);
+	ClassDB::bind_method(D_METHOD("space_save_snapshot", "space"), &PhysicsServer3D::space_save_snapshot);
+	ClassDB::bind_method(D_METHOD("space_restore_snapshot", "space", "snapshot"), &PhysicsServer3D::space_restore_snapshot);
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
@@ -998,6 +1098,8 @@ void PhysicsServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(INFO_BROADPHASE_PAIR_TESTS);
+	BIND_ENUM_CONSTANT(INFO_BROADPHASE_TIME_USEC);
 
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_RECYCLE_RADIUS);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_MAX_SEPARATION);
@@ -1007,6 +1109,7 @@ void PhysicsServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(SPACE_PARAM_BODY_ANGULAR_VELOCITY_SLEEP_THRESHOLD);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_BODY_TIME_TO_SLEEP);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_ITERATIONS);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_RESIDUAL_THRESHOLD);
 
 	BIND_ENUM_CONSTANT(BODY_AXIS_LINEAR_X);
 	BIND_ENUM_CONSTANT(BODY_AXIS_LINEAR_Y);
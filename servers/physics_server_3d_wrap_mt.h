@@ -108,6 +108,11 @@ public:
 	FUNCRID(space);
 	FUNC2(space_set_active, RID, bool);
 	FUNC1RC(bool, space_is_active, RID);
+	FUNC2(space_set_deterministic, RID, bool);
+	FUNC1RC(bool, space_is_deterministic, RID);
+	FUNC1RC(int64_t, space_get_state_hash, RID);
+	FUNC1RC(Vector<uint8_t>, space_save_snapshot, RID);
+	FUNC2R(bool, space_restore_snapshot, RID, const Vector<uint8_t> &);
 
 	FUNC3(space_set_param, RID, SpaceParameter, real_t);
 	FUNC2RC(real_t, space_get_param, RID, SpaceParameter);
@@ -31,6 +31,7 @@
 #include "renderer_canvas_cull.h"
 
 #include "core/math/geometry_2d.h"
+#include "core/os/frame_allocator.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -291,7 +292,8 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			}
 
 			child_item_count = ci->ysort_children_count + 1;
-			child_items = (Item **)alloca(child_item_count * sizeof(Item *));
+			// Y-sorted subtrees can be large, so don't put this on the stack.
+			child_items = (Item **)FrameAllocator::alloc(child_item_count * sizeof(Item *));
 
 			child_items[0] = ci;
 			int i = 1;
@@ -304,6 +306,8 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			for (i = 0; i < child_item_count; i++) {
 				_cull_canvas_item(child_items[i], xform * child_items[i]->ysort_xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, false);
 			}
+
+			FrameAllocator::free(child_items);
 		} else {
 			RendererCanvasRender::Item *canvas_group_from = nullptr;
 			bool use_canvas_group = ci->canvas_group != nullptr && (ci->canvas_group->fit_empty || ci->commands != nullptr);
@@ -32,6 +32,7 @@
 #define RENDERING_SERVER_DEFAULT_H
 
 #include "core/math/octree.h"
+#include "core/os/thread.h"
 #include "core/templates/command_queue_mt.h"
 #include "core/templates/ordered_hash_map.h"
 #include "renderer_canvas_cull.h"
@@ -0,0 +1,259 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/config/project_settings.h"
+#include "core/object/message_queue.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "main/performance.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows):
+// "Unqualified friend declaration referring to type outside of the nearest enclosing namespace
+// is a Microsoft extension; add a nested name specifier".
+class _TestMessageRecorder : public Object {
+	GDCLASS(_TestMessageRecorder, Object);
+
+protected:
+	void _notification(int p_what) {
+		// Engine notifications (postinitialize, predelete) are below the offset.
+		if (p_what >= NOTIFICATION_OFFSET) {
+			received.push_back(p_what - NOTIFICATION_OFFSET);
+		}
+	}
+
+	bool _set(const StringName &p_name, const Variant &p_value) {
+		if (p_name == "value") {
+			received.push_back(p_value);
+			return true;
+		}
+		return false;
+	}
+
+public:
+	enum {
+		NOTIFICATION_OFFSET = 10000,
+	};
+
+	// Only touched by the thread that flushes the queue.
+	LocalVector<int> received;
+
+	Variant callp(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) override {
+		if (p_method == "record") {
+			received.push_back(*p_args[0]);
+			r_error.error = Callable::CallError::CALL_OK;
+			return Variant();
+		}
+		return Object::callp(p_method, p_args, p_argcount, r_error);
+	}
+};
+
+namespace TestMessageQueue {
+
+struct Producer {
+	ObjectID target;
+	int count = 0;
+};
+
+// Cycles through the three kinds of messages, so ordering is checked across them.
+static void _push_messages(void *p_userdata) {
+	Producer *producer = static_cast<Producer *>(p_userdata);
+	MessageQueue *queue = MessageQueue::get_singleton();
+	for (int i = 0; i < producer->count; i++) {
+		switch (i % 3) {
+			case 0: {
+				queue->push_call(producer->target, "record", i);
+			} break;
+			case 1: {
+				queue->push_notification(producer->target, _TestMessageRecorder::NOTIFICATION_OFFSET + i);
+			} break;
+			case 2: {
+				queue->push_set(producer->target, "value", i);
+			} break;
+		}
+	}
+}
+
+static bool _received_in_order(const _TestMessageRecorder *p_recorder, int p_count) {
+	if ((int)p_recorder->received.size() != p_count) {
+		return false;
+	}
+	for (int i = 0; i < p_count; i++) {
+		if (p_recorder->received[i] != i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// The queue reads its size when it is created, and [SceneTree] tests create their own afterwards.
+class QueueScope {
+	Variant old_size_kb;
+
+public:
+	MessageQueue *queue = nullptr;
+
+	QueueScope(int p_size_kb) {
+		old_size_kb = ProjectSettings::get_singleton()->get_setting("memory/limits/message_queue/max_size_kb");
+		ProjectSettings::get_singleton()->set_setting("memory/limits/message_queue/max_size_kb", p_size_kb);
+		queue = memnew(MessageQueue);
+	}
+
+	~QueueScope() {
+		memdelete(queue);
+		ProjectSettings::get_singleton()->set_setting("memory/limits/message_queue/max_size_kb", old_size_kb);
+	}
+};
+
+#if !defined(NO_THREADS)
+TEST_CASE("[MessageQueue] Messages from each producer thread are delivered in order") {
+	const int producer_count = 4;
+	const int message_count = 3000;
+
+	QueueScope scope(4096);
+	MessageQueue *queue = scope.queue;
+
+	_TestMessageRecorder *recorders[producer_count];
+	Producer producers[producer_count];
+	Thread threads[producer_count];
+	for (int i = 0; i < producer_count; i++) {
+		recorders[i] = memnew(_TestMessageRecorder);
+		producers[i].target = recorders[i]->get_instance_id();
+		producers[i].count = message_count;
+	}
+	for (int i = 0; i < producer_count; i++) {
+		threads[i].start(_push_messages, &producers[i]);
+	}
+
+	// Flush while the producers are still pushing, so pages are drained under them.
+	bool producing = true;
+	while (producing) {
+		queue->flush();
+		producing = false;
+		for (int i = 0; i < producer_count; i++) {
+			producing = producing || int(recorders[i]->received.size()) < message_count;
+		}
+	}
+	for (int i = 0; i < producer_count; i++) {
+		threads[i].wait_to_finish();
+	}
+	queue->flush();
+
+	for (int i = 0; i < producer_count; i++) {
+		CHECK_MESSAGE(_received_in_order(recorders[i], message_count), "Each producer's messages should arrive once and in push order.");
+		memdelete(recorders[i]);
+	}
+	CHECK_MESSAGE(queue->get_overflow_count() == 0, "Nothing should overflow in a queue of the default size.");
+}
+
+TEST_CASE("[MessageQueue] The buffer of a thread that exited is drained and reused") {
+	QueueScope scope(4096);
+	MessageQueue *queue = scope.queue;
+
+	_TestMessageRecorder *recorder = memnew(_TestMessageRecorder);
+	Producer producer;
+	producer.target = recorder->get_instance_id();
+	producer.count = 300;
+
+	Thread thread;
+	thread.start(_push_messages, &producer);
+	thread.wait_to_finish();
+	CHECK(queue->get_thread_buffer_count() == 1);
+
+	queue->flush();
+	CHECK_MESSAGE(_received_in_order(recorder, producer.count), "Messages left behind by an exited thread should still be delivered.");
+
+	recorder->received.clear();
+	Thread other_thread;
+	other_thread.start(_push_messages, &producer);
+	other_thread.wait_to_finish();
+	CHECK_MESSAGE(queue->get_thread_buffer_count() == 1, "A new thread should take over the drained buffer instead of registering another one.");
+
+	queue->flush();
+	CHECK_MESSAGE(_received_in_order(recorder, producer.count), "Messages pushed into a reused buffer should be delivered.");
+
+	memdelete(recorder);
+}
+#endif // NO_THREADS
+
+TEST_CASE("[MessageQueue] Pushes past max_size_kb fail and are counted") {
+	QueueScope scope(1);
+	MessageQueue *queue = scope.queue;
+	Performance *performance = memnew(Performance);
+
+	_TestMessageRecorder *recorder = memnew(_TestMessageRecorder);
+	const ObjectID target = recorder->get_instance_id();
+	const int limit = 1024; // A notification takes more than one byte.
+
+	ERR_PRINT_OFF;
+	_print_line_enabled = false;
+	int pushed = 0;
+	while (pushed < limit && queue->push_notification(target, _TestMessageRecorder::NOTIFICATION_OFFSET + pushed) == OK) {
+		pushed++;
+	}
+	const Error set_error = queue->push_set(target, "value", pushed);
+	_print_line_enabled = true;
+	ERR_PRINT_ON;
+
+	CHECK(pushed > 0);
+	CHECK(pushed < limit);
+	CHECK(set_error == ERR_OUT_OF_MEMORY);
+	CHECK_MESSAGE(queue->get_overflow_count() == 2, "Both rejected pushes should be counted.");
+	CHECK(performance->get_monitor(Performance::MESSAGE_QUEUE_OVERFLOW_COUNT) == 2);
+
+	queue->flush();
+	CHECK_MESSAGE(_received_in_order(recorder, pushed), "Messages accepted before the overflow should be delivered.");
+	CHECK(queue->get_buffer_usage() > 0);
+	CHECK(queue->get_buffer_usage() <= 1024);
+	CHECK(queue->get_max_buffer_usage() == queue->get_buffer_usage());
+
+	// Flushing gives the room back, so the same amount fits again.
+	recorder->received.clear();
+	int pushed_again = 0;
+	while (pushed_again < pushed && queue->push_notification(target, _TestMessageRecorder::NOTIFICATION_OFFSET + pushed_again) == OK) {
+		pushed_again++;
+	}
+	CHECK(pushed_again == pushed);
+	CHECK(queue->get_overflow_count() == 2);
+
+	queue->flush();
+	CHECK(_received_in_order(recorder, pushed));
+
+	memdelete(recorder);
+	memdelete(performance);
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -31,6 +31,10 @@
 #ifndef TEST_STRING_H
 #define TEST_STRING_H
 
+#include "core/io/json.h"
+#include "core/os/os.h"
+#include "core/string/node_path.h"
+#include "core/string/print_string.h"
 #include "core/string/ustring.h"
 
 #include "tests/test_macros.h"
@@ -1101,6 +1105,50 @@ TEST_CASE("[String] Cyrillic to_lower()") {
 	CHECK(state);
 }
 
+TEST_CASE("[String] ASCII fast paths with mixed text") {
+	// Non-ASCII characters at every offset around the 16 byte blocks.
+	for (int pos = 0; pos < 40; pos++) {
+		String expected;
+		for (int i = 0; i < 40; i++) {
+			expected += i == pos ? String::utf8("é") : String::chr('a' + i % 26);
+		}
+		expected += String::chr(0x1F600);
+
+		const CharString cs = expected.utf8();
+		CHECK(cs.length() == 40 + 1 + 4);
+		CHECK(uint8_t(cs[pos]) == 0xc3);
+
+		String parsed;
+		CHECK(!parsed.parse_utf8(cs.get_data()));
+		CHECK(parsed == expected);
+		CHECK(String::utf8(cs.get_data(), cs.length()) == expected);
+
+		CHECK(expected.to_upper().to_lower() == expected);
+		CHECK(expected.to_upper()[pos] == 0xc9); // É
+		CHECK(expected.find(String::utf8("é")) == pos);
+		CHECK(expected.find(String::chr(0x1F600)) == 40);
+	}
+
+	// Parsing stops at the first zero byte.
+	const char embedded_nul[] = "abcdefghijklmnopqrstuvwxyz\0abc";
+	CHECK(String::utf8(embedded_nul, sizeof(embedded_nul) - 1) == "abcdefghijklmnopqrstuvwxyz");
+
+	// Strings that don't change are shared instead of copied.
+	const String lower = "already lower case, long enough for several blocks";
+	CHECK(lower.to_lower().ptr() == lower.ptr());
+	CHECK(lower.to_upper() == "ALREADY LOWER CASE, LONG ENOUGH FOR SEVERAL BLOCKS");
+	CHECK(String("[MixedCase] Text With 123 Digits @ Z").to_lower() == "[mixedcase] text with 123 digits @ z");
+	CHECK(String("[mixedcase] text with 123 digits ` z{").to_upper() == "[MIXEDCASE] TEXT WITH 123 DIGITS ` Z{");
+
+	const String haystack = "node_0/node_1/node_2/node_10/node_11";
+	CHECK(haystack.find("node_1") == 7);
+	CHECK(haystack.find("node_11") == 29);
+	CHECK(haystack.find("node_12") == -1);
+	CHECK(haystack.find(String("node_10"), 8) == 21);
+	CHECK(haystack.find("1", 30) == 34);
+	CHECK(haystack.find("", 3) == 3);
+}
+
 TEST_CASE("[String] Count and countn functionality") {
 #define COUNT_TEST(x)             \
 	{                             \
@@ -1496,6 +1544,68 @@ TEST_CASE("[Stress][String] Empty via `is_empty()`") {
 		}
 	}
 }
+
+// Benchmarks, run with --no-skip to print timings.
+
+template <class F>
+static void _benchmark(const char *p_name, F p_function) {
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	const int64_t checksum = p_function();
+	const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("%s: %d usec (checksum %d)", p_name, elapsed, checksum));
+}
+
+TEST_CASE("[String][Benchmark] JSON parse" * doctest::skip()) {
+	// Plain C strings are Latin-1, decode the accented label from UTF-8.
+	const String plain_label = "plain label";
+	const String accented_label = String::utf8("étiquette");
+	String text = "[";
+	for (int i = 0; i < 20000; i++) {
+		text += vformat("{\"name\": \"item_%d\", \"label\": \"%s\", \"value\": %d},", i, i % 10 ? plain_label : accented_label, i);
+	}
+	text += "{}]";
+	const CharString utf8 = text.utf8();
+
+	_benchmark("JSON parse from UTF-8", [&]() {
+		int64_t sum = 0;
+		for (int i = 0; i < 10; i++) {
+			Ref<JSON> json;
+			json.instantiate();
+			json->parse(String::utf8(utf8.get_data(), utf8.length()));
+			sum += Array(json->get_data()).size();
+		}
+		return sum;
+	});
+}
+
+TEST_CASE("[String][Benchmark] Node path building" * doctest::skip()) {
+	_benchmark("NodePath building", []() {
+		int64_t sum = 0;
+		for (int i = 0; i < 100000; i++) {
+			const String path = "/root/Main/Level_" + itos(i % 16) + "/Enemies/Enemy_" + itos(i) + "/Sprite2D";
+			const NodePath node_path = path;
+			sum += node_path.get_name_count() + path.to_lower().find("enemy_");
+		}
+		return sum;
+	});
+}
+
+TEST_CASE("[String][Benchmark] Scene text round trip" * doctest::skip()) {
+	String scene = "[gd_scene load_steps=3 format=3]\n\n";
+	for (int i = 0; i < 5000; i++) {
+		scene += vformat("[node name=\"Node%d\" type=\"Sprite2D\" parent=\".\"]\nposition = Vector2(%d, %d)\ntexture = ExtResource(\"1\")\n\n", i, i, -i);
+	}
+	const CharString utf8 = scene.utf8();
+
+	_benchmark("Scene text UTF-8 round trip", [&]() {
+		int64_t sum = 0;
+		for (int i = 0; i < 20; i++) {
+			const String parsed = String::utf8(utf8.get_data(), utf8.length());
+			sum += parsed.utf8().length() + parsed.find("[node name=\"Node4999\"");
+		}
+		return sum;
+	});
+}
 } // namespace TestString
 
 #endif // TEST_STRING_H
@@ -0,0 +1,112 @@
+/*************************************************************************/
+/*  test_string_name.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/worker_thread_pool.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName a = "interning_test";
+	const StringName b = String("interning_test");
+	const StringName c = StaticCString::create("interning_test");
+	const StringName d = SNAME("interning_test");
+
+	CHECK(a == b);
+	CHECK(a == c);
+	CHECK(a == d);
+	CHECK(a.hash() == String("interning_test").hash());
+	CHECK(a == "interning_test");
+	CHECK(StringName::search("interning_test") == a);
+	CHECK(StringName::search(String("interning_test")) == a);
+	CHECK(StringName::search(U"interning_test") == a);
+	CHECK(StringName::search("interning_test_missing") == StringName());
+}
+
+TEST_CASE("[StringName] Precomputed hash") {
+	static_assert(StaticCString::hash_static("") == 5381);
+	CHECK(StaticCString::hash_static("position") == String::hash("position"));
+	CHECK(StaticCString::hash_static("Ünïcödé") == String::hash("Ünïcödé"));
+}
+
+TEST_CASE("[StringName] Table growth and removal") {
+	Vector<StringName> names;
+	for (int i = 0; i < 20000; i++) {
+		names.push_back(StringName("growth_test_" + itos(i)));
+	}
+	for (int i = 0; i < names.size(); i += 997) {
+		CHECK(StringName::search("growth_test_" + itos(i)) == names[i]);
+	}
+	names.clear();
+	CHECK(StringName::search("growth_test_0") == StringName());
+}
+
+class Interner {
+public:
+	StringName expected[64];
+	std::atomic<uint32_t> mismatches;
+
+	void intern(uint32_t p_index, void *p_userdata) {
+		for (int i = 0; i < 200; i++) {
+			const int n = (p_index * 7 + i) % 64;
+			const StringName name = "concurrent_test_" + itos(n);
+			if (name != expected[n]) {
+				mismatches.fetch_add(1);
+			}
+			// Short lived names get freed and created again while other threads look them up.
+			const StringName temporary = "concurrent_temporary_" + itos(i % 8);
+			if (temporary != StringName("concurrent_temporary_" + itos(i % 8))) {
+				mismatches.fetch_add(1);
+			}
+		}
+	}
+
+	Interner() {
+		for (int i = 0; i < 64; i++) {
+			expected[i] = "concurrent_test_" + itos(i);
+		}
+		mismatches.store(0);
+	}
+};
+
+TEST_CASE("[StringName] Concurrent interning") {
+	Interner interner;
+	WorkerThreadPool::get_singleton()->do_work(256, &interner, &Interner::intern, (void *)nullptr);
+	CHECK_MESSAGE(interner.mismatches.load() == 0, "The same name should always be interned to the same StringName.");
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
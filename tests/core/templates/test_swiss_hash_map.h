@@ -0,0 +1,345 @@
+/*************************************************************************/
+/*  test_swiss_hash_map.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SWISS_HASH_MAP_H
+#define TEST_SWISS_HASH_MAP_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/string/print_string.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/map.h"
+#include "core/templates/oa_hash_map.h"
+#include "core/templates/swiss_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSwissHashMap {
+
+TEST_CASE("[SwissHashMap] Insert, lookup and overwrite") {
+	SwissHashMap<int, int> map;
+	CHECK(map.is_empty());
+	CHECK(map.getptr(42) == nullptr);
+
+	map.set(42, 1337);
+	map.set(1337, 21);
+	map.set(42, 11880);
+
+	CHECK(map.size() == 2);
+	CHECK(map.has(42));
+	CHECK(map.get(42) == 11880);
+	CHECK(map[1337] == 21);
+
+	int value = 0;
+	CHECK(map.lookup(1337, value));
+	CHECK(value == 21);
+	CHECK_FALSE(map.lookup(7, value));
+
+	map[7] = 3;
+	CHECK(map.size() == 3);
+	CHECK(map.get(7) == 3);
+}
+
+TEST_CASE("[SwissHashMap] Erase and reuse of deleted slots") {
+	SwissHashMap<int, int> map;
+	for (int i = 0; i < 5000; i++) {
+		map.set(i, i * 2);
+	}
+	for (int i = 0; i < 5000; i += 2) {
+		CHECK(map.erase(i));
+	}
+	CHECK_FALSE(map.erase(0));
+	CHECK(map.size() == 2500);
+
+	bool all_match = true;
+	for (int i = 0; i < 5000; i++) {
+		const int *v = map.getptr(i);
+		if ((i % 2 == 0) != (v == nullptr) || (v && *v != i * 2)) {
+			all_match = false;
+		}
+	}
+	CHECK_MESSAGE(all_match, "Only odd keys should remain, with their values.");
+
+	// Churn through many insert/erase cycles, tombstones must not make the table grow forever.
+	for (int i = 0; i < 100000; i++) {
+		map.set(10000 + i, i);
+		map.erase(10000 + i);
+	}
+	CHECK(map.size() == 2500);
+	CHECK(map.get_capacity() <= 8192);
+
+	for (int i = 1; i < 5000; i += 2) {
+		map.erase(i);
+	}
+	CHECK(map.is_empty());
+	CHECK(map.get_capacity() == 0);
+}
+
+TEST_CASE("[SwissHashMap] Iteration") {
+	SwissHashMap<String, int> map;
+	map.set("Hello", 1);
+	map.set("World", 2);
+	map.set("Godot rocks", 42);
+
+	int sum = 0;
+	int count = 0;
+	for (SwissHashMap<String, int>::Iterator it = map.iter(); it.valid; it = map.next_iter(it)) {
+		sum += *it.value;
+		count++;
+	}
+	CHECK(count == 3);
+	CHECK(sum == 45);
+
+	sum = 0;
+	count = 0;
+	const String *k = nullptr;
+	while ((k = map.next(k))) {
+		sum += map[*k];
+		count++;
+	}
+	CHECK(count == 3);
+	CHECK(sum == 45);
+
+	List<String> keys;
+	map.get_key_list(&keys);
+	CHECK(keys.size() == 3);
+	CHECK(keys.find("Godot rocks") != nullptr);
+
+	// Erasing the first key repeatedly is how Object clears its signals.
+	while ((k = map.next(nullptr))) {
+		map.erase(*k);
+	}
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[SwissHashMap] Copy, custom lookup and reserve") {
+	SwissHashMap<StringName, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.set(StringName(itos(i)), i);
+	}
+
+	SwissHashMap<StringName, int> copy = map;
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(copy.size() == 100);
+	CHECK(copy[StringName("57")] == 57);
+
+	const String key = "42";
+	const int *v = copy.custom_getptr(key, key.hash());
+	REQUIRE(v != nullptr);
+	CHECK(*v == 42);
+
+	SwissHashMap<int, int> reserved;
+	reserved.reserve(1000);
+	const uint32_t capacity = reserved.get_capacity();
+	CHECK(capacity >= 1000);
+	for (int i = 0; i < 1000; i++) {
+		reserved.set(i, i);
+	}
+	CHECK(reserved.get_capacity() == capacity);
+}
+
+TEST_CASE("[SwissHashMap] Matches HashMap on random operations") {
+	SwissHashMap<uint32_t, uint32_t> map;
+	HashMap<uint32_t, uint32_t> reference;
+	RandomPCG rng(1234);
+
+	bool consistent = true;
+	for (uint32_t i = 0; i < 50000; i++) {
+		const uint32_t key = rng.rand() % 2048;
+		switch (rng.rand() % 3) {
+			case 0: {
+				map.set(key, i);
+				reference.set(key, i);
+			} break;
+			case 1: {
+				consistent = consistent && map.erase(key) == reference.erase(key);
+			} break;
+			default: {
+				const uint32_t *a = map.getptr(key);
+				const uint32_t *b = reference.getptr(key);
+				consistent = consistent && (a == nullptr) == (b == nullptr) && (!a || *a == *b);
+			} break;
+		}
+		consistent = consistent && map.size() == reference.size();
+	}
+	CHECK_MESSAGE(consistent, "SwissHashMap should behave like HashMap.");
+}
+
+// Benchmarks, run with --no-skip to print timings.
+
+template <class F>
+static void _benchmark(const char *p_name, F p_function) {
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	const uint64_t checksum = p_function();
+	const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("%s: %d usec (checksum %d)", p_name, elapsed, checksum));
+}
+
+TEST_CASE("[SwissHashMap][Benchmark] Integer keys" * doctest::skip()) {
+	const uint32_t element_count = 1 << 18;
+	LocalVector<uint32_t> keys;
+	keys.resize(element_count);
+	RandomPCG rng(42);
+	for (uint32_t i = 0; i < element_count; i++) {
+		keys[i] = rng.rand();
+	}
+
+	// Half of the lookups hit, half (most likely) miss.
+	_benchmark("SwissHashMap", [&]() {
+		SwissHashMap<uint32_t, uint32_t> map;
+		for (uint32_t i = 0; i < element_count; i++) {
+			map.set(keys[i], i);
+		}
+		uint64_t sum = 0;
+		for (uint32_t i = 0; i < element_count; i++) {
+			const uint32_t *v = map.getptr(keys[(i * 31) & (element_count - 1)]);
+			sum += v ? *v : 0;
+			v = map.getptr(i);
+			sum += v ? *v : 0;
+		}
+		return sum;
+	});
+	_benchmark("HashMap", [&]() {
+		HashMap<uint32_t, uint32_t> map;
+		for (uint32_t i = 0; i < element_count; i++) {
+			map.set(keys[i], i);
+		}
+		uint64_t sum = 0;
+		for (uint32_t i = 0; i < element_count; i++) {
+			const uint32_t *v = map.getptr(keys[(i * 31) & (element_count - 1)]);
+			sum += v ? *v : 0;
+			v = map.getptr(i);
+			sum += v ? *v : 0;
+		}
+		return sum;
+	});
+	_benchmark("OAHashMap", [&]() {
+		OAHashMap<uint32_t, uint32_t> map;
+		for (uint32_t i = 0; i < element_count; i++) {
+			map.set(keys[i], i);
+		}
+		uint64_t sum = 0;
+		uint32_t v = 0;
+		for (uint32_t i = 0; i < element_count; i++) {
+			if (map.lookup(keys[(i * 31) & (element_count - 1)], v)) {
+				sum += v;
+			}
+			if (map.lookup(i, v)) {
+				sum += v;
+			}
+		}
+		return sum;
+	});
+	_benchmark("Map", [&]() {
+		Map<uint32_t, uint32_t> map;
+		for (uint32_t i = 0; i < element_count; i++) {
+			map[keys[i]] = i;
+		}
+		uint64_t sum = 0;
+		for (uint32_t i = 0; i < element_count; i++) {
+			const Map<uint32_t, uint32_t>::Element *E = map.find(keys[(i * 31) & (element_count - 1)]);
+			sum += E ? E->get() : 0;
+			E = map.find(i);
+			sum += E ? E->get() : 0;
+		}
+		return sum;
+	});
+}
+
+TEST_CASE("[SwissHashMap][Benchmark] StringName keys" * doctest::skip()) {
+	const uint32_t element_count = 1 << 14;
+	LocalVector<StringName> keys;
+	keys.resize(element_count);
+	for (uint32_t i = 0; i < element_count; i++) {
+		keys[i] = StringName("key_" + itos(i));
+	}
+	const uint32_t rounds = 16;
+
+	_benchmark("SwissHashMap", [&]() {
+		SwissHashMap<StringName, uint32_t> map;
+		for (uint32_t i = 0; i < element_count; i++) {
+			map.set(keys[i], i);
+		}
+		uint64_t sum = 0;
+		for (uint32_t r = 0; r < rounds; r++) {
+			for (uint32_t i = 0; i < element_count; i++) {
+				sum += *map.getptr(keys[(i * 31) & (element_count - 1)]);
+			}
+		}
+		return sum;
+	});
+	_benchmark("HashMap", [&]() {
+		HashMap<StringName, uint32_t> map;
+		for (uint32_t i = 0; i < element_count; i++) {
+			map.set(keys[i], i);
+		}
+		uint64_t sum = 0;
+		for (uint32_t r = 0; r < rounds; r++) {
+			for (uint32_t i = 0; i < element_count; i++) {
+				sum += *map.getptr(keys[(i * 31) & (element_count - 1)]);
+			}
+		}
+		return sum;
+	});
+	_benchmark("OAHashMap", [&]() {
+		OAHashMap<StringName, uint32_t> map;
+		for (uint32_t i = 0; i < element_count; i++) {
+			map.set(keys[i], i);
+		}
+		uint64_t sum = 0;
+		uint32_t v = 0;
+		for (uint32_t r = 0; r < rounds; r++) {
+			for (uint32_t i = 0; i < element_count; i++) {
+				map.lookup(keys[(i * 31) & (element_count - 1)], v);
+				sum += v;
+			}
+		}
+		return sum;
+	});
+	_benchmark("Map", [&]() {
+		Map<StringName, uint32_t> map;
+		for (uint32_t i = 0; i < element_count; i++) {
+			map[keys[i]] = i;
+		}
+		uint64_t sum = 0;
+		for (uint32_t r = 0; r < rounds; r++) {
+			for (uint32_t i = 0; i < element_count; i++) {
+				sum += map.find(keys[(i * 31) & (element_count - 1)])->get();
+			}
+		}
+		return sum;
+	});
+}
+
+} // namespace TestSwissHashMap
+
+#endif // TEST_SWISS_HASH_MAP_H
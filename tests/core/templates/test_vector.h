@@ -530,6 +530,42 @@ TEST_CASE("[Vector] Operators") {
 	CHECK(vector != vector_other);
 }
 
+TEST_CASE("[Vector] Span view") {
+	Vector<int> vector{ 3, 1, 4 };
+	Span<int> span = vector.span();
+
+	CHECK(span.size() == 3);
+	CHECK(span.ptr() == vector.ptr());
+	CHECK(span[2] == 4);
+
+	int sum = 0;
+	for (int value : span) {
+		sum += value;
+	}
+	CHECK(sum == 8);
+
+	CHECK(Vector<int>().span().is_empty());
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Vector] Copy on write is counted") {
+	Vector<int> vector{ 0, 1, 2 };
+	Vector<int> shared = vector;
+
+	uint64_t copies = CowDataStats::get_copy_count();
+	Span<int> span = shared;
+	CHECK(span.ptr() == vector.ptr());
+	CHECK_MESSAGE(CowDataStats::get_copy_count() == copies, "Reading a shared vector should not copy it.");
+
+	shared.write[0] = 5;
+	CHECK_MESSAGE(CowDataStats::get_copy_count() == copies + 1, "Writing to a shared vector should copy it once.");
+	CHECK(vector[0] == 0);
+
+	shared.write[1] = 6;
+	CHECK_MESSAGE(CowDataStats::get_copy_count() == copies + 1, "Writing to a unique vector should not copy it.");
+}
+#endif
+
 } // namespace TestVector
 
 #endif // TEST_VECTOR_H
@@ -0,0 +1,119 @@
+/*************************************************************************/
+/*  test_frame_allocator.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FRAME_ALLOCATOR_H
+#define TEST_FRAME_ALLOCATOR_H
+
+#include "core/os/frame_allocator.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameAllocator {
+
+TEST_CASE("[FrameAllocator] Allocations are aligned and rewound in LIFO order") {
+	uint8_t *a = (uint8_t *)FrameAllocator::alloc(3);
+	uint8_t *b = (uint8_t *)FrameAllocator::alloc(40);
+	CHECK(((uintptr_t)a & 15) == 0);
+	CHECK(((uintptr_t)b & 15) == 0);
+	CHECK(b > a);
+
+	memset(a, 0xAA, 3);
+	memset(b, 0xBB, 40);
+	CHECK(a[2] == 0xAA);
+
+	FrameAllocator::free(b);
+	uint8_t *c = (uint8_t *)FrameAllocator::alloc(40);
+	CHECK_MESSAGE(c == b, "Freeing the last allocation should make its memory available again.");
+
+	FrameAllocator::free(c);
+	FrameAllocator::free(a);
+}
+
+TEST_CASE("[FrameAllocator] Realloc keeps contents and large allocations work") {
+	FrameAllocator::next_frame();
+
+	int *data = (int *)FrameAllocator::alloc(4 * sizeof(int));
+	for (int i = 0; i < 4; i++) {
+		data[i] = i;
+	}
+	int *grown = (int *)FrameAllocator::realloc(data, 1024 * sizeof(int));
+	CHECK_MESSAGE(grown == data, "The most recent allocation should grow in place.");
+
+	// Bigger than the arena budget, served by the regular allocator.
+	uint8_t *huge = (uint8_t *)FrameAllocator::alloc(128 * 1024 * 1024);
+	REQUIRE(huge != nullptr);
+	huge[128 * 1024 * 1024 - 1] = 1;
+
+	grown = (int *)FrameAllocator::realloc(grown, 2048 * sizeof(int));
+	bool preserved = true;
+	for (int i = 0; i < 4; i++) {
+		preserved = preserved && grown[i] == i;
+	}
+	CHECK(preserved);
+
+	FrameAllocator::free(huge);
+	FrameAllocator::free(grown);
+}
+
+TEST_CASE("[FrameAllocator] FrameLocalVector") {
+	FrameLocalVector<int> vector;
+	for (int i = 0; i < 10000; i++) {
+		vector.push_back(i);
+	}
+	CHECK(vector.size() == 10000);
+
+	bool all_match = true;
+	for (int i = 0; i < 10000; i++) {
+		all_match = all_match && vector[i] == i;
+	}
+	CHECK(all_match);
+}
+
+TEST_CASE("[FrameAllocator] Memory survives the next frame change") {
+	uint32_t *value = (uint32_t *)FrameAllocator::alloc(sizeof(uint32_t));
+	*value = 0xCAFE;
+
+	FrameAllocator::next_frame();
+	uint32_t *other = (uint32_t *)FrameAllocator::alloc(256);
+	memset(other, 0, 256);
+	CHECK(*value == 0xCAFE);
+
+	FrameAllocator::next_frame();
+	FrameAllocator::next_frame();
+	uint32_t *after_reset = (uint32_t *)FrameAllocator::alloc(sizeof(uint32_t));
+	REQUIRE(after_reset != nullptr);
+	*after_reset = 1;
+
+	CHECK(FrameAllocator::get_peak_usage() > 0);
+}
+
+} // namespace TestFrameAllocator
+
+#endif // TEST_FRAME_ALLOCATOR_H
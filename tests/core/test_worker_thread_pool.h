@@ -0,0 +1,104 @@
+/*************************************************************************/
+/*  test_worker_thread_pool.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_WORKER_THREAD_POOL_H
+#define TEST_WORKER_THREAD_POOL_H
+
+#include "core/os/worker_thread_pool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkerThreadPool {
+
+class Counter {
+public:
+	std::atomic<uint64_t> sum;
+	std::atomic<uint32_t> nested_calls;
+	std::atomic<int> stage;
+	std::atomic<uint32_t> order_errors;
+
+	void add(uint32_t p_index, uint32_t p_offset) {
+		sum.fetch_add(p_index + p_offset);
+	}
+
+	void nested_inner(uint32_t p_index, void *p_userdata) {
+		nested_calls.fetch_add(1);
+	}
+
+	void nested_outer(uint32_t p_index, void *p_userdata) {
+		WorkerThreadPool::get_singleton()->do_work(32, this, &Counter::nested_inner, (void *)nullptr);
+	}
+
+	void first_stage(uint32_t p_index, void *p_userdata) {
+		stage.store(1);
+	}
+
+	void second_stage(uint32_t p_index, void *p_userdata) {
+		if (stage.load() != 1) {
+			order_errors.fetch_add(1);
+		}
+	}
+
+	Counter() {
+		sum.store(0);
+		nested_calls.store(0);
+		stage.store(0);
+		order_errors.store(0);
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Parallel for") {
+	Counter counter;
+	WorkerThreadPool::get_singleton()->do_work(1000, &counter, &Counter::add, 1u);
+	CHECK_MESSAGE(counter.sum.load() == 1000 * 999 / 2 + 1000, "Every element should be processed exactly once.");
+}
+
+TEST_CASE("[WorkerThreadPool] Nested parallel for") {
+	Counter counter;
+	WorkerThreadPool::get_singleton()->do_work(16, &counter, &Counter::nested_outer, (void *)nullptr);
+	CHECK_MESSAGE(counter.nested_calls.load() == 16 * 32, "Nested work should complete without deadlocking.");
+}
+
+TEST_CASE("[WorkerThreadPool] Group dependencies") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	for (int i = 0; i < 16; i++) {
+		Counter counter;
+		WorkerThreadPool::GroupID first = pool->add_template_group_task(&counter, &Counter::first_stage, (void *)nullptr, 1);
+		WorkerThreadPool::GroupID second = pool->add_template_group_task(&counter, &Counter::second_stage, (void *)nullptr, 64, &first, 1);
+		pool->wait_for_group_task_completion(second);
+		CHECK_MESSAGE(pool->is_group_task_completed(first), "A group should only start after its dependencies are done.");
+		pool->wait_for_group_task_completion(first);
+		CHECK_MESSAGE(counter.order_errors.load() == 0, "A group should only start after its dependencies are done.");
+	}
+}
+
+} // namespace TestWorkerThreadPool
+
+#endif // TEST_WORKER_THREAD_POOL_H
@@ -31,6 +31,7 @@
 #ifndef TEST_VARIANT_H
 #define TEST_VARIANT_H
 
+#include "core/variant/binder_common.h"
 #include "core/variant/variant.h"
 #include "core/variant/variant_parser.h"
 
@@ -911,6 +912,30 @@ TEST_CASE("[Variant] Nested dictionary comparison") {
 	CHECK_FALSE(v_d1 == v_d_other_val);
 }
 
+TEST_CASE("[Variant] Packed array arguments read the stored array") {
+	PackedVector3Array points;
+	points.push_back(Vector3(1, 2, 3));
+	points.push_back(Vector3(4, 5, 6));
+	Variant v = points;
+	const Vector3 *stored = VariantInternal::get_vector3_array(&v)->ptr();
+
+	const PackedVector3Array &by_reference = VariantCaster<const PackedVector3Array &>::cast(v);
+	CHECK(by_reference.ptr() == stored);
+	Span<Vector3> span = VariantCaster<Span<Vector3>>::cast(v);
+	CHECK(span.ptr() == stored);
+	CHECK(span.size() == 2);
+	CHECK(PtrToArg<const PackedVector3Array &>::convert(VariantInternal::get_vector3_array(&v)).ptr() == stored);
+	CHECK(PtrToArg<Span<Vector3>>::convert(VariantInternal::get_vector3_array(&v))[1] == Vector3(4, 5, 6));
+
+	// Other types are converted, so the result holds its own array.
+	Array array;
+	array.push_back(Vector3(7, 8, 9));
+	Variant converted = array;
+	PackedVector3Array from_array = VariantCaster<const PackedVector3Array &>::cast(converted);
+	CHECK(from_array.size() == 1);
+	CHECK(from_array[0] == Vector3(7, 8, 9));
+}
+
 } // namespace TestVariant
 
 #endif // TEST_VARIANT_H
@@ -0,0 +1,129 @@
+/*************************************************************************/
+/*  test_mesh_tools.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESH_TOOLS_H
+#define TEST_MESH_TOOLS_H
+
+#include "scene/resources/mesh.h"
+#include "scene/resources/mesh_data_tool.h"
+#include "scene/resources/surface_tool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMeshTools {
+
+// The dummy renderer used by tests drops surface data, so keep the arrays on the mesh.
+class ArrayMeshWithArrays : public ArrayMesh {
+public:
+	Array arrays;
+
+	Array surface_get_arrays(int p_surface) const override {
+		return arrays;
+	}
+};
+
+static Array make_grid_arrays(int p_size) {
+	PackedVector3Array vertices;
+	PackedVector3Array normals;
+	PackedVector2Array uvs;
+	PackedInt32Array indices;
+
+	for (int y = 0; y <= p_size; y++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(x, 0, y));
+			normals.push_back(Vector3(0, 1, 0));
+			uvs.push_back(Vector2(x, y) / p_size);
+		}
+	}
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			int i = y * (p_size + 1) + x;
+			indices.push_back(i);
+			indices.push_back(i + 1);
+			indices.push_back(i + p_size + 1);
+			indices.push_back(i + 1);
+			indices.push_back(i + p_size + 2);
+			indices.push_back(i + p_size + 1);
+		}
+	}
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_NORMAL] = normals;
+	arrays[Mesh::ARRAY_TEX_UV] = uvs;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+	return arrays;
+}
+
+#ifdef DEBUG_ENABLED
+// Calls go through Object::call() like scripts do, so argument binding is part of what is measured.
+TEST_CASE("[SceneTree][MeshTools] Packed arrays are not copied on their way through mesh tools") {
+	const int size = 16;
+	const int vertex_count = (size + 1) * (size + 1);
+
+	Ref<ArrayMeshWithArrays> mesh = memnew(ArrayMeshWithArrays);
+	mesh->arrays = make_grid_arrays(size);
+
+	uint64_t copies = CowDataStats::get_copy_count();
+	mesh->call("add_surface_from_arrays", (int)Mesh::PRIMITIVE_TRIANGLES, mesh->arrays);
+	CHECK_MESSAGE(CowDataStats::get_copy_count() == copies, "ArrayMesh.add_surface_from_arrays should not copy the packed arrays.");
+	REQUIRE(mesh->get_surface_count() == 1);
+
+	SUBCASE("SurfaceTool") {
+		Ref<SurfaceTool> st;
+		st.instantiate();
+
+		copies = CowDataStats::get_copy_count();
+		st->call("create_from", mesh, 0);
+		Array arrays = st->call("commit_to_arrays");
+		CHECK_MESSAGE(CowDataStats::get_copy_count() == copies, "SurfaceTool.create_from and commit_to_arrays should not copy the packed arrays.");
+		CHECK(PackedVector3Array(arrays[Mesh::ARRAY_VERTEX]).size() == vertex_count);
+	}
+
+	SUBCASE("MeshDataTool") {
+		Ref<MeshDataTool> mdt;
+		mdt.instantiate();
+
+		copies = CowDataStats::get_copy_count();
+		CHECK(Error(int(mdt->call("create_from_surface", mesh, 0))) == OK);
+		Ref<ArrayMesh> result;
+		result.instantiate();
+		CHECK(Error(int(mdt->call("commit_to_surface", result))) == OK);
+		CHECK_MESSAGE(CowDataStats::get_copy_count() == copies, "MeshDataTool.create_from_surface and commit_to_surface should not copy the packed arrays.");
+		CHECK(mdt->get_vertex_count() == vertex_count);
+		CHECK(mdt->get_face_count() == size * size * 2);
+	}
+}
+#endif
+
+} // namespace TestMeshTools
+
+#endif // TEST_MESH_TOOLS_H
@@ -0,0 +1,175 @@
+/*************************************************************************/
+/*  test_physics_determinism.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_DETERMINISM_H
+#define TEST_PHYSICS_DETERMINISM_H
+
+#include "core/os/worker_thread_pool.h"
+#include "servers/physics_server_2d.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsDeterminism {
+
+const int step_count = 90;
+
+static void _restart_thread_pool(int p_thread_count) {
+	WorkerThreadPool::get_singleton()->finish();
+	WorkerThreadPool::get_singleton()->init(p_thread_count);
+}
+
+// Boxes dropped in tilted columns so they topple onto each other, spread over
+// a few islands and enough bodies to use the parallel broadphase path.
+static Vector<int64_t> _simulate_3d(int p_thread_count) {
+	_restart_thread_pool(p_thread_count);
+
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->space_set_deterministic(space, true);
+
+	RID floor_shape = ps->box_shape_create();
+	ps->shape_set_data(floor_shape, Vector3(50, 1, 50));
+	RID floor = ps->body_create();
+	ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -1, 0)));
+	ps->body_set_space(floor, space);
+
+	RID box = ps->box_shape_create();
+	ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+	Vector<RID> bodies;
+	for (int column = 0; column < 25; column++) {
+		for (int i = 0; i < 4; i++) {
+			RID body = ps->body_create();
+			ps->body_add_shape(body, box);
+			Basis basis(Vector3(0, 1, 0), 0.3 * i);
+			Vector3 origin((column % 5) * 3 + 0.2 * i, 0.6 + 1.1 * i, (column / 5) * 3);
+			ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(basis, origin));
+			ps->body_set_space(body, space);
+			bodies.push_back(body);
+		}
+	}
+
+	Vector<int64_t> hashes;
+	for (int i = 0; i < step_count; i++) {
+		ps->step(1.0 / 60.0);
+		hashes.push_back(ps->space_get_state_hash(space));
+	}
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(floor);
+	ps->free(box);
+	ps->free(floor_shape);
+	ps->free(space);
+
+	_restart_thread_pool(-1);
+	return hashes;
+}
+
+static Vector<int64_t> _simulate_2d(int p_thread_count) {
+	_restart_thread_pool(p_thread_count);
+
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->space_set_deterministic(space, true);
+
+	RID floor_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(floor_shape, Vector2(500, 10));
+	RID floor = ps->body_create();
+	ps->body_set_mode(floor, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_state(floor, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, 10)));
+	ps->body_set_space(floor, space);
+
+	RID box = ps->rectangle_shape_create();
+	ps->shape_set_data(box, Vector2(5, 5));
+	Vector<RID> bodies;
+	for (int column = 0; column < 20; column++) {
+		for (int i = 0; i < 5; i++) {
+			RID body = ps->body_create();
+			ps->body_add_shape(body, box);
+			Vector2 origin(column * 30 - 300 + 2 * i, -6 - 11 * i);
+			ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0.2 * i, origin));
+			ps->body_set_space(body, space);
+			bodies.push_back(body);
+		}
+	}
+
+	Vector<int64_t> hashes;
+	for (int i = 0; i < step_count; i++) {
+		ps->step(1.0 / 60.0);
+		hashes.push_back(ps->space_get_state_hash(space));
+	}
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(floor);
+	ps->free(box);
+	ps->free(floor_shape);
+	ps->free(space);
+
+	_restart_thread_pool(-1);
+	return hashes;
+}
+
+TEST_CASE("[SceneTree][Physics3D] Deterministic space gives the same state hashes with any thread count") {
+	Vector<int64_t> single_thread = _simulate_3d(0);
+	Vector<int64_t> multi_thread = _simulate_3d(4);
+
+	REQUIRE(single_thread.size() == step_count);
+	REQUIRE(multi_thread.size() == step_count);
+	// The scene changes, so matching hashes mean matching states.
+	CHECK(single_thread[0] != single_thread[step_count - 1]);
+	for (int i = 0; i < step_count; i++) {
+		CHECK_MESSAGE(single_thread[i] == multi_thread[i], vformat("State hashes diverged at step %d.", i));
+	}
+}
+
+TEST_CASE("[SceneTree][Physics2D] Deterministic space gives the same state hashes with any thread count") {
+	Vector<int64_t> single_thread = _simulate_2d(0);
+	Vector<int64_t> multi_thread = _simulate_2d(4);
+
+	REQUIRE(single_thread.size() == step_count);
+	REQUIRE(multi_thread.size() == step_count);
+	CHECK(single_thread[0] != single_thread[step_count - 1]);
+	for (int i = 0; i < step_count; i++) {
+		CHECK_MESSAGE(single_thread[i] == multi_thread[i], vformat("State hashes diverged at step %d.", i));
+	}
+}
+
+} // namespace TestPhysicsDeterminism
+
+#endif // TEST_PHYSICS_DETERMINISM_H
@@ -0,0 +1,216 @@
+/*************************************************************************/
+/*  test_physics_heightmap.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_HEIGHTMAP_H
+#define TEST_PHYSICS_HEIGHTMAP_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_collision_solver_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsHeightmap {
+
+static Vector<real_t> _make_heights(int p_width, int p_depth, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	Vector<real_t> heights;
+	heights.resize(p_width * p_depth);
+	real_t *w = heights.ptrw();
+	for (int z = 0; z < p_depth; z++) {
+		for (int x = 0; x < p_width; x++) {
+			// Rolling hills with some noise, so that rays pass both above and below nodes.
+			w[z * p_width + x] = Math::sin(x * 0.1) * Math::cos(z * 0.13) * 8.0 + rng.random(-0.5f, 0.5f);
+		}
+	}
+	return heights;
+}
+
+static void _setup_heightmap(GodotHeightMapShape3D &p_shape, int p_width, int p_depth, const Vector<real_t> &p_heights) {
+	Dictionary data;
+	data["width"] = p_width;
+	data["depth"] = p_depth;
+	data["heights"] = p_heights;
+	p_shape.set_data(data);
+}
+
+struct BruteForceRay {
+	Vector3 begin;
+	Vector3 end;
+	bool hit = false;
+	Vector3 point;
+};
+
+static bool _brute_force_face(void *p_userdata, GodotShape3D *p_face) {
+	BruteForceRay &ray = *(BruteForceRay *)p_userdata;
+	Vector3 point, normal;
+	if (p_face->intersect_segment(ray.begin, ray.end, point, normal, false)) {
+		if (!ray.hit || ray.begin.distance_squared_to(point) < ray.begin.distance_squared_to(ray.point)) {
+			ray.point = point;
+		}
+		ray.hit = true;
+	}
+	return false;
+}
+
+// Tests the segment against every triangle of the heightmap.
+static bool _brute_force_intersect(const GodotHeightMapShape3D &p_shape, const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point) {
+	BruteForceRay ray;
+	ray.begin = p_begin;
+	ray.end = p_end;
+	p_shape.cull(p_shape.get_aabb(), _brute_force_face, &ray, false);
+	r_point = ray.point;
+	return ray.hit;
+}
+
+static void _check_rays_match_brute_force(const GodotHeightMapShape3D &p_shape, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	const AABB aabb = p_shape.get_aabb();
+	int mismatches = 0;
+	int hits = 0;
+	for (int i = 0; i < 500; i++) {
+		Vector3 begin = aabb.position + Vector3(rng.randf(), 0, rng.randf()) * aabb.size + Vector3(0, aabb.size.y + rng.random(0.0f, 4.0f), 0);
+		Vector3 end = aabb.position + Vector3(rng.randf(), rng.randf(), rng.randf()) * aabb.size;
+
+		Vector3 point, normal, brute_force_point;
+		bool hit = p_shape.intersect_segment(begin, end, point, normal, false);
+		bool brute_force_hit = _brute_force_intersect(p_shape, begin, end, brute_force_point);
+		// The quadtree tests clipped segments, so grazing rays can land slightly apart.
+		if (hit != brute_force_hit || (hit && point.distance_to(brute_force_point) > 0.001)) {
+			mismatches++;
+		}
+		hits += hit ? 1 : 0;
+	}
+	CHECK(hits > 0);
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("[Physics3D] Heightmap rays match a brute-force search") {
+	// Sizes that don't divide evenly into the quadtree leaves.
+	const int sizes[][2] = { { 2, 2 }, { 5, 5 }, { 37, 23 }, { 64, 64 }, { 129, 65 } };
+	for (int i = 0; i < 5; i++) {
+		GodotHeightMapShape3D shape;
+		_setup_heightmap(shape, sizes[i][0], sizes[i][1], _make_heights(sizes[i][0], sizes[i][1], i + 1));
+		_check_rays_match_brute_force(shape, i + 100);
+	}
+}
+
+TEST_CASE("[Physics3D] Heightmap region updates") {
+	const int size = 65;
+	GodotHeightMapShape3D shape;
+	_setup_heightmap(shape, size, size, _make_heights(size, size, 3));
+
+	Vector3 begin(0, 50, 0);
+	Vector3 end(0, -50, 0);
+	Vector3 point, normal;
+	REQUIRE(shape.intersect_segment(begin, end, point, normal, false));
+	CHECK(point.y < 10);
+
+	// Raise a plateau in the middle of the heightmap, above the current bounds.
+	Vector<real_t> plateau;
+	plateau.resize(8 * 8);
+	plateau.fill(20.0);
+	Dictionary data;
+	data["width"] = size;
+	data["depth"] = size;
+	data["heights"] = plateau;
+	data["region"] = Rect2i(28, 28, 8, 8);
+	shape.set_data(data);
+
+	CHECK(shape.get_aabb().size.y + shape.get_aabb().position.y == doctest::Approx(20.0));
+	REQUIRE(shape.intersect_segment(begin, end, point, normal, false));
+	CHECK(point.y == doctest::Approx(20.0));
+
+	// A long ray across the heightmap has to descend into the updated nodes.
+	REQUIRE(shape.intersect_segment(Vector3(-32, 19, -32), Vector3(32, 19, 32), point, normal, false));
+	CHECK(point.y == doctest::Approx(19.0));
+
+	_check_rays_match_brute_force(shape, 7);
+}
+
+// Benchmarks, run with --no-skip to print timings.
+
+TEST_CASE("[Physics3D][Benchmark] Heightmap ray casts" * doctest::skip()) {
+	const int size = 2049;
+	GodotHeightMapShape3D shape;
+	_setup_heightmap(shape, size, size, _make_heights(size, size, 5));
+	const AABB aabb = shape.get_aabb();
+
+	RandomPCG rng(11);
+	LocalVector<Vector3> points;
+	for (int i = 0; i < 10000; i++) {
+		points.push_back(aabb.position + Vector3(rng.randf(), rng.random(1.0f, 1.5f), rng.randf()) * aabb.size);
+		points.push_back(aabb.position + Vector3(rng.randf(), rng.random(-0.5f, 1.0f), rng.randf()) * aabb.size);
+	}
+
+	int hits = 0;
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < points.size(); i += 2) {
+		Vector3 point, normal;
+		hits += shape.intersect_segment(points[i], points[i + 1], point, normal, false) ? 1 : 0;
+	}
+	const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("Heightmap ray casts: %d usec for %d rays, %d hits", elapsed, points.size() / 2, hits));
+}
+
+static void _contact_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, void *p_userdata) {
+	(*(uint64_t *)p_userdata)++;
+}
+
+TEST_CASE("[Physics3D][Benchmark] Bodies resting on a heightmap" * doctest::skip()) {
+	const int size = 2049;
+	GodotHeightMapShape3D shape;
+	_setup_heightmap(shape, size, size, _make_heights(size, size, 5));
+
+	GodotBoxShape3D box;
+	box.set_data(Vector3(1, 1, 1));
+
+	// Boxes just over the surface, as they would be while resting on the terrain.
+	RandomPCG rng(13);
+	LocalVector<Transform3D> xforms;
+	for (int i = 0; i < 10000; i++) {
+		Vector3 origin(rng.random(-1000.0f, 1000.0f), 0, rng.random(-1000.0f, 1000.0f));
+		Vector3 point, normal;
+		shape.intersect_segment(origin + Vector3(0, 100, 0), origin - Vector3(0, 100, 0), point, normal, false);
+		xforms.push_back(Transform3D(Basis(), point + Vector3(0, 0.9, 0)));
+	}
+
+	uint64_t contacts = 0;
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < xforms.size(); i++) {
+		GodotCollisionSolver3D::solve_static(&box, xforms[i], &shape, Transform3D(), _contact_callback, &contacts);
+	}
+	const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("Heightmap contacts: %d usec for %d boxes, %d contacts", elapsed, xforms.size(), contacts));
+}
+
+} // namespace TestPhysicsHeightmap
+
+#endif // TEST_PHYSICS_HEIGHTMAP_H
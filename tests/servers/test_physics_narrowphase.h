@@ -0,0 +1,239 @@
+/*************************************************************************/
+/*  test_physics_narrowphase.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_NARROWPHASE_H
+#define TEST_PHYSICS_NARROWPHASE_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_collision_solver_3d.h"
+#include "servers/physics_3d/godot_simd_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsNarrowphase {
+
+static Vector3 _random_vector(RandomPCG &p_rng) {
+	return Vector3(p_rng.random(-1.0f, 1.0f), p_rng.random(-1.0f, 1.0f), p_rng.random(-1.0f, 1.0f));
+}
+
+static Transform3D _random_transform(RandomPCG &p_rng, real_t p_distance) {
+	Vector3 axis = _random_vector(p_rng) + Vector3(0, 0, 0.1);
+	Basis basis(axis.normalized(), p_rng.random(0.0f, (float)Math_TAU));
+	Vector3 direction = _random_vector(p_rng) + Vector3(0.1, 0, 0);
+	return Transform3D(basis, direction.normalized() * p_distance);
+}
+
+TEST_CASE("[Physics3D] Narrowphase kernels match the scalar path") {
+	RandomPCG rng(1234);
+	Vector3 points[40];
+	Vector3 axes[15];
+	real_t min[15], max[15], scalar_min[15], scalar_max[15];
+
+	// Counts on both sides of the vector width, with a tail.
+	for (int count = 1; count <= 40; count++) {
+		for (int i = 0; i < count; i++) {
+			points[i] = _random_vector(rng) * 10;
+		}
+		Vector3 axis = _random_vector(rng).normalized();
+
+		GodotSIMD3D::project_points(points, count, axis, min[0], max[0]);
+		GodotSIMD3D::project_points_scalar(points, count, axis, scalar_min[0], scalar_max[0]);
+		CHECK(Math::is_equal_approx(min[0], scalar_min[0]));
+		CHECK(Math::is_equal_approx(max[0], scalar_max[0]));
+
+		int support = GodotSIMD3D::support_point(points, count, axis);
+		int scalar_support = GodotSIMD3D::support_point_scalar(points, count, axis);
+		CHECK(Math::is_equal_approx(axis.dot(points[support]), axis.dot(points[scalar_support])));
+		CHECK(Math::is_equal_approx(axis.dot(points[support]), scalar_max[0]));
+	}
+
+	for (int axis_count = 1; axis_count <= 15; axis_count++) {
+		for (int i = 0; i < axis_count; i++) {
+			axes[i] = _random_vector(rng).normalized();
+		}
+		Transform3D xform = _random_transform(rng, 5);
+		Vector3 half_extents(1, 2, 3);
+
+		GodotSIMD3D::project_box(half_extents, xform, axes, axis_count, min, max);
+		GodotSIMD3D::project_box_scalar(half_extents, xform, axes, axis_count, scalar_min, scalar_max);
+		for (int i = 0; i < axis_count; i++) {
+			CHECK(Math::is_equal_approx(min[i], scalar_min[i]));
+			CHECK(Math::is_equal_approx(max[i], scalar_max[i]));
+		}
+	}
+}
+
+static PackedVector3Array _box_points(const Vector3 &p_half_extents) {
+	PackedVector3Array points;
+	for (int i = 0; i < 8; i++) {
+		points.push_back(Vector3((i & 1) ? p_half_extents.x : -p_half_extents.x, (i & 2) ? p_half_extents.y : -p_half_extents.y, (i & 4) ? p_half_extents.z : -p_half_extents.z));
+	}
+	return points;
+}
+
+TEST_CASE("[Physics3D] Box SAT agrees with the convex polygon path") {
+	GodotBoxShape3D box;
+	box.set_data(Vector3(1, 1, 1));
+	GodotConvexPolygonShape3D convex_box;
+	convex_box.set_data(_box_points(Vector3(1, 1, 1)));
+
+	// Boxes of half size 1 always overlap closer than 2, and never further than 2 * sqrt(3).
+	RandomPCG rng(42);
+	for (int i = 0; i < 100; i++) {
+		bool overlapping = (i % 2) == 0;
+		Transform3D xform_b = _random_transform(rng, overlapping ? 1.5 : 3.6);
+
+		bool box_box = GodotCollisionSolver3D::solve_static(&box, Transform3D(), &box, xform_b, nullptr, nullptr);
+		bool box_convex = GodotCollisionSolver3D::solve_static(&box, Transform3D(), &convex_box, xform_b, nullptr, nullptr);
+		bool convex_convex = GodotCollisionSolver3D::solve_static(&convex_box, Transform3D(), &convex_box, xform_b, nullptr, nullptr);
+		CHECK(box_box == overlapping);
+		CHECK(box_convex == overlapping);
+		CHECK(convex_convex == overlapping);
+	}
+}
+
+TEST_CASE("[Physics3D] Time of impact of moving convex shapes") {
+	GodotBoxShape3D box;
+	box.set_data(Vector3(0.5, 0.5, 0.5));
+	GodotBoxShape3D thin_wall;
+	thin_wall.set_data(Vector3(5, 5, 0.01));
+	const real_t tolerance = 0.001;
+
+	GodotCollisionSolver3D::ShapeMotion still;
+	GodotCollisionSolver3D::ShapeMotion motion;
+	motion.linear = Vector3(0, 0, 20);
+
+	// Passes through the wall in one motion, touching it at z = 4.49.
+	real_t toi = 1.0;
+	Transform3D wall_xform(Basis(), Vector3(0, 0, 5));
+	REQUIRE(GodotCollisionSolver3D::solve_time_of_impact(&box, Transform3D(), motion, &thin_wall, wall_xform, still, tolerance, toi));
+	CHECK(toi * 20 == doctest::Approx(4.49).epsilon(0.01));
+	CHECK(toi * 20 <= 4.49);
+
+	// Same with the wall moving towards the box.
+	GodotCollisionSolver3D::ShapeMotion wall_motion;
+	wall_motion.linear = Vector3(0, 0, -20);
+	wall_motion.pivot = wall_xform.origin;
+	REQUIRE(GodotCollisionSolver3D::solve_time_of_impact(&box, Transform3D(), motion, &thin_wall, wall_xform, wall_motion, tolerance, toi));
+	CHECK(toi * 40 == doctest::Approx(4.49).epsilon(0.01));
+
+	// Moving away, or not far enough.
+	motion.linear = Vector3(0, 0, -20);
+	CHECK_FALSE(GodotCollisionSolver3D::solve_time_of_impact(&box, Transform3D(), motion, &thin_wall, wall_xform, still, tolerance, toi));
+	motion.linear = Vector3(0, 0, 4);
+	CHECK_FALSE(GodotCollisionSolver3D::solve_time_of_impact(&box, Transform3D(), motion, &thin_wall, wall_xform, still, tolerance, toi));
+
+	// A long thin box spinning without moving sweeps through the wall next to it.
+	GodotBoxShape3D stick;
+	stick.set_data(Vector3(0.05, 0.05, 2));
+	GodotCollisionSolver3D::ShapeMotion spin;
+	spin.angular = Vector3(0, Math_PI * 0.5, 0);
+	Transform3D side_wall_xform(Basis(Vector3(0, 1, 0), Math_PI * 0.5), Vector3(1.5, 0, 0));
+	REQUIRE(GodotCollisionSolver3D::solve_time_of_impact(&stick, Transform3D(), spin, &thin_wall, side_wall_xform, still, tolerance, toi));
+	CHECK(toi > 0.0);
+	CHECK(toi < 1.0);
+	Transform3D stick_at_toi(Basis(spin.angular.normalized(), spin.angular.length() * toi), Vector3());
+	CHECK_FALSE(GodotCollisionSolver3D::solve_static(&stick, stick_at_toi, &thin_wall, side_wall_xform, nullptr, nullptr));
+}
+
+TEST_CASE("[Physics3D] Time of impact against a concave shape") {
+	GodotSphereShape3D sphere;
+	sphere.set_data(0.25);
+	GodotConcavePolygonShape3D floor;
+	Vector<Vector3> faces;
+	faces.push_back(Vector3(-10, 0, -10));
+	faces.push_back(Vector3(10, 0, -10));
+	faces.push_back(Vector3(-10, 0, 10));
+	faces.push_back(Vector3(10, 0, -10));
+	faces.push_back(Vector3(10, 0, 10));
+	faces.push_back(Vector3(-10, 0, 10));
+	Dictionary data;
+	data["faces"] = faces;
+	data["backface_collision"] = false;
+	floor.set_data(data);
+
+	GodotCollisionSolver3D::ShapeMotion still;
+	GodotCollisionSolver3D::ShapeMotion fall;
+	fall.linear = Vector3(0, -10, 0);
+	fall.pivot = Vector3(0, 2.25, 0);
+
+	real_t toi = 1.0;
+	REQUIRE(GodotCollisionSolver3D::solve_time_of_impact(&sphere, Transform3D(Basis(), Vector3(0, 2.25, 0)), fall, &floor, Transform3D(), still, 0.001, toi));
+	CHECK(toi * 10 == doctest::Approx(2.0).epsilon(0.01));
+}
+
+// Benchmarks, run with --no-skip to print timings.
+
+static void _contact_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, void *p_userdata) {
+	(*(uint64_t *)p_userdata)++;
+}
+
+static void _benchmark_contacts(const char *p_name, const GodotShape3D *p_shape_a, const GodotShape3D *p_shape_b, int p_passes) {
+	RandomPCG rng(7);
+	LocalVector<Transform3D> xforms;
+	for (int i = 0; i < 1024; i++) {
+		xforms.push_back(_random_transform(rng, rng.random(1.0f, 2.5f)));
+	}
+
+	uint64_t contacts = 0;
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int pass = 0; pass < p_passes; pass++) {
+		for (uint32_t i = 0; i < xforms.size(); i++) {
+			GodotCollisionSolver3D::solve_static(p_shape_a, Transform3D(), p_shape_b, xforms[i], _contact_callback, &contacts);
+		}
+	}
+	const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line(vformat("%s: %d usec for %d pairs, %d contacts (vectorized: %s)", p_name, elapsed, xforms.size() * p_passes, contacts, GodotSIMD3D::is_vectorized()));
+}
+
+TEST_CASE("[Physics3D][Benchmark] Contact generation" * doctest::skip()) {
+	GodotBoxShape3D box;
+	box.set_data(Vector3(1, 1, 1));
+
+	// A rounded hull with enough vertices for the point kernels to matter.
+	PackedVector3Array points;
+	for (int i = 0; i < 64; i++) {
+		real_t phi = Math::acos(1 - 2 * (i + 0.5) / 64);
+		real_t theta = Math_PI * (1 + Math::sqrt(5.0)) * i;
+		points.push_back(Vector3(Math::cos(theta) * Math::sin(phi), Math::sin(theta) * Math::sin(phi), Math::cos(phi)));
+	}
+	GodotConvexPolygonShape3D hull;
+	hull.set_data(points);
+
+	// Hull pairs test every edge pair as a separating axis, so they get fewer passes.
+	_benchmark_contacts("Box-box", &box, &box, 100);
+	_benchmark_contacts("Box-convex", &box, &hull, 10);
+	_benchmark_contacts("Convex-convex", &hull, &hull, 1);
+}
+
+} // namespace TestPhysicsNarrowphase
+
+#endif // TEST_PHYSICS_NARROWPHASE_H
@@ -0,0 +1,216 @@
+/*************************************************************************/
+/*  test_physics_queries.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_QUERIES_H
+#define TEST_PHYSICS_QUERIES_H
+
+#include "servers/physics_server_2d.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsQueries {
+
+// Enough rays to go through the worker threads, aimed at static spheres (or circles) placed along the X axis.
+static const int ray_count = 200;
+static const int target_count = 3;
+static const real_t target_spacing = 5;
+
+TEST_CASE("[SceneTree][Physics3D] Batched ray and shape queries") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	RID sphere = ps->sphere_shape_create();
+	ps->shape_set_data(sphere, 1.0);
+
+	Vector<RID> bodies;
+	for (int i = 0; i < target_count; i++) {
+		RID body = ps->body_create();
+		ps->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+		ps->body_add_shape(body, sphere);
+		ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i * target_spacing, 0, 0)));
+		ps->body_set_space(body, space);
+		bodies.push_back(body);
+	}
+
+	PhysicsDirectSpaceState3D *state = ps->space_get_direct_state(space);
+	REQUIRE(state);
+
+	// Every fourth ray passes between the spheres.
+	PackedVector3Array segments;
+	for (int i = 0; i < ray_count; i++) {
+		real_t x = (i % 4 == 3) ? target_spacing * 0.5 : (i % target_count) * target_spacing;
+		segments.push_back(Vector3(x, 0, -10 - i * 0.01));
+		segments.push_back(Vector3(x, 0, 10));
+	}
+
+	PhysicsDirectSpaceState3D::RayParameters parameters;
+	Vector<PhysicsDirectSpaceState3D::RayResult> results;
+	results.resize(ray_count);
+	state->intersect_rays(parameters, segments.ptr(), ray_count, results.ptrw());
+
+	int hits = 0;
+	for (int i = 0; i < ray_count; i++) {
+		PhysicsDirectSpaceState3D::RayResult expected;
+		parameters.from = segments[i * 2 + 0];
+		parameters.to = segments[i * 2 + 1];
+		bool hit = state->intersect_ray(parameters, expected);
+		CHECK(results[i].rid.is_valid() == hit);
+		if (hit) {
+			hits++;
+			CHECK(results[i].rid == expected.rid);
+			CHECK(results[i].position.is_equal_approx(expected.position));
+			CHECK(results[i].position.distance_to(Vector3(segments[i * 2].x, 0, -1)) < 0.001);
+		}
+	}
+	CHECK(hits == ray_count - ray_count / 4);
+
+	Ref<PhysicsRayQueryParameters3D> ray_query;
+	ray_query.instantiate();
+	Dictionary rays = state->call("intersect_rays", ray_query, segments);
+	PackedInt32Array shapes = rays["shape"];
+	REQUIRE(shapes.size() == ray_count);
+	CHECK(shapes[0] == 0);
+	CHECK(shapes[3] == -1);
+
+	Ref<PhysicsShapeQueryParameters3D> shape_query;
+	shape_query.instantiate();
+	shape_query->set_shape_rid(sphere);
+	PackedVector3Array origins;
+	origins.push_back(Vector3(0, 0, 0));
+	origins.push_back(Vector3(target_spacing * 0.5, 0, 0));
+	origins.push_back(Vector3(target_spacing * 2, 0.5, 0));
+	Dictionary overlaps = state->call("intersect_shapes", shape_query, origins);
+	PackedInt32Array counts = overlaps["count"];
+	REQUIRE(counts.size() == 3);
+	CHECK(counts[0] == 1);
+	CHECK(counts[1] == 0);
+	CHECK(counts[2] == 1);
+	CHECK(PackedInt64Array(overlaps["collider_id"]).size() == 2);
+
+	// An invalid shape fails every query, which must not leave the counts unset.
+	shape_query->set_shape_rid(RID());
+	ERR_PRINT_OFF;
+	overlaps = state->call("intersect_shapes", shape_query, origins);
+	ERR_PRINT_ON;
+	counts = overlaps["count"];
+	REQUIRE(counts.size() == 3);
+	CHECK(counts[0] == 0);
+	CHECK(counts[2] == 0);
+	CHECK(PackedInt64Array(overlaps["collider_id"]).size() == 0);
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(sphere);
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics2D] Batched ray and shape queries") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID space = ps->space_create();
+	RID circle = ps->circle_shape_create();
+	ps->shape_set_data(circle, 1.0);
+
+	Vector<RID> bodies;
+	for (int i = 0; i < target_count; i++) {
+		RID body = ps->body_create();
+		ps->body_set_mode(body, PhysicsServer2D::BODY_MODE_STATIC);
+		ps->body_add_shape(body, circle);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(i * target_spacing, 0)));
+		ps->body_set_space(body, space);
+		bodies.push_back(body);
+	}
+
+	PhysicsDirectSpaceState2D *state = ps->space_get_direct_state(space);
+	REQUIRE(state);
+
+	PackedVector2Array segments;
+	for (int i = 0; i < ray_count; i++) {
+		real_t x = (i % 4 == 3) ? target_spacing * 0.5 : (i % target_count) * target_spacing;
+		segments.push_back(Vector2(x, -10 - i * 0.01));
+		segments.push_back(Vector2(x, 10));
+	}
+
+	PhysicsDirectSpaceState2D::RayParameters parameters;
+	Vector<PhysicsDirectSpaceState2D::RayResult> results;
+	results.resize(ray_count);
+	state->intersect_rays(parameters, segments.ptr(), ray_count, results.ptrw());
+
+	int hits = 0;
+	for (int i = 0; i < ray_count; i++) {
+		PhysicsDirectSpaceState2D::RayResult expected;
+		parameters.from = segments[i * 2 + 0];
+		parameters.to = segments[i * 2 + 1];
+		bool hit = state->intersect_ray(parameters, expected);
+		CHECK(results[i].rid.is_valid() == hit);
+		if (hit) {
+			hits++;
+			CHECK(results[i].rid == expected.rid);
+			CHECK(results[i].position.is_equal_approx(expected.position));
+			CHECK(results[i].position.distance_to(Vector2(segments[i * 2].x, -1)) < 0.001);
+		}
+	}
+	CHECK(hits == ray_count - ray_count / 4);
+
+	Ref<PhysicsShapeQueryParameters2D> shape_query;
+	shape_query.instantiate();
+	shape_query->set_shape_rid(circle);
+	PackedVector2Array origins;
+	origins.push_back(Vector2(0, 0));
+	origins.push_back(Vector2(target_spacing * 0.5, 0));
+	origins.push_back(Vector2(target_spacing * 2, 0.5));
+	Dictionary overlaps = state->call("intersect_shapes", shape_query, origins);
+	PackedInt32Array counts = overlaps["count"];
+	REQUIRE(counts.size() == 3);
+	CHECK(counts[0] == 1);
+	CHECK(counts[1] == 0);
+	CHECK(counts[2] == 1);
+
+	// An invalid shape fails every query, which must not leave the counts unset.
+	shape_query->set_shape_rid(RID());
+	ERR_PRINT_OFF;
+	overlaps = state->call("intersect_shapes", shape_query, origins);
+	ERR_PRINT_ON;
+	counts = overlaps["count"];
+	REQUIRE(counts.size() == 3);
+	CHECK(counts[0] == 0);
+	CHECK(counts[2] == 0);
+	CHECK(PackedInt64Array(overlaps["collider_id"]).size() == 0);
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(circle);
+	ps->free(space);
+}
+
+} // namespace TestPhysicsQueries
+
+#endif // TEST_PHYSICS_QUERIES_H
@@ -0,0 +1,389 @@
+/*************************************************************************/
+/*  test_physics_snapshot.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_SNAPSHOT_H
+#define TEST_PHYSICS_SNAPSHOT_H
+
+#include "core/os/os.h"
+#include "servers/physics_server_2d.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsSnapshot {
+
+const int snapshot_step = 60;
+const int resimulated_steps = 30;
+
+// Stacks of boxes settling on the floor. The contacts between them stay the same
+// after the snapshot, so resimulating has to restore their warm started impulses.
+TEST_CASE("[SceneTree][Physics3D] Restoring a space snapshot resimulates the same steps") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->space_set_deterministic(space, true);
+
+	RID floor_shape = ps->box_shape_create();
+	ps->shape_set_data(floor_shape, Vector3(50, 1, 50));
+	RID floor = ps->body_create();
+	ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -1, 0)));
+	ps->body_set_space(floor, space);
+
+	RID box = ps->box_shape_create();
+	ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+	Vector<RID> bodies;
+	for (int stack = 0; stack < 10; stack++) {
+		for (int i = 0; i < 5; i++) {
+			RID body = ps->body_create();
+			ps->body_add_shape(body, box);
+			ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(stack * 2, 0.5 + i * 1.05, 0)));
+			ps->body_set_space(body, space);
+			bodies.push_back(body);
+		}
+	}
+
+	for (int i = 0; i < snapshot_step; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	Vector<uint8_t> snapshot = ps->space_save_snapshot(space);
+	const int64_t snapshot_hash = ps->space_get_state_hash(space);
+	CHECK(snapshot.size() > 0);
+
+	Vector<int64_t> hashes;
+	for (int i = 0; i < resimulated_steps; i++) {
+		ps->step(1.0 / 60.0);
+		hashes.push_back(ps->space_get_state_hash(space));
+	}
+	CHECK(hashes[resimulated_steps - 1] != snapshot_hash);
+
+	CHECK(ps->space_restore_snapshot(space, snapshot));
+	CHECK(ps->space_get_state_hash(space) == snapshot_hash);
+
+	for (int i = 0; i < resimulated_steps; i++) {
+		ps->step(1.0 / 60.0);
+		CHECK_MESSAGE(ps->space_get_state_hash(space) == hashes[i], vformat("State hashes diverged at resimulated step %d.", i));
+	}
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(floor);
+	ps->free(box);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics2D] Restoring a space snapshot resimulates the same steps") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->space_set_deterministic(space, true);
+
+	RID floor_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(floor_shape, Vector2(500, 10));
+	RID floor = ps->body_create();
+	ps->body_set_mode(floor, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_state(floor, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, 10)));
+	ps->body_set_space(floor, space);
+
+	RID box = ps->rectangle_shape_create();
+	ps->shape_set_data(box, Vector2(5, 5));
+	Vector<RID> bodies;
+	for (int stack = 0; stack < 10; stack++) {
+		for (int i = 0; i < 5; i++) {
+			RID body = ps->body_create();
+			ps->body_add_shape(body, box);
+			ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(stack * 20 - 100, -5.5 - i * 10.5)));
+			ps->body_set_space(body, space);
+			bodies.push_back(body);
+		}
+	}
+
+	for (int i = 0; i < snapshot_step; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	Vector<uint8_t> snapshot = ps->space_save_snapshot(space);
+	const int64_t snapshot_hash = ps->space_get_state_hash(space);
+	CHECK(snapshot.size() > 0);
+
+	Vector<int64_t> hashes;
+	for (int i = 0; i < resimulated_steps; i++) {
+		ps->step(1.0 / 60.0);
+		hashes.push_back(ps->space_get_state_hash(space));
+	}
+
+	CHECK(ps->space_restore_snapshot(space, snapshot));
+	CHECK(ps->space_get_state_hash(space) == snapshot_hash);
+
+	for (int i = 0; i < resimulated_steps; i++) {
+		ps->step(1.0 / 60.0);
+		CHECK_MESSAGE(ps->space_get_state_hash(space) == hashes[i], vformat("State hashes diverged at resimulated step %d.", i));
+	}
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(floor);
+	ps->free(box);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+// A box resting on the floor is launched after the snapshot, and has left the floor by the
+// time the snapshot is restored. Their pair is created again in the first resimulated step,
+// which has to warm start from the contacts in the snapshot like the first run did.
+TEST_CASE("[SceneTree][Physics3D] Restoring a space snapshot brings back the contacts of separated pairs") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->space_set_deterministic(space, true);
+
+	RID floor_shape = ps->box_shape_create();
+	ps->shape_set_data(floor_shape, Vector3(50, 1, 50));
+	RID floor = ps->body_create();
+	ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -1, 0)));
+	ps->body_set_space(floor, space);
+
+	RID box_shape = ps->box_shape_create();
+	ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+	RID box = ps->body_create();
+	ps->body_add_shape(box, box_shape);
+	ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 0.5, 0)));
+	ps->body_set_space(box, space);
+
+	for (int i = 0; i < snapshot_step; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	Vector<uint8_t> snapshot = ps->space_save_snapshot(space);
+	// High enough to leave the floor's broadphase AABB, which is grown by 5% of its size.
+	const Vector3 launch_velocity(0, 16, 0);
+
+	Vector<int64_t> hashes;
+	ps->body_set_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, launch_velocity);
+	for (int i = 0; i < resimulated_steps; i++) {
+		ps->step(1.0 / 60.0);
+		hashes.push_back(ps->space_get_state_hash(space));
+	}
+	CHECK(ps->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS) == 0);
+
+	CHECK(ps->space_restore_snapshot(space, snapshot));
+	ps->body_set_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, launch_velocity);
+	for (int i = 0; i < resimulated_steps; i++) {
+		ps->step(1.0 / 60.0);
+		CHECK_MESSAGE(ps->space_get_state_hash(space) == hashes[i], vformat("State hashes diverged at resimulated step %d.", i));
+	}
+
+	ps->free(box);
+	ps->free(floor);
+	ps->free(box_shape);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics2D] Restoring a space snapshot brings back the contacts of separated pairs") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->space_set_deterministic(space, true);
+
+	RID floor_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(floor_shape, Vector2(500, 10));
+	RID floor = ps->body_create();
+	ps->body_set_mode(floor, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_state(floor, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, 10)));
+	ps->body_set_space(floor, space);
+
+	RID box_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(box_shape, Vector2(5, 5));
+	RID box = ps->body_create();
+	ps->body_add_shape(box, box_shape);
+	ps->body_set_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, -5)));
+	ps->body_set_space(box, space);
+
+	for (int i = 0; i < snapshot_step; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	Vector<uint8_t> snapshot = ps->space_save_snapshot(space);
+	const Vector2 launch_velocity(0, -600);
+
+	Vector<int64_t> hashes;
+	ps->body_set_state(box, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, launch_velocity);
+	for (int i = 0; i < resimulated_steps; i++) {
+		ps->step(1.0 / 60.0);
+		hashes.push_back(ps->space_get_state_hash(space));
+	}
+	CHECK(ps->get_process_info(PhysicsServer2D::INFO_COLLISION_PAIRS) == 0);
+
+	CHECK(ps->space_restore_snapshot(space, snapshot));
+	ps->body_set_state(box, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, launch_velocity);
+	for (int i = 0; i < resimulated_steps; i++) {
+		ps->step(1.0 / 60.0);
+		CHECK_MESSAGE(ps->space_get_state_hash(space) == hashes[i], vformat("State hashes diverged at resimulated step %d.", i));
+	}
+
+	ps->free(box);
+	ps->free(floor);
+	ps->free(box_shape);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics3D] Invalid space snapshots are rejected") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+
+	Vector<uint8_t> snapshot = ps->space_save_snapshot(space);
+	CHECK(ps->space_restore_snapshot(space, snapshot));
+
+	ERR_PRINT_OFF;
+	CHECK_FALSE(ps->space_restore_snapshot(space, Vector<uint8_t>()));
+	// Claims more bodies than it holds.
+	snapshot.write[4] = 0xFF;
+	CHECK_FALSE(ps->space_restore_snapshot(space, snapshot));
+	ERR_PRINT_ON;
+
+	ps->free(space);
+}
+
+// Benchmarks, run with --no-skip to print timings.
+
+const int benchmark_body_count = 10000;
+const int benchmark_iterations = 100;
+
+TEST_CASE("[SceneTree][Physics3D][Benchmark] Space snapshot of 10k bodies" * doctest::skip()) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID sphere = ps->sphere_shape_create();
+	ps->shape_set_data(sphere, 0.5);
+	Vector<RID> bodies;
+	for (int i = 0; i < benchmark_body_count; i++) {
+		RID body = ps->body_create();
+		ps->body_add_shape(body, sphere);
+		ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3((i % 100) * 2, (i / 1000) * 2, ((i / 100) % 10) * 2)));
+		ps->body_set_space(body, space);
+		bodies.push_back(body);
+	}
+	ps->step(1.0 / 60.0);
+
+	Vector<uint8_t> snapshot;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < benchmark_iterations; i++) {
+		snapshot = ps->space_save_snapshot(space);
+	}
+	const uint64_t save_usec = (OS::get_singleton()->get_ticks_usec() - begin) / benchmark_iterations;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < benchmark_iterations; i++) {
+		ps->space_restore_snapshot(space, snapshot);
+	}
+	const uint64_t restore_usec = (OS::get_singleton()->get_ticks_usec() - begin) / benchmark_iterations;
+
+	// What the same state costs to read through the body API.
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (const RID &body : bodies) {
+		ps->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		ps->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+		ps->body_get_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+		ps->body_get_state(body, PhysicsServer3D::BODY_STATE_SLEEPING);
+	}
+	const uint64_t query_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	print_line(vformat("%d bodies, %d bytes: save %d usec, restore %d usec, body_get_state %d usec", benchmark_body_count, snapshot.size(), save_usec, restore_usec, query_usec));
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(sphere);
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics2D][Benchmark] Space snapshot of 10k bodies" * doctest::skip()) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID circle = ps->circle_shape_create();
+	ps->shape_set_data(circle, 5.0);
+	Vector<RID> bodies;
+	for (int i = 0; i < benchmark_body_count; i++) {
+		RID body = ps->body_create();
+		ps->body_add_shape(body, circle);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2((i % 100) * 20, (i / 100) * 20)));
+		ps->body_set_space(body, space);
+		bodies.push_back(body);
+	}
+	ps->step(1.0 / 60.0);
+
+	Vector<uint8_t> snapshot;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < benchmark_iterations; i++) {
+		snapshot = ps->space_save_snapshot(space);
+	}
+	const uint64_t save_usec = (OS::get_singleton()->get_ticks_usec() - begin) / benchmark_iterations;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < benchmark_iterations; i++) {
+		ps->space_restore_snapshot(space, snapshot);
+	}
+	const uint64_t restore_usec = (OS::get_singleton()->get_ticks_usec() - begin) / benchmark_iterations;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (const RID &body : bodies) {
+		ps->body_get_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM);
+		ps->body_get_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY);
+		ps->body_get_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY);
+		ps->body_get_state(body, PhysicsServer2D::BODY_STATE_SLEEPING);
+	}
+	const uint64_t query_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	print_line(vformat("%d bodies, %d bytes: save %d usec, restore %d usec, body_get_state %d usec", benchmark_body_count, snapshot.size(), save_usec, restore_usec, query_usec));
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(circle);
+	ps->free(space);
+}
+
+} // namespace TestPhysicsSnapshot
+
+#endif // TEST_PHYSICS_SNAPSHOT_H
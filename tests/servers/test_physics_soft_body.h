@@ -0,0 +1,183 @@
+/*************************************************************************/
+/*  test_physics_soft_body.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_SOFT_BODY_H
+#define TEST_PHYSICS_SOFT_BODY_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_simd_3d.h"
+#include "servers/physics_3d/godot_soft_body_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsSoftBody {
+
+// Square cloth of p_side x p_side vertices with unit spacing, in the XZ plane.
+static void _create_cloth(GodotSoftBody3D &r_soft_body, int p_side) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z < p_side; z++) {
+		for (int x = 0; x < p_side; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	Vector<int> indices;
+	for (int z = 0; z < p_side - 1; z++) {
+		for (int x = 0; x < p_side - 1; x++) {
+			const int i = z * p_side + x;
+			indices.push_back(i);
+			indices.push_back(i + 1);
+			indices.push_back(i + p_side);
+			indices.push_back(i + 1);
+			indices.push_back(i + p_side + 1);
+			indices.push_back(i + p_side);
+		}
+	}
+
+	r_soft_body.create_from_trimesh(indices, vertices);
+}
+
+// Pushes the nodes apart with random impulses.
+static void _stretch_cloth(GodotSoftBody3D &r_soft_body) {
+	RandomPCG rng(4321);
+	for (uint32_t i = 0; i < r_soft_body.get_node_count(); i++) {
+		const Vector3 impulse(rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f));
+		r_soft_body.apply_node_impulse(i, impulse / r_soft_body.get_node_inv_mass(i));
+	}
+}
+
+TEST_CASE("[Physics3D] Soft body node integration kernels match the scalar path") {
+	RandomPCG rng(1234);
+	Vector3 a[23], b[23], result[23], scalar_result[23];
+	for (int i = 0; i < 23; i++) {
+		a[i] = Vector3(rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f));
+		b[i] = Vector3(rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f));
+	}
+
+	// Counts on both sides of the vector width, with a tail.
+	const int counts[] = { 1, 3, 4, 5, 8, 23 };
+	for (int count : counts) {
+		GodotSIMD3D::multiply_add(result, a, b, 0.25, count);
+		GodotSIMD3D::multiply_add_scalar(scalar_result, a, b, 0.25, count);
+		for (int i = 0; i < count; i++) {
+			CHECK(result[i].is_equal_approx(scalar_result[i]));
+		}
+
+		GodotSIMD3D::scaled_difference(result, a, b, 60.0, count);
+		GodotSIMD3D::scaled_difference_scalar(scalar_result, a, b, 60.0, count);
+		for (int i = 0; i < count; i++) {
+			CHECK(result[i].is_equal_approx(scalar_result[i]));
+		}
+	}
+
+	// In place, as used for the position update.
+	memcpy(result, a, sizeof(a));
+	memcpy(scalar_result, a, sizeof(a));
+	GodotSIMD3D::multiply_add(result, result, b, 0.5, 23);
+	GodotSIMD3D::multiply_add_scalar(scalar_result, scalar_result, b, 0.5, 23);
+	for (int i = 0; i < 23; i++) {
+		CHECK(result[i].is_equal_approx(scalar_result[i]));
+	}
+}
+
+TEST_CASE("[Physics3D] Soft body links pull a stretched cloth back") {
+	GodotSoftBody3D soft_body;
+	soft_body.set_linear_stiffness(1.0);
+	soft_body.set_iteration_count(20);
+	_create_cloth(soft_body, 8);
+	REQUIRE(soft_body.get_node_count() == 64);
+	CHECK(soft_body.get_link_batch_count() > 0);
+
+	_stretch_cloth(soft_body);
+	for (int i = 0; i < 60; i++) {
+		soft_body.solve_constraints(1.0 / 60.0);
+	}
+
+	// Neighbors along X and Z keep about their rest distance.
+	real_t max_error = 0.0;
+	for (int z = 0; z < 8; z++) {
+		for (int x = 0; x < 7; x++) {
+			const real_t along_x = soft_body.get_node_position(z * 8 + x).distance_to(soft_body.get_node_position(z * 8 + x + 1));
+			const real_t along_z = soft_body.get_node_position(x * 8 + z).distance_to(soft_body.get_node_position((x + 1) * 8 + z));
+			max_error = MAX(max_error, MAX(Math::abs(along_x - 1.0), Math::abs(along_z - 1.0)));
+		}
+	}
+	CHECK(max_error < 0.1);
+}
+
+TEST_CASE("[Physics3D] Soft body solve does not depend on the worker split") {
+	// Large enough for the link batches to be solved on the worker pool.
+	const int side = 40;
+	GodotSoftBody3D soft_body_a;
+	GodotSoftBody3D soft_body_b;
+	_create_cloth(soft_body_a, side);
+	_create_cloth(soft_body_b, side);
+
+	// Few colors are needed for a regular grid, so batches stay large.
+	CHECK(soft_body_a.get_link_batch_count() <= 32);
+
+	_stretch_cloth(soft_body_a);
+	_stretch_cloth(soft_body_b);
+	for (int i = 0; i < 10; i++) {
+		soft_body_a.solve_constraints(1.0 / 60.0);
+		soft_body_b.solve_constraints(1.0 / 60.0);
+	}
+
+	bool same = true;
+	for (uint32_t i = 0; i < soft_body_a.get_node_count(); i++) {
+		same = same && soft_body_a.get_node_position(i) == soft_body_b.get_node_position(i);
+	}
+	CHECK(same);
+}
+
+// Benchmark, run with --no-skip to print timings.
+
+TEST_CASE("[Physics3D][Benchmark] Soft body solve" * doctest::skip()) {
+	const int sides[] = { 16, 32, 48, 64 };
+	for (int side : sides) {
+		GodotSoftBody3D soft_body;
+		_create_cloth(soft_body, side);
+		_stretch_cloth(soft_body);
+
+		const int steps = 60;
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < steps; i++) {
+			soft_body.solve_constraints(1.0 / 60.0);
+		}
+		const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_line(vformat("%d nodes, %d link batches: %.3f ms/step", soft_body.get_node_count(), soft_body.get_link_batch_count(), elapsed / 1000.0 / steps));
+	}
+}
+
+} // namespace TestPhysicsSoftBody
+
+#endif // TEST_PHYSICS_SOFT_BODY_H
@@ -0,0 +1,307 @@
+/*************************************************************************/
+/*  test_physics_step.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_STEP_H
+#define TEST_PHYSICS_STEP_H
+
+#include "core/os/os.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsStep {
+
+static RID _create_floor(PhysicsServer3D *p_ps, RID p_space, RID p_shape) {
+	RID floor = p_ps->body_create();
+	p_ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	p_ps->body_add_shape(floor, p_shape);
+	p_ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -1, 0)));
+	p_ps->body_set_space(floor, p_space);
+	return floor;
+}
+
+// Stacks of unit cubes in a row along X, resting on each other.
+static void _create_box_stacks(PhysicsServer3D *p_ps, RID p_space, RID p_shape, int p_stack_count, int p_height, Vector<RID> &r_bodies) {
+	for (int stack = 0; stack < p_stack_count; stack++) {
+		for (int i = 0; i < p_height; i++) {
+			RID body = p_ps->body_create();
+			p_ps->body_add_shape(body, p_shape);
+			p_ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(stack * 2, 0.5 + i, 0)));
+			p_ps->body_set_space(body, p_space);
+			r_bodies.push_back(body);
+		}
+	}
+}
+
+TEST_CASE("[SceneTree][Physics3D] Stepping a large pile of bodies") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID floor_shape = ps->box_shape_create();
+	ps->shape_set_data(floor_shape, Vector3(50, 1, 50));
+	RID floor = _create_floor(ps, space, floor_shape);
+
+	// Enough touching spheres to go through the parallel broadphase pairing and pre-solve paths.
+	const int side = 12;
+	RID sphere = ps->sphere_shape_create();
+	ps->shape_set_data(sphere, 0.5);
+	Vector<RID> bodies;
+	for (int i = 0; i < side * side; i++) {
+		RID body = ps->body_create();
+		ps->body_add_shape(body, sphere);
+		ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i % side - side / 2, 0.5, i / side - side / 2)));
+		ps->body_set_space(body, space);
+		bodies.push_back(body);
+	}
+
+	for (int i = 0; i < 30; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	CHECK(ps->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS) >= bodies.size());
+	for (const RID &body : bodies) {
+		Transform3D xform = ps->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		CHECK(xform.origin.y > 0.4);
+		CHECK(xform.origin.y < 0.6);
+	}
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(floor);
+	ps->free(sphere);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics3D] Box stack stays up when stopping at the solver residual") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->space_set_param(space, PhysicsServer3D::SPACE_PARAM_SOLVER_RESIDUAL_THRESHOLD, 0.001);
+	CHECK(ps->space_get_param(space, PhysicsServer3D::SPACE_PARAM_SOLVER_RESIDUAL_THRESHOLD) == doctest::Approx(0.001));
+
+	RID floor_shape = ps->box_shape_create();
+	ps->shape_set_data(floor_shape, Vector3(50, 1, 50));
+	RID floor = _create_floor(ps, space, floor_shape);
+
+	const int height = 8;
+	RID box = ps->box_shape_create();
+	ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+	Vector<RID> bodies;
+	_create_box_stacks(ps, space, box, 1, height, bodies);
+
+	for (int i = 0; i < 120; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	for (int i = 0; i < height; i++) {
+		Transform3D xform = ps->body_get_state(bodies[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		CHECK(Math::abs(xform.origin.x) < 0.05);
+		CHECK(Math::abs(xform.origin.z) < 0.05);
+		CHECK(Math::abs(xform.origin.y - (0.5 + i)) < 0.1);
+	}
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(floor);
+	ps->free(box);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics3D] Sleeping bodies are not pair tested by the broadphase") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID floor_shape = ps->box_shape_create();
+	ps->shape_set_data(floor_shape, Vector3(50, 1, 50));
+	RID floor = _create_floor(ps, space, floor_shape);
+
+	// Static clutter that awake bodies would have to be tested against.
+	RID pillar_shape = ps->box_shape_create();
+	ps->shape_set_data(pillar_shape, Vector3(0.25, 2, 0.25));
+	Vector<RID> pillars;
+	for (int i = 0; i < 20; i++) {
+		for (int j = 0; j < 20; j++) {
+			RID pillar = ps->body_create();
+			ps->body_set_mode(pillar, PhysicsServer3D::BODY_MODE_STATIC);
+			ps->body_add_shape(pillar, pillar_shape);
+			ps->body_set_state(pillar, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i * 4 - 40, 2, j * 4 - 40 + 2)));
+			ps->body_set_space(pillar, space);
+			pillars.push_back(pillar);
+		}
+	}
+
+	RID box = ps->box_shape_create();
+	ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+	Vector<RID> bodies;
+	_create_box_stacks(ps, space, box, 5, 2, bodies);
+
+	for (int i = 0; i < 180; i++) {
+		ps->step(1.0 / 60.0);
+	}
+
+	// Everything is asleep, and the resting contacts are kept.
+	CHECK(ps->get_process_info(PhysicsServer3D::INFO_ACTIVE_OBJECTS) == 0);
+	CHECK(ps->get_process_info(PhysicsServer3D::INFO_BROADPHASE_PAIR_TESTS) == 0);
+	const int resting_pairs = ps->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS);
+	CHECK(resting_pairs >= bodies.size());
+	for (const RID &body : bodies) {
+		CHECK(bool(ps->body_get_state(body, PhysicsServer3D::BODY_STATE_SLEEPING)));
+	}
+
+	// Waking the top of a stack wakes the stack through its kept contacts. The push has
+	// to be well over the sleep threshold, or the box falls asleep again right away.
+	ps->body_apply_central_impulse(bodies[1], Vector3(0, 2, 0));
+	ps->step(1.0 / 60.0);
+	ps->step(1.0 / 60.0);
+	CHECK(ps->get_process_info(PhysicsServer3D::INFO_BROADPHASE_PAIR_TESTS) > 0);
+	CHECK(!bool(ps->body_get_state(bodies[0], PhysicsServer3D::BODY_STATE_SLEEPING)));
+
+	for (int i = 0; i < 60; i++) {
+		ps->step(1.0 / 60.0);
+	}
+	Transform3D xform = ps->body_get_state(bodies[1], PhysicsServer3D::BODY_STATE_TRANSFORM);
+	CHECK(Math::abs(xform.origin.y - 1.5) < 0.1);
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	for (const RID &pillar : pillars) {
+		ps->free(pillar);
+	}
+	ps->free(floor);
+	ps->free(box);
+	ps->free(pillar_shape);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+// A small box shot at a thin wall, crossing it in a single step at 30 Hz.
+static real_t _shoot_at_thin_wall(bool p_continuous_cd, const Vector3 &p_angular_velocity) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID wall_shape = ps->box_shape_create();
+	ps->shape_set_data(wall_shape, Vector3(0.01, 5, 5));
+	RID wall = ps->body_create();
+	ps->body_set_mode(wall, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_add_shape(wall, wall_shape);
+	ps->body_set_state(wall, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(5, 0, 0)));
+	ps->body_set_space(wall, space);
+
+	RID box = ps->box_shape_create();
+	ps->shape_set_data(box, Vector3(0.5, 0.1, 0.1));
+	RID body = ps->body_create();
+	ps->body_add_shape(body, box);
+	ps->body_set_param(body, PhysicsServer3D::BODY_PARAM_GRAVITY_SCALE, 0.0);
+	ps->body_set_enable_continuous_collision_detection(body, p_continuous_cd);
+	ps->body_set_space(body, space);
+	ps->body_set_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(200, 0, 0));
+	ps->body_set_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, p_angular_velocity);
+
+	for (int i = 0; i < 10; i++) {
+		ps->step(1.0 / 30.0);
+	}
+	Transform3D xform = ps->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+
+	ps->free(body);
+	ps->free(wall);
+	ps->free(box);
+	ps->free(wall_shape);
+	ps->free(space);
+	return xform.origin.x;
+}
+
+TEST_CASE("[SceneTree][Physics3D] Continuous collision detection stops fast bodies at thin walls") {
+	// Without it, the box tunnels through.
+	CHECK(_shoot_at_thin_wall(false, Vector3()) > 5.0);
+	CHECK(_shoot_at_thin_wall(true, Vector3()) < 5.0);
+	// Spinning fast, where casting from a single support point misses the wall.
+	CHECK(_shoot_at_thin_wall(true, Vector3(0, 40, 0)) < 5.0);
+}
+
+// Benchmarks, run with --no-skip to print timings.
+
+static void _benchmark_stacks(real_t p_residual_threshold, int p_iterations) {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	ps->space_set_param(space, PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS, p_iterations);
+	ps->space_set_param(space, PhysicsServer3D::SPACE_PARAM_SOLVER_RESIDUAL_THRESHOLD, p_residual_threshold);
+
+	RID floor_shape = ps->box_shape_create();
+	ps->shape_set_data(floor_shape, Vector3(100, 1, 100));
+	RID floor = _create_floor(ps, space, floor_shape);
+
+	const int height = 10;
+	RID box = ps->box_shape_create();
+	ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+	Vector<RID> bodies;
+	_create_box_stacks(ps, space, box, 40, height, bodies);
+
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < 300; i++) {
+		ps->step(1.0 / 60.0);
+	}
+	const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	// How far the stacks drifted from their initial layout.
+	real_t drift = 0.0;
+	for (int i = 0; i < bodies.size(); i++) {
+		Transform3D xform = ps->body_get_state(bodies[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		drift = MAX(drift, xform.origin.distance_to(Vector3((i / height) * 2, 0.5 + i % height, 0)));
+	}
+	print_line(vformat("%d iterations, residual threshold %f: %d usec, max drift %f", p_iterations, p_residual_threshold, elapsed, drift));
+
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(floor);
+	ps->free(box);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics3D][Benchmark] Box stacks" * doctest::skip()) {
+	_benchmark_stacks(0.0, 16);
+	_benchmark_stacks(0.001, 16);
+	_benchmark_stacks(0.0, 32);
+	_benchmark_stacks(0.001, 32);
+}
+
+} // namespace TestPhysicsStep
+
+#endif // TEST_PHYSICS_STEP_H
@@ -54,10 +54,12 @@
 #include "tests/core/math/test_vector3.h"
 #include "tests/core/math/test_vector3i.h"
 #include "tests/core/object/test_class_db.h"
+#include "tests/core/object/test_message_queue.h"
 #include "tests/core/object/test_method_bind.h"
 #include "tests/core/object/test_object.h"
 #include "tests/core/string/test_node_path.h"
 #include "tests/core/string/test_string.h"
+#include "tests/core/string/test_string_name.h"
 #include "tests/core/string/test_translation.h"
 #include "tests/core/templates/test_command_queue.h"
 #include "tests/core/templates/test_list.h"
@@ -66,10 +68,13 @@
 #include "tests/core/templates/test_oa_hash_map.h"
 #include "tests/core/templates/test_ordered_hash_map.h"
 #include "tests/core/templates/test_paged_array.h"
+#include "tests/core/templates/test_swiss_hash_map.h"
 #include "tests/core/templates/test_vector.h"
 #include "tests/core/test_crypto.h"
+#include "tests/core/test_frame_allocator.h"
 #include "tests/core/test_hashing_context.h"
 #include "tests/core/test_time.h"
+#include "tests/core/test_worker_thread_pool.h"
 #include "tests/core/variant/test_array.h"
 #include "tests/core/variant/test_dictionary.h"
 #include "tests/core/variant/test_variant.h"
@@ -78,9 +83,17 @@
 #include "tests/scene/test_curve.h"
 #include "tests/scene/test_gradient.h"
 #include "tests/scene/test_gui.h"
+#include "tests/scene/test_mesh_tools.h"
 #include "tests/scene/test_path_3d.h"
 #include "tests/servers/test_physics_2d.h"
 #include "tests/servers/test_physics_3d.h"
+#include "tests/servers/test_physics_determinism.h"
+#include "tests/servers/test_physics_heightmap.h"
+#include "tests/servers/test_physics_narrowphase.h"
+#include "tests/servers/test_physics_queries.h"
+#include "tests/servers/test_physics_snapshot.h"
+#include "tests/servers/test_physics_soft_body.h"
+#include "tests/servers/test_physics_step.h"
 #include "tests/servers/test_render.h"
 #include "tests/servers/test_shader_lang.h"
 #include "tests/servers/test_text_server.h"